@@ -27,6 +27,7 @@
 #include <vespa/document/fieldvalue/weightedsetfieldvalue.h>
 #include <vespa/document/fieldvalue/tensorfieldvalue.h>
 #include <vespa/document/fieldvalue/referencefieldvalue.h>
+#include <vespa/document/fieldset/fieldsets.h>
 #include <vespa/document/predicate/predicate.h>
 #include <vespa/document/predicate/predicate_slime_builder.h>
 #include <vespa/document/repo/configbuilder.h>
@@ -580,6 +581,31 @@ TEST("requireThatDocumentCanBeSerialized") {
     EXPECT_EQUAL(0, read_version);
 }
 
+TEST("require that document can be deserialized with only selected fields") {
+    const DocumentType &type = repo.getDocumentType();
+
+    DocumentId doc_id("doc::testdoc");
+    Document value(type, doc_id);
+    value.setValue(type.getField("header field"), IntFieldValue(42));
+    value.setValue(type.getField("body field"), StringFieldValue("foobar"));
+
+    nbostream stream;
+    VespaDocumentSerializer serializer(stream);
+    serializer.write(value);
+
+    FieldCollection fields(type);
+    fields.insert(type.getField("body field"));
+    Document selected;
+    VespaDocumentDeserializer deserializer(repo, stream, serialization_version);
+    deserializer.read(selected, fields);
+    EXPECT_EQUAL(0u, stream.size());
+
+    EXPECT_EQUAL(doc_id, selected.getId());
+    EXPECT_FALSE(selected.hasValue(type.getField("header field")));
+    ASSERT_TRUE(selected.hasValue(type.getField("body field")));
+    EXPECT_EQUAL(StringFieldValue("foobar"), *selected.getValue(type.getField("body field")));
+}
+
 TEST("requireThatOldVersionDocumentCanBeDeserialized") {
     uint16_t old_version = 6;
     uint16_t data_size = 432;
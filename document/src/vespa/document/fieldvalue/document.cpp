@@ -417,6 +417,15 @@ void Document::deserialize(const DocumentTypeRepo& repo, vespalib::nbostream & o
     }
 }
 
+void Document::deserialize(const DocumentTypeRepo& repo, vespalib::nbostream & os, const FieldSet & fields) {
+    VespaDocumentDeserializer deserializer(repo, os, 0);
+    try {
+        deserializer.read(*this, fields);
+    } catch (const IllegalStateException &e) {
+        throw DeserializeException(vespalib::string("Buffer out of bounds: ") + e.what());
+    }
+}
+
 void Document::deserialize(const DocumentTypeRepo& repo, ByteBuffer& data) {
     nbostream stream(data.getBufferAtPos(), data.getRemaining());
     deserialize(repo, stream);
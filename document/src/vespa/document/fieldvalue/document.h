@@ -118,6 +118,12 @@ public:
     /** Deserialize document contained in given bytebuffer. */
     void deserialize(const DocumentTypeRepo& repo, ByteBuffer& data);
     void deserialize(const DocumentTypeRepo& repo, vespalib::nbostream & os);
+    /**
+     * Deserialize document contained in given stream, keeping only the given fields.
+     * The serialized data of other fields is skipped, so the cost follows the size of
+     * the selected fields rather than the size of the document.
+     */
+    void deserialize(const DocumentTypeRepo& repo, vespalib::nbostream & os, const FieldSet & fields);
     /** Deserialize document contained in given bytebuffers. */
     void deserialize(const DocumentTypeRepo& repo, ByteBuffer& body, ByteBuffer& header);
     void deserializeHeader(const DocumentTypeRepo& repo, ByteBuffer& header);
@@ -16,6 +16,7 @@
 #include <vespa/document/fieldvalue/shortfieldvalue.h>
 #include <vespa/document/fieldvalue/stringfieldvalue.h>
 #include <vespa/document/fieldvalue/weightedsetfieldvalue.h>
+#include <vespa/document/fieldset/fieldset.h>
 #include <vespa/document/fieldvalue/tensorfieldvalue.h>
 #include <vespa/document/fieldvalue/referencefieldvalue.h>
 #include <vespa/document/repo/documenttyperepo.h>
@@ -76,7 +77,7 @@ getChunkCount(uint8_t contentCode)
 
 }  // namespace
 
-void VespaDocumentDeserializer::readDocument(Document &value) {
+void VespaDocumentDeserializer::readDocument(Document &value, const FieldSet * fields) {
     read(value.getId());
     uint8_t content_code = readValue<uint8_t>(_stream);
 
@@ -93,7 +94,7 @@ void VespaDocumentDeserializer::readDocument(Document &value) {
     uint32_t chunkCount = getChunkCount(content_code);
     value.getFields().reset();
     for (uint32_t i = 0; i < chunkCount; ++i) {
-        readStructNoReset(value.getFields());
+        readStructNoReset(value.getFields(), fields);
     }
 }
 
@@ -134,6 +135,14 @@ void VespaDocumentDeserializer::read(DocumentType &value) {
 }
 
 void VespaDocumentDeserializer::read(Document &value) {
+    readVersionedDocument(value, nullptr);
+}
+
+void VespaDocumentDeserializer::read(Document &value, const FieldSet & fields) {
+    readVersionedDocument(value, (fields.getType() == FieldSet::ALL) ? nullptr : &fields);
+}
+
+void VespaDocumentDeserializer::readVersionedDocument(Document &value, const FieldSet * fields) {
     uint16_t version = readValue<uint16_t>(_stream);
     VarScope<uint16_t> version_scope(_version, version);
 
@@ -146,7 +155,7 @@ void VespaDocumentDeserializer::read(Document &value) {
     if (version >= 7) {
         uint32_t data_size = readValue<uint32_t>(_stream);
         size_t data_start_size = _stream.size();
-        readDocument(value);
+        readDocument(value, fields);
         if (version == 7) {
             readValue<uint32_t>(_stream);  // Skip crc value.
         }
@@ -159,7 +168,7 @@ void VespaDocumentDeserializer::read(Document &value) {
         }
     } else {  // version <= 6
         getInt2_4_8Bytes(_stream);  // skip document length
-        readDocument(value);
+        readDocument(value, fields);
         readValue<uint32_t>(_stream);  // Skip crc value.
     }
 }
@@ -305,9 +314,47 @@ void readFieldInfo(nbostream& input, SerializableArray::EntryMap & field_info) {
         offset += size;
     }
 }
+
+/**
+ * Keep only the entries of fields in the given field set, preserving their order.
+ */
+FieldInfo
+selectFields(const FieldInfo & field_info, const StructDataType & type, const FieldSet & fields) {
+    FieldInfo selected;
+    for (const auto & entry : field_info) {
+        if (type.hasField(entry.id()) && fields.contains(type.getField(entry.id()))) {
+            selected.push_back(entry);
+        }
+    }
+    return selected;
+}
+
+/**
+ * Copy the serialized data of the selected fields into a compact buffer, rebasing their offsets.
+ */
+ByteBuffer::UP
+copySelectedFields(const ByteBuffer & source, FieldInfo & selected) {
+    size_t total_size = 0;
+    for (const auto & entry : selected) {
+        total_size += entry.size();
+    }
+    ByteBuffer::UP buffer(new ByteBuffer(total_size));
+    uint32_t offset = 0;
+    for (auto & entry : selected) {
+        memcpy(buffer->getBuffer() + offset, entry.getBuffer(&source), entry.size());
+        entry = SerializableArray::Entry(entry.id(), entry.size(), offset);
+        offset += entry.size();
+    }
+    return buffer;
+}
+
 }  // namespace
 
 void VespaDocumentDeserializer::readStructNoReset(StructFieldValue &value) {
+    readStructNoReset(value, nullptr);
+}
+
+void VespaDocumentDeserializer::readStructNoReset(StructFieldValue &value, const FieldSet * fields) {
     size_t start_size = _stream.size();
     size_t data_size;
     if (_version < 6) {
@@ -338,6 +385,23 @@ void VespaDocumentDeserializer::readStructNoReset(StructFieldValue &value) {
         }
     }
 
+    if ((data_size > 0) && (fields != nullptr)) {
+        const auto & type = static_cast<const StructDataType &>(*value.getDataType());
+        FieldInfo selected = selectFields(field_info, type, *fields);
+        if (selected.empty()) {
+            _stream.adjustReadPos(data_size);
+            return;
+        }
+        if ((selected.size() < field_info.size()) && ! CompressionConfig::isCompressed(compression_type)) {
+            ByteBuffer::UP buffer(_stream.isLongLivedBuffer()
+                                  ? new ByteBuffer(_stream.peek(), data_size)
+                                  : copySelectedFields(ByteBuffer(_stream.peek(), data_size), selected).release());
+            value.lazyDeserialize(_repo, _version, std::move(selected),
+                                  std::move(buffer), compression_type, uncompressed_size);
+            _stream.adjustReadPos(data_size);
+            return;
+        }
+    }
     if (data_size > 0) {
         ByteBuffer::UP buffer(_stream.isLongLivedBuffer()
                           ? new ByteBuffer(_stream.peek(), data_size)
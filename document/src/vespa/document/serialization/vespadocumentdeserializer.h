@@ -13,6 +13,7 @@ class DocumentId;
 class DocumentType;
 class DocumentTypeRepo;
 class FieldValue;
+class FieldSet;
 
 class VespaDocumentDeserializer : private FieldValueVisitor {
     vespalib::nbostream &_stream;
@@ -37,7 +38,9 @@ class VespaDocumentDeserializer : private FieldValueVisitor {
     void visit(TensorFieldValue &value) override { read(value); }
     void visit(ReferenceFieldValue &value) override { read(value); }
 
-    void readDocument(Document &value);
+    void readDocument(Document &value, const FieldSet * fields);
+    void readVersionedDocument(Document &value, const FieldSet * fields);
+    void readStructNoReset(StructFieldValue &value, const FieldSet * fields);
 
 public:
     VespaDocumentDeserializer(const DocumentTypeRepo &repo, vespalib::nbostream &stream, uint16_t version) :
@@ -60,6 +63,11 @@ public:
     void read(DocumentId &value);
     void read(DocumentType &value);
     void read(Document &value);
+    /**
+     * Read a document, but only keep the serialized data of the top level fields in the given field set.
+     * The data of the other fields is skipped without being copied or decompressed.
+     */
+    void read(Document &value, const FieldSet & fields);
     void read(AnnotationReferenceFieldValue &value);
     void read(ArrayFieldValue &value);
     void read(MapFieldValue &value);
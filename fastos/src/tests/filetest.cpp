@@ -301,6 +301,61 @@ public:
         PrintSeparator();
     }
 
+    void PrefetchTest (bool useMemoryMap)
+    {
+        TestHeader ("Prefetch Test");
+
+        int i;
+        const int bufSize = 10000;
+
+        FastOS_File::MakeDirectory("generated");
+        FastOS_File file("generated/prefetchtest");
+
+        bool rc = file.OpenReadWrite();
+        Progress(rc, "Opening file 'generated/prefetchtest'");
+
+        if (rc) {
+            char *buffer = new char [bufSize];
+            for (i = 0; i < bufSize; i++) {
+                buffer[i] = i % 256;
+            }
+            ssize_t wroteB = file.Write2(buffer, bufSize);
+            Progress(wroteB == bufSize, "Writing %d bytes to file", bufSize);
+
+            file.Close();
+
+            if (useMemoryMap) {
+                file.enableMemoryMap(0);
+            }
+            rc = file.OpenReadOnly();
+            Progress(rc, "Opening file 'generated/prefetchtest' read-only");
+            if (rc) {
+                Progress(true, "Memory mapping %s",
+                         file.IsMemoryMapped() ? "enabled" : "disabled");
+
+                // Unaligned ranges, and ranges reaching or starting past
+                // the end of the file, are only hints and must be harmless.
+                file.prefetch(0, bufSize);
+                file.prefetch(4097, 100);
+                file.prefetch(bufSize - 10, 100);
+                file.prefetch(bufSize, 100);
+                file.prefetch(2 * bufSize, 100);
+                Progress(true, "Prefetching ranges of file");
+
+                memset(buffer, 0, bufSize);
+                file.ReadBuf(buffer, bufSize, 0);
+                rc = true;
+                for (i = 0; i < bufSize; i++) {
+                    rc &= (buffer[i] == static_cast<char>(i % 256));
+                }
+                Progress(rc, "Reading %d bytes after prefetch", bufSize);
+            }
+            delete [] buffer;
+        }
+        FastOS_File::EmptyAndRemoveDirectory("generated");
+        PrintSeparator();
+    }
+
     void DirectIOTest ()
     {
         TestHeader ("Direct Disk IO Test");
@@ -814,6 +869,8 @@ public:
         ReadBufTest();
         MemoryMapTest(0);
         MemoryMapTest(MAP_HUGETLB);
+        PrefetchTest(false);
+        PrefetchTest(true);
 
         PrintSeparator();
         printf("END OF TEST (%s)\n", _argv[0]);
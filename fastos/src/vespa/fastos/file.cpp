@@ -490,6 +490,12 @@ void FastOS_FileInterface::dropFromCache() const
 {
 }
 
+void FastOS_FileInterface::prefetch(int64_t offset, size_t length) const
+{
+    (void) offset;
+    (void) length;
+}
+
 FastOS_DirectoryScanInterface::FastOS_DirectoryScanInterface(const char *path)
     : _searchPath(strdup(path))
 {
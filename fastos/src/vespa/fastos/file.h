@@ -587,6 +587,13 @@ public:
      **/
     virtual void dropFromCache() const;
 
+    /**
+     * Hint that the given range will be read soon, allowing the OS to
+     * start reading it into the FS cache (or page in the memory mapping)
+     * asynchronously. Does not block and has no effect on file content.
+     **/
+    virtual void prefetch(int64_t offset, size_t length) const;
+
     enum Error
     {
         ERR_ZERO = 1,   // No error                       New style
@@ -9,6 +9,7 @@
 
 #include "file.h"
 #include <sstream>
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <unistd.h>
@@ -248,6 +249,22 @@ void FastOS_UNIX_File::dropFromCache() const
     posix_fadvise(_filedes, 0, 0, POSIX_FADV_DONTNEED);
 }
 
+void FastOS_UNIX_File::prefetch(int64_t offset, size_t length) const
+{
+    if (_mmapbase != nullptr) {
+        if ((offset < 0) || (static_cast<size_t>(offset) >= _mmaplen)) {
+            return;
+        }
+        length = std::min(length, _mmaplen - offset);
+        // madvise requires a page aligned start address
+        size_t pageSize = getpagesize();
+        size_t pageOffset = offset & (pageSize - 1);
+        madvise(static_cast<char *>(_mmapbase) + offset - pageOffset, length + pageOffset, MADV_WILLNEED);
+    } else if (_filedes >= 0) {
+        posix_fadvise(_filedes, offset, length, POSIX_FADV_WILLNEED);
+    }
+}
+
 
 bool
 FastOS_UNIX_File::Close(void)
@@ -63,6 +63,8 @@ void AuxTest::init()
         &AuxTest::TestSpecialTokenRegistry;
     test_methods_["TestWhiteSpacePreserved"] =
         &AuxTest::TestWhiteSpacePreserved;
+    test_methods_["TestEarlyTermination"] =
+        &AuxTest::TestEarlyTermination;
 }
 
 
@@ -909,6 +911,57 @@ AuxTest::TestWhiteSpacePreserved()
     juniper::ReleaseResult(res);
 }
 
+void
+AuxTest::TestEarlyTermination()
+{
+    vespalib::string input = "elvis has left the building, elvis is back. Elvis lives. ";
+    for (int i = 0; i < 200; ++i) {
+        input += "some filler text without the query term. ";
+    }
+    input += "elvis at the end";
+
+    juniper::PropertyMap fullprops;
+    fullprops.set("juniper.dynsum.escape_markup", "off")
+                .set("juniper.dynsum.highlight_off", "</hi>")
+                .set("juniper.dynsum.continuation", "<sep />")
+                .set("juniper.dynsum.highlight_on", "<hi>")
+                .set("juniper.dynsum.length", "64")
+                .set("juniper.dynsum.max_matches", "2");
+    juniper::PropertyMap earlyprops(fullprops);
+    earlyprops.set("juniper.matcher.early_termination", "on");
+    Fast_NormalizeWordFolder wf;
+    juniper::Juniper fulljuniper(&fullprops, &wf);
+    juniper::Juniper earlyjuniper(&earlyprops, &wf);
+    juniper::Config fullConfig("myconfig", fulljuniper);
+    juniper::Config earlyConfig("myconfig", earlyjuniper);
+
+    juniper::QueryParser q("elvis");
+    juniper::QueryHandle fullqh(q, NULL, fulljuniper.getModifier());
+    juniper::QueryHandle earlyqh(q, NULL, earlyjuniper.getModifier());
+    juniper::Result* full = juniper::Analyse(&fullConfig, &fullqh, input.c_str(), input.size(), 0, 0, 0);
+    juniper::Result* early = juniper::Analyse(&earlyConfig, &earlyqh, input.c_str(), input.size(), 0, 0, 0);
+    _test(full != NULL);
+    _test(early != NULL);
+
+    juniper::Summary* fullsum = juniper::GetTeaser(full, NULL);
+    juniper::Summary* earlysum = juniper::GetTeaser(early, NULL);
+    _test(fullsum->Length() > 0);
+    _test(vespalib::string(fullsum->Text(), fullsum->Length()) ==
+          vespalib::string(earlysum->Text(), earlysum->Length()));
+    // The early terminated scan skipped the hit at the end of the text
+    _test(full->_matcher->TotalHits() == 4);
+    _test(early->_matcher->TotalHits() == 3);
+    _test(early->_matcher->scan_truncated());
+    _test(early->_matcher->DocumentSize() == input.size());
+
+    // Relevancy needs the whole text and rescans it
+    _test(juniper::GetRelevancy(early) == juniper::GetRelevancy(full));
+    _test(early->_matcher->TotalHits() == 4);
+    _test(!early->_matcher->scan_truncated());
+    juniper::ReleaseResult(full);
+    juniper::ReleaseResult(early);
+}
+
 void AuxTest::Run(MethodContainer::iterator &itr) {
     try {
         (this->*itr->second)();
@@ -57,6 +57,12 @@ public:
      *  @param token The token to process.
      */
     virtual void handle_end(Token& token) = 0;
+
+    /** Check if the processor has all the tokens it needs. The tokenizer
+     *  then skips the rest of the text and proceeds with handle_end.
+     *  @return true if no more tokens are needed.
+     */
+    virtual bool settled() const { return false; }
 };
 
 
@@ -29,6 +29,9 @@ Matcher::Matcher(Result* result) :
     _proximity_factor(1.0),
     _need_complete_cnt(3),
     _endpos(0),
+    _early_termination_margin(0),
+    _settle_pos(0),
+    _scan_truncated(false),
     _nontermcnt(_mo->NontermCount()),
     _occ(),
     _wrk_set(NULL),
@@ -112,6 +115,9 @@ void Matcher::reset_document()
     reset_matches();
     reset_occurrences();
     _endpos = 0;
+    _need_complete_cnt = _result->_config->_docsumparams.MaxMatches();
+    _settle_pos = 0;
+    _scan_truncated = false;
 }
 
 void Matcher::reset_matches()
@@ -254,6 +260,9 @@ void Matcher::update_wrk_set(match_sequence& ws, MatchElement* k, QueryExpr* mex
                 if (m->matches_limit()) {
                     if (_need_complete_cnt > 0) {
                         _need_complete_cnt--;
+                        if ((_need_complete_cnt == 0) && (_early_termination_margin > 0)) {
+                            _settle_pos = m->endpos() + _early_termination_margin;
+                        }
                     }
                     update_match(m);
                 } else {
@@ -330,6 +339,7 @@ void Matcher::handle_end(Token& token)
         dump_matches(10, false);
     }
     JL(JD_MDUMP, log_matches(20));
+    _scan_truncated = settled() && (_endpos < static_cast<size_t>(token.bytepos));
     // Just keep track of end of the text
     _endpos = token.bytepos;
     // flush here for now since we do not traverse all the nonterminal lists for each kw.
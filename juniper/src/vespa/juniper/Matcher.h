@@ -70,6 +70,17 @@ public:
     /** Token handlers to be called by tokenization step */
     void handle_token(Token& token) override;
     void handle_end(Token& token) override;
+    bool settled() const override { return (_settle_pos > 0) && (_endpos >= _settle_pos); }
+
+    /** Stop the scan margin bytes after the end of the match completing
+     *  the number of matches needed for the teaser. The teaser cannot show
+     *  text further away than that from the selected matches.
+     *  @param margin The number of bytes to scan past that match, 0 to scan the whole text.
+     */
+    void set_early_termination(size_t margin) { _early_termination_margin = margin; }
+
+    /** @return true if the last scan skipped the end of the text */
+    bool scan_truncated() const { return _scan_truncated; }
 
     /** Utilities for dump to standard output */
     void dump_matches(int printcount = 10, bool best = false);
@@ -163,6 +174,10 @@ private:
     // Internal state
     size_t _endpos; // The last valid position from the token pipeline
 
+    size_t _early_termination_margin; // 0 means scan the whole text
+    size_t _settle_pos;  // If >0, the text position after which no more tokens are needed
+    bool _scan_truncated;
+
     size_t _nontermcnt;  // The number of nonterminals in the query
     // The sequence of occurrences of the search terms in the document
     key_occ_vector _occ;
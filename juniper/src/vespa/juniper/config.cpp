@@ -7,6 +7,7 @@
 #define _NEED_SUMMARY_CONFIG_IMPL
 #include "SummaryConfig.h"
 #include <vespa/vespalib/locale/c.h>
+#include <cstring>
 
 namespace juniper
 {
@@ -36,6 +37,7 @@ Config::Config(const char* config_name, Juniper & juniper) :
     const char* preserve_white_space  = GetProp("dynsum.preserve_white_space", "off");
     size_t match_winsize = strtol(GetProp("matcher.winsize", "200"), NULL, 0);
     size_t max_match_candidates = atoi(GetProp("matcher.max_match_candidates", "1000"));
+    const char* early_termination = GetProp("matcher.early_termination", "off");
     const char* seps = GetProp("dynsum.separators", separators.c_str());
     const unsigned char* cons =
         reinterpret_cast<const unsigned char*>(GetProp("dynsum.connectors", separators.c_str()));
@@ -55,6 +57,7 @@ Config::Config(const char* config_name, Juniper & juniper) :
         .SetStemMinLength(stem_min).SetStemMaxExtend(stem_extend)
         .SetMatchWindowSize(match_winsize)
         .SetMaxMatchCandidates(max_match_candidates)
+        .SetEarlyTermination(strcmp(early_termination, "on") == 0)
         .SetWordFolder(& _juniper.getWordFolder())
         .SetProximityFactor(proximity_factor);
 }
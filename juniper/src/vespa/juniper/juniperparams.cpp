@@ -77,6 +77,7 @@ MatcherParams::MatcherParams() :
     _match_winsize_fallback_multiplier(10.0),
     _max_match_candidates(1000),
     _want_global_rank(false),
+    _early_termination(false),
     _stem_min(0), _stem_extend(0),
     _wordfolder(NULL), _proximity_factor(1.0)
 { }
@@ -119,6 +120,12 @@ MatcherParams& MatcherParams::SetWantGlobalRank(bool global_rank)
     return *this;
 }
 
+MatcherParams& MatcherParams::SetEarlyTermination(bool early_termination)
+{
+    _early_termination = early_termination;
+    return *this;
+}
+
 MatcherParams& MatcherParams::SetStemMinLength(size_t stem_min)
 {
     _stem_min = stem_min;
@@ -138,6 +145,7 @@ size_t MatcherParams::MatchWindowSize() const { return _match_winsize; }
 double MatcherParams::MatchWindowSizeFallbackMultiplier() const { return _match_winsize_fallback_multiplier; }
 size_t MatcherParams::MaxMatchCandidates() const { return _max_match_candidates; }
 bool   MatcherParams::WantGlobalRank() const { return _want_global_rank; }
+bool   MatcherParams::EarlyTermination() const { return _early_termination; }
 size_t MatcherParams::StemMinLength() const { return _stem_min; }
 size_t MatcherParams::StemMaxExtend() const { return _stem_extend; }
 
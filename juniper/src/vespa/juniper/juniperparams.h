@@ -71,6 +71,9 @@ public:
     MatcherParams& SetWantGlobalRank(bool global_rank);
     bool WantGlobalRank() const;
 
+    MatcherParams& SetEarlyTermination(bool early_termination);
+    bool EarlyTermination() const;
+
     MatcherParams& SetStemMinLength(size_t stem_min);
     size_t StemMinLength() const;
 
@@ -90,6 +93,7 @@ private:
     double _match_winsize_fallback_multiplier;
     size_t _max_match_candidates;
     bool _want_global_rank;
+    bool _early_termination; // Stop scanning for teasers once enough matches are found
     size_t _stem_min;
     size_t _stem_extend;
     Fast_WordFolder* _wordfolder; // The wordfolder object needed as 1st parameter to folderfun
@@ -46,7 +46,8 @@ Result::Result(Config* config, QueryHandle* qhandle,
     _stem_extend(0),
     _winsize(0),
     _winsize_fallback_multiplier(10.0),
-    _max_match_candidates(1000)
+    _max_match_candidates(1000),
+    _early_termination(false)
 {
     if (!_mo) return; // The empty result..
 
@@ -79,6 +80,8 @@ Result::Result(Config* config, QueryHandle* qhandle,
         _max_match_candidates = _qhandle->_max_match_candidates;
     }
 
+    _early_termination = mp.EarlyTermination();
+
     /* Create the new pipeline */
     _tokenizer.reset(new JuniperTokenizer(wordfolder, NULL, 0, NULL));
 
@@ -102,6 +105,30 @@ Result::~Result()
 }
 
 
+void Result::Scan(bool for_teaser)
+{
+    if (_scan_done && (for_teaser || !_matcher->scan_truncated())) return;
+    if (_scan_done) {
+        _matcher->reset_document();
+    }
+    _matcher->set_early_termination(for_teaser ? EarlyTerminationMargin() : 0);
+    _tokenizer->SetText(_docsum, _docsum_len);
+    _tokenizer->scan();
+    _scan_done = true;
+}
+
+
+size_t Result::EarlyTerminationMargin() const
+{
+    if (!_early_termination || _dynsum_len <= 0) return 0;
+    // The matcher counts the complete matches wanted by the default config
+    if (_max_matches <= 0 ||
+        static_cast<size_t>(_max_matches) > _config->_docsumparams.MaxMatches()) return 0;
+    // A teaser char is at most 4 bytes of UTF-8 text
+    return 4 * static_cast<size_t>(_dynsum_len);
+}
+
+
 long Result::GetRelevancy()
 {
     if (!_mo) return PROXIMITYBOOST_NOCONSTRAINT_OFFSET;
@@ -124,7 +151,6 @@ Summary* Result::GetTeaser(const Config* alt_config)
     SummaryImpl *sum = NULL;
     // Avoid overhead when being called with an empty stack
     if (_mo && _mo->Query()) {
-        Scan();
         if (_qhandle->_max_matches < 0)
             _max_matches = dsp.MaxMatches();
         else
@@ -133,6 +159,7 @@ Summary* Result::GetTeaser(const Config* alt_config)
             _surround_max = dsp.SurroundMax();
         else
             _surround_max = _qhandle->_surround_max;
+        Scan(true);
 
         SummaryDesc* sdesc =
             _matcher->CreateSummaryDesc(_dynsum_len, dsp.MinLength(), _max_matches, _surround_max);
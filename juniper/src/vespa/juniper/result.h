@@ -18,15 +18,12 @@ public:
 	   const char* docsum, size_t docsum_len, uint32_t langid);
     ~Result();
 
-    inline void Scan()
-    {
-        if (!_scan_done)
-        {
-            _tokenizer->SetText(_docsum, _docsum_len);
-            _tokenizer->scan();
-            _scan_done = true;
-        }
-    }
+    /** Scan the text, if not already done.
+     *  @param for_teaser If set and early termination is enabled, the scan stops
+     *   shortly after the matcher has found the matches wanted for the teaser.
+     *   A later full scan then starts over.
+     */
+    void Scan(bool for_teaser = false);
 
     long GetRelevancy();
     size_t StemMin()  const { return _stem_min; }
@@ -34,6 +31,7 @@ public:
     size_t WinSize()  const { return _winsize; }
     double WinSizeFallbackMultiplier() const { return _winsize_fallback_multiplier; }
     size_t MaxMatchCandidates()  const { return _max_match_candidates; }
+    size_t EarlyTerminationMargin() const;
     Summary* GetTeaser(const Config* alt_config);
     Summary* GetLog();
 
@@ -62,6 +60,7 @@ private:
     size_t _winsize;  // Window size to use when matching
     double _winsize_fallback_multiplier;
     size_t _max_match_candidates;
+    bool _early_termination;
 
     Result(Result &);
     Result &operator=(Result &);
@@ -60,6 +60,7 @@ void JuniperTokenizer::scan()
             token.curlen, token.bytepos, token.bytelen);
         // NB! not setting charlen/charpos/_utf8pos/_utf8len yet...!
         _successor->handle_token(token);
+        if (_successor->settled()) break;
     }
     token.bytepos = _len;
     token.bytelen = 0;
@@ -15,6 +15,13 @@ namespace attribute {
 class Config
 {
 public:
+    /**
+     * Dictionary used for enumerated attributes. BTREE_AND_HASH keeps a
+     * hash index from value to enum index in addition to the ordered
+     * dictionary, used for exact value lookups when feeding.
+     */
+    enum class DictionaryType { BTREE, BTREE_AND_HASH };
+
     Config();
     Config(BasicType bt, CollectionType ct = CollectionType::SINGLE,
            bool fastSearch_ = false, bool huge_ = false);
@@ -49,6 +56,8 @@ public:
      */
     bool fastAccess() const { return _fastAccess; }
 
+    DictionaryType dictionaryType() const { return _dictionaryType; }
+
     const GrowStrategy & getGrowStrategy() const { return _growStrategy; }
     const CompactionStrategy &getCompactionStrategy() const { return _compactionStrategy; }
     void setHuge(bool v)                         { _huge = v; }
@@ -84,6 +93,7 @@ public:
     }
 
     void setFastAccess(bool v) { _fastAccess = v; }
+    void setDictionaryType(DictionaryType v) { _dictionaryType = v; }
     Config & setGrowStrategy(const GrowStrategy &gs) { _growStrategy = gs; return *this; }
     Config &setCompactionStrategy(const CompactionStrategy &compactionStrategy) { _compactionStrategy = compactionStrategy; return *this; }
     bool operator!=(const Config &b) const { return !(operator==(b)); }
@@ -99,6 +109,7 @@ public:
                _enableOnlyBitVector == b._enableOnlyBitVector &&
                _isFilter == b._isFilter &&
                _fastAccess == b._fastAccess &&
+               _dictionaryType == b._dictionaryType &&
                _growStrategy == b._growStrategy &&
                _compactionStrategy == b._compactionStrategy &&
                _predicateParams == b._predicateParams &&
@@ -115,6 +126,7 @@ private:
     bool           _enableOnlyBitVector;
     bool           _isFilter;
     bool           _fastAccess;
+    DictionaryType _dictionaryType;
     GrowStrategy   _growStrategy;
     CompactionStrategy _compactionStrategy;
     PredicateParams    _predicateParams;
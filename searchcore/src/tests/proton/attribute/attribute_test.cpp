@@ -31,6 +31,7 @@
 #include <vespa/searchlib/attribute/singlenumericattribute.hpp>
 #include <vespa/searchlib/common/foregroundtaskexecutor.h>
 #include <vespa/searchlib/common/idestructorcallback.h>
+#include <vespa/searchlib/common/sequencedtaskexecutor.h>
 #include <vespa/searchlib/common/sequencedtaskexecutorobserver.h>
 #include <vespa/searchlib/index/docbuilder.h>
 #include <vespa/searchlib/index/dummyfileheadercontext.h>
@@ -40,6 +41,8 @@
 #include <vespa/searchlib/test/directory_handler.h>
 #include <vespa/searchlib/util/filekit.h>
 #include <vespa/vespalib/io/fileutil.h>
+#include <vespa/vespalib/util/gate.h>
+#include <vespa/vespalib/util/stringfmt.h>
 #include <vespa/vespalib/test/insertion_operators.h>
 #include <vespa/vespalib/testkit/testapp.h>
 #include <vespa/searchcommon/attribute/iattributevector.h>
@@ -119,17 +122,19 @@ struct Fixture
 {
     DirectoryHandler _dirHandler;
     DummyFileHeaderContext   _fileHeaderContext;
-    ForegroundTaskExecutor   _attributeFieldWriterReal;
+    std::unique_ptr<ISequencedTaskExecutor> _attributeFieldWriterReal;
     SequencedTaskExecutorObserver _attributeFieldWriter;
     HwInfo                   _hwInfo;
     proton::AttributeManager::SP _m;
     std::unique_ptr<AttributeWriter> _aw;
 
-    Fixture(uint32_t threads)
+    Fixture(uint32_t threads, bool foreground = true)
         : _dirHandler(test_dir),
           _fileHeaderContext(),
-          _attributeFieldWriterReal(threads),
-          _attributeFieldWriter(_attributeFieldWriterReal),
+          _attributeFieldWriterReal(foreground
+                                    ? std::unique_ptr<ISequencedTaskExecutor>(std::make_unique<ForegroundTaskExecutor>(threads))
+                                    : std::unique_ptr<ISequencedTaskExecutor>(std::make_unique<SequencedTaskExecutor>(threads))),
+          _attributeFieldWriter(*_attributeFieldWriterReal),
           _hwInfo(),
           _m(std::make_shared<proton::AttributeManager>
              (test_dir, "test.subdb", TuneFileAttributes(),
@@ -410,6 +415,57 @@ TEST_F("require that visibilitydelay is honoured", Fixture)
     
 }
 
+TEST_F("require that attribute writer batches writes queued behind busy executor", Fixture(1, false))
+{
+    AttributeVector::SP a1 = f.addAttribute("a1");
+    Schema s;
+    s.addAttributeField(Schema::AttributeField("a1", schema::DataType::INT32, CollectionType::SINGLE));
+    DocBuilder idb(s);
+    vespalib::Gate gate;
+    f._attributeFieldWriter.executeLambda(ISequencedTaskExecutor::ExecutorId(0), [&gate]() { gate.await(); });
+    for (uint32_t lid = 1; lid <= 10; ++lid) {
+        f.put(lid, *idb.startDocument(vespalib::make_string("doc::%u", lid)).
+              startAttributeField("a1").addInt(lid * 10).endField().
+              endDocument(), lid);
+    }
+    f.remove(11, 3);
+    gate.countDown();
+    f._attributeFieldWriter.sync();
+    TEST_DO(f.assertExecuteHistory({0, 0}));
+    EXPECT_EQUAL(11u, a1->getNumDocs());
+    EXPECT_EQUAL(11u, a1->getStatus().getLastSyncToken());
+    EXPECT_EQUAL(10, a1->getInt(1));
+    TEST_DO(assertUndefined(*a1, 3));
+    EXPECT_EQUAL(100, a1->getInt(10));
+    f.commit(12);
+    f.put(13, *idb.startDocument("doc::11").startAttributeField("a1").addInt(110).endField().endDocument(), 11);
+    f._attributeFieldWriter.sync();
+    TEST_DO(f.assertExecuteHistory({0, 0, 0, 0}));
+    EXPECT_EQUAL(13u, a1->getStatus().getLastSyncToken());
+    EXPECT_EQUAL(110, a1->getInt(11));
+}
+
+TEST_F("require that attribute writer does not batch writes across tasks scheduled by others", Fixture(1, false))
+{
+    AttributeVector::SP a1 = f.addAttribute("a1");
+    Schema s;
+    s.addAttributeField(Schema::AttributeField("a1", schema::DataType::INT32, CollectionType::SINGLE));
+    DocBuilder idb(s);
+    vespalib::Gate gate;
+    f._attributeFieldWriter.executeLambda(ISequencedTaskExecutor::ExecutorId(0), [&gate]() { gate.await(); });
+    f.put(1, *idb.startDocument("doc::1").startAttributeField("a1").addInt(10).endField().endDocument(), 1);
+    int32_t seenByOther = 0;
+    f._attributeFieldWriter.executeLambda(ISequencedTaskExecutor::ExecutorId(0),
+                                          [&seenByOther, a1]() { seenByOther = a1->getInt(1); });
+    f.put(2, *idb.startDocument("doc::1").startAttributeField("a1").addInt(20).endField().endDocument(), 1);
+    gate.countDown();
+    f._attributeFieldWriter.sync();
+    TEST_DO(f.assertExecuteHistory({0, 0, 0, 0}));
+    EXPECT_EQUAL(10, seenByOther);
+    EXPECT_EQUAL(20, a1->getInt(1));
+    EXPECT_EQUAL(2u, a1->getStatus().getLastSyncToken());
+}
+
 TEST_F("require that attribute writer handles predicate remove", Fixture)
 {
     AttributeVector::SP a1 = f.addAttribute({"a1", AVConfig(AVBasicType::PREDICATE)}, createSerialNum);
@@ -0,0 +1,166 @@
+// Copyright 2018 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/document/fieldvalue/document.h>
+#include <vespa/searchcore/proton/attribute/attribute_writer.h>
+#include <vespa/searchcore/proton/attribute/attributemanager.h>
+#include <vespa/searchcore/proton/common/hw_info.h>
+#include <vespa/searchlib/attribute/attributevector.h>
+#include <vespa/searchlib/common/idestructorcallback.h>
+#include <vespa/searchlib/common/sequencedtaskexecutor.h>
+#include <vespa/searchlib/index/docbuilder.h>
+#include <vespa/searchlib/index/dummyfileheadercontext.h>
+#include <vespa/searchlib/test/directory_handler.h>
+#include <vespa/vespalib/testkit/test_kit.h>
+#include <vespa/vespalib/util/benchmark_timer.h>
+#include <vespa/vespalib/util/stringfmt.h>
+
+using document::Document;
+using proton::AttributeManager;
+using proton::AttributeWriter;
+using proton::HwInfo;
+using search::AttributeVector;
+using search::IDestructorCallback;
+using search::ISequencedTaskExecutor;
+using search::SequencedTaskExecutor;
+using search::SerialNum;
+using search::TuneFileAttributes;
+using search::index::DocBuilder;
+using search::index::DummyFileHeaderContext;
+using search::index::Schema;
+using search::index::schema::CollectionType;
+using search::index::schema::DataType;
+using search::test::DirectoryHandler;
+using vespalib::BenchmarkTimer;
+using vespalib::make_string;
+
+using AVBasicType = search::attribute::BasicType;
+using AVCollectionType = search::attribute::CollectionType;
+using AVConfig = search::attribute::Config;
+
+namespace {
+
+const vespalib::string test_dir = "test_output";
+const uint32_t num_docs = 10000;
+const uint32_t num_words = 1000;
+
+const std::shared_ptr<IDestructorCallback> emptyCallback;
+
+/*
+ * Builds documents resembling the ones made by vespa-gen-testdocs:
+ * a handful of numeric fields and a string field drawn from a small
+ * vocabulary.
+ */
+std::vector<std::unique_ptr<Document>>
+makeDocs(DocBuilder &builder)
+{
+    std::vector<std::unique_ptr<Document>> docs;
+    docs.reserve(num_docs);
+    for (uint32_t i = 0; i < num_docs; ++i) {
+        docs.push_back(builder.startDocument(make_string("id:test:searchdocument::%u", i)).
+                       startAttributeField("i1").addInt(i).endField().
+                       startAttributeField("i2").addInt(i % 100).endField().
+                       startAttributeField("l1").addInt(i * 7919).endField().
+                       startAttributeField("s1").addStr(make_string("word%u", (i * 31) % num_words)).endField().
+                       endDocument());
+    }
+    return docs;
+}
+
+struct Feeder
+{
+    DirectoryHandler                 _dirHandler;
+    DummyFileHeaderContext           _fileHeaderContext;
+    SequencedTaskExecutor            _attributeFieldWriter;
+    HwInfo                           _hwInfo;
+    std::shared_ptr<AttributeManager> _m;
+    std::unique_ptr<AttributeWriter> _aw;
+    SerialNum                        _serialNum;
+
+    Feeder(uint32_t threads);
+    ~Feeder();
+    uint64_t numScheduledTasks() const;
+    void feed(const std::vector<std::unique_ptr<Document>> &docs, bool interleaveOtherTasks);
+};
+
+Feeder::Feeder(uint32_t threads)
+    : _dirHandler(test_dir),
+      _fileHeaderContext(),
+      _attributeFieldWriter(threads),
+      _hwInfo(),
+      _m(std::make_shared<AttributeManager>(test_dir, "test.subdb", TuneFileAttributes(),
+                                            _fileHeaderContext, _attributeFieldWriter, _hwInfo)),
+      _aw(),
+      _serialNum(1)
+{
+    _m->addAttribute({"i1", AVConfig(AVBasicType::INT32)}, _serialNum);
+    _m->addAttribute({"i2", AVConfig(AVBasicType::INT32)}, _serialNum);
+    _m->addAttribute({"l1", AVConfig(AVBasicType::INT64)}, _serialNum);
+    _m->addAttribute({"s1", AVConfig(AVBasicType::STRING)}, _serialNum);
+    _aw = std::make_unique<AttributeWriter>(_m);
+}
+
+Feeder::~Feeder() = default;
+
+uint64_t
+Feeder::numScheduledTasks() const
+{
+    uint64_t result = 0;
+    for (uint32_t id = 0; id < _attributeFieldWriter.getNumExecutors(); ++id) {
+        result += _attributeFieldWriter.getNumScheduledTasks(ISequencedTaskExecutor::ExecutorId(id));
+    }
+    return result;
+}
+
+void
+Feeder::feed(const std::vector<std::unique_ptr<Document>> &docs, bool interleaveOtherTasks)
+{
+    for (uint32_t i = 0; i < docs.size(); ++i) {
+        _aw->put(++_serialNum, *docs[i], i + 1, true, emptyCallback);
+        if (interleaveOtherTasks) {
+            // Emulates others sharing the executors (e.g. the gid to lid
+            // change listener), which closes the open write batches.
+            for (uint32_t id = 0; id < _attributeFieldWriter.getNumExecutors(); ++id) {
+                _attributeFieldWriter.executeLambda(ISequencedTaskExecutor::ExecutorId(id), []() { });
+            }
+        }
+    }
+    _attributeFieldWriter.sync();
+}
+
+void
+benchmarkFeed(const std::vector<std::unique_ptr<Document>> &docs, uint32_t threads, bool interleaveOtherTasks)
+{
+    Feeder feeder(threads);
+    uint64_t tasksBefore = 0;
+    uint64_t tasks = 0;
+    BenchmarkTimer timer(2.0);
+    while (timer.has_budget()) {
+        tasksBefore = feeder.numScheduledTasks();
+        timer.before();
+        feeder.feed(docs, interleaveOtherTasks);
+        timer.after();
+        tasks = feeder.numScheduledTasks() - tasksBefore;
+    }
+    double min_time_s = timer.min_time();
+    fprintf(stderr, "threads=%u, %s: %zu puts in %g ms, %g puts/s, %" PRIu64 " executor tasks\n",
+            threads, interleaveOtherTasks ? "interleaved" : "batched",
+            docs.size(), min_time_s * 1000.0, docs.size() / min_time_s, tasks);
+}
+
+}
+
+TEST("measure attribute writer feed throughput") {
+    Schema schema;
+    schema.addAttributeField(Schema::AttributeField("i1", DataType::INT32, CollectionType::SINGLE));
+    schema.addAttributeField(Schema::AttributeField("i2", DataType::INT32, CollectionType::SINGLE));
+    schema.addAttributeField(Schema::AttributeField("l1", DataType::INT64, CollectionType::SINGLE));
+    schema.addAttributeField(Schema::AttributeField("s1", DataType::STRING, CollectionType::SINGLE));
+    DocBuilder builder(schema);
+    auto docs = makeDocs(builder);
+    for (uint32_t threads : {1, 4}) {
+        benchmarkFeed(docs, threads, false);
+        benchmarkFeed(docs, threads, true);
+    }
+}
+
+TEST_MAIN() { TEST_RUN_ALL(); }
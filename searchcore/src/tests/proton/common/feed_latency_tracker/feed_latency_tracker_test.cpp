@@ -0,0 +1,103 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#include <vespa/log/log.h>
+LOG_SETUP("feed_latency_tracker_test");
+
+#include <vespa/searchcore/proton/common/feed_latency_tracker.h>
+#include <vespa/vespalib/testkit/testapp.h>
+
+using namespace proton;
+using search::IDestructorCallback;
+
+namespace {
+
+class CountingCallback : public IDestructorCallback
+{
+    uint32_t &_destroyed;
+public:
+    CountingCallback(uint32_t &destroyed) : _destroyed(destroyed) {}
+    ~CountingCallback() override { ++_destroyed; }
+};
+
+}
+
+struct Fixture {
+    FeedLatencyCollector::SP collector;
+    Fixture()
+        : collector(std::make_shared<FeedLatencyCollector>())
+    {
+    }
+    FeedLatencyTracker::SP makeTracker() {
+        return std::make_shared<FeedLatencyTracker>(collector, vespalib::string());
+    }
+};
+
+TEST_F("require that latencies are collected when the tracker is destroyed", Fixture)
+{
+    auto tracker = f.makeTracker();
+    tracker->stageDone(FeedLatencyStats::QUEUE, tracker->getReceived());
+    tracker->stageDone(FeedLatencyStats::MASTER, FeedLatencyTracker::clock::now());
+    EXPECT_EQUAL(0u, f.collector->take().get(FeedLatencyStats::TOTAL).count());
+    tracker.reset();
+    FeedLatencyStats stats = f.collector->take();
+    EXPECT_EQUAL(1u, stats.get(FeedLatencyStats::QUEUE).count());
+    EXPECT_EQUAL(1u, stats.get(FeedLatencyStats::MASTER).count());
+    EXPECT_EQUAL(0u, stats.get(FeedLatencyStats::TLS).count());
+    EXPECT_EQUAL(0u, stats.get(FeedLatencyStats::ATTRIBUTE).count());
+    EXPECT_EQUAL(1u, stats.get(FeedLatencyStats::TOTAL).count());
+    EXPECT_LESS_EQUAL(stats.get(FeedLatencyStats::QUEUE).max(), stats.get(FeedLatencyStats::TOTAL).max());
+}
+
+TEST_F("require that take resets the collected latencies", Fixture)
+{
+    f.makeTracker();
+    f.makeTracker();
+    EXPECT_EQUAL(2u, f.collector->take().get(FeedLatencyStats::TOTAL).count());
+    EXPECT_EQUAL(0u, f.collector->take().get(FeedLatencyStats::TOTAL).count());
+}
+
+TEST_F("require that a stage done in several parts is counted once", Fixture)
+{
+    auto tracker = f.makeTracker();
+    tracker->stageDone(FeedLatencyStats::ATTRIBUTE, FeedLatencyTracker::clock::now());
+    tracker->stageDone(FeedLatencyStats::ATTRIBUTE, tracker->getReceived());
+    tracker.reset();
+    EXPECT_EQUAL(1u, f.collector->take().get(FeedLatencyStats::ATTRIBUTE).count());
+}
+
+TEST_F("require that a tracked stage is done when its callback is destroyed", Fixture)
+{
+    uint32_t destroyed = 0;
+    auto tracker = f.makeTracker();
+    auto onDone = FeedLatencyTracker::trackStage(tracker, FeedLatencyStats::INDEX,
+                                                 std::make_shared<CountingCallback>(destroyed));
+    tracker.reset();
+    EXPECT_EQUAL(0u, f.collector->take().get(FeedLatencyStats::TOTAL).count());
+    onDone.reset();
+    EXPECT_EQUAL(1u, destroyed);
+    FeedLatencyStats stats = f.collector->take();
+    EXPECT_EQUAL(1u, stats.get(FeedLatencyStats::INDEX).count());
+    EXPECT_EQUAL(1u, stats.get(FeedLatencyStats::TOTAL).count());
+}
+
+TEST("require that callbacks are passed through when there is no tracker")
+{
+    uint32_t destroyed = 0;
+    std::shared_ptr<IDestructorCallback> inner = std::make_shared<CountingCallback>(destroyed);
+    auto onDone = FeedLatencyTracker::trackStage(FeedLatencyTracker::SP(), FeedLatencyStats::TLS, inner);
+    EXPECT_EQUAL(inner.get(), onDone.get());
+}
+
+TEST_F("require that every trace interval-th operation is traced", Fixture)
+{
+    EXPECT_FALSE(f.collector->sampleTrace());
+    f.collector->setTraceInterval(3);
+    EXPECT_TRUE(f.collector->sampleTrace());
+    EXPECT_FALSE(f.collector->sampleTrace());
+    EXPECT_FALSE(f.collector->sampleTrace());
+    EXPECT_TRUE(f.collector->sampleTrace());
+}
+
+TEST_MAIN()
+{
+    TEST_RUN_ALL();
+}
@@ -7,8 +7,10 @@
 #include <vespa/eval/tensor/tensor_factory.h>
 #include <vespa/document/repo/documenttyperepo.h>
 #include <vespa/document/test/make_bucket_space.h>
+#include <vespa/document/update/documentupdate.h>
 #include <vespa/searchcore/proton/attribute/attribute_writer.h>
 #include <vespa/searchcore/proton/test/bucketfactory.h>
+#include <vespa/searchcore/proton/docsummary/docsum_blob_store.h>
 #include <vespa/searchcore/proton/docsummary/docsumcontext.h>
 #include <vespa/searchcore/proton/docsummary/documentstoreadapter.h>
 #include <vespa/searchcore/proton/docsummary/summarymanager.h>
@@ -32,6 +34,7 @@
 #include <vespa/searchlib/transactionlog/translogserver.h>
 #include <vespa/vespalib/data/slime/slime.h>
 #include <vespa/vespalib/encoding/base64.h>
+#include <vespa/vespalib/util/simple_thread_bundle.h>
 #include <vespa/config-bucketspaces.h>
 #include <vespa/vespalib/testkit/testapp.h>
 
@@ -332,6 +335,11 @@ private:
     void requireThatRawFieldsWorks();
     void requireThatFieldCacheRepoCanReturnDefaultFieldCache();
     void requireThatSummariesTimeout();
+    void requireThatDocsumsCanBeProducedInParallel();
+    void requireThatParallelSlimeDocsumsMatchSingleThreaded();
+    void requireThatParallelSlimeSummariesTimeout();
+    void requireThatAdapterUsesPackedDocsumBlobs();
+    void requireThatSummaryManagerMaintainsDocsumBlobs();
 
 public:
     Test();
@@ -577,6 +585,106 @@ Test::requireThatAdapterHandlesDocumentIdField()
 }
 
 
+void
+Test::requireThatAdapterUsesPackedDocsumBlobs()
+{
+    Schema s;
+    s.addSummaryField(Schema::SummaryField("a", schema::DataType::INT32));
+    BuildContext bc(s);
+    bc._bld.startDocument("doc::0").startSummaryField("a").addInt(1000).endField();
+    bc.endDocument(0);
+    Document::UP packed = bc._bld.startDocument("doc::0").startSummaryField("a").addInt(2000).endField().endDocument();
+    FieldCacheRepo::UP cacheRepo = bc.createFieldCacheRepo(getResultConfig());
+    DocsumBlobStore blobs(1024);
+    DocumentStoreAdapter packer(bc._str, *bc._repo, getResultConfig(), "class1",
+                                cacheRepo->getFieldCache("class1"), getMarkupFields());
+    DocsumStoreValue value = packer.packDocsum(*packed, 0);
+    ASSERT_TRUE(value.pt() != NULL);
+    blobs.put(0, 1, packer.getSummaryClassId(), value.pt(), value.len());
+    EXPECT_EQUAL(1u, blobs.size());
+    EXPECT_LESS(value.len(), blobs.getMemoryUsed());
+
+    { // blob packed by the same setup is used instead of the stored document
+        DocumentStoreAdapter dsa(bc._str, *bc._repo, getResultConfig(), "class1",
+                                 cacheRepo->getFieldCache("class1"), getMarkupFields(), &blobs, 1);
+        EXPECT_EQUAL(2000u, getResult(dsa, 0)->GetEntry("a")->_intval);
+        dsa.prefetch({0});
+        EXPECT_EQUAL(2000u, getResult(dsa, 0)->GetEntry("a")->_intval);
+    }
+    { // blob packed by another setup is ignored
+        DocumentStoreAdapter dsa(bc._str, *bc._repo, getResultConfig(), "class1",
+                                 cacheRepo->getFieldCache("class1"), getMarkupFields(), &blobs, 2);
+        EXPECT_EQUAL(1000u, getResult(dsa, 0)->GetEntry("a")->_intval);
+    }
+    { // blob packed for another result class is ignored
+        std::vector<char> buf;
+        EXPECT_FALSE(blobs.get(0, 1, packer.getSummaryClassId() + 1, buf));
+        EXPECT_TRUE(blobs.get(0, 1, packer.getSummaryClassId(), buf));
+        EXPECT_EQUAL(value.len(), buf.size());
+    }
+    blobs.remove(0);
+    EXPECT_EQUAL(0u, blobs.size());
+    EXPECT_EQUAL(0u, blobs.getMemoryUsed());
+    { // memory budget is respected
+        DocsumBlobStore small(value.len());
+        small.put(0, 1, packer.getSummaryClassId(), value.pt(), value.len());
+        EXPECT_EQUAL(0u, small.size());
+        EXPECT_EQUAL(0u, small.getMemoryUsed());
+    }
+    blobs.put(0, 1, packer.getSummaryClassId(), value.pt(), value.len());
+    blobs.clear();
+    EXPECT_EQUAL(0u, blobs.size());
+    EXPECT_EQUAL(0u, blobs.getMemoryUsed());
+}
+
+
+void
+Test::requireThatSummaryManagerMaintainsDocsumBlobs()
+{
+    Schema s;
+    s.addSummaryField(Schema::SummaryField("a", schema::DataType::INT32));
+    BuildContext bc(s);
+    DirMaker dmk("blobsummary");
+    SummaryManager mgr(bc._summaryExecutor, LogDocumentStore::Config(), GrowStrategy(), "blobsummary",
+                       DocTypeName(getDocTypeName()), TuneFileSummary(), bc._fileHeaderContext,
+                       bc._noTlSyncer, search::IBucketizer::SP());
+    mgr.enableDocsumBlobs(0x10000);
+    const DocsumBlobStore & blobs = *mgr.getDocsumBlobStore();
+    ISummaryManager::ISummarySetup::SP setup =
+        mgr.createSummarySetup(*_summaryCfg, vespa::config::search::SummarymapConfig(),
+                               vespa::config::search::summary::JuniperrcConfig(), bc._repo,
+                               search::IAttributeManager::SP());
+    Document::UP doc = bc._bld.startDocument("doc::1").startSummaryField("a").addInt(1000).endField().endDocument();
+
+    mgr.putDocument(1, 1, *doc);
+    EXPECT_EQUAL(1u, blobs.size());
+    {
+        IDocsumStore::UP store = setup->createDocsumStore("class1");
+        DocumentStoreAdapter & dsa = dynamic_cast<DocumentStoreAdapter &>(*store);
+        EXPECT_EQUAL(1000u, getResult(dsa, 1)->GetEntry("a")->_intval);
+    }
+
+    // The packed docsum needs the complete document, so updates are put instead.
+    DocumentUpdate upd(*bc._repo, bc._bld.getDocumentType(), doc->getId());
+    vespalib::nbostream updatedDoc;
+    doc->serialize(updatedDoc);
+    EXPECT_FALSE(mgr.updateDocument(2, 1, upd, bc._repo, updatedDoc));
+    EXPECT_EQUAL(1u, blobs.size());
+
+    mgr.removeDocument(3, 1);
+    EXPECT_EQUAL(0u, blobs.size());
+    EXPECT_EQUAL(0u, blobs.getMemoryUsed());
+
+    mgr.putDocument(4, 1, *doc);
+    EXPECT_EQUAL(1u, blobs.size());
+    mgr.createSummarySetup(*_summaryCfg, vespa::config::search::SummarymapConfig(),
+                           vespa::config::search::summary::JuniperrcConfig(), bc._repo,
+                           search::IAttributeManager::SP());
+    EXPECT_EQUAL(0u, blobs.size());
+    EXPECT_EQUAL(0u, blobs.getMemoryUsed());
+}
+
+
 GlobalId gid1 = DocumentId("doc::1").getGlobalId(); // lid 1
 GlobalId gid2 = DocumentId("doc::2").getGlobalId(); // lid 2
 GlobalId gid3 = DocumentId("doc::3").getGlobalId(); // lid 3
@@ -669,6 +777,111 @@ Test::requireThatRewritersAreUsed()
     EXPECT_TRUE(assertSlime("{aa:20}", *rep, 0, false));
 }
 
+void
+Test::requireThatDocsumsCanBeProducedInParallel()
+{
+    Schema s;
+    s.addSummaryField(Schema::SummaryField("a", schema::DataType::INT32));
+
+    BuildContext bc(s);
+    DBContext dc(bc._repo, getDocTypeName());
+    const uint32_t numDocs = 20;
+    DocsumRequest req;
+    req.resultClassName = "class1";
+    for (uint32_t lid = 1; lid <= numDocs; ++lid) {
+        vespalib::string docId = vespalib::make_string("doc::%u", lid);
+        dc.put(*bc._bld.startDocument(docId).
+               startSummaryField("a").
+               addInt(lid * 10).
+               endField().
+               endDocument(),
+               lid);
+        req.hits.push_back(DocsumRequest::Hit(DocumentId(docId).getGlobalId()));
+    }
+    req.hits.push_back(DocsumRequest::Hit(gid9));
+
+    vespalib::SimpleThreadBundle threadBundle(3);
+    DocsumReply::UP rep = dc._ddb->getDocsums(req, threadBundle);
+    EXPECT_EQUAL(numDocs + 1, rep->docsums.size());
+    for (uint32_t i = 0; i < numDocs; ++i) {
+        EXPECT_EQUAL(i + 1, rep->docsums[i].docid);
+        EXPECT_TRUE(assertSlime(vespalib::make_string("{a:%u}", (i + 1) * 10), *rep, i, false));
+    }
+    EXPECT_EQUAL(search::endDocId, rep->docsums[numDocs].docid);
+    EXPECT_TRUE(rep->docsums[numDocs].data.get() == NULL);
+}
+
+void
+putSummaryDocs(BuildContext &bc, DBContext &dc, DocsumRequest &req, uint32_t numDocs)
+{
+    for (uint32_t lid = 1; lid <= numDocs; ++lid) {
+        vespalib::string docId = vespalib::make_string("doc::%u", lid);
+        dc.put(*bc._bld.startDocument(docId).
+               startSummaryField("a").
+               addInt(lid * 10).
+               endField().
+               endDocument(),
+               lid);
+        req.hits.push_back(DocsumRequest::Hit(DocumentId(docId).getGlobalId()));
+    }
+}
+
+void
+Test::requireThatParallelSlimeDocsumsMatchSingleThreaded()
+{
+    Schema s;
+    s.addSummaryField(Schema::SummaryField("a", schema::DataType::INT32));
+
+    BuildContext bc(s);
+    DBContext dc(bc._repo, getDocTypeName());
+    const uint32_t numDocs = 23;
+    DocsumRequest req(true);
+    req.resultClassName = "class1";
+    putSummaryDocs(bc, dc, req, numDocs);
+    req.hits.insert(req.hits.begin() + 10, DocsumRequest::Hit(gid9));
+
+    DocsumReply::UP single = dc._ddb->getDocsums(req);
+    ASSERT_TRUE(single->_root.get() != nullptr);
+    const vespalib::slime::Inspector & docsums = single->_root->get()["docsums"];
+    EXPECT_EQUAL(numDocs + 1, docsums.entries());
+    EXPECT_EQUAL(30, docsums[2]["docsum"]["a"].asLong());
+    EXPECT_FALSE(docsums[10]["docsum"]["a"].valid());
+    EXPECT_FALSE(single->_root->get()["errors"].valid());
+    for (size_t numThreads : {2, 3, 5}) {
+        TEST_STATE(vespalib::make_string("numThreads=%zu", numThreads).c_str());
+        vespalib::SimpleThreadBundle threadBundle(numThreads);
+        DocsumReply::UP parallel = dc._ddb->getDocsums(req, threadBundle);
+        ASSERT_TRUE(parallel->_root.get() != nullptr);
+        EXPECT_EQUAL(*single->_root, *parallel->_root);
+    }
+}
+
+void
+Test::requireThatParallelSlimeSummariesTimeout()
+{
+    Schema s;
+    s.addSummaryField(Schema::SummaryField("a", schema::DataType::INT32));
+
+    BuildContext bc(s);
+    DBContext dc(bc._repo, getDocTypeName());
+    const uint32_t numDocs = 20;
+    DocsumRequest req(true);
+    req.setTimeout(0);
+    EXPECT_TRUE(req.expired());
+    req.resultClassName = "class1";
+    putSummaryDocs(bc, dc, req, numDocs);
+
+    vespalib::SimpleThreadBundle threadBundle(3);
+    DocsumReply::UP rep = dc._ddb->getDocsums(req, threadBundle);
+    ASSERT_TRUE(rep->_root.get() != nullptr);
+    const vespalib::slime::Inspector & root = rep->_root->get();
+    EXPECT_EQUAL(0u, root["docsums"].entries());
+    EXPECT_EQUAL(1u, root["errors"].entries());
+    EXPECT_EQUAL("timeout", root["errors"][0]["type"].asString().make_string());
+    EXPECT_TRUE(vespalib::Regexp("^Timed out 20 summaries with -[0-9]+us left.$").
+                match(root["errors"][0]["message"].asString().make_stringref()));
+}
+
 void
 Test::requireThatSummariesTimeout()
 {
@@ -1313,6 +1526,11 @@ Test::Main()
     TEST_DO(requireThatRawFieldsWorks());
     TEST_DO(requireThatFieldCacheRepoCanReturnDefaultFieldCache());
     TEST_DO(requireThatSummariesTimeout());
+    TEST_DO(requireThatDocsumsCanBeProducedInParallel());
+    TEST_DO(requireThatParallelSlimeDocsumsMatchSingleThreaded());
+    TEST_DO(requireThatParallelSlimeSummariesTimeout());
+    TEST_DO(requireThatAdapterUsesPackedDocsumBlobs());
+    TEST_DO(requireThatSummaryManagerMaintainsDocsumBlobs());
 
     TEST_DONE();
 }
@@ -7,6 +7,7 @@
 #include <vespa/searchcore/proton/bucketdb/bucketdbhandler.h>
 #include <vespa/searchcore/proton/test/bucketfactory.h>
 #include <vespa/searchcore/proton/common/feedtoken.h>
+#include <vespa/searchcore/proton/feedoperation/createbucketoperation.h>
 #include <vespa/searchcore/proton/feedoperation/moveoperation.h>
 #include <vespa/searchcore/proton/feedoperation/pruneremoveddocumentsoperation.h>
 #include <vespa/searchcore/proton/feedoperation/putoperation.h>
@@ -21,11 +22,14 @@
 #include <vespa/searchcore/proton/server/i_feed_handler_owner.h>
 #include <vespa/searchcore/proton/server/ireplayconfig.h>
 #include <vespa/searchcore/proton/test/dummy_feed_view.h>
+#include <vespa/searchcore/proton/test/threading_service_observer.h>
 #include <vespa/searchlib/common/idestructorcallback.h>
+#include <vespa/searchlib/common/isequencedtaskexecutor.h>
 #include <vespa/searchlib/index/docbuilder.h>
 #include <vespa/searchlib/index/dummyfileheadercontext.h>
 #include <vespa/searchlib/transactionlog/translogclient.h>
 #include <vespa/searchlib/transactionlog/translogserver.h>
+#include <vespa/vespalib/test/insertion_operators.h>
 #include <vespa/vespalib/testkit/testapp.h>
 #include <vespa/vespalib/util/closuretask.h>
 #include <vespa/vespalib/util/lambdatask.h>
@@ -181,6 +185,7 @@ struct MyFeedView : public test::DummyFeedView {
     SerialNum put_serial;
     int heartbeat_count;
     int remove_count;
+    SerialNum remove_serial;
     int move_count;
     int prune_removed_count;
     int update_count;
@@ -228,9 +233,10 @@ struct MyFeedView : public test::DummyFeedView {
         ++update_count;
         update_serial = op.getSerialNum();
     }
-    void handleRemove(FeedToken token, const RemoveOperation &) override {
+    void handleRemove(FeedToken token, const RemoveOperation &op) override {
         (void) token;
         ++remove_count;
+        remove_serial = op.getSerialNum();
     }
     void handleMove(const MoveOperation &, IDestructorCallback::SP) override { ++move_count; }
     void heartBeat(SerialNum) override { ++heartbeat_count; }
@@ -256,6 +262,7 @@ MyFeedView::MyFeedView(const std::shared_ptr<const DocumentTypeRepo> &dtr, const
       put_serial(0),
       heartbeat_count(0),
       remove_count(0),
+      remove_serial(0),
       move_count(0),
       prune_removed_count(0),
       update_count(0),
@@ -431,6 +438,7 @@ struct FeedHandlerFixture
     TransLogServer               tls;
     vespalib::string             tlsSpec;
     ExecutorThreadingService     writeService;
+    test::ThreadingServiceObserver writeServiceObserver;
     SchemaContext                schema;
     MyOwner                      owner;
     MyResourceWriteFilter        writeFilter;
@@ -441,11 +449,12 @@ struct FeedHandlerFixture
     BucketDBOwner                _bucketDB;
     bucketdb::BucketDBHandler    _bucketDBHandler;
     FeedHandler                  handler;
-    FeedHandlerFixture()
+    FeedHandlerFixture(uint32_t feedPrepareThreads = 0)
         : _fileHeaderContext(),
           tls("mytls", 9016, "mytlsdir", _fileHeaderContext, 0x10000),
           tlsSpec("tcp/localhost:9016"),
-          writeService(),
+          writeService(1, 128 * 1024, 1000, feedPrepareThreads),
+          writeServiceObserver(writeService),
           schema(),
           owner(),
           _state(),
@@ -453,7 +462,7 @@ struct FeedHandlerFixture
           feedView(schema.getRepo(), schema.getDocType()),
           _bucketDB(),
           _bucketDBHandler(_bucketDB),
-          handler(writeService, tlsSpec, schema.getDocType(), _state, owner,
+          handler(writeServiceObserver, tlsSpec, schema.getDocType(), _state, owner,
                   writeFilter, replayConfig, tls, &tls_writer)
     {
         _state.enterLoadState();
@@ -773,6 +782,51 @@ TEST_F("require that put with different document type repo is ok", FeedHandlerFi
     EXPECT_EQUAL(1, f.tls_writer.store_count);
 }
 
+uint32_t
+getPrepareExecutorId(const DocumentId &docId, uint32_t numExecutors)
+{
+    return GlobalId::hash()(docId.getGlobalId()) % numExecutors;
+}
+
+TEST_F("require that operations pass through feed prepare threads", FeedHandlerFixture(2))
+{
+    f.handler.changeToNormalFeedState();
+    TwoFieldsSchemaContext schema;
+    DocumentContext put_context("id:test:searchdocument::foo", *schema.builder);
+    UpdateContext update_context("id:test:searchdocument::foo", *f.schema.builder);
+    DocumentContext remove_context("id:test:searchdocument::bar", *f.schema.builder);
+    f.handler.handleOperation(FeedToken(), std::make_unique<PutOperation>(put_context.bucketId, Timestamp(10),
+                                                                          put_context.doc));
+    f.handler.handleOperation(FeedToken(), std::make_unique<UpdateOperation>(update_context.bucketId, Timestamp(11),
+                                                                             update_context.update));
+    f.handler.handleOperation(FeedToken(), std::make_unique<RemoveOperation>(remove_context.bucketId, Timestamp(12),
+                                                                             remove_context.doc->getId()));
+    const search::SequencedTaskExecutorObserver &prepare = f.writeServiceObserver.feedPrepareObserver();
+    EXPECT_EQUAL(0u, prepare.getSyncCnt());
+    // Operations without a global id wait for the feed prepare threads to drain.
+    f.handler.handleOperation(FeedToken(), std::make_unique<CreateBucketOperation>(put_context.bucketId));
+    EXPECT_EQUAL(1u, prepare.getSyncCnt());
+    f.writeService.sync();
+
+    // Each document operation is prepared by the executor selected by its global id.
+    uint32_t numExecutors = prepare.getNumExecutors();
+    EXPECT_EQUAL(2u, numExecutors);
+    std::vector<uint32_t> expHistory({getPrepareExecutorId(put_context.doc->getId(), numExecutors),
+                                      getPrepareExecutorId(update_context.update->getId(), numExecutors),
+                                      getPrepareExecutorId(remove_context.doc->getId(), numExecutors)});
+    EXPECT_EQUAL(expHistory, prepare.getExecuteHistory());
+
+    // Operations for the same document reach the master thread in feed order.
+    EXPECT_EQUAL(1, f.feedView.put_count);
+    EXPECT_EQUAL(1, f.feedView.update_count);
+    EXPECT_EQUAL(1, f.feedView.remove_count);
+    EXPECT_LESS(f.feedView.put_serial, f.feedView.update_serial);
+    // The bucket operation is handled after everything that was prepared before it.
+    EXPECT_LESS(f.feedView.update_serial, f.handler.getSerialNum());
+    EXPECT_LESS(f.feedView.remove_serial, f.handler.getSerialNum());
+    EXPECT_EQUAL(4, f.tls_writer.store_count);
+}
+
 }  // namespace
 
 TEST_MAIN()
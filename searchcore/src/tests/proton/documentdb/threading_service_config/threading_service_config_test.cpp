@@ -60,6 +60,18 @@ TEST_F("require that semiunbound task limit is scaled based on indexing threads"
     EXPECT_EQUAL(12500u, f.make(24).semiUnboundTaskLimit());
 }
 
+TEST_F("require that feed prepare threads are disabled by default", Fixture)
+{
+    EXPECT_EQUAL(0u, f.make(24).feedPrepareThreads());
+}
+
+TEST("require that feed prepare threads are taken from config")
+{
+    ProtonConfigBuilder builder;
+    builder.feeding.preparethreads = 4;
+    EXPECT_EQUAL(4u, ThreadingServiceConfig::make(builder, HwInfo::Cpu(24)).feedPrepareThreads());
+}
+
 TEST_MAIN()
 {
     TEST_RUN_ALL();
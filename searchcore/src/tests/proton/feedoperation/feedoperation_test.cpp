@@ -79,6 +79,11 @@ uint32_t getDocSize(const Document &doc)
     return docSize;
 }
 
+vespalib::string asString(const vespalib::nbostream &os)
+{
+    return vespalib::string(os.peek(), os.size());
+}
+
 uint32_t getDocIdSize(const DocumentId &doc_id)
 {
     return doc_id.toString().size() + 1;
@@ -319,6 +324,32 @@ TEST_F("require that we can serialize and deserialize put operations", Fixture)
     }
 }
 
+TEST_F("require that put operations keep the serialized document", Fixture)
+{
+    vespalib::nbostream stream;
+    BucketId bucket(toBucket(docId.getGlobalId()));
+    auto doc(f.makeDoc());
+    vespalib::nbostream expDoc;
+    doc->serialize(expDoc);
+    {
+        PutOperation op(bucket, Timestamp(10), doc);
+        EXPECT_FALSE(op.getSerializedDocument());
+        op.serialize(stream);
+        ASSERT_TRUE(op.getSerializedDocument());
+        EXPECT_EQUAL(asString(expDoc), asString(*op.getSerializedDocument()));
+    }
+    {
+        PutOperation op;
+        op.deserialize(stream, *f._repo);
+        ASSERT_TRUE(op.getSerializedDocument());
+        EXPECT_EQUAL(asString(expDoc), asString(*op.getSerializedDocument()));
+        op.deserializeDocument(*f._repo);
+        EXPECT_EQUAL(*doc, *op.getDocument());
+        ASSERT_TRUE(op.getSerializedDocument());
+        EXPECT_EQUAL(asString(expDoc), asString(*op.getSerializedDocument()));
+    }
+}
+
 TEST_F("require that we can serialize and deserialize move operations", Fixture)
 {
     vespalib::nbostream stream;
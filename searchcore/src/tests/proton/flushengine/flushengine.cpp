@@ -402,6 +402,23 @@ class NoFlushStrategy : public SimpleStrategy
     }
 };
 
+class PassCountingStrategy : public NoFlushStrategy
+{
+public:
+    mutable vespalib::CountDownLatch _passes;
+
+    PassCountingStrategy(uint32_t passes)
+        : _passes(passes)
+    {
+    }
+
+    virtual FlushContext::List getFlushTargets(const FlushContext::List &,
+                                               const flushengine::TlsStatsMap &) const override {
+        _passes.countDown();
+        return FlushContext::List();
+    }
+};
+
 // --------------------------------------------------------------------------------
 //
 // Tests.
@@ -437,10 +454,11 @@ struct Fixture
     SimpleStrategy::SP strategy;
     FlushEngine engine;
 
-    Fixture(uint32_t numThreads, uint32_t idleIntervalMS, SimpleStrategy::SP strategy_)
+    Fixture(uint32_t numThreads, uint32_t idleIntervalMS, SimpleStrategy::SP strategy_,
+            uint32_t checkpointIntervalMS = 0)
         : tlsStatsFactory(std::make_shared<SimpleTlsStatsFactory>()),
           strategy(strategy_),
-          engine(tlsStatsFactory, strategy, numThreads, idleIntervalMS)
+          engine(tlsStatsFactory, strategy, numThreads, idleIntervalMS, checkpointIntervalMS)
     {
     }
 
@@ -762,6 +780,37 @@ TEST_F("require that oldest serial is updated when finishing priority flush stra
     EXPECT_EQUAL(20u, handler->_oldestSerial);
 }
 
+TEST_F("require that checkpoint flushes all targets", Fixture(2, IINTERVAL, std::make_shared<NoFlushStrategy>()))
+{
+    auto target1 = std::make_shared<SimpleTarget>("target1", 10);
+    auto target2 = std::make_shared<SimpleTarget>("target2", 15);
+    auto handler = std::make_shared<SimpleHandler>(Targets({ target1, target2 }), "handler", 20);
+    f.engine.putFlushHandler(DocTypeName("handler"), handler);
+    f.engine.checkpoint();
+    EXPECT_TRUE(target1->_taskDone.await(SHORT_TIMEOUT));
+    EXPECT_TRUE(target2->_taskDone.await(SHORT_TIMEOUT));
+    EXPECT_EQUAL(20u, handler->_oldestSerial);
+}
+
+TEST_F("require that checkpoint is done periodically when enabled", Fixture(2, IINTERVAL, std::make_shared<NoFlushStrategy>(), 100))
+{
+    auto target1 = std::make_shared<SimpleTarget>("target1", 10);
+    auto target2 = std::make_shared<SimpleTarget>("target2", 15);
+    auto handler = f.addSimpleHandler({ target1, target2 });
+    EXPECT_TRUE(target1->_taskDone.await(LONG_TIMEOUT));
+    EXPECT_TRUE(target2->_taskDone.await(LONG_TIMEOUT));
+    TEST_DO(f.assertOldestSerial(*handler, 20));
+}
+
+TEST_F("require that checkpoint is disabled by default", Fixture(1, 1, std::make_shared<PassCountingStrategy>(10)))
+{
+    auto target1 = std::make_shared<SimpleTarget>("target1", 10);
+    auto handler = f.addSimpleHandler({ target1 });
+    EXPECT_TRUE(static_cast<PassCountingStrategy &>(*f.strategy)._passes.await(LONG_TIMEOUT));
+    EXPECT_FALSE(target1->_initDone.await(SHORT_TIMEOUT));
+    EXPECT_EQUAL(0u, handler->_oldestSerial);
+}
+
 
 TEST_MAIN()
 {
@@ -1,9 +1,12 @@
 // Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include <vespa/searchcore/proton/matching/fakesearchcontext.h>
+#include <vespa/searchcorespi/index/querysamplerecorder.h>
 #include <vespa/searchcorespi/index/warmupindexcollection.h>
+#include <vespa/searchlib/query/tree/simplequery.h>
 #include <vespa/vespalib/testkit/testapp.h>
 #include <vespa/vespalib/util/threadstackexecutor.h>
+#include <vespa/vespalib/util/stringfmt.h>
 
 #include <vespa/log/log.h>
 LOG_SETUP("indexcollection_test");
@@ -14,6 +17,31 @@ using search::FixedSourceSelector;
 using namespace proton;
 using namespace searchcorespi;
 using searchcorespi::index::WarmupConfig;
+using searchcorespi::index::QuerySampleRecorder;
+using searchcorespi::index::WarmupQuerySample;
+using search::queryeval::FieldSpec;
+using search::queryeval::FieldSpecList;
+using search::query::Node;
+using search::query::SimpleStringTerm;
+using search::query::Weight;
+
+namespace {
+
+class CountingIndexSearchable : public FakeIndexSearchable {
+public:
+    std::atomic<uint32_t> _createBlueprintCount;
+    CountingIndexSearchable() : FakeIndexSearchable(), _createBlueprintCount(0) {}
+    Blueprint::UP
+    createBlueprint(const IRequestContext & requestContext,
+                    const FieldSpec &field,
+                    const Node &term) override
+    {
+        ++_createBlueprintCount;
+        return FakeIndexSearchable::createBlueprint(requestContext, field, term);
+    }
+};
+
+}
 
 namespace {
 
@@ -30,6 +58,12 @@ class Test : public vespalib::TestApp,
     void requireThatSearchablesCanBeAppended(IndexCollection::UP fsc);
     void requireThatSearchablesCanBeReplaced(IndexCollection::UP fsc);
     void requireThatReplaceAndRenumberUpdatesCollectionAfterFusion();
+    void requireThatQuerySampleIsBounded();
+    void requireThatQuerySampleFollowsRecentTerms();
+    void requireThatQuerySampleOnlyRecordsEveryIntervalTerm();
+    void requireThatQuerySampleIsRecordedFromQueryPath();
+    void requireThatQuerySampleIsReplayedOnWarmup();
+    void requireThatQuerySampleIsNotReplayedAfterWarmupEnds();
     IndexCollection::UP createWarmup(const IndexCollection::SP & prev, const IndexCollection::SP & next);
     virtual void warmupDone(ISearchableIndexCollection::SP current) override {
         (void) current;
@@ -63,6 +97,12 @@ Test::Main()
     TEST_DO(requireThatSearchablesCanBeAppended(IndexCollection::UP(new IndexCollection(_selector))));
     TEST_DO(requireThatSearchablesCanBeReplaced(IndexCollection::UP(new IndexCollection(_selector))));
     TEST_DO(requireThatReplaceAndRenumberUpdatesCollectionAfterFusion());
+    TEST_DO(requireThatQuerySampleIsBounded());
+    TEST_DO(requireThatQuerySampleFollowsRecentTerms());
+    TEST_DO(requireThatQuerySampleOnlyRecordsEveryIntervalTerm());
+    TEST_DO(requireThatQuerySampleIsRecordedFromQueryPath());
+    TEST_DO(requireThatQuerySampleIsReplayedOnWarmup());
+    TEST_DO(requireThatQuerySampleIsNotReplayedAfterWarmupEnds());
     {
         IndexCollection::SP prev(new IndexCollection(_selector));
         IndexCollection::SP next(new IndexCollection(_selector));
@@ -123,6 +163,113 @@ void Test::requireThatReplaceAndRenumberUpdatesCollectionAfterFusion() {
     EXPECT_EQUAL(_source2.get(), &new_fsc->getSearchable(1));
 }
 
+void Test::requireThatQuerySampleIsBounded() {
+    WarmupQuerySample sample(3);
+    FieldSpecList fields;
+    fields.add(FieldSpec("f1", 1, 0));
+    for (uint32_t i = 0; i < 10; ++i) {
+        SimpleStringTerm term(vespalib::make_string("term%u", i), "f1", 0, Weight(100));
+        sample.record(fields, term);
+    }
+    EXPECT_EQUAL(3u, sample.size());
+    uint32_t visited = 0;
+    sample.forEach([&visited](const FieldSpecList &sampleFields, const Node &term) {
+        EXPECT_EQUAL(1u, sampleFields.size());
+        EXPECT_EQUAL("f1", sampleFields[0].getName());
+        EXPECT_TRUE(dynamic_cast<const SimpleStringTerm *>(&term) != nullptr);
+        ++visited;
+    });
+    EXPECT_EQUAL(3u, visited);
+}
+
+void Test::requireThatQuerySampleFollowsRecentTerms() {
+    WarmupQuerySample sample(3);
+    FieldSpecList fields;
+    fields.add(FieldSpec("f1", 1, 0));
+    for (uint32_t i = 0; i < 3; ++i) {
+        sample.record(fields, SimpleStringTerm(vespalib::make_string("old%u", i), "f1", 0, Weight(100)));
+    }
+    for (uint32_t i = 0; i < 100; ++i) {
+        sample.record(fields, SimpleStringTerm(vespalib::make_string("new%u", i), "f1", 0, Weight(100)));
+    }
+    EXPECT_EQUAL(3u, sample.size());
+    sample.forEach([](const FieldSpecList &, const Node &term) {
+        const auto &stringTerm = dynamic_cast<const SimpleStringTerm &>(term);
+        EXPECT_EQUAL("new", stringTerm.getTerm().substr(0, 3));
+    });
+}
+
+void Test::requireThatQuerySampleOnlyRecordsEveryIntervalTerm() {
+    WarmupQuerySample sample(10, 4);
+    FieldSpecList fields;
+    fields.add(FieldSpec("f1", 1, 0));
+    for (uint32_t i = 0; i < 8; ++i) {
+        sample.record(fields, SimpleStringTerm(vespalib::make_string("term%u", i), "f1", 0, Weight(100)));
+    }
+    EXPECT_EQUAL(2u, sample.size());
+}
+
+void Test::requireThatQuerySampleIsRecordedFromQueryPath() {
+    auto sample = std::make_shared<WarmupQuerySample>(10);
+    IndexCollection::SP indexes(new IndexCollection(_selector));
+    indexes->append(0, _source1);
+    indexes->setCurrentIndex(0);
+    QuerySampleRecorder recorder(indexes, sample);
+    FieldSpecList fields;
+    fields.add(FieldSpec("f1", 1, 0));
+    search::queryeval::FakeRequestContext requestContext;
+    EXPECT_TRUE(recorder.createBlueprint(requestContext, fields, SimpleStringTerm("foo", "f1", 0, Weight(100))));
+    EXPECT_EQUAL(1u, sample->size());
+    EXPECT_EQUAL(indexes.get(), recorder.getSearchable().get());
+}
+
+void Test::requireThatQuerySampleIsReplayedOnWarmup() {
+    auto sample = std::make_shared<WarmupQuerySample>(10);
+    FieldSpecList fields;
+    fields.add(FieldSpec("f1", 1, 0));
+    sample->record(fields, SimpleStringTerm("foo", "f1", 0, Weight(100)));
+    sample->record(fields, SimpleStringTerm("bar", "f1", 0, Weight(100)));
+    sample->record(fields, SimpleStringTerm("foo", "f1", 0, Weight(100)));
+    CountingIndexSearchable warmup;
+    IndexCollection::SP prev(new IndexCollection(_selector));
+    IndexCollection::SP next(new IndexCollection(_selector));
+    next->append(0, _source1);
+    next->setCurrentIndex(0);
+    {
+        WarmupIndexCollection wic(WarmupConfig(1.0, false, 10), prev, next, warmup, _executor, *this, sample);
+        _executor.sync();
+        EXPECT_EQUAL(0u, warmup._createBlueprintCount.load());
+        wic.start();
+        _executor.sync();
+        // Duplicate terms are only warmed up once
+        EXPECT_EQUAL(2u, warmup._createBlueprintCount.load());
+        // Terms are recorded from the query path, not by the warmup itself
+        search::queryeval::FakeRequestContext requestContext;
+        wic.createBlueprint(requestContext, fields, SimpleStringTerm("baz", "f1", 0, Weight(100)));
+        _executor.sync();
+    }
+    EXPECT_EQUAL(3u, sample->size());
+}
+
+void Test::requireThatQuerySampleIsNotReplayedAfterWarmupEnds() {
+    auto sample = std::make_shared<WarmupQuerySample>(10);
+    FieldSpecList fields;
+    fields.add(FieldSpec("f1", 1, 0));
+    sample->record(fields, SimpleStringTerm("foo", "f1", 0, Weight(100)));
+    sample->record(fields, SimpleStringTerm("bar", "f1", 0, Weight(100)));
+    CountingIndexSearchable warmup;
+    IndexCollection::SP prev(new IndexCollection(_selector));
+    IndexCollection::SP next(new IndexCollection(_selector));
+    next->append(0, _source1);
+    next->setCurrentIndex(0);
+    {
+        WarmupIndexCollection wic(WarmupConfig(0.0, false, 10), prev, next, warmup, _executor, *this, sample);
+        wic.start();
+        _executor.sync();
+        EXPECT_EQUAL(0u, warmup._createBlueprintCount.load());
+    }
+}
+
 }  // namespace
 
 TEST_APPHOOK(Test);
@@ -19,7 +19,7 @@ class MySearchHandler : public ISearchHandler {
 public:
     MySearchHandler(size_t numHits = 0) :
         _numHits(numHits), _name("my"), _reply("myreply") {}
-    virtual DocsumReply::UP getDocsums(const DocsumRequest &) override {
+    virtual DocsumReply::UP getDocsums(const DocsumRequest &, vespalib::ThreadBundle &) override {
         return DocsumReply::UP(new DocsumReply);
     }
 
@@ -321,7 +321,7 @@ struct MyWorld {
 
         MySearchHandler(Matcher::SP matcher) : _matcher(matcher) {}
 
-        virtual DocsumReply::UP getDocsums(const DocsumRequest &) override
+        virtual DocsumReply::UP getDocsums(const DocsumRequest &, vespalib::ThreadBundle &) override
         { return DocsumReply::UP(); }
         virtual SearchReply::UP match(const ISearchHandler::SP &,
                                       const SearchRequest &,
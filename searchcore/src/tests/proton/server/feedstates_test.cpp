@@ -15,8 +15,11 @@
 #include <vespa/vespalib/objects/nbostream.h>
 #include <vespa/vespalib/testkit/testapp.h>
 #include <vespa/vespalib/util/buffer.h>
+#include <vespa/vespalib/util/simple_thread_bundle.h>
 #include <vespa/searchcore/proton/bucketdb/bucketdbhandler.h>
 
+#include <thread>
+
 #include <vespa/log/log.h>
 LOG_SETUP("feedstates_test");
 
@@ -59,6 +62,36 @@ struct InstantExecutor : vespalib::Executor {
     }
 };
 
+struct QueuedExecutor : vespalib::Executor {
+    std::vector<Task::UP> tasks;
+    virtual Task::UP execute(Task::UP task) override {
+        tasks.push_back(std::move(task));
+        return Task::UP();
+    }
+    void runAll() {
+        for (size_t i = 0; i < tasks.size(); ++i) {
+            tasks[i]->run();
+        }
+        tasks.clear();
+    }
+};
+
+/**
+ * Runs the repo lookup of the replay state right away, and queues the dispatch
+ * of decoded operations like a busy master thread would.
+ */
+struct DecodeExecutor : QueuedExecutor {
+    bool queue = false;
+    virtual Task::UP execute(Task::UP task) override {
+        if (queue) {
+            return QueuedExecutor::execute(std::move(task));
+        }
+        task->run();
+        queue = true;
+        return Task::UP();
+    }
+};
+
 struct Fixture
 {
     MyFeedView feed_view1;
@@ -97,6 +130,9 @@ struct RemoveOperationContext
 
     RemoveOperationContext(search::SerialNum serial);
     ~RemoveOperationContext();
+    void add(search::SerialNum serial) {
+        packet->add(Packet::Entry(serial, FeedOperation::REMOVE, ConstBufferRef(str.c_str(), str.wp())));
+    }
 };
 
 RemoveOperationContext::RemoveOperationContext(search::SerialNum serial)
@@ -139,6 +175,73 @@ TEST_F("require that replay progress is tracked", Fixture)
     EXPECT_EQUAL(0.5, progress.getProgress());
 }
 
+TEST_F("require that operations decoded by a thread bundle are replayed in order", Fixture)
+{
+    vespalib::SimpleThreadBundle bundle(3);
+    ReplayTransactionLogState state("doctypename", f.feed_view_ptr, f._bucketDBHandler,
+                                    f.replay_config, f.config_store, &bundle);
+    RemoveOperationContext opCtx(10);
+    for (SerialNum serial = 11; serial < 15; ++serial) {
+        opCtx.add(serial);
+    }
+    TlsReplayProgress progress("test", 5, 15);
+    PacketWrapper::SP wrap(new PacketWrapper(*opCtx.packet, &progress));
+    InstantExecutor executor;
+
+    state.receive(wrap, executor);
+    EXPECT_EQUAL(0u, wrap->gate.getCount());
+    EXPECT_EQUAL(5, f.feed_view1.remove_handled);
+    EXPECT_EQUAL(14u, progress.getCurrent());
+}
+
+TEST_F("require that failure to decode a packet is reported to the transaction log visitor", Fixture)
+{
+    vespalib::SimpleThreadBundle bundle(2);
+    ReplayTransactionLogState state("doctypename", f.feed_view_ptr, f._bucketDBHandler,
+                                    f.replay_config, f.config_store, &bundle);
+    Packet packet;
+    vespalib::string garbage("not a remove operation");
+    packet.add(Packet::Entry(10, FeedOperation::REMOVE, ConstBufferRef(garbage.c_str(), garbage.size())));
+    PacketWrapper::SP wrap(new PacketWrapper(packet, NULL));
+    InstantExecutor executor;
+
+    state.receive(wrap, executor);
+    EXPECT_EQUAL(0u, wrap->gate.getCount());
+    EXPECT_TRUE(search::transactionlog::RPC::ERROR == wrap->result);
+    EXPECT_EQUAL(0, f.feed_view1.remove_handled);
+}
+
+TEST_F("require that decoded operations are dispatched after the replay state is gone", Fixture)
+{
+    vespalib::SimpleThreadBundle bundle(2);
+    auto state = std::make_unique<ReplayTransactionLogState>("doctypename", f.feed_view_ptr, f._bucketDBHandler,
+                                                             f.replay_config, f.config_store, &bundle);
+    RemoveOperationContext opCtx(10);
+    opCtx.add(11);
+    PacketWrapper::SP wrap(new PacketWrapper(*opCtx.packet, NULL));
+    DecodeExecutor executor;
+
+    state->receive(wrap, executor);
+    EXPECT_EQUAL(0u, wrap->gate.getCount());
+    EXPECT_TRUE(search::transactionlog::RPC::OK == wrap->result);
+    EXPECT_EQUAL(1u, executor.tasks.size());
+    state.reset();
+    EXPECT_EQUAL(0, f.feed_view1.remove_handled);
+    executor.runAll();
+    EXPECT_EQUAL(2, f.feed_view1.remove_handled);
+}
+
+TEST("require that replay throughput and time left are estimated")
+{
+    TlsReplayProgress progress("test", 5, 15);
+    EXPECT_EQUAL(-1.0, progress.getEstimatedSecondsLeft());
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    progress.updateCurrent(10);
+    EXPECT_GREATER(progress.getOperationsPerSecond(), 0.0);
+    EXPECT_GREATER(progress.getEstimatedSecondsLeft(), 0.0);
+    EXPECT_LESS(progress.getEstimatedSecondsLeft(), progress.getElapsedSeconds() * 1.5);
+}
+
 }  // namespace
 
 TEST_MAIN() { TEST_RUN_ALL(); }
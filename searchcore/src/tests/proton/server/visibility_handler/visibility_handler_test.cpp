@@ -3,6 +3,7 @@
 LOG_SETUP("visibility_handler_test");
 #include <vespa/vespalib/testkit/testapp.h>
 #include <vespa/searchcore/proton/server/visibilityhandler.h>
+#include <vespa/searchcore/proton/common/commit_scheduler.h>
 #include <vespa/searchcore/proton/test/dummy_feed_view.h>
 #include <vespa/searchcore/proton/test/threading_service_observer.h>
 #include <vespa/searchcore/proton/server/executorthreadingservice.h>
@@ -15,6 +16,7 @@ using proton::ExecutorThreadingService;
 using proton::test::ThreadingServiceObserver;
 using proton::IFeedView;
 using proton::VisibilityHandler;
+using proton::CommitScheduler;
 using vespalib::makeLambdaTask;
 using fastos::TimeStamp;
 
@@ -142,8 +144,22 @@ public:
                                  expMasterExecuteCnt,
                                  expAttributeFieldWriterSyncCnt);
     }
+
+    void
+    commitIfDue()
+    {
+        VisibilityHandler *visibilityHandler = &_visibilityHandler;
+        _writeService.master().execute(makeLambdaTask([=]() { visibilityHandler->commitIfDue(); }));
+        _writeService.master().sync();
+    }
 };
 
+TimeStamp
+ms(int64_t v)
+{
+    return TimeStamp(v * TimeStamp::MS);
+}
+
 }
 
 TEST_F("Check external commit with zero visibility delay", Fixture)
@@ -206,4 +222,65 @@ TEST_F("Check internal commitAndWait with nonzero visibility delay and no new fe
     f.testCommitAndWait(1.0, true, 0u, 0u, 1u, 1u, 0u);
 }
 
+TEST("require that commit scheduler does not commit when nothing is fed")
+{
+    CommitScheduler scheduler(ms(1000));
+    EXPECT_FALSE(scheduler.tick(0, ms(100)));
+    EXPECT_FALSE(scheduler.tick(0, ms(200)));
+    EXPECT_FALSE(scheduler.tick(0, ms(5000)));
+}
+
+TEST("require that commit scheduler batches up to the visibility delay while feed keeps coming")
+{
+    CommitScheduler scheduler(ms(1000));
+    EXPECT_EQUAL(ms(100), CommitScheduler::getTickInterval(ms(1000)));
+    EXPECT_FALSE(scheduler.tick(0, ms(100)));
+    SerialNum serialNum = 0;
+    for (int64_t t = 200; t < 1000; t += 100) {
+        EXPECT_FALSE(scheduler.tick(++serialNum, ms(t)));
+    }
+    EXPECT_TRUE(scheduler.tick(++serialNum, ms(1000)));
+    scheduler.committed(serialNum, ms(1000));
+    EXPECT_FALSE(scheduler.tick(serialNum, ms(1100)));
+    auto stats = scheduler.takeStats();
+    EXPECT_EQUAL(1u, stats.commits());
+    EXPECT_EQUAL(1u, stats.visibilityDelay().count());
+    EXPECT_APPROX(0.9, stats.visibilityDelay().max(), 0.000001);
+    EXPECT_EQUAL(0u, scheduler.takeStats().commits());
+}
+
+TEST("require that commit scheduler commits when feed goes idle")
+{
+    CommitScheduler scheduler(ms(1000));
+    EXPECT_FALSE(scheduler.tick(0, ms(100)));
+    EXPECT_FALSE(scheduler.tick(5, ms(200)));
+    EXPECT_TRUE(scheduler.tick(5, ms(300)));
+    scheduler.committed(5, ms(300));
+    auto stats = scheduler.takeStats();
+    EXPECT_EQUAL(1u, stats.commits());
+    EXPECT_APPROX(0.2, stats.visibilityDelay().max(), 0.000001);
+}
+
+TEST_F("require that commitIfDue commits when feed goes idle", Fixture)
+{
+    f._getSerialNum.setSerialNum(10u);
+    f._visibilityHandler.setVisibilityDelay(TimeStamp::Seconds(1000.0));
+    f.commitIfDue();
+    EXPECT_EQUAL(0u, f._feedViewReal->getForceCommitCount());
+    f.commitIfDue();
+    EXPECT_EQUAL(1u, f._feedViewReal->getForceCommitCount());
+    EXPECT_EQUAL(10u, f._feedViewReal->getCommittedSerialNum());
+    f.commitIfDue();
+    EXPECT_EQUAL(1u, f._feedViewReal->getForceCommitCount());
+    EXPECT_EQUAL(1u, f._visibilityHandler.takeCommitStats().commits());
+}
+
+TEST_F("require that commitIfDue does nothing with zero visibility delay", Fixture)
+{
+    f._getSerialNum.setSerialNum(10u);
+    f.commitIfDue();
+    f.commitIfDue();
+    EXPECT_EQUAL(0u, f._feedViewReal->getForceCommitCount());
+}
+
 TEST_MAIN() { TEST_RUN_ALL(); }
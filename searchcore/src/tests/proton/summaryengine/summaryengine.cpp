@@ -42,7 +42,7 @@ public:
         : _name(name), _reply(reply)
     {}
 
-    virtual DocsumReply::UP getDocsums(const DocsumRequest &request) override {
+    virtual DocsumReply::UP getDocsums(const DocsumRequest &request, vespalib::ThreadBundle &) override {
         return (request.useRootSlime())
                ? std::make_unique<DocsumReply>(createSlimeReply(request.hits.size()))
                : createOldDocSum(request);
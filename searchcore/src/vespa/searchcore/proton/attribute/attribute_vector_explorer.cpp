@@ -73,12 +73,20 @@ convertMemoryUsageToSlime(const MemoryUsage &usage, Cursor &object)
     object.setLong("onHold", usage.allocatedBytesOnHold());
 }
 
+double
+deadBytesRatio(const MemoryUsage &usage)
+{
+    return (usage.usedBytes() != 0) ? (static_cast<double>(usage.deadBytes()) / usage.usedBytes()) : 0.0;
+}
+
 void
 convertEnumStoreToSlime(const EnumStoreBase &enumStore, Cursor &object)
 {
     object.setLong("lastEnum", enumStore.getLastEnum());
     object.setLong("numUniques", enumStore.getNumUniques());
-    convertMemoryUsageToSlime(enumStore.getMemoryUsage(), object.setObject("memoryUsage"));
+    MemoryUsage usage = enumStore.getMemoryUsage();
+    convertMemoryUsageToSlime(usage, object.setObject("memoryUsage"));
+    object.setDouble("deadBytesRatio", deadBytesRatio(usage));
     convertMemoryUsageToSlime(enumStore.getTreeMemoryUsage(), object.setObject("treeMemoryUsage"));
 }
 
@@ -87,6 +95,10 @@ convertMultiValueToSlime(const MultiValueMappingBase &multiValue, Cursor &object
 {
     object.setLong("totalValueCnt", multiValue.getTotalValueCnt());
     convertMemoryUsageToSlime(multiValue.getMemoryUsage(), object.setObject("memoryUsage"));
+    Cursor &compaction = object.setObject("compaction");
+    compaction.setDouble("deadBytesRatio", deadBytesRatio(multiValue.getArrayStoreMemoryUsage()));
+    compaction.setBool("inProgress", multiValue.compactionInProgress());
+    compaction.setLong("backlogLids", multiValue.getCompactionBacklog());
 }
 
 void
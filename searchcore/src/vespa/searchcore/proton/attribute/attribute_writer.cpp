@@ -14,6 +14,7 @@
 #include <vespa/document/datatype/documenttype.h>
 #include <vespa/document/fieldvalue/document.h>
 #include <vespa/vespalib/stllike/hash_map.hpp>
+#include <mutex>
 
 #include <vespa/log/log.h>
 LOG_SETUP(".proton.server.attributeadapter");
@@ -409,6 +410,131 @@ CommitTask::run()
 
 }
 
+/**
+ * A batch of write tasks for a single attribute field writer executor.
+ * The master thread adds tasks until the executor thread starts
+ * running the batch or the batch is full. The tasks are run back to
+ * back, followed by a single commit of the attributes in the write
+ * context if any of the writes asked for an immediate commit.
+ */
+class AttributeWriter::WriteBatch
+{
+    std::mutex                 _lock;
+    const WriteContext        &_wc;
+    std::vector<Task::UP>      _tasks;
+    SerialNum                  _serialNum;
+    bool                       _immediateCommit;
+    bool                       _started;
+    uint64_t                   _numScheduledTasks;
+public:
+    WriteBatch(const WriteContext &wc);
+    ~WriteBatch();
+    bool tryAdd(Task::UP &task, SerialNum serialNum, bool immediateCommit);
+    // Tasks scheduled on the executor up to and including this batch, only used by the master thread
+    uint64_t getNumScheduledTasks() const { return _numScheduledTasks; }
+    void setNumScheduledTasks(uint64_t numScheduledTasks) { _numScheduledTasks = numScheduledTasks; }
+    void run();
+};
+
+AttributeWriter::WriteBatch::WriteBatch(const WriteContext &wc)
+    : _lock(),
+      _wc(wc),
+      _tasks(),
+      _serialNum(0),
+      _immediateCommit(false),
+      _started(false),
+      _numScheduledTasks(0)
+{
+}
+
+AttributeWriter::WriteBatch::~WriteBatch() = default;
+
+bool
+AttributeWriter::WriteBatch::tryAdd(Task::UP &task, SerialNum serialNum, bool immediateCommit)
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    if (_started || _tasks.size() >= MAX_BATCHED_WRITES) {
+        return false;
+    }
+    _tasks.emplace_back(std::move(task));
+    _serialNum = std::max(_serialNum, serialNum);
+    _immediateCommit |= immediateCommit;
+    return true;
+}
+
+void
+AttributeWriter::WriteBatch::run()
+{
+    std::vector<Task::UP> tasks;
+    SerialNum serialNum;
+    bool immediateCommit;
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        _started = true;
+        tasks.swap(_tasks);
+        serialNum = _serialNum;
+        immediateCommit = _immediateCommit;
+    }
+    for (auto &task : tasks) {
+        task->run();
+    }
+    if (immediateCommit) {
+        for (auto &field : _wc.getFields()) {
+            AttributeVector &attr = field.getAttribute();
+            if (attr.getStatus().getLastSyncToken() <= serialNum) {
+                attr.commit(serialNum, serialNum);
+            }
+        }
+    }
+    // Tasks (and their write done callbacks) are destroyed after the commit.
+}
+
+namespace {
+
+class WriteBatchTask : public vespalib::Executor::Task
+{
+    std::shared_ptr<AttributeWriter::WriteBatch> _batch;
+public:
+    WriteBatchTask(std::shared_ptr<AttributeWriter::WriteBatch> batch)
+        : _batch(std::move(batch))
+    {
+    }
+    ~WriteBatchTask() override;
+    void run() override { _batch->run(); }
+};
+
+WriteBatchTask::~WriteBatchTask() = default;
+
+}
+
+void
+AttributeWriter::executeBatched(const WriteContext &wc, Task::UP task, SerialNum serialNum, bool immediateCommit)
+{
+    ExecutorId id = wc.getExecutorId();
+    auto &batch = _openBatches[id.getId()];
+    // Tasks scheduled on the executor by others since the batch was
+    // scheduled, e.g. by the gid to lid change listener, close the batch.
+    if (!batch ||
+        (batch->getNumScheduledTasks() != _attributeFieldWriter.getNumScheduledTasks(id)) ||
+        !batch->tryAdd(task, serialNum, immediateCommit))
+    {
+        batch = std::make_shared<WriteBatch>(wc);
+        bool added = batch->tryAdd(task, serialNum, immediateCommit);
+        assert(added);
+        (void) added;
+        _attributeFieldWriter.executeTask(id, std::make_unique<WriteBatchTask>(batch));
+        batch->setNumScheduledTasks(_attributeFieldWriter.getNumScheduledTasks(id));
+    }
+}
+
+void
+AttributeWriter::executeUnbatched(ExecutorId id, Task::UP task)
+{
+    // Later writes must not be reordered before this task.
+    _openBatches[id.getId()].reset();
+    _attributeFieldWriter.executeTask(id, std::move(task));
+}
+
 void
 AttributeWriter::setupWriteContexts()
 {
@@ -425,10 +551,13 @@ AttributeWriter::setupWriteContexts()
         }
         _writeContexts.back().add(*fc.getAttribute());
     }
+    _writeContextByExecutor.resize(_attributeFieldWriter.getNumExecutors(), nullptr);
+    _openBatches.resize(_attributeFieldWriter.getNumExecutors());
     for (const auto &wc : _writeContexts) {
         if (wc.hasStructFieldAttribute()) {
             _hasStructFieldAttribute = true;
         }
+        _writeContextByExecutor[wc.getExecutorId().getId()] = &wc;
     }
 }
 
@@ -452,8 +581,8 @@ AttributeWriter::internalPut(SerialNum serialNum, const Document &doc, DocumentI
     auto extractor = std::make_shared<DocumentFieldExtractor>(doc);
     for (const auto &wc : _writeContexts) {
         if (allAttributes || wc.hasStructFieldAttribute()) {
-            auto putTask = std::make_unique<PutTask>(wc, serialNum, extractor, lid, immediateCommit, allAttributes, onWriteDone);
-            _attributeFieldWriter.executeTask(wc.getExecutorId(), std::move(putTask));
+            auto putTask = std::make_unique<PutTask>(wc, serialNum, extractor, lid, false, allAttributes, onWriteDone);
+            executeBatched(wc, std::move(putTask), serialNum, immediateCommit);
         }
     }
 }
@@ -463,8 +592,8 @@ AttributeWriter::internalRemove(SerialNum serialNum, DocumentIdT lid, bool immed
                                 OnWriteDoneType onWriteDone)
 {
     for (const auto &wc : _writeContexts) {
-        auto removeTask = std::make_unique<RemoveTask>(wc, serialNum, lid, immediateCommit, onWriteDone);
-        _attributeFieldWriter.executeTask(wc.getExecutorId(), std::move(removeTask));
+        auto removeTask = std::make_unique<RemoveTask>(wc, serialNum, lid, false, onWriteDone);
+        executeBatched(wc, std::move(removeTask), serialNum, immediateCommit);
     }
 }
 
@@ -472,6 +601,8 @@ AttributeWriter::AttributeWriter(const proton::IAttributeManager::SP &mgr)
     : _mgr(mgr),
       _attributeFieldWriter(mgr->getAttributeFieldWriter()),
       _writeContexts(),
+      _writeContextByExecutor(),
+      _openBatches(),
       _dataType(nullptr),
       _hasStructFieldAttribute(false),
       _attrMap()
@@ -536,8 +667,8 @@ AttributeWriter::remove(const LidVector &lidsToRemove, SerialNum serialNum,
                         bool immediateCommit, OnWriteDoneType onWriteDone)
 {
     for (const auto &writeCtx : _writeContexts) {
-        auto removeTask = std::make_unique<BatchRemoveTask>(writeCtx, serialNum, lidsToRemove, immediateCommit, onWriteDone);
-        _attributeFieldWriter.executeTask(writeCtx.getExecutorId(), std::move(removeTask));
+        auto removeTask = std::make_unique<BatchRemoveTask>(writeCtx, serialNum, lidsToRemove, false, onWriteDone);
+        executeBatched(writeCtx, std::move(removeTask), serialNum, immediateCommit);
     }
 }
 
@@ -550,7 +681,7 @@ AttributeWriter::update(SerialNum serialNum, const DocumentUpdate &upd, Document
     uint32_t numExecutors = _attributeFieldWriter.getNumExecutors();
     args.reserve(numExecutors);
     for (uint32_t i(0); i < numExecutors; i++) {
-        args.emplace_back(std::make_unique<BatchUpdateTask>(serialNum, lid, immediateCommit));
+        args.emplace_back(std::make_unique<BatchUpdateTask>(serialNum, lid, false));
         args.back()->_updates.reserve((2*upd.getUpdates().size())/numExecutors);
     }
 
@@ -575,7 +706,7 @@ AttributeWriter::update(SerialNum serialNum, const DocumentUpdate &upd, Document
     for (uint32_t id(0); id < args.size(); id++) {
         if ( ! args[id]->_updates.empty()) {
             args[id]->_onWriteDone = onWriteDone;
-            _attributeFieldWriter.executeTask(ExecutorId(id), std::move(args[id]));
+            executeBatched(*_writeContextByExecutor[id], std::move(args[id]), serialNum, immediateCommit);
         }
     }
 
@@ -585,9 +716,9 @@ void
 AttributeWriter::heartBeat(SerialNum serialNum)
 {
     for (auto entry : _attrMap) {
-        _attributeFieldWriter.execute(entry.second.second,
-                                      [serialNum, attr=entry.second.first]()
-                                      { applyHeartBeat(serialNum, *attr); });
+        executeUnbatched(entry.second.second,
+                         vespalib::makeLambdaTask([serialNum, attr=entry.second.first]()
+                                                  { applyHeartBeat(serialNum, *attr); }));
     }
 }
 
@@ -604,7 +735,7 @@ AttributeWriter::forceCommit(SerialNum serialNum, OnWriteDoneType onWriteDone)
     }
     for (const auto &wc : _writeContexts) {
         auto commitTask = std::make_unique<CommitTask>(wc, serialNum, onWriteDone);
-        _attributeFieldWriter.executeTask(wc.getExecutorId(), std::move(commitTask));
+        executeUnbatched(wc.getExecutorId(), std::move(commitTask));
     }
 }
 
@@ -613,9 +744,9 @@ void
 AttributeWriter::onReplayDone(uint32_t docIdLimit)
 {
     for (auto entry : _attrMap) {
-        _attributeFieldWriter.execute(entry.second.second,
-                                      [docIdLimit, attr = entry.second.first]()
-                                      { applyReplayDone(docIdLimit, *attr); });
+        executeUnbatched(entry.second.second,
+                         vespalib::makeLambdaTask([docIdLimit, attr = entry.second.first]()
+                                                  { applyReplayDone(docIdLimit, *attr); }));
     }
     _attributeFieldWriter.sync();
 }
@@ -625,10 +756,9 @@ void
 AttributeWriter::compactLidSpace(uint32_t wantedLidLimit, SerialNum serialNum)
 {
     for (auto entry : _attrMap) {
-        _attributeFieldWriter.
-            execute(entry.second.second,
-                    [wantedLidLimit, serialNum, attr=entry.second.first]()
-                    { applyCompactLidSpace(wantedLidLimit, serialNum, *attr); });
+        executeUnbatched(entry.second.second,
+                         vespalib::makeLambdaTask([wantedLidLimit, serialNum, attr=entry.second.first]()
+                                                  { applyCompactLidSpace(wantedLidLimit, serialNum, *attr); }));
     }
     _attributeFieldWriter.sync();
 }
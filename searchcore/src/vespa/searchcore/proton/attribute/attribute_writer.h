@@ -15,6 +15,11 @@ namespace proton {
 /**
  * Concrete attribute writer that handles writes in form of put, update and remove
  * to the attribute vectors managed by the underlying attribute manager.
+ *
+ * Puts, updates and removes are batched per attribute field writer
+ * executor. Writes are appended to the open batch for the executor
+ * until the executor thread starts processing it or the batch is full,
+ * and all writes in a batch are followed by a single commit.
  */
 class AttributeWriter : public IAttributeWriter
 {
@@ -57,16 +62,22 @@ public:
         const std::vector<WriteField> &getFields() const { return _fields; }
         bool hasStructFieldAttribute() const { return _hasStructFieldAttribute; }
     };
+    class WriteBatch;
 private:
     using AttrWithId = std::pair<search::AttributeVector *, ExecutorId>;
     using AttrMap = vespalib::hash_map<vespalib::string, AttrWithId>;
+    using Task = vespalib::Executor::Task;
     std::vector<WriteContext> _writeContexts;
+    std::vector<const WriteContext *> _writeContextByExecutor;
+    std::vector<std::shared_ptr<WriteBatch>> _openBatches;
     const DataType           *_dataType;
     bool                      _hasStructFieldAttribute;
     AttrMap                   _attrMap;
 
     void setupWriteContexts();
     void setupAttriuteMapping();
+    void executeBatched(const WriteContext &wc, std::unique_ptr<Task> task, SerialNum serialNum, bool immediateCommit);
+    void executeUnbatched(ExecutorId id, std::unique_ptr<Task> task);
     void buildFieldPaths(const DocumentType &docType, const DataType *dataType);
     void internalPut(SerialNum serialNum, const Document &doc, DocumentIdT lid,
                      bool immediateCommit, bool allAttributes, OnWriteDoneType onWriteDone);
@@ -74,6 +85,8 @@ private:
                         bool immediateCommit, OnWriteDoneType onWriteDone);
 
 public:
+    static constexpr uint32_t MAX_BATCHED_WRITES = 256;
+
     AttributeWriter(const proton::IAttributeManager::SP &mgr);
     ~AttributeWriter();
 
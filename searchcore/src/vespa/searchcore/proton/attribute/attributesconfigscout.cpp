@@ -27,6 +27,7 @@ AttributesConfigScout::adjust(AttributesConfig::Attribute &attr,
     attr.enableonlybitvector = liveAttr.enableonlybitvector;
     attr.fastsearch = liveAttr.fastsearch;
     attr.huge = liveAttr.huge;
+    attr.dictionary.type = liveAttr.dictionary.type;
     // Note: Predicate attributes only handle changes for the dense-posting-list-threshold config.
     attr.densepostinglistthreshold = liveAttr.densepostinglistthreshold;
 }
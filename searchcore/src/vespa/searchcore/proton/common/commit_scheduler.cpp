@@ -0,0 +1,61 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "commit_scheduler.h"
+
+namespace proton {
+
+CommitScheduler::CommitScheduler(TimeStamp maxDelay)
+    : _maxDelay(maxDelay),
+      _committedSerialNum(0),
+      _lastTickSerialNum(0),
+      _lastTick(0),
+      _firstPending(0),
+      _stats()
+{
+}
+
+CommitScheduler::~CommitScheduler() = default;
+
+bool
+CommitScheduler::tick(SerialNum current, TimeStamp now)
+{
+    SerialNum lastTickSerialNum = _lastTickSerialNum;
+    TimeStamp lastTick = _lastTick;
+    _lastTickSerialNum = current;
+    _lastTick = now;
+    if (current <= _committedSerialNum) {
+        return false;
+    }
+    if (_firstPending == 0) {
+        // Fed some time since the previous tick, assume the worst.
+        _firstPending = (lastTick != 0) ? lastTick : now;
+    }
+    if (current == lastTickSerialNum) {
+        // Nothing fed since the previous tick, waiting does not batch anything more.
+        return true;
+    }
+    // Commit now if the next tick would be too late.
+    return (now - _firstPending) + getTickInterval(_maxDelay) >= _maxDelay;
+}
+
+void
+CommitScheduler::committed(SerialNum serialNum, TimeStamp now)
+{
+    _committedSerialNum = serialNum;
+    TimeStamp firstPending = _firstPending;
+    _stats.update([firstPending, now](CommitStats &stats) {
+        stats.addCommit();
+        if (firstPending != 0) {
+            stats.visibilityDelay().add((now - firstPending).sec());
+        }
+    });
+    _firstPending = 0;
+}
+
+CommitStats
+CommitScheduler::takeStats()
+{
+    return _stats.take();
+}
+
+} // namespace proton
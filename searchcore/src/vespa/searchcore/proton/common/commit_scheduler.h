@@ -0,0 +1,53 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include <vespa/searchcore/proton/metrics/commit_stats.h>
+#include <vespa/searchlib/common/serialnum.h>
+#include <vespa/searchlib/common/stats_collector.h>
+#include <vespa/fastos/timestamp.h>
+
+namespace proton {
+
+/**
+ * Decides when to commit fed documents to make them visible, given a max
+ * visibility delay. It is asked at ticks spread evenly over the delay.
+ * While feed keeps coming it batches as much as the delay allows, once
+ * the feed goes idle it commits right away instead of leaving the last
+ * documents invisible for the rest of the delay.
+ *
+ * All but takeStats() are called by the master write thread.
+ */
+class CommitScheduler
+{
+public:
+    using SerialNum = search::SerialNum;
+    using TimeStamp = fastos::TimeStamp;
+
+    static constexpr uint32_t TICKS_PER_DELAY = 10;
+
+    CommitScheduler(TimeStamp maxDelay);
+    ~CommitScheduler();
+
+    void setMaxDelay(TimeStamp maxDelay) { _maxDelay = maxDelay; }
+    TimeStamp getMaxDelay() const { return _maxDelay; }
+    static TimeStamp getTickInterval(TimeStamp maxDelay) { return TimeStamp(maxDelay.val() / TICKS_PER_DELAY); }
+
+    /**
+     * Return whether to commit now, given the serial number of the last
+     * operation fed.
+     */
+    bool tick(SerialNum current, TimeStamp now);
+    /** Note that everything up to the given serial number is committed. */
+    void committed(SerialNum serialNum, TimeStamp now);
+    /** Return the stats collected since the previous call. */
+    CommitStats takeStats();
+private:
+    TimeStamp   _maxDelay;
+    SerialNum   _committedSerialNum;
+    SerialNum   _lastTickSerialNum;
+    TimeStamp   _lastTick;
+    TimeStamp   _firstPending; // 0 when nothing is known to be pending
+    search::StatsCollector<CommitStats> _stats;
+};
+
+} // namespace proton
@@ -0,0 +1,133 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "feed_latency_tracker.h"
+#include <vespa/vespalib/stllike/asciistream.h>
+
+#include <vespa/log/log.h>
+LOG_SETUP(".proton.common.feed_latency_tracker");
+
+using search::IDestructorCallback;
+
+namespace proton {
+
+namespace {
+
+class StageDoneCallback : public IDestructorCallback
+{
+    FeedLatencyTracker::SP               _tracker;
+    FeedLatencyTracker::Stage            _stage;
+    FeedLatencyTracker::clock::time_point _start;
+    std::shared_ptr<IDestructorCallback> _onDone;
+public:
+    StageDoneCallback(FeedLatencyTracker::SP tracker, FeedLatencyTracker::Stage stage,
+                      std::shared_ptr<IDestructorCallback> onDone)
+        : _tracker(std::move(tracker)),
+          _stage(stage),
+          _start(FeedLatencyTracker::clock::now()),
+          _onDone(std::move(onDone))
+    {
+    }
+    ~StageDoneCallback() override {
+        _onDone.reset();
+        _tracker->stageDone(_stage, _start);
+    }
+};
+
+double
+toSeconds(int64_t nanos)
+{
+    return nanos / 1e9;
+}
+
+}
+
+FeedLatencyCollector::FeedLatencyCollector()
+    : _stats(),
+      _traceInterval(0),
+      _operations(0)
+{
+}
+
+FeedLatencyCollector::~FeedLatencyCollector() = default;
+
+void
+FeedLatencyCollector::setTraceInterval(uint32_t traceInterval)
+{
+    _traceInterval.store(traceInterval, std::memory_order_relaxed);
+}
+
+bool
+FeedLatencyCollector::sampleTrace()
+{
+    uint32_t traceInterval = _traceInterval.load(std::memory_order_relaxed);
+    if (traceInterval == 0) {
+        return false;
+    }
+    return (_operations.fetch_add(1, std::memory_order_relaxed) % traceInterval) == 0;
+}
+
+void
+FeedLatencyCollector::add(const FeedLatencyStats &stats)
+{
+    _stats.add(stats);
+}
+
+FeedLatencyStats
+FeedLatencyCollector::take()
+{
+    return _stats.take();
+}
+
+FeedLatencyTracker::FeedLatencyTracker(FeedLatencyCollector::SP collector, const vespalib::string &traceName)
+    : _collector(std::move(collector)),
+      _traceName(traceName),
+      _received(clock::now()),
+      _stageNanos()
+{
+    for (auto &nanos : _stageNanos) {
+        nanos.store(-1, std::memory_order_relaxed);
+    }
+}
+
+FeedLatencyTracker::~FeedLatencyTracker()
+{
+    stageDone(FeedLatencyStats::TOTAL, _received);
+    FeedLatencyStats stats;
+    vespalib::asciistream trace;
+    for (size_t i = 0; i < FeedLatencyStats::NUM_STAGES; ++i) {
+        Stage stage = static_cast<Stage>(i);
+        int64_t nanos = _stageNanos[i].load(std::memory_order_relaxed);
+        if (nanos >= 0) {
+            stats.get(stage).add(toSeconds(nanos));
+            if ( ! _traceName.empty()) {
+                trace << " " << FeedLatencyStats::getStageName(stage) << "=" << toSeconds(nanos);
+            }
+        }
+    }
+    _collector->add(stats);
+    if ( ! _traceName.empty()) {
+        LOG(info, "Feed latency trace for %s:%s", _traceName.c_str(), trace.str().c_str());
+    }
+}
+
+void
+FeedLatencyTracker::stageDone(Stage stage, clock::time_point start)
+{
+    int64_t nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count();
+    // A stage done in several parts, like an update applied to attributes twice, is as slow as its slowest part.
+    std::atomic<int64_t> &stageNanos = _stageNanos[stage];
+    int64_t old = stageNanos.load(std::memory_order_relaxed);
+    while ((nanos > old) && ! stageNanos.compare_exchange_weak(old, nanos, std::memory_order_relaxed)) {
+    }
+}
+
+std::shared_ptr<IDestructorCallback>
+FeedLatencyTracker::trackStage(const SP &tracker, Stage stage, std::shared_ptr<IDestructorCallback> onDone)
+{
+    if ( ! tracker) {
+        return onDone;
+    }
+    return std::make_shared<StageDoneCallback>(tracker, stage, std::move(onDone));
+}
+
+} // namespace proton
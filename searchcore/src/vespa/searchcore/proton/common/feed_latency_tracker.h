@@ -0,0 +1,75 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include <vespa/searchcore/proton/metrics/feed_latency_stats.h>
+#include <vespa/searchlib/common/idestructorcallback.h>
+#include <vespa/searchlib/common/stats_collector.h>
+#include <vespa/vespalib/stllike/string.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+namespace proton {
+
+/**
+ * Thread safe accumulation of the feed latencies of a document db.
+ * Also picks which operations to trace, one out of every trace interval.
+ */
+class FeedLatencyCollector
+{
+public:
+    using SP = std::shared_ptr<FeedLatencyCollector>;
+
+    FeedLatencyCollector();
+    ~FeedLatencyCollector();
+    /** Trace every traceInterval-th operation, 0 disables tracing. */
+    void setTraceInterval(uint32_t traceInterval);
+    /** Return whether the next operation should be traced. */
+    bool sampleTrace();
+    void add(const FeedLatencyStats &stats);
+    /** Return the stats collected since the previous call. */
+    FeedLatencyStats take();
+private:
+    search::StatsCollector<FeedLatencyStats> _stats;
+    std::atomic<uint32_t> _traceInterval;
+    std::atomic<uint64_t> _operations;
+};
+
+/**
+ * Tracks the time a single feed operation spends in each stage. It is
+ * shared by the operation and the callbacks of the stages completing in
+ * other threads, and hands the latencies to the collector when the last
+ * of them lets go. Traced operations also log their breakdown then.
+ */
+class FeedLatencyTracker
+{
+public:
+    using SP = std::shared_ptr<FeedLatencyTracker>;
+    using Stage = FeedLatencyStats::Stage;
+    using clock = std::chrono::steady_clock;
+
+    /**
+     * @param traceName Name of the operation in the trace, empty if it is not traced.
+     */
+    FeedLatencyTracker(FeedLatencyCollector::SP collector, const vespalib::string &traceName);
+    ~FeedLatencyTracker();
+
+    clock::time_point getReceived() const { return _received; }
+    /** Record that the given stage, started at the given time, is done now. */
+    void stageDone(Stage stage, clock::time_point start);
+
+    /**
+     * Return a callback that records the given stage as done when it is
+     * destroyed, after letting go of onDone. Returns onDone itself when
+     * there is no tracker.
+     */
+    static std::shared_ptr<search::IDestructorCallback>
+    trackStage(const SP &tracker, Stage stage, std::shared_ptr<search::IDestructorCallback> onDone);
+private:
+    FeedLatencyCollector::SP    _collector;
+    const vespalib::string      _traceName;
+    const clock::time_point     _received;
+    std::atomic<int64_t>        _stageNanos[FeedLatencyStats::NUM_STAGES];
+};
+
+} // namespace proton
@@ -0,0 +1,109 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "docsum_blob_store.h"
+#include <vespa/vespalib/stllike/hash_map.hpp>
+
+namespace proton {
+
+DocsumBlobStore::DocsumBlobStore(size_t maxBytes)
+    : _maxBytes(maxBytes),
+      _lock(),
+      _entries(),
+      _memoryUsed(0)
+{
+}
+
+DocsumBlobStore::~DocsumBlobStore() {}
+
+void
+DocsumBlobStore::removeLocked(uint32_t lid)
+{
+    auto found = _entries.find(lid);
+    if (found != _entries.end()) {
+        _memoryUsed -= entrySize(found->second);
+        _entries.erase(found);
+    }
+}
+
+void
+DocsumBlobStore::put(uint32_t lid, uint64_t generation, uint32_t classId, const char * buf, size_t len)
+{
+    Entry entry;
+    entry._generation = generation;
+    entry._classId = classId;
+    entry._blob.assign(buf, buf + len);
+    size_t size = entrySize(entry);
+    std::lock_guard<std::mutex> guard(_lock);
+    removeLocked(lid);
+    if (_memoryUsed + size > _maxBytes) {
+        return;
+    }
+    _memoryUsed += size;
+    _entries[lid] = std::move(entry);
+}
+
+void
+DocsumBlobStore::remove(uint32_t lid)
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    removeLocked(lid);
+}
+
+void
+DocsumBlobStore::clear()
+{
+    EntryMap entries;
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        _entries.swap(entries);
+        _memoryUsed = 0;
+    }
+}
+
+const DocsumBlobStore::Entry *
+DocsumBlobStore::findLocked(uint32_t lid, uint64_t generation, uint32_t classId) const
+{
+    auto found = _entries.find(lid);
+    if ((found == _entries.end()) ||
+        (found->second._generation != generation) ||
+        (found->second._classId != classId))
+    {
+        return nullptr;
+    }
+    return &found->second;
+}
+
+bool
+DocsumBlobStore::get(uint32_t lid, uint64_t generation, uint32_t classId, std::vector<char> & buf) const
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    const Entry * entry = findLocked(lid, generation, classId);
+    if (entry == nullptr) {
+        return false;
+    }
+    buf = entry->_blob;
+    return true;
+}
+
+bool
+DocsumBlobStore::contains(uint32_t lid, uint64_t generation, uint32_t classId) const
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    return findLocked(lid, generation, classId) != nullptr;
+}
+
+size_t
+DocsumBlobStore::getMemoryUsed() const
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    return _memoryUsed;
+}
+
+size_t
+DocsumBlobStore::size() const
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    return _entries.size();
+}
+
+} // namespace proton
@@ -0,0 +1,66 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/vespalib/stllike/hash_map.h>
+#include <mutex>
+#include <vector>
+
+namespace proton {
+
+/**
+ * Memory bounded store of docsum blobs packed at feed time.
+ *
+ * Each lid holds at most one blob, packed for a given result class by the
+ * summary setup with the given generation. A docsum store only uses a blob
+ * when both match its own setup, so blobs packed with an older summary
+ * config are never returned for a newer one. When the memory budget is
+ * exhausted new blobs are dropped and docsums are produced from the
+ * document store as before.
+ */
+class DocsumBlobStore
+{
+private:
+    struct Entry {
+        uint64_t          _generation;
+        uint32_t          _classId;
+        std::vector<char> _blob;
+        Entry() : _generation(0), _classId(0), _blob() {}
+    };
+    using EntryMap = vespalib::hash_map<uint32_t, Entry>;
+
+    const size_t       _maxBytes;
+    mutable std::mutex _lock;
+    EntryMap           _entries;
+    size_t             _memoryUsed;
+
+    static size_t entrySize(const Entry & entry) { return sizeof(Entry) + entry._blob.capacity(); }
+    void removeLocked(uint32_t lid);
+    const Entry * findLocked(uint32_t lid, uint64_t generation, uint32_t classId) const;
+public:
+    DocsumBlobStore(size_t maxBytes);
+    ~DocsumBlobStore();
+
+    /**
+     * Store the blob for the given lid, replacing any blob already
+     * stored. The old blob is removed if the new one does not fit.
+     */
+    void put(uint32_t lid, uint64_t generation, uint32_t classId, const char * buf, size_t len);
+    void remove(uint32_t lid);
+    void clear();
+
+    /**
+     * Copy the blob for the given lid into buf if it was packed for the
+     * given generation and result class.
+     *
+     * @return true if a blob was found.
+     */
+    bool get(uint32_t lid, uint64_t generation, uint32_t classId, std::vector<char> & buf) const;
+    bool contains(uint32_t lid, uint64_t generation, uint32_t classId) const;
+
+    size_t getMemoryUsed() const;
+    size_t size() const;
+    size_t getMaxBytes() const { return _maxBytes; }
+};
+
+} // namespace proton
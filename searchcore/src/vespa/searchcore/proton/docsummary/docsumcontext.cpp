@@ -6,6 +6,7 @@
 #include <vespa/searchlib/common/location.h>
 #include <vespa/searchlib/common/transport.h>
 #include <vespa/vespalib/data/slime/slime.h>
+#include <vespa/vespalib/data/slime/inject.h>
 #include <vespa/vespalib/util/stringfmt.h>
 
 #include <vespa/log/log.h>
@@ -44,96 +45,258 @@ Memory TIMEOUT("timeout");
 
 }
 
+namespace {
+
+/**
+ * Parallel docsum generation is not worth the setup cost for fewer
+ * hits than this per thread.
+ **/
+constexpr uint32_t MIN_HITS_PER_THREAD = 4;
+
+vespalib::Slime::Params
+makeSlimeParams(size_t chunkSize) {
+    Slime::Params params;
+    params.setChunkSize(chunkSize);
+    return params;
+}
+
+size_t
+estimateChunkSize(uint32_t docsumCnt) {
+    return std::min(0x200000ul, docsumCnt*0x400ul);
+}
+
+}
+
+/**
+ * A consecutive range of the hits in a request, produced by a single
+ * thread with its own docsum state and docsum store.
+ **/
+struct DocsumContext::Part : public vespalib::Runnable {
+    DocsumContext               & _ctx;
+    GetDocsumsState               _state;
+    IDocsumStore::UP              _ownedStore;
+    IDocsumStore                & _store;
+    uint32_t                      _begin;
+    vespalib::Slime::UP           _slime;
+    uint32_t                      _done;
+    std::function<void(Part &)>   _work;
+
+    Part(DocsumContext & ctx, IDocsumStore::UP ownedStore, IDocsumStore & store, uint32_t begin, uint32_t end)
+        : _ctx(ctx),
+          _state(ctx),
+          _ownedStore(std::move(ownedStore)),
+          _store(store),
+          _begin(begin),
+          _slime(),
+          _done(0),
+          _work()
+    {
+        _ctx.initState(_state, begin, end);
+    }
+    void run() override {
+        _ctx._docsumWriter.InitState(_ctx._attrMgr, &_state);
+        _work(*this);
+    }
+};
+
 void
-DocsumContext::initState()
+DocsumContext::initState(GetDocsumsState & state, uint32_t begin, uint32_t end)
 {
     const DocsumRequest & req = _request;
-    _docsumState._args.initFromDocsumRequest(req);
-    _docsumState._args.SetQueryFlags(req.queryFlags & ~search::fs4transport::QFLAG_DROP_SORTDATA);
-    _docsumState._docsumcnt = req.hits.size();
+    state._args.initFromDocsumRequest(req);
+    state._args.SetQueryFlags(req.queryFlags & ~search::fs4transport::QFLAG_DROP_SORTDATA);
+    state._docsumcnt = end - begin;
 
-    _docsumState._docsumbuf = (_docsumState._docsumcnt > 0)
-                              ? (uint32_t*)malloc(sizeof(uint32_t) * _docsumState._docsumcnt)
-                              : nullptr;
+    state._docsumbuf = (state._docsumcnt > 0)
+                       ? (uint32_t*)malloc(sizeof(uint32_t) * state._docsumcnt)
+                       : nullptr;
 
-    for (uint32_t i = 0; i < _docsumState._docsumcnt; i++) {
-        _docsumState._docsumbuf[i] = req.hits[i].docid;
+    for (uint32_t i = 0; i < state._docsumcnt; i++) {
+        state._docsumbuf[i] = req.hits[begin + i].docid;
     }
 }
 
-DocsumReply::UP
-DocsumContext::createReply()
+void
+DocsumContext::prefetchDocsums(GetDocsumsState & state, IDocsumStore & store, const ResolveClassInfo & rci)
+{
+    if (rci.mustSkip || rci.allGenerated) {
+        return;
+    }
+    std::vector<uint32_t> docIds;
+    docIds.reserve(state._docsumcnt);
+    for (uint32_t i = 0; i < state._docsumcnt; ++i) {
+        uint32_t docId = state._docsumbuf[i];
+        if (docId != search::endDocId) {
+            docIds.push_back(docId);
+        }
+    }
+    store.prefetch(docIds);
+}
+
+void
+DocsumContext::fillDocsums(GetDocsumsState & state, IDocsumStore & store, const ResolveClassInfo & rci,
+                           DocsumReply & reply, uint32_t offset)
 {
-    DocsumReply::UP reply(new DocsumReply());
     search::RawBuf buf(4096);
-    _docsumWriter.InitState(_attrMgr, &_docsumState);
-    reply->docsums.resize(_docsumState._docsumcnt);
     SymbolTable::UP symbols = std::make_unique<SymbolTable>();
-    IDocsumWriter::ResolveClassInfo rci = _docsumWriter.resolveClassInfo(_docsumState._args.getResultClassName(), _docsumStore.getSummaryClassId());
-    for (uint32_t i = 0; i < _docsumState._docsumcnt; ++i) {
+    prefetchDocsums(state, store, rci);
+    for (uint32_t i = 0; i < state._docsumcnt; ++i) {
         buf.reset();
-        uint32_t docId = _docsumState._docsumbuf[i];
-        reply->docsums[i].docid = docId;
+        uint32_t docId = state._docsumbuf[i];
+        DocsumReply::Docsum & docsum = reply.docsums[offset + i];
+        docsum.docid = docId;
         if (docId != search::endDocId && !rci.mustSkip) {
             Slime slime(Slime::Params(std::move(symbols)));
             vespalib::slime::SlimeInserter inserter(slime);
             if (_request.expired()) {
                 inserter.insertString(make_string("Timed out with %ldus left.", _request.getTimeLeft().us()));
             } else {
-                _docsumWriter.insertDocsum(rci, docId, &_docsumState, &_docsumStore, slime, inserter);
+                _docsumWriter.insertDocsum(rci, docId, &state, &store, slime, inserter);
             }
             uint32_t docsumLen = (slime.get().type().getId() != NIX::ID)
                                    ? IDocsumWriter::slime2RawBuf(slime, buf)
                                    : 0;
-            reply->docsums[i].setData(buf.GetDrainPos(), docsumLen);
+            docsum.setData(buf.GetDrainPos(), docsumLen);
             symbols = Slime::reclaimSymbols(std::move(slime));
         }
     }
-    return reply;
 }
 
-namespace {
+uint32_t
+DocsumContext::fillDocsums(GetDocsumsState & state, IDocsumStore & store, const ResolveClassInfo & rci,
+                           Slime & slime, Cursor & array)
+{
+    const Symbol docsumSym = slime.insert(DOCSUM);
+    prefetchDocsums(state, store, rci);
+    uint32_t i(0);
+    for (i = 0; (i < state._docsumcnt) && !_request.expired(); ++i) {
+        uint32_t docId = state._docsumbuf[i];
+        Cursor & docSumC = array.addObject();
+        ObjectSymbolInserter inserter(docSumC, docsumSym);
+        if ((docId != search::endDocId) && !rci.mustSkip) {
+            _docsumWriter.insertDocsum(rci, docId, &state, &store, slime, inserter);
+        }
+    }
+    return i;
+}
 
-vespalib::Slime::Params
-makeSlimeParams(size_t chunkSize) {
-    Slime::Params params;
-    params.setChunkSize(chunkSize);
-    return params;
+IDocsumWriter::ResolveClassInfo
+DocsumContext::resolveClassInfo() const
+{
+    return _docsumWriter.resolveClassInfo(_docsumState._args.getResultClassName(), _docsumStore.getSummaryClassId());
+}
+
+void
+DocsumContext::addTimeoutError(Cursor & root, uint32_t numTimedOut) const
+{
+    Cursor & errors = root.setArray(ERRORS);
+    Cursor & timeout = errors.addObject();
+    timeout.setString(TYPE, TIMEOUT);
+    timeout.setString(MESSAGE, make_string("Timed out %d summaries with %ldus left.",
+                                           numTimedOut, _request.getTimeLeft().us()));
 }
 
+DocsumReply::UP
+DocsumContext::createReply()
+{
+    DocsumReply::UP reply(new DocsumReply());
+    _docsumWriter.InitState(_attrMgr, &_docsumState);
+    reply->docsums.resize(_docsumState._docsumcnt);
+    fillDocsums(_docsumState, _docsumStore, resolveClassInfo(), *reply, 0);
+    return reply;
+}
+
+DocsumReply::UP
+DocsumContext::createReply(vespalib::ThreadBundle & threadBundle, Parts & parts)
+{
+    DocsumReply::UP reply(new DocsumReply());
+    reply->docsums.resize(_docsumState._docsumcnt);
+    const ResolveClassInfo rci = resolveClassInfo();
+    DocsumReply & target = *reply;
+    std::vector<vespalib::Runnable *> targets;
+    for (auto & part : parts) {
+        part->_work = [this, &rci, &target](Part & p) {
+            fillDocsums(p._state, p._store, rci, target, p._begin);
+        };
+        targets.push_back(part.get());
+    }
+    threadBundle.run(targets);
+    return reply;
 }
 
 vespalib::Slime::UP
 DocsumContext::createSlimeReply()
 {
     _docsumWriter.InitState(_attrMgr, &_docsumState);
-    const size_t estimatedChunkSize(std::min(0x200000ul, _docsumState._docsumcnt*0x400ul));
-    vespalib::Slime::UP response(std::make_unique<vespalib::Slime>(makeSlimeParams(estimatedChunkSize)));
+    vespalib::Slime::UP response(std::make_unique<vespalib::Slime>(makeSlimeParams(estimateChunkSize(_docsumState._docsumcnt))));
     Cursor & root = response->setObject();
     Cursor & array = root.setArray(DOCSUMS);
-    const Symbol docsumSym = response->insert(DOCSUM);
-    IDocsumWriter::ResolveClassInfo rci = _docsumWriter.resolveClassInfo(_docsumState._args.getResultClassName(),
-                                                                         _docsumStore.getSummaryClassId());
-    uint32_t i(0);
-    for (i = 0; (i < _docsumState._docsumcnt) && !_request.expired(); ++i) {
-        uint32_t docId = _docsumState._docsumbuf[i];
-        Cursor & docSumC = array.addObject();
-        ObjectSymbolInserter inserter(docSumC, docsumSym);
-        if ((docId != search::endDocId) && !rci.mustSkip) {
-            _docsumWriter.insertDocsum(rci, docId, &_docsumState, &_docsumStore, *response, inserter);
+    uint32_t done = fillDocsums(_docsumState, _docsumStore, resolveClassInfo(), *response, array);
+    if (done != _docsumState._docsumcnt) {
+        addTimeoutError(root, _docsumState._docsumcnt - done);
+    }
+    return response;
+}
+
+vespalib::Slime::UP
+DocsumContext::createSlimeReply(vespalib::ThreadBundle & threadBundle, Parts & parts)
+{
+    const ResolveClassInfo rci = resolveClassInfo();
+    std::vector<vespalib::Runnable *> targets;
+    for (auto & part : parts) {
+        part->_work = [this, &rci](Part & p) {
+            p._slime = std::make_unique<vespalib::Slime>(makeSlimeParams(estimateChunkSize(p._state._docsumcnt)));
+            Cursor & partArray = p._slime->setArray();
+            p._done = fillDocsums(p._state, p._store, rci, *p._slime, partArray);
+        };
+        targets.push_back(part.get());
+    }
+    threadBundle.run(targets);
+
+    vespalib::Slime::UP response(std::make_unique<vespalib::Slime>(makeSlimeParams(estimateChunkSize(_docsumState._docsumcnt))));
+    Cursor & root = response->setObject();
+    Cursor & array = root.setArray(DOCSUMS);
+    uint32_t done(0);
+    for (auto & part : parts) {
+        const vespalib::slime::Inspector & partArray = part->_slime->get();
+        for (size_t i = 0; i < part->_done; ++i) {
+            vespalib::slime::inject(partArray[i], vespalib::slime::ArrayInserter(array));
+        }
+        done += part->_done;
+        if (part->_done != part->_state._docsumcnt) {
+            break;
         }
     }
-    if (i != _docsumState._docsumcnt) {
-        const uint32_t numTimedOut = _docsumState._docsumcnt - i;
-        Cursor & errors = root.setArray(ERRORS);
-        Cursor & timeout = errors.addObject();
-        timeout.setString(TYPE, TIMEOUT);
-        timeout.setString(MESSAGE, make_string("Timed out %d summaries with %ldus left.",
-                                               numTimedOut, _request.getTimeLeft().us()));
+    if (done != _docsumState._docsumcnt) {
+        addTimeoutError(root, _docsumState._docsumcnt - done);
     }
     return response;
 }
 
+DocsumContext::Parts
+DocsumContext::createParts(size_t maxParts, const DocsumStoreFactory & storeFactory)
+{
+    const uint32_t cnt = _docsumState._docsumcnt;
+    const size_t numParts = std::min(maxParts, size_t((cnt + MIN_HITS_PER_THREAD - 1) / MIN_HITS_PER_THREAD));
+    Parts parts;
+    if (numParts <= 1) {
+        return parts;
+    }
+    parts.reserve(numParts);
+    for (size_t i = 0; i < numParts; ++i) {
+        uint32_t begin = (cnt * i) / numParts;
+        uint32_t end = (cnt * (i + 1)) / numParts;
+        if (i == 0) {
+            parts.push_back(std::make_unique<Part>(*this, IDocsumStore::UP(), _docsumStore, begin, end));
+        } else {
+            IDocsumStore::UP store = storeFactory();
+            IDocsumStore & storeRef = *store;
+            parts.push_back(std::make_unique<Part>(*this, std::move(store), storeRef, begin, end));
+        }
+    }
+    return parts;
+}
+
 DocsumContext::DocsumContext(const DocsumRequest & request, IDocsumWriter & docsumWriter,
                              IDocsumStore & docsumStore, const Matcher::SP & matcher,
                              ISearchContext & searchCtx, IAttributeContext & attrCtx,
@@ -146,11 +309,18 @@ DocsumContext::DocsumContext(const DocsumRequest & request, IDocsumWriter & docs
     _attrCtx(attrCtx),
     _attrMgr(attrMgr),
     _docsumState(*this),
-    _sessionMgr(sessionMgr)
+    _sessionMgr(sessionMgr),
+    _lock(),
+    _summaryFeatures(),
+    _summaryFeaturesFilled(false),
+    _rankFeatures(),
+    _rankFeaturesFilled(false)
 {
-    initState();
+    initState(_docsumState, 0, request.hits.size());
 }
 
+DocsumContext::~DocsumContext() = default;
+
 DocsumReply::UP
 DocsumContext::getDocsums()
 {
@@ -160,25 +330,47 @@ DocsumContext::getDocsums()
     return createReply();
 }
 
+DocsumReply::UP
+DocsumContext::getDocsums(vespalib::ThreadBundle & threadBundle, const DocsumStoreFactory & storeFactory)
+{
+    Parts parts = createParts(threadBundle.size(), storeFactory);
+    if (parts.empty()) {
+        return getDocsums();
+    }
+    if (_request.useRootSlime()) {
+        return std::make_unique<DocsumReply>(createSlimeReply(threadBundle, parts));
+    }
+    return createReply(threadBundle, parts);
+}
+
 void
 DocsumContext::FillSummaryFeatures(search::docsummary::GetDocsumsState * state, search::docsummary::IDocsumEnvironment *)
 {
-    assert(&_docsumState == state);
-    if (_matcher->canProduceSummaryFeatures()) {
-        state->_summaryFeatures = _matcher->getSummaryFeatures(_request, _searchCtx, _attrCtx, _sessionMgr);
+    // Computed once for all hits, and shared by the states of all threads
+    std::lock_guard<std::mutex> guard(_lock);
+    if (!_summaryFeaturesFilled) {
+        if (_matcher->canProduceSummaryFeatures()) {
+            _summaryFeatures = _matcher->getSummaryFeatures(_request, _searchCtx, _attrCtx, _sessionMgr);
+        }
+        _summaryFeaturesFilled = true;
     }
+    state->_summaryFeatures = _summaryFeatures;
     state->_summaryFeaturesCached = false;
 }
 
 void
 DocsumContext::FillRankFeatures(search::docsummary::GetDocsumsState * state, search::docsummary::IDocsumEnvironment *)
 {
-    assert(&_docsumState == state);
     // check if we are allowed to run
     if ((state->_args.GetQueryFlags() & search::fs4transport::QFLAG_DUMP_FEATURES) == 0) {
         return;
     }
-    state->_rankFeatures = _matcher->getRankFeatures(_request, _searchCtx, _attrCtx, _sessionMgr);
+    std::lock_guard<std::mutex> guard(_lock);
+    if (!_rankFeaturesFilled) {
+        _rankFeatures = _matcher->getRankFeatures(_request, _searchCtx, _attrCtx, _sessionMgr);
+        _rankFeaturesFilled = true;
+    }
+    state->_rankFeatures = _rankFeatures;
 }
 
 namespace {
@@ -210,6 +402,7 @@ Location *getLocation(const string &loc_str, search::IAttributeManager &attrMgr)
 void
 DocsumContext::ParseLocation(search::docsummary::GetDocsumsState *state)
 {
+    std::lock_guard<std::mutex> guard(_lock);
     state->_parsedLocation.reset(getLocation(_request.location, _attrMgr));
 }
 
@@ -7,6 +7,9 @@
 #include <vespa/searchsummary/docsummary/docsumwriter.h>
 #include <vespa/searchlib/engine/docsumrequest.h>
 #include <vespa/searchlib/engine/docsumreply.h>
+#include <vespa/vespalib/util/thread_bundle.h>
+#include <functional>
+#include <mutex>
 
 namespace proton {
 
@@ -15,7 +18,18 @@ namespace proton {
  * creating a docsum reply.
  **/
 class DocsumContext : public search::docsummary::GetDocsumsStateCallback {
+public:
+    /**
+     * Creates a docsum store for each additional thread producing docsums.
+     **/
+    using DocsumStoreFactory = std::function<search::docsummary::IDocsumStore::UP()>;
 private:
+    using GetDocsumsState = search::docsummary::GetDocsumsState;
+    using IDocsumStore = search::docsummary::IDocsumStore;
+    using ResolveClassInfo = search::docsummary::IDocsumWriter::ResolveClassInfo;
+    struct Part;
+    using Parts = std::vector<std::unique_ptr<Part>>;
+
     const search::engine::DocsumRequest  & _request;
     search::docsummary::IDocsumWriter    & _docsumWriter;
     search::docsummary::IDocsumStore     & _docsumStore;
@@ -25,10 +39,25 @@ private:
     search::IAttributeManager            & _attrMgr;
     search::docsummary::GetDocsumsState    _docsumState;
     matching::SessionManager             & _sessionMgr;
+    std::mutex                             _lock;
+    search::FeatureSet::SP                 _summaryFeatures;
+    bool                                   _summaryFeaturesFilled;
+    search::FeatureSet::SP                 _rankFeatures;
+    bool                                   _rankFeaturesFilled;
 
-    void initState();
+    void initState(GetDocsumsState & state, uint32_t begin, uint32_t end);
+    void prefetchDocsums(GetDocsumsState & state, IDocsumStore & store, const ResolveClassInfo & rci);
+    void fillDocsums(GetDocsumsState & state, IDocsumStore & store, const ResolveClassInfo & rci,
+                     search::engine::DocsumReply & reply, uint32_t offset);
+    uint32_t fillDocsums(GetDocsumsState & state, IDocsumStore & store, const ResolveClassInfo & rci,
+                         vespalib::Slime & slime, vespalib::slime::Cursor & array);
+    ResolveClassInfo resolveClassInfo() const;
     search::engine::DocsumReply::UP createReply();
+    search::engine::DocsumReply::UP createReply(vespalib::ThreadBundle & threadBundle, Parts & parts);
     std::unique_ptr<vespalib::Slime> createSlimeReply();
+    std::unique_ptr<vespalib::Slime> createSlimeReply(vespalib::ThreadBundle & threadBundle, Parts & parts);
+    Parts createParts(size_t maxParts, const DocsumStoreFactory & storeFactory);
+    void addTimeoutError(vespalib::slime::Cursor & root, uint32_t numTimedOut) const;
 
 public:
     typedef std::unique_ptr<DocsumContext> UP;
@@ -41,9 +70,19 @@ public:
                   search::attribute::IAttributeContext & attrCtx,
                   search::IAttributeManager & attrMgr,
                   matching::SessionManager & sessionMgr);
+    ~DocsumContext();
 
     search::engine::DocsumReply::UP getDocsums();
 
+    /**
+     * Produce the docsums with the hits split in consecutive ranges
+     * over the threads in the given bundle. Each thread uses its own
+     * docsum store and state. The reply has the same content and order
+     * as with getDocsums().
+     **/
+    search::engine::DocsumReply::UP getDocsums(vespalib::ThreadBundle & threadBundle,
+                                               const DocsumStoreFactory & storeFactory);
+
     // Implements GetDocsumsStateCallback
     virtual void FillSummaryFeatures(search::docsummary::GetDocsumsState * state, search::docsummary::IDocsumEnvironment * env) override;
     virtual void FillRankFeatures(search::docsummary::GetDocsumsState * state, search::docsummary::IDocsumEnvironment * env) override;
@@ -51,4 +90,3 @@ public:
 };
 
 } // namespace proton
-
@@ -1,11 +1,13 @@
 // Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "documentstoreadapter.h"
+#include "docsum_blob_store.h"
 #include <vespa/searchsummary/docsummary/summaryfieldconverter.h>
 #include <vespa/document/fieldvalue/stringfieldvalue.h>
 #include <vespa/eval/tensor/tensor.h>
 #include <vespa/eval/tensor/serialization/typed_binary_format.h>
 #include <vespa/vespalib/objects/nbostream.h>
+#include <vespa/vespalib/stllike/hash_map.hpp>
 #include <vespa/document/fieldvalue/tensorfieldvalue.h>
 
 #include <vespa/log/log.h>
@@ -105,7 +107,7 @@ DocumentStoreAdapter::writeField(const FieldValue &value, ResType type)
 
 
 void
-DocumentStoreAdapter::convertFromSearchDoc(Document &doc, uint32_t docId)
+DocumentStoreAdapter::convertFromSearchDoc(const Document &doc, uint32_t docId)
 {
     for (size_t i = 0; i < _resultClass->GetNumEntries(); ++i) {
         const ResConfigEntry * entry = _resultClass->GetEntry(i);
@@ -166,7 +168,9 @@ DocumentStoreAdapter(const search::IDocumentStore & docStore,
                      const ResultConfig & resultConfig,
                      const vespalib::string & resultClassName,
                      const FieldCache::CSP & fieldCache,
-                     const std::set<vespalib::string> &markupFields)
+                     const std::set<vespalib::string> &markupFields,
+                     const DocsumBlobStore *blobStore,
+                     uint64_t blobGeneration)
     : _docStore(docStore),
       _repo(repo),
       _resultConfig(resultConfig),
@@ -176,22 +180,55 @@ DocumentStoreAdapter(const search::IDocumentStore & docStore,
                                              c_str()))),
       _resultPacker(&_resultConfig),
       _fieldCache(fieldCache),
-      _markupFields(markupFields)
+      _markupFields(markupFields),
+      _prefetched(),
+      _blobStore(blobStore),
+      _blobGeneration(blobGeneration),
+      _blob()
 {
 }
 
 DocumentStoreAdapter::~DocumentStoreAdapter() {}
 
+void
+DocumentStoreAdapter::prefetch(const std::vector<uint32_t> & docIds)
+{
+    _prefetched.clear();
+    std::vector<uint32_t> toRead;
+    if (_blobStore != nullptr) {
+        toRead.reserve(docIds.size());
+        for (uint32_t docId : docIds) {
+            if (!_blobStore->contains(docId, _blobGeneration, getSummaryClassId())) {
+                toRead.push_back(docId);
+            }
+        }
+    }
+    const std::vector<uint32_t> & ids = (_blobStore != nullptr) ? toRead : docIds;
+    if (ids.empty()) {
+        return;
+    }
+    std::vector<Document::UP> documents = _docStore.read(ids, _repo, _fieldCache->getFieldSet());
+    for (size_t i(0); i < ids.size(); i++) {
+        if (documents[i]) {
+            _prefetched[ids[i]] = std::move(documents[i]);
+        }
+    }
+}
+
 DocsumStoreValue
 DocumentStoreAdapter::getMappedDocsum(uint32_t docId)
 {
-    if (!_resultPacker.Init(getSummaryClassId())) {
-        LOG(warning,
-            "Error during init of result class '%s' with class id %u",
-            _resultClass->GetClassName(), getSummaryClassId());
-        return DocsumStoreValue();
+    if ((_blobStore != nullptr) && _blobStore->get(docId, _blobGeneration, getSummaryClassId(), _blob)) {
+        return DocsumStoreValue(&_blob[0], _blob.size());
+    }
+    Document::UP document;
+    auto prefetched = _prefetched.find(docId);
+    if (prefetched != _prefetched.end()) {
+        document = std::move(prefetched->second);
+        _prefetched.erase(prefetched);
+    } else {
+        document = _docStore.read(docId, _repo, _fieldCache->getFieldSet());
     }
-    Document::UP document = _docStore.read(docId, _repo);
     if (document.get() == NULL) {
         LOG(debug,
             "Did not find summary document for docId %u. "
@@ -203,7 +240,19 @@ DocumentStoreAdapter::getMappedDocsum(uint32_t docId)
         "getMappedDocSum(%u): document={\n%s\n}",
         docId,
         document->toString(true).c_str());
-    convertFromSearchDoc(*document, docId);
+    return packDocsum(*document, docId);
+}
+
+DocsumStoreValue
+DocumentStoreAdapter::packDocsum(const Document &doc, uint32_t docId)
+{
+    if (!_resultPacker.Init(getSummaryClassId())) {
+        LOG(warning,
+            "Error during init of result class '%s' with class id %u",
+            _resultClass->GetClassName(), getSummaryClassId());
+        return DocsumStoreValue();
+    }
+    convertFromSearchDoc(doc, docId);
     const char * buf;
     uint32_t buflen;
     if (!_resultPacker.GetDocsumBlob(&buf, &buflen)) {
@@ -8,9 +8,12 @@
 #include <vespa/searchsummary/docsummary/resultpacker.h>
 #include <vespa/document/fieldvalue/document.h>
 #include <vespa/searchlib/docstore/idocumentstore.h>
+#include <vespa/vespalib/stllike/hash_map.h>
 
 namespace proton {
 
+class DocsumBlobStore;
+
 class DocumentStoreAdapter : public search::docsummary::IDocsumStore
 {
 private:
@@ -21,6 +24,10 @@ private:
     search::docsummary::ResultPacker         _resultPacker;
     FieldCache::CSP                          _fieldCache;
     const std::set<vespalib::string>       & _markupFields;
+    vespalib::hash_map<uint32_t, document::Document::UP> _prefetched;
+    const DocsumBlobStore                  * _blobStore;
+    uint64_t                                 _blobGeneration;
+    std::vector<char>                        _blob;
 
     bool
     writeStringField(const char * buf,
@@ -32,7 +39,7 @@ private:
                search::docsummary::ResType type);
 
     void
-    convertFromSearchDoc(document::Document &doc, uint32_t docId);
+    convertFromSearchDoc(const document::Document &doc, uint32_t docId);
 
 public:
     DocumentStoreAdapter(const search::IDocumentStore &docStore,
@@ -40,7 +47,9 @@ public:
                          const search::docsummary::ResultConfig &resultConfig,
                          const vespalib::string &resultClassName,
                          const FieldCache::CSP &fieldCache,
-                         const std::set<vespalib::string> &markupFields);
+                         const std::set<vespalib::string> &markupFields,
+                         const DocsumBlobStore *blobStore = nullptr,
+                         uint64_t blobGeneration = 0);
     ~DocumentStoreAdapter();
 
     const search::docsummary::ResultClass *getResultClass() const {
@@ -49,8 +58,15 @@ public:
 
     uint32_t getNumDocs() const override { return _docStore.getDocIdLimit(); }
     search::docsummary::DocsumStoreValue getMappedDocsum(uint32_t docId) override;
+    void prefetch(const std::vector<uint32_t> & docIds) override;
     uint32_t getSummaryClassId() const override { return _resultClass->GetClassID(); }
 
+    /**
+     * Pack the summary fields of the given document into a docsum blob.
+     * The blob is owned by this adapter and valid until the next call.
+     **/
+    search::docsummary::DocsumStoreValue packDocsum(const document::Document &doc, uint32_t docId);
+
 };
 
 } // namespace proton
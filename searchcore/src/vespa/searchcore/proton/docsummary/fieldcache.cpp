@@ -2,6 +2,7 @@
 
 #include "fieldcache.h"
 #include <vespa/document/fieldvalue/document.h>
+#include <vespa/document/fieldset/fieldsets.h>
 #include <vespa/log/log.h>
 LOG_SETUP(".proton.docsummary.fieldcache");
 
@@ -11,14 +12,19 @@ using namespace search::docsummary;
 namespace proton {
 
 FieldCache::FieldCache() :
-    _cache()
+    _cache(),
+    _fieldSet(std::make_unique<AllFields>())
 {
 }
 
+FieldCache::~FieldCache() = default;
+
 FieldCache::FieldCache(const ResultClass &resClass,
                        const DocumentType &docType) :
-    _cache()
+    _cache(),
+    _fieldSet()
 {
+    auto fieldSet = std::make_unique<FieldCollection>(docType);
     LOG(debug, "Creating field cache for summary class '%s'", resClass.GetClassName());
     for (uint32_t i = 0; i < resClass.GetNumEntries(); ++i) {
         const ResConfigEntry *entry = resClass.GetEntry(i);
@@ -28,10 +34,12 @@ FieldCache::FieldCache(const ResultClass &resClass,
             LOG(debug, "Caching Field instance for field '%s': %s.%u",
                 fieldName.c_str(), field.getName().c_str(), field.getId());
             _cache.push_back(Field::CSP(new Field(field)));
+            fieldSet->insert(*_cache.back());
         } else {
             _cache.push_back(Field::CSP());
         }
     }
+    _fieldSet = std::move(fieldSet);
 }
 
 } // namespace proton
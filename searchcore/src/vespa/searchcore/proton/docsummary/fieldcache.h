@@ -17,12 +17,14 @@ class FieldCache
 private:
     typedef std::vector<document::Field::CSP> Cache;
 
-    Cache _cache;
+    Cache                      _cache;
+    document::FieldSet::UP     _fieldSet;
 
 public:
     typedef std::shared_ptr<const FieldCache> CSP;
 
     FieldCache();
+    ~FieldCache();
 
     FieldCache(const search::docsummary::ResultClass &resClass,
                const document::DocumentType &docType);
@@ -32,6 +34,12 @@ public:
     const document::Field *getField(size_t idx) const {
         return _cache[idx].get();
     }
+
+    /**
+     * The document fields used by the summary result class. Reading only these
+     * avoids deserializing fields that are not part of the summary.
+     **/
+    const document::FieldSet &getFieldSet() const { return *_fieldSet; }
 };
 
 } // namespace proton
@@ -1,5 +1,6 @@
 // Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
+#include "docsum_blob_store.h"
 #include "documentstoreadapter.h"
 #include "summarycompacttarget.h"
 #include "summaryflushtarget.h"
@@ -11,6 +12,7 @@
 #include <vespa/searchcore/proton/flushengine/shrink_lid_space_flush_target.h>
 #include <vespa/vespalib/util/lambdatask.h>
 #include <vespa/searchsummary/docsummary/docsumconfig.h>
+#include <vespa/vespalib/objects/nbostream.h>
 #include <vespa/vespalib/util/exceptions.h>
 #include <sstream>
 
@@ -82,7 +84,8 @@ SummaryManager::SummarySetup::
 SummarySetup(const vespalib::string & baseDir, const DocTypeName & docTypeName, const SummaryConfig & summaryCfg,
              const SummarymapConfig & summarymapCfg, const JuniperrcConfig & juniperCfg,
              const search::IAttributeManager::SP &attributeMgr, const search::IDocumentStore::SP & docStore,
-             const std::shared_ptr<const DocumentTypeRepo> &repo)
+             const std::shared_ptr<const DocumentTypeRepo> &repo,
+             const std::shared_ptr<DocsumBlobStore> &blobStore, uint64_t generation)
     : _docsumWriter(),
       _wordFolder(),
       _juniperProps(juniperCfg),
@@ -91,7 +94,11 @@ SummarySetup(const vespalib::string & baseDir, const DocTypeName & docTypeName,
       _docStore(docStore),
       _fieldCacheRepo(),
       _repo(repo),
-      _markupFields()
+      _markupFields(),
+      _blobStore(blobStore),
+      _generation(generation),
+      _packLock(),
+      _packer()
 {
     std::unique_ptr<ResultConfig> resultConfig(new ResultConfig());
     if (!resultConfig->ReadConfig(summaryCfg, make_string("SummaryManager(%s)", baseDir.c_str()).c_str())) {
@@ -128,12 +135,39 @@ SummarySetup(const vespalib::string & baseDir, const DocTypeName & docTypeName,
                                                    " Cannot setup field cache repo for the summary setup",
                                                    docTypeName.toString().c_str()));
     }
+    const ResultClass *defaultClass = getResultConfig().LookupResultClass(getResultConfig().LookupResultClassId(""));
+    if (_blobStore && (defaultClass != nullptr)) {
+        vespalib::string className(defaultClass->GetClassName());
+        _packer = std::make_unique<DocumentStoreAdapter>(*_docStore, *_repo, getResultConfig(), className,
+                                                         _fieldCacheRepo->getFieldCache(className), _markupFields);
+    }
 }
 
+SummaryManager::SummarySetup::~SummarySetup() {}
+
 IDocsumStore::UP
 SummaryManager::SummarySetup::createDocsumStore(const vespalib::string &resultClassName) {
     return std::make_unique<DocumentStoreAdapter>(*_docStore, *_repo, getResultConfig(), resultClassName,
-                                                  _fieldCacheRepo->getFieldCache(resultClassName), _markupFields);
+                                                  _fieldCacheRepo->getFieldCache(resultClassName), _markupFields,
+                                                  _blobStore.get(), _generation);
+}
+
+void
+SummaryManager::SummarySetup::packDocsum(search::DocumentIdT lid, const Document & doc)
+{
+    if (!_packer) {
+        if (_blobStore) {
+            _blobStore->remove(lid);
+        }
+        return;
+    }
+    std::lock_guard<std::mutex> guard(_packLock);
+    DocsumStoreValue value = _packer->packDocsum(doc, lid);
+    if (value.pt() != nullptr) {
+        _blobStore->put(lid, _generation, _packer->getSummaryClassId(), value.pt(), value.len());
+    } else {
+        _blobStore->remove(lid);
+    }
 }
 
 
@@ -142,8 +176,18 @@ SummaryManager::createSummarySetup(const SummaryConfig & summaryCfg, const Summa
                                    const JuniperrcConfig & juniperCfg, const std::shared_ptr<const DocumentTypeRepo> &repo,
                                    const search::IAttributeManager::SP &attributeMgr)
 {
-    return std::make_shared<SummarySetup>(_baseDir, _docTypeName, summaryCfg, summarymapCfg,
-                                          juniperCfg, attributeMgr, _docStore, repo);
+    if (!_blobStore) {
+        return std::make_shared<SummarySetup>(_baseDir, _docTypeName, summaryCfg, summarymapCfg,
+                                              juniperCfg, attributeMgr, _docStore, repo);
+    }
+    std::lock_guard<std::mutex> guard(_setupLock);
+    auto setup = std::make_shared<SummarySetup>(_baseDir, _docTypeName, summaryCfg, summarymapCfg,
+                                                juniperCfg, attributeMgr, _docStore, repo,
+                                                _blobStore, ++_setupGeneration);
+    // Blobs packed with the previous setup are never used by the new one.
+    _blobStore->clear();
+    _packSetup = setup;
+    return setup;
 }
 
 SummaryManager::SummaryManager(vespalib::ThreadExecutor & executor, const LogDocumentStore::Config & storeConfig,
@@ -155,7 +199,11 @@ SummaryManager::SummaryManager(vespalib::ThreadExecutor & executor, const LogDoc
       _docTypeName(docTypeName),
       _docStore(),
       _tuneFileSummary(tuneFileSummary),
-      _currentSerial(0u)
+      _currentSerial(0u),
+      _blobStore(),
+      _setupLock(),
+      _packSetup(),
+      _setupGeneration(0u)
 {
     _docStore = std::make_shared<LogDocumentStore>(executor, baseDir, storeConfig, growStrategy, tuneFileSummary,
                                                    fileHeaderContext, tlSyncer, bucketizer);
@@ -163,10 +211,55 @@ SummaryManager::SummaryManager(vespalib::ThreadExecutor & executor, const LogDoc
 
 SummaryManager::~SummaryManager() {}
 
+void
+SummaryManager::enableDocsumBlobs(size_t maxBytes)
+{
+    _blobStore = std::make_shared<DocsumBlobStore>(maxBytes);
+}
+
+std::shared_ptr<SummaryManager::SummarySetup>
+SummaryManager::getPackSetup()
+{
+    std::lock_guard<std::mutex> guard(_setupLock);
+    return _packSetup;
+}
+
+void
+SummaryManager::packDocsum(search::DocumentIdT lid, const Document & doc)
+{
+    std::shared_ptr<SummarySetup> setup = getPackSetup();
+    if (setup) {
+        setup->packDocsum(lid, doc);
+    } else {
+        _blobStore->remove(lid);
+    }
+}
+
+void
+SummaryManager::packDocsum(search::DocumentIdT lid, const vespalib::nbostream & doc)
+{
+    std::shared_ptr<SummarySetup> setup = getPackSetup();
+    if (!setup) {
+        _blobStore->remove(lid);
+        return;
+    }
+    try {
+        vespalib::nbostream stream(doc.peek(), doc.size());
+        Document document(*setup->getRepo(), stream);
+        setup->packDocsum(lid, document);
+    } catch (const vespalib::Exception & e) {
+        LOG(warning, "Could not pack docsum for lid %u: %s", lid, e.what());
+        _blobStore->remove(lid);
+    }
+}
+
 void
 SummaryManager::putDocument(uint64_t syncToken, search::DocumentIdT lid, const Document & doc)
 {
     _docStore->write(syncToken, lid, doc);
+    if (_blobStore) {
+        packDocsum(lid, doc);
+    }
     _currentSerial = syncToken;
 }
 
@@ -174,13 +267,43 @@ void
 SummaryManager::putDocument(uint64_t syncToken, search::DocumentIdT lid, const vespalib::nbostream & doc)
 {
     _docStore->write(syncToken, lid, doc);
+    if (_blobStore) {
+        packDocsum(lid, doc);
+    }
+    _currentSerial = syncToken;
+}
+
+void
+SummaryManager::putDocument(uint64_t syncToken, search::DocumentIdT lid, const Document & doc,
+                            const vespalib::nbostream & serializedDoc)
+{
+    _docStore->write(syncToken, lid, serializedDoc);
+    if (_blobStore) {
+        packDocsum(lid, doc);
+    }
     _currentSerial = syncToken;
 }
 
+bool
+SummaryManager::updateDocument(uint64_t syncToken, search::DocumentIdT lid, const document::DocumentUpdate & upd,
+                               const std::shared_ptr<const document::DocumentTypeRepo> & repo,
+                               const vespalib::nbostream & updatedDoc)
+{
+    // The packed docsum needs the complete updated document.
+    if (_blobStore || ! _docStore->writeUpdate(syncToken, lid, upd, repo, updatedDoc)) {
+        return false;
+    }
+    _currentSerial = syncToken;
+    return true;
+}
+
 void
 SummaryManager::removeDocument(uint64_t syncToken, search::DocumentIdT lid)
 {
     _docStore->remove(syncToken, lid);
+    if (_blobStore) {
+        _blobStore->remove(lid);
+    }
     _currentSerial = syncToken;
 }
 
@@ -12,6 +12,7 @@
 #include <vespa/document/fieldvalue/document.h>
 #include <vespa/vespalib/util/threadstackexecutor.h>
 #include <vespa/fastlib/text/normwordfolder.h>
+#include <mutex>
 
 namespace searchcorespi::index { class IThreadService; }
 namespace search { class IBucketizer; }
@@ -19,6 +20,9 @@ namespace search::common { class FileHeaderContext; }
 
 namespace proton {
 
+class DocsumBlobStore;
+class DocumentStoreAdapter;
+
 class SummaryManager : public ISummaryManager
 {
 public:
@@ -33,6 +37,10 @@ public:
         FieldCacheRepo::UP                    _fieldCacheRepo;
         const std::shared_ptr<const document::DocumentTypeRepo>  _repo;
         std::set<vespalib::string>            _markupFields;
+        std::shared_ptr<DocsumBlobStore>      _blobStore;
+        const uint64_t                        _generation;
+        std::mutex                            _packLock;
+        std::unique_ptr<DocumentStoreAdapter> _packer;
     public:
         SummarySetup(const vespalib::string & baseDir,
                      const DocTypeName & docTypeName,
@@ -41,7 +49,10 @@ public:
                      const vespa::config::search::summary::JuniperrcConfig & juniperCfg,
                      const search::IAttributeManager::SP &attributeMgr,
                      const search::IDocumentStore::SP & docStore,
-                     const std::shared_ptr<const document::DocumentTypeRepo> &repo);
+                     const std::shared_ptr<const document::DocumentTypeRepo> &repo,
+                     const std::shared_ptr<DocsumBlobStore> &blobStore = std::shared_ptr<DocsumBlobStore>(),
+                     uint64_t generation = 0);
+        ~SummarySetup();
 
         search::docsummary::IDocsumWriter & getDocsumWriter() const override { return *_docsumWriter; }
         search::docsummary::ResultConfig & getResultConfig() override { return *_docsumWriter->GetResultConfig(); }
@@ -51,6 +62,14 @@ public:
         search::IAttributeManager * getAttributeManager() override { return _attributeMgr.get(); }
         vespalib::string lookupIndex(const vespalib::string & s) const override { (void) s; return ""; }
         juniper::Juniper * getJuniper() override { return _juniperConfig.get(); }
+
+        const std::shared_ptr<const document::DocumentTypeRepo> & getRepo() const { return _repo; }
+
+        /**
+         * Pack the docsum of the default result class for the given
+         * document and store it in the docsum blob store, if any.
+         */
+        void packDocsum(search::DocumentIdT lid, const document::Document & doc);
     };
 
 private:
@@ -59,6 +78,14 @@ private:
     std::shared_ptr<search::IDocumentStore> _docStore;
     const search::TuneFileSummary  _tuneFileSummary;
     uint64_t                       _currentSerial;
+    std::shared_ptr<DocsumBlobStore> _blobStore;
+    std::mutex                     _setupLock;
+    std::shared_ptr<SummarySetup>  _packSetup;
+    uint64_t                       _setupGeneration;
+
+    std::shared_ptr<SummarySetup> getPackSetup();
+    void packDocsum(search::DocumentIdT lid, const document::Document & doc);
+    void packDocsum(search::DocumentIdT lid, const vespalib::nbostream & doc);
 
 public:
     typedef std::shared_ptr<SummaryManager> SP;
@@ -75,6 +102,20 @@ public:
 
     void putDocument(uint64_t syncToken, search::DocumentIdT lid, const document::Document & doc);
     void putDocument(uint64_t syncToken, search::DocumentIdT lid, const vespalib::nbostream & doc);
+    /**
+     * Put a document that is already serialized. The serialized form is written to
+     * the document store, and the document is used for packing the docsum.
+     */
+    void putDocument(uint64_t syncToken, search::DocumentIdT lid, const document::Document & doc,
+                     const vespalib::nbostream & serializedDoc);
+    /**
+     * Store an update of an existing document as a delta in the document store, together
+     * with the serialized updated document for readers.
+     * Returns false if the delta is not kept, and the updated document must be put instead.
+     */
+    bool updateDocument(uint64_t syncToken, search::DocumentIdT lid, const document::DocumentUpdate & upd,
+                        const std::shared_ptr<const document::DocumentTypeRepo> & repo,
+                        const vespalib::nbostream & updatedDoc);
     void removeDocument(uint64_t syncToken, search::DocumentIdT lid);
     searchcorespi::IFlushTarget::List getFlushTargets(searchcorespi::index::IThreadService & summaryService);
 
@@ -87,6 +128,16 @@ public:
 
     search::IDocumentStore & getBackingStore() override { return *_docStore; }
     void reconfigure(const search::LogDocumentStore::Config & config);
+
+    /**
+     * Keep docsums of the default result class packed in memory, up to
+     * the given number of bytes, as documents are fed. Docsum stores
+     * created by later summary setups serve docsums from these blobs
+     * instead of reading and converting the stored documents. Must be
+     * called before feeding starts.
+     */
+    void enableDocsumBlobs(size_t maxBytes);
+    const DocsumBlobStore * getDocsumBlobStore() const { return _blobStore.get(); }
 };
 
 } // namespace proton
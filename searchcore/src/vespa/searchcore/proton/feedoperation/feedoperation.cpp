@@ -6,7 +6,8 @@ namespace proton {
 
 FeedOperation::FeedOperation(Type type)
     : _type(type),
-      _serialNum(0)
+      _serialNum(0),
+      _latencyTracker()
 {
 }
 
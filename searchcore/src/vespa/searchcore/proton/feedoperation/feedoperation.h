@@ -3,11 +3,14 @@
 
 #include <vespa/searchlib/common/serialnum.h>
 #include <vespa/vespalib/stllike/string.h>
+#include <memory>
 
 namespace document { class DocumentTypeRepo; }
 namespace vespalib { class nbostream; }
 namespace proton {
 
+class FeedLatencyTracker;
+
 class FeedOperation
 {
 public:
@@ -44,6 +47,7 @@ public:
 private:
     Type _type;
     SerialNum _serialNum;
+    std::shared_ptr<FeedLatencyTracker> _latencyTracker;
 
 public:
     FeedOperation(Type type);
@@ -51,6 +55,11 @@ public:
     Type getType() const { return _type; }
     void setSerialNum(SerialNum serialNum) { _serialNum = serialNum; }
     SerialNum getSerialNum() const { return _serialNum; }
+    /**
+     * Tracks the latency of each stage of this operation when it is fed. Not serialized.
+     */
+    void setLatencyTracker(std::shared_ptr<FeedLatencyTracker> latencyTracker) { _latencyTracker = std::move(latencyTracker); }
+    const std::shared_ptr<FeedLatencyTracker> &getLatencyTracker() const { return _latencyTracker; }
     virtual void serialize(vespalib::nbostream &os) const = 0;
     virtual void deserialize(vespalib::nbostream &is, const document::DocumentTypeRepo &repo) = 0;
     virtual vespalib::string toString() const = 0;
@@ -2,6 +2,7 @@
 
 #include "putoperation.h"
 #include <vespa/document/fieldvalue/document.h>
+#include <vespa/vespalib/objects/nbostream.h>
 
 using document::BucketId;
 using document::Document;
@@ -13,7 +14,8 @@ namespace proton {
 
 PutOperation::PutOperation()
     : DocumentOperation(FeedOperation::PUT),
-      _doc()
+      _doc(),
+      _serializedDoc()
 { }
 
 
@@ -23,19 +25,31 @@ PutOperation::PutOperation(const BucketId &bucketId,
     : DocumentOperation(FeedOperation::PUT,
                         bucketId,
                         timestamp),
-      _doc(doc)
+      _doc(doc),
+      _serializedDoc()
 { }
 
 PutOperation::~PutOperation() { }
 
+const PutOperation::SerializedDocumentSP &
+PutOperation::serializeDocument() const
+{
+    if ( ! _serializedDoc) {
+        auto stream = std::make_shared<vespalib::nbostream>();
+        _doc->serialize(*stream);
+        _serializedDoc = std::move(stream);
+    }
+    return _serializedDoc;
+}
+
 void
 PutOperation::serialize(vespalib::nbostream &os) const
 {
     assertValidBucketId(_doc->getId());
     DocumentOperation::serialize(os);
-    size_t oldSize = os.size();
-    _doc->serialize(os);
-    _serializedDocSize = os.size() - oldSize;
+    const vespalib::nbostream &doc = *serializeDocument();
+    os.write(doc.peek(), doc.size());
+    _serializedDocSize = doc.size();
 }
 
 
@@ -45,16 +59,22 @@ PutOperation::deserialize(vespalib::nbostream &is,
 {
     DocumentOperation::deserialize(is, repo);
     size_t oldSize = is.size();
+    const char *start = is.peek();
     _doc.reset(new Document(repo, is));
     _serializedDocSize = oldSize - is.size();
+    auto stream = std::make_shared<vespalib::nbostream>(_serializedDocSize);
+    stream->write(start, _serializedDocSize);
+    _serializedDoc = std::move(stream);
 }
 
 void
 PutOperation::deserializeDocument(const DocumentTypeRepo &repo)
 {
-    vespalib::nbostream stream;
-    _doc->serialize(stream);
-    auto fixedDoc = std::make_shared<Document>(repo, stream);
+    // The serialized document is kept, it is also what is written to the transaction log.
+    _serializedDoc.reset();
+    const vespalib::nbostream &stream = *serializeDocument();
+    vespalib::nbostream_longlivedbuf is(stream.peek(), stream.size());
+    auto fixedDoc = std::make_shared<Document>(repo, is);
     _doc = std::move(fixedDoc);
 }
 
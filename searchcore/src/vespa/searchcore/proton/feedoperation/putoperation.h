@@ -7,8 +7,13 @@ namespace proton {
 
 class PutOperation : public DocumentOperation
 {
+public:
+    using SerializedDocumentSP = std::shared_ptr<const vespalib::nbostream>;
+private:
     using DocumentSP = std::shared_ptr<document::Document>;
     DocumentSP _doc;
+    // The document serialized once, shared by the transaction log entry and the document store.
+    mutable SerializedDocumentSP _serializedDoc;
 
 public:
     PutOperation();
@@ -17,6 +22,16 @@ public:
                  const DocumentSP &doc);
     virtual ~PutOperation();
     const DocumentSP &getDocument() const { return _doc; }
+    /**
+     * The serialized document if the operation has been serialized or
+     * deserialized, otherwise empty.
+     */
+    const SerializedDocumentSP &getSerializedDocument() const { return _serializedDoc; }
+    /**
+     * Serialize the document unless already done, allowing it to be done
+     * ahead of serializing the operation.
+     */
+    const SerializedDocumentSP &serializeDocument() const;
     void assertValid() const;
     virtual void serialize(vespalib::nbostream &os) const override;
     virtual void deserialize(vespalib::nbostream &is,
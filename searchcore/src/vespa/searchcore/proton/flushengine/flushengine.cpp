@@ -62,10 +62,13 @@ FlushEngine::FlushInfo::FlushInfo(uint32_t taskId,
 FlushEngine::FlushEngine(std::shared_ptr<flushengine::ITlsStatsFactory>
                          tlsStatsFactory,
                          IFlushStrategy::SP strategy, uint32_t numThreads,
-                         uint32_t idleIntervalMS)
+                         uint32_t idleIntervalMS,
+                         uint32_t checkpointIntervalMS)
     : _closed(false),
       _maxConcurrent(numThreads),
       _idleIntervalMS(idleIntervalMS),
+      _checkpointIntervalMS(checkpointIntervalMS),
+      _lastCheckpoint(fastos::ClockSystem::now()),
       _taskId(0),
       _threadPool(128 * 1024),
       _strategy(strategy),
@@ -154,11 +157,15 @@ FlushEngine::Run(FastOS_ThreadInterface *thread, void *arg)
     (void)arg;
     bool shouldIdle = false;
     vespalib::string prevFlushName;
-    while (wait(shouldIdle ? _idleIntervalMS : 0)) {
+    while (wait(shouldIdle ? getIdleWaitMS() : 0)) {
         shouldIdle = false;
         if (prune()) {
             continue; // Prune attempted on one or more handlers
         }
+        if (checkpointDue()) {
+            checkpoint();
+            continue;
+        }
         prevFlushName = flushNextTarget(prevFlushName);
         if ( ! prevFlushName.empty()) {
             // Sleep at least 10 ms after a successful flush in order to avoid busy loop in case
@@ -167,7 +174,7 @@ FlushEngine::Run(FastOS_ThreadInterface *thread, void *arg)
         } else {
             shouldIdle = true;
         }
-        LOG(debug, "Making another wait(idle=%s, timeMS=%d) last was '%s'", shouldIdle ? "true" : "false", shouldIdle ? _idleIntervalMS : 0, prevFlushName.c_str());
+        LOG(debug, "Making another wait(idle=%s, timeMS=%d) last was '%s'", shouldIdle ? "true" : "false", shouldIdle ? getIdleWaitMS() : 0, prevFlushName.c_str());
     }
     _executor.sync();
     prune();
@@ -292,6 +299,43 @@ FlushEngine::flushAll(const FlushContext::List &lst)
     }
 }
 
+uint32_t
+FlushEngine::getIdleWaitMS() const
+{
+    if (_checkpointIntervalMS == 0) {
+        return _idleIntervalMS;
+    }
+    int64_t sinceCheckpointMS = (fastos::TimeStamp(fastos::ClockSystem::now()) - _lastCheckpoint).ms();
+    int64_t untilCheckpointMS = std::max(int64_t(_checkpointIntervalMS) - sinceCheckpointMS, int64_t(1));
+    return std::min(int64_t(_idleIntervalMS), untilCheckpointMS);
+}
+
+bool
+FlushEngine::checkpointDue() const
+{
+    return (_checkpointIntervalMS != 0) &&
+           ((fastos::TimeStamp(fastos::ClockSystem::now()) - _lastCheckpoint).ms() >= _checkpointIntervalMS);
+}
+
+void
+FlushEngine::checkpoint()
+{
+    fastos::TimeStamp start(fastos::ClockSystem::now());
+    // All targets are flushed in one round, oldest first, and the handlers are
+    // pruned afterwards so the transaction log only needs to be replayed from
+    // the serial number where the round started.
+    FlushContext::List lst = getTargetList(false);
+    {
+        flushengine::TlsStatsMap tlsStatsMap(_tlsStatsFactory->create());
+        lst = FlushAllStrategy().getFlushTargets(lst, tlsStatsMap);
+    }
+    flushAll(lst);
+    _executor.sync();
+    prune();
+    _lastCheckpoint = fastos::ClockSystem::now();
+    LOG(debug, "Checkpoint of %zu targets took %f secs", lst.size(), (_lastCheckpoint - start).sec());
+}
+
 vespalib::string
 FlushEngine::flushNextTarget(const vespalib::string & name)
 {
@@ -49,6 +49,8 @@ private:
     bool                           _closed;
     const uint32_t                 _maxConcurrent;
     const uint32_t                 _idleIntervalMS;
+    const uint32_t                 _checkpointIntervalMS;
+    fastos::TimeStamp              _lastCheckpoint;
     uint32_t                       _taskId;    
     FastOS_ThreadPool              _threadPool;
     IFlushStrategy::SP             _strategy;
@@ -69,6 +71,8 @@ private:
     FlushContext::SP initNextFlush(const FlushContext::List &lst);
     vespalib::string flushNextTarget(const vespalib::string & name);
     void flushAll(const FlushContext::List &lst);
+    uint32_t getIdleWaitMS() const;
+    bool checkpointDue() const;
     bool prune();
     uint32_t initFlush(const FlushContext &ctx);
     uint32_t initFlush(const IFlushHandler::SP &handler, const IFlushTarget::SP &target);
@@ -95,10 +99,13 @@ public:
      * @param strategy   The flushing strategy to use.
      * @param numThreads The number of worker threads to use.
      * @param idleInterval The interval between when flushes are checked whne there are no one progressing.
+     * @param checkpointIntervalMS The interval between checkpoints, where all targets are
+     *                             flushed together, or 0 to disable checkpoints.
      */
     FlushEngine(std::shared_ptr<flushengine::ITlsStatsFactory>
                 tlsStatsFactory,
-                IFlushStrategy::SP strategy, uint32_t numThreads, uint32_t idleIntervalMS);
+                IFlushStrategy::SP strategy, uint32_t numThreads, uint32_t idleIntervalMS,
+                uint32_t checkpointIntervalMS = 0);
 
     /**
      * Destructor. Waits for all pending tasks to complete.
@@ -134,6 +141,14 @@ public:
      */
     void triggerFlush();
 
+    /**
+     * Flushes all flush targets in one round and prunes the handlers
+     * afterwards. This is called by the scheduling thread when a checkpoint
+     * is due, and must only be called elsewhere while that thread is not
+     * running.
+     */
+    void checkpoint();
+
     void kick();
 
     /**
@@ -0,0 +1,39 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "cache_metrics.h"
+#include <vespa/searchlib/docstore/cachestats.h>
+
+namespace proton {
+
+CacheMetrics::CacheMetrics(metrics::MetricSet *parent, const vespalib::string &name,
+                           const vespalib::string &description)
+    : metrics::MetricSet(name, "", description, parent),
+      _memoryUsage("memory_usage", "", "Memory usage of the cache (in bytes)", this),
+      _elements("elements", "", "Number of elements in the cache", this),
+      _hitRate("hit_rate", "", "Rate of hits in the cache compared to number of lookups", this),
+      _lookups("lookups", "", "Number of lookups in the cache (hits + misses)", this),
+      _admissionRejects("admission_rejects", "",
+                        "Number of elements not inserted into the cache because they were less frequently "
+                        "used than the element they would have evicted", this)
+{
+}
+
+CacheMetrics::~CacheMetrics() {}
+
+void
+CacheMetrics::update(const search::CacheStats &current, const search::CacheStats &last)
+{
+    _memoryUsage.set(current.memory_used);
+    _elements.set(current.elements);
+    size_t lookups = current.hits + current.misses;
+    size_t lastLookups = last.hits + last.misses;
+    if ((lookups >= lastLookups) && (current.hits >= last.hits)) {
+        _hitRate.addTotalValueWithCount(current.hits - last.hits, lookups - lastLookups);
+        _lookups.inc(lookups - lastLookups);
+    }
+    if (current.admission_rejects >= last.admission_rejects) {
+        _admissionRejects.inc(current.admission_rejects - last.admission_rejects);
+    }
+}
+
+}
@@ -0,0 +1,35 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/metrics/metrics.h>
+#include <vespa/vespalib/stllike/string.h>
+
+namespace search { struct CacheStats; }
+
+namespace proton {
+
+/**
+ * Metric set for cache usage and efficiency metrics.
+ */
+class CacheMetrics : public metrics::MetricSet
+{
+private:
+    metrics::LongValueMetric   _memoryUsage;
+    metrics::LongValueMetric   _elements;
+    metrics::LongAverageMetric _hitRate;
+    metrics::LongCountMetric   _lookups;
+    metrics::LongCountMetric   _admissionRejects;
+
+public:
+    CacheMetrics(metrics::MetricSet *parent, const vespalib::string &name = "cache",
+                 const vespalib::string &description = "Cache metrics");
+    ~CacheMetrics();
+    /**
+     * Update with the current cumulative stats. The counts and rates are
+     * computed as the change since the last stats.
+     */
+    void update(const search::CacheStats &current, const search::CacheStats &last);
+};
+
+} // namespace proton
@@ -0,0 +1,27 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "commit_metrics.h"
+#include "commit_stats.h"
+
+namespace proton {
+
+CommitMetrics::CommitMetrics(metrics::MetricSet *parent)
+    : metrics::MetricSet("commit", "", "Commits making fed documents visible", parent),
+      _commits("commits", "", "Number of commits done", this),
+      _visibilityDelay("visibility_delay", "", "Time from the first operation in a commit was fed until the commit (in seconds)", this)
+{
+}
+
+CommitMetrics::~CommitMetrics() {}
+
+void
+CommitMetrics::update(const CommitStats &stats)
+{
+    _commits.inc(stats.commits());
+    const CommitStats::Latency &delay = stats.visibilityDelay();
+    if (delay.count() > 0) {
+        _visibilityDelay.addValueBatch(delay.avg(), delay.count(), delay.min(), delay.max());
+    }
+}
+
+} // namespace proton
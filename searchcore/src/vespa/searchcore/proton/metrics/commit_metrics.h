@@ -0,0 +1,29 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/metrics/metrics.h>
+
+namespace proton {
+
+class CommitStats;
+
+/**
+ * Metric set for the commits making fed documents visible in a document db.
+ */
+class CommitMetrics : public metrics::MetricSet
+{
+private:
+    metrics::LongCountMetric     _commits;
+    metrics::DoubleAverageMetric _visibilityDelay;
+
+public:
+    CommitMetrics(metrics::MetricSet *parent);
+    ~CommitMetrics();
+    /**
+     * Update with the stats collected since the last update.
+     */
+    void update(const CommitStats &stats);
+};
+
+} // namespace proton
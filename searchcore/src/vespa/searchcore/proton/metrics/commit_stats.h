@@ -0,0 +1,34 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include <vespa/searchlib/common/latency_stats.h>
+
+namespace proton {
+
+/**
+ * Commits done to make fed documents visible in a document db, and the
+ * visibility delay achieved in seconds, i.e. the time from the first
+ * operation included in a commit was fed until the commit.
+ */
+class CommitStats
+{
+public:
+    using Latency = search::LatencyStats;
+
+    CommitStats() : _commits(0), _visibilityDelay() {}
+    CommitStats & operator += (const CommitStats &rhs) {
+        _commits += rhs._commits;
+        _visibilityDelay.add(rhs._visibilityDelay);
+        return *this;
+    }
+
+    size_t commits() const { return _commits; }
+    void addCommit() { ++_commits; }
+    Latency & visibilityDelay() { return _visibilityDelay; }
+    const Latency & visibilityDelay() const { return _visibilityDelay; }
+private:
+    size_t  _commits;
+    Latency _visibilityDelay;
+};
+
+} // namespace proton
@@ -0,0 +1,42 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "document_store_write_metrics.h"
+#include <vespa/searchlib/docstore/data_store_write_stats.h>
+
+namespace proton {
+
+namespace {
+
+void
+addLatency(metrics::DoubleAverageMetric &metric, const search::LatencyStats &latency)
+{
+    if (latency.count() > 0) {
+        metric.addValueBatch(latency.avg(), latency.count(), latency.min(), latency.max());
+    }
+}
+
+}
+
+DocumentStoreWriteMetrics::DocumentStoreWriteMetrics(metrics::MetricSet *parent)
+    : metrics::MetricSet("write", "", "Document store write path metrics", parent),
+      _compressLatency("compress_latency", "", "Time used to compress a chunk (in seconds)", this),
+      _writeLatency("write_latency", "", "Time used to write a batch of compressed chunks to disk (in seconds)", this),
+      _syncLatency("sync_latency", "", "Time used to sync written chunks and their index to disk (in seconds)", this),
+      _syncRequests("sync_requests", "", "Number of requests to sync written chunks to disk", this),
+      _syncs("syncs", "", "Number of syncs done. Concurrent sync requests are coalesced", this)
+{
+}
+
+DocumentStoreWriteMetrics::~DocumentStoreWriteMetrics() {}
+
+void
+DocumentStoreWriteMetrics::update(const search::DataStoreWriteStats &stats)
+{
+    addLatency(_compressLatency, stats.compress());
+    addLatency(_writeLatency, stats.write());
+    addLatency(_syncLatency, stats.sync());
+    _syncRequests.inc(stats.syncRequests());
+    _syncs.inc(stats.sync().count());
+}
+
+} // namespace proton
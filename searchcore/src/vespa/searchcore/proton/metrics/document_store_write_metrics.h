@@ -0,0 +1,35 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/metrics/metrics.h>
+
+namespace search { class DataStoreWriteStats; }
+
+namespace proton {
+
+/**
+ * Metric set for the latencies of the document store write path:
+ * chunk compression, chunk write and sync. Sync requests are counted
+ * separately from actual syncs, so the ratio shows how well concurrent
+ * flushes share a sync.
+ */
+class DocumentStoreWriteMetrics : public metrics::MetricSet
+{
+private:
+    metrics::DoubleAverageMetric _compressLatency;
+    metrics::DoubleAverageMetric _writeLatency;
+    metrics::DoubleAverageMetric _syncLatency;
+    metrics::LongCountMetric     _syncRequests;
+    metrics::LongCountMetric     _syncs;
+
+public:
+    DocumentStoreWriteMetrics(metrics::MetricSet *parent);
+    ~DocumentStoreWriteMetrics();
+    /**
+     * Update with the stats collected since the last update.
+     */
+    void update(const search::DataStoreWriteStats &stats);
+};
+
+} // namespace proton
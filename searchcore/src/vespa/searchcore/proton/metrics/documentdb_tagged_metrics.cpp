@@ -56,7 +56,10 @@ DocumentDBTaggedMetrics::SubDBMetrics::DocumentStoreMetrics::DocumentStoreMetric
       diskUsage("disk_usage", "", "Disk space usage in bytes", this),
       diskBloat("disk_bloat", "", "Disk space bloat in bytes", this),
       maxBucketSpread("max_bucket_spread", "", "Max bucket spread in underlying files (sum(unique buckets in each chunk)/unique buckets in file)", this),
-      memoryUsage(this)
+      memoryUsage(this),
+      cache(this),
+      hotStore(this, "hot_store", "Metrics for the in memory hot tier pinning frequently read documents"),
+      write(this)
 { }
 
 DocumentDBTaggedMetrics::SubDBMetrics::DocumentStoreMetrics::~DocumentStoreMetrics() { }
@@ -202,7 +205,9 @@ DocumentDBTaggedMetrics::DocumentDBTaggedMetrics(const vespalib::string &docType
       notReady("notready", this),
       removed("removed", this),
       threadingService("threading_service", this),
-      matching(this)
+      matching(this),
+      feeding(this),
+      commit(this)
 { }
 
 DocumentDBTaggedMetrics::~DocumentDBTaggedMetrics() { }
@@ -2,6 +2,10 @@
 #pragma once
 
 #include "attribute_metrics.h"
+#include "cache_metrics.h"
+#include "commit_metrics.h"
+#include "document_store_write_metrics.h"
+#include "feed_latency_metrics.h"
 #include "memory_usage_metrics.h"
 #include "executor_threading_service_metrics.h"
 #include <vespa/metrics/metricset.h>
@@ -53,6 +57,9 @@ struct DocumentDBTaggedMetrics : metrics::MetricSet
             metrics::LongValueMetric diskBloat;
             metrics::DoubleValueMetric maxBucketSpread;
             MemoryUsageMetrics memoryUsage;
+            CacheMetrics cache;
+            CacheMetrics hotStore;
+            DocumentStoreWriteMetrics write;
 
             DocumentStoreMetrics(metrics::MetricSet *parent);
             ~DocumentStoreMetrics();
@@ -153,6 +160,8 @@ struct DocumentDBTaggedMetrics : metrics::MetricSet
     SubDBMetrics removed;
     ExecutorThreadingServiceMetrics threadingService;
     MatchingMetrics matching;
+    FeedLatencyMetrics feeding;
+    CommitMetrics commit;
 
     DocumentDBTaggedMetrics(const vespalib::string &docTypeName);
     ~DocumentDBTaggedMetrics();
@@ -0,0 +1,46 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "feed_latency_metrics.h"
+#include "feed_latency_stats.h"
+
+namespace proton {
+
+namespace {
+
+void
+addLatency(metrics::DoubleAverageMetric &metric, const FeedLatencyStats::Latency &latency)
+{
+    if (latency.count() > 0) {
+        metric.addValueBatch(latency.avg(), latency.count(), latency.min(), latency.max());
+    }
+}
+
+}
+
+FeedLatencyMetrics::FeedLatencyMetrics(metrics::MetricSet *parent)
+    : metrics::MetricSet("feeding", "", "Latencies of the stages feed operations pass through", parent),
+      _queueLatency("queue_latency", "", "Time from an operation is received until the master write thread starts on it (in seconds)", this),
+      _masterLatency("master_latency", "", "Time the master write thread uses to handle an operation (in seconds)", this),
+      _tlsLatency("tls_latency", "", "Time from an operation is appended to the transaction log until it is acked (in seconds)", this),
+      _attributeLatency("attribute_latency", "", "Time used to apply an operation to the attribute vectors (in seconds)", this),
+      _indexLatency("index_latency", "", "Time used to apply an operation to the memory index (in seconds)", this),
+      _summaryLatency("summary_latency", "", "Time used to write an operation to the document store (in seconds)", this),
+      _totalLatency("total_latency", "", "Time from an operation is received until all its stages are done (in seconds)", this)
+{
+}
+
+FeedLatencyMetrics::~FeedLatencyMetrics() {}
+
+void
+FeedLatencyMetrics::update(const FeedLatencyStats &stats)
+{
+    addLatency(_queueLatency, stats.get(FeedLatencyStats::QUEUE));
+    addLatency(_masterLatency, stats.get(FeedLatencyStats::MASTER));
+    addLatency(_tlsLatency, stats.get(FeedLatencyStats::TLS));
+    addLatency(_attributeLatency, stats.get(FeedLatencyStats::ATTRIBUTE));
+    addLatency(_indexLatency, stats.get(FeedLatencyStats::INDEX));
+    addLatency(_summaryLatency, stats.get(FeedLatencyStats::SUMMARY));
+    addLatency(_totalLatency, stats.get(FeedLatencyStats::TOTAL));
+}
+
+} // namespace proton
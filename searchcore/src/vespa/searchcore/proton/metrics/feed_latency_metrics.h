@@ -0,0 +1,35 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/metrics/metrics.h>
+
+namespace proton {
+
+class FeedLatencyStats;
+
+/**
+ * Metric set for the latencies of the stages feed operations pass
+ * through in a document db.
+ */
+class FeedLatencyMetrics : public metrics::MetricSet
+{
+private:
+    metrics::DoubleAverageMetric _queueLatency;
+    metrics::DoubleAverageMetric _masterLatency;
+    metrics::DoubleAverageMetric _tlsLatency;
+    metrics::DoubleAverageMetric _attributeLatency;
+    metrics::DoubleAverageMetric _indexLatency;
+    metrics::DoubleAverageMetric _summaryLatency;
+    metrics::DoubleAverageMetric _totalLatency;
+
+public:
+    FeedLatencyMetrics(metrics::MetricSet *parent);
+    ~FeedLatencyMetrics();
+    /**
+     * Update with the stats collected since the last update.
+     */
+    void update(const FeedLatencyStats &stats);
+};
+
+} // namespace proton
@@ -0,0 +1,36 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "feed_latency_stats.h"
+
+namespace proton {
+
+FeedLatencyStats::FeedLatencyStats()
+    : _latencies()
+{
+}
+
+FeedLatencyStats &
+FeedLatencyStats::operator += (const FeedLatencyStats & rhs)
+{
+    for (size_t i = 0; i < NUM_STAGES; ++i) {
+        _latencies[i].add(rhs._latencies[i]);
+    }
+    return *this;
+}
+
+const char *
+FeedLatencyStats::getStageName(Stage stage)
+{
+    switch (stage) {
+    case QUEUE:     return "queue";
+    case MASTER:    return "master";
+    case TLS:       return "tls";
+    case ATTRIBUTE: return "attribute";
+    case INDEX:     return "index";
+    case SUMMARY:   return "summary";
+    case TOTAL:     return "total";
+    default:        return "unknown";
+    }
+}
+
+} // namespace proton
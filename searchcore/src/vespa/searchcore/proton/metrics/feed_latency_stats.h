@@ -0,0 +1,39 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include <vespa/searchlib/common/latency_stats.h>
+#include <array>
+
+namespace proton {
+
+/**
+ * Latencies in seconds of the stages feed operations pass through in a
+ * document db, from being received until all their work is done.
+ */
+class FeedLatencyStats
+{
+public:
+    using Latency = search::LatencyStats;
+
+    enum Stage {
+        QUEUE,      // Received until the master write thread starts on it
+        MASTER,     // Handled by the master write thread
+        TLS,        // Appended to the transaction log until acked
+        ATTRIBUTE,  // Applied to the attribute vectors
+        INDEX,      // Applied to the memory index
+        SUMMARY,    // Written to the document store
+        TOTAL,      // Received until all stages are done
+        NUM_STAGES
+    };
+
+    FeedLatencyStats();
+    FeedLatencyStats & operator += (const FeedLatencyStats & rhs);
+
+    Latency & get(Stage stage) { return _latencies[stage]; }
+    const Latency & get(Stage stage) const { return _latencies[stage]; }
+    static const char * getStageName(Stage stage);
+private:
+    std::array<Latency, NUM_STAGES> _latencies;
+};
+
+} // namespace proton
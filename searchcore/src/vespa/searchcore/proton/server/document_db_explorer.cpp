@@ -4,6 +4,7 @@
 
 #include "document_meta_store_read_guards.h"
 #include "document_subdb_collection_explorer.h"
+#include "feedhandler.h"
 #include "maintenance_controller_explorer.h"
 #include <vespa/searchcore/proton/common/state_reporter_utils.h>
 #include <vespa/searchcore/proton/bucketdb/bucket_db_explorer.h>
@@ -42,6 +43,19 @@ DocumentDBExplorer::get_state(const Inserter &inserter, bool full) const
         documents.setLong("stored", dmss.numStoredDocs());
         documents.setLong("removed", dmss.numRemovedDocs());
     }
+    const FeedHandler &feedHandler = _docDb->getFeedHandler();
+    const TlsReplayProgress *progress = feedHandler.getTlsReplayProgress();
+    if ((progress != nullptr) && feedHandler.isDoingReplay()) {
+        Cursor &replay = object.setObject("replay");
+        replay.setString("domain", progress->getDomainName());
+        replay.setLong("first", progress->getFirst());
+        replay.setLong("last", progress->getLast());
+        replay.setLong("current", progress->getCurrent());
+        replay.setDouble("progress", progress->getProgress());
+        replay.setDouble("elapsedSeconds", progress->getElapsedSeconds());
+        replay.setDouble("operationsPerSecond", progress->getOperationsPerSecond());
+        replay.setDouble("estimatedSecondsLeft", progress->getEstimatedSecondsLeft());
+    }
 }
 
 const vespalib::string SUB_DB = "subdb";
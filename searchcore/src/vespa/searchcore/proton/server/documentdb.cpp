@@ -34,6 +34,7 @@
 #include <vespa/vespalib/io/fileutil.h>
 #include <vespa/vespalib/util/closuretask.h>
 #include <vespa/vespalib/util/exceptions.h>
+#include <vespa/vespalib/util/simple_thread_bundle.h>
 
 #include <vespa/log/log.h>
 LOG_SETUP(".proton.server.documentdb");
@@ -103,8 +104,10 @@ DocumentDB::DocumentDB(const vespalib::string &baseDir,
       _writeServiceConfig(ThreadingServiceConfig::make(protonCfg, hwInfo.cpu())),
       _writeService(_writeServiceConfig.indexingThreads(),
                     indexing_thread_stack_size,
-                    _writeServiceConfig.defaultTaskLimit()),
+                    _writeServiceConfig.defaultTaskLimit(),
+                    _writeServiceConfig.feedPrepareThreads()),
       _initializeThreads(initializeThreads),
+      _replayThreads(std::max(0, protonCfg.replay.threads)),
       _initConfigSnapshot(),
       _initConfigSerialNum(0u),
       _pendingConfigSnapshot(configSnapshot),
@@ -137,6 +140,12 @@ DocumentDB::DocumentDB(const vespalib::string &baseDir,
       _lidSpaceCompactionHandlers(),
       _jobTrackers(),
       _lastDocStoreCacheStats(),
+      _lastReadyCacheStats(),
+      _lastNotReadyCacheStats(),
+      _lastRemovedCacheStats(),
+      _lastReadyHotStoreStats(),
+      _lastNotReadyHotStoreStats(),
+      _lastRemovedHotStoreStats(),
       _calc()
 {
     assert(configSnapshot);
@@ -146,6 +155,7 @@ DocumentDB::DocumentDB(const vespalib::string &baseDir,
 
     _feedHandler.init(_config_store->getOldestSerialNum());
     _feedHandler.setBucketDBHandler(&_subDBs.getBucketDBHandler());
+    _feedHandler.setLatencyTraceInterval(std::max(0, protonCfg.feeding.latencytraceinterval));
     saveInitialConfig(*configSnapshot);
     resumeSaveConfig();
     SerialNum configSerial = _config_store->getPrevValidSerial(_feedHandler.getPrunedSerialNum() + 1);
@@ -680,7 +690,8 @@ DocumentDB::startTransactionLogReplay()
                                       getBackingStore().lastSyncToken(),
                                       oldestFlushedSerial,
                                       newestFlushedSerial,
-                                      *_config_store);
+                                      *_config_store,
+                                      _replayThreads);
     _initGate.countDown();
 
     LOG(debug, "DocumentDB(%s): Database started.", _docTypeName.toString().c_str());
@@ -730,10 +741,17 @@ DocumentDB::match(const ISearchHandler::SP &, const SearchRequest &req, vespalib
 }
 
 std::unique_ptr<DocsumReply>
-DocumentDB::getDocsums(const DocsumRequest & request)
+DocumentDB::getDocsums(const DocsumRequest & request, vespalib::ThreadBundle &threadBundle)
 {
     ISearchHandler::SP view(_subDBs.getReadySubDB()->getSearchView());
-    return view->getDocsums(request);
+    return view->getDocsums(request, threadBundle);
+}
+
+std::unique_ptr<DocsumReply>
+DocumentDB::getDocsums(const DocsumRequest & request)
+{
+    vespalib::SimpleThreadBundle threadBundle(1);
+    return getDocsums(request, threadBundle);
 }
 
 IFlushTarget::List
@@ -1209,7 +1227,9 @@ updateDocstoreMetrics(LegacyDocumentDBMetrics::DocstoreMetrics &metrics,
 void
 updateDocumentStoreMetrics(DocumentDBTaggedMetrics::SubDBMetrics::
                            DocumentStoreMetrics &metrics,
-                           IDocumentSubDB *subDb)
+                           IDocumentSubDB *subDb,
+                           CacheStats &lastCacheStats,
+                           CacheStats &lastHotStoreStats)
 {
     const ISummaryManager::SP &summaryMgr = subDb->getSummaryManager();
     search::IDocumentStore &backingStore = summaryMgr->getBackingStore();
@@ -1218,6 +1238,13 @@ updateDocumentStoreMetrics(DocumentDBTaggedMetrics::SubDBMetrics::
     metrics.diskBloat.set(storageStats.diskBloat());
     metrics.maxBucketSpread.set(storageStats.maxBucketSpread());
     metrics.memoryUsage.update(backingStore.getMemoryUsage());
+    CacheStats cacheStats = backingStore.getCacheStats();
+    metrics.cache.update(cacheStats, lastCacheStats);
+    lastCacheStats = cacheStats;
+    CacheStats hotStoreStats = backingStore.getHotStoreStats();
+    metrics.hotStore.update(hotStoreStats, lastHotStoreStats);
+    lastHotStoreStats = hotStoreStats;
+    metrics.write.update(backingStore.getWriteStats());
 }
 
 template <typename MetricSetType>
@@ -1292,12 +1319,17 @@ void
 DocumentDB::updateMetrics(DocumentDBTaggedMetrics &metrics, const ExecutorThreadingServiceStats &threadingServiceStats)
 {
     metrics.threadingService.update(threadingServiceStats);
+    metrics.feeding.update(_feedHandler.takeLatencyStats());
+    metrics.commit.update(_visibility.takeCommitStats());
     _jobTrackers.updateMetrics(metrics.job);
 
     updateMetrics(metrics.attribute);
-    updateDocumentStoreMetrics(metrics.ready.documentStore, _subDBs.getReadySubDB());
-    updateDocumentStoreMetrics(metrics.removed.documentStore, _subDBs.getRemSubDB());
-    updateDocumentStoreMetrics(metrics.notReady.documentStore, _subDBs.getNotReadySubDB());
+    updateDocumentStoreMetrics(metrics.ready.documentStore, _subDBs.getReadySubDB(),
+                               _lastReadyCacheStats, _lastReadyHotStoreStats);
+    updateDocumentStoreMetrics(metrics.removed.documentStore, _subDBs.getRemSubDB(),
+                               _lastRemovedCacheStats, _lastRemovedHotStoreStats);
+    updateDocumentStoreMetrics(metrics.notReady.documentStore, _subDBs.getNotReadySubDB(),
+                               _lastNotReadyCacheStats, _lastNotReadyHotStoreStats);
     DocumentMetaStoreReadGuards dmss(_subDBs);
     updateLidSpaceMetrics(metrics.ready.lidSpace, dmss.readydms->get());
     updateLidSpaceMetrics(metrics.notReady.lidSpace, dmss.notreadydms->get());
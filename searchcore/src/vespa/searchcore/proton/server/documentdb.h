@@ -87,6 +87,8 @@ private:
     ExecutorThreadingService      _writeService;
     // threads for initializer tasks during proton startup
     InitializeThreads             _initializeThreads;
+    // threads deserializing operations during transaction log replay
+    const uint32_t                _replayThreads;
 
     typedef search::SerialNum      SerialNum;
     typedef fastos::TimeStamp      TimeStamp;
@@ -131,6 +133,12 @@ private:
 
     // Last updated cache statistics. Necessary due to metrics implementation is upside down.
     search::CacheStats            _lastDocStoreCacheStats;
+    search::CacheStats            _lastReadyCacheStats;
+    search::CacheStats            _lastNotReadyCacheStats;
+    search::CacheStats            _lastRemovedCacheStats;
+    search::CacheStats            _lastReadyHotStoreStats;
+    search::CacheStats            _lastNotReadyHotStoreStats;
+    search::CacheStats            _lastRemovedHotStoreStats;
     IBucketStateCalculator::SP    _calc;
 
     void registerReference();
@@ -369,6 +377,12 @@ public:
           vespalib::ThreadBundle &threadBundle) const;
 
     std::unique_ptr<search::engine::DocsumReply>
+    getDocsums(const search::engine::DocsumRequest & request, vespalib::ThreadBundle &threadBundle);
+
+    /**
+     * Produce the docsums of the request in the calling thread only.
+     */
+    std::unique_ptr<search::engine::DocsumReply>
     getDocsums(const search::engine::DocsumRequest & request);
 
     IFlushTargetList getFlushTargets();
@@ -2,11 +2,13 @@
 
 #include "documentdb_commit_job.h"
 #include "icommitable.h"
+#include <vespa/searchcore/proton/common/commit_scheduler.h>
 
 namespace proton {
 
 DocumentDBCommitJob::DocumentDBCommitJob(ICommitable & committer, fastos::TimeStamp visibilityDelay) :
-    IMaintenanceJob("documentdb_commit", visibilityDelay.sec(), visibilityDelay.sec()),
+    IMaintenanceJob("documentdb_commit", CommitScheduler::getTickInterval(visibilityDelay).sec(),
+                    CommitScheduler::getTickInterval(visibilityDelay).sec()),
     _committer(committer)
 {
 }
@@ -14,7 +16,7 @@ DocumentDBCommitJob::DocumentDBCommitJob(ICommitable & committer, fastos::TimeSt
 bool
 DocumentDBCommitJob::run()
 {
-    _committer.commit();
+    _committer.commitIfDue();
     return true;
 }
 
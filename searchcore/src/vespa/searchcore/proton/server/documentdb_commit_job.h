@@ -9,7 +9,9 @@ namespace proton {
 class ICommitable;
 
 /**
- * Job that regularly commits the documentdb.
+ * Job that regularly lets the documentdb commit. It runs at the tick
+ * interval of the commit scheduler, which decides when to commit within
+ * the visibility delay.
  */
 class DocumentDBCommitJob : public IMaintenanceJob
 {
@@ -163,20 +163,27 @@ getStoreConfig(const ProtonConfig::Summary::Cache & cache, const HwInfo & hwInfo
     size_t maxBytes = (cache.maxbytes < 0)
                       ? (hwInfo.memory().sizeBytes()*std::min(50l, -cache.maxbytes))/100l
                       : cache.maxbytes;
-    return DocumentStore::Config(deriveCompression(cache.compression), maxBytes, cache.initialentries).allowVisitCaching(cache.allowvisitcaching);
+    return DocumentStore::Config(deriveCompression(cache.compression), maxBytes, cache.initialentries)
+            .allowVisitCaching(cache.allowvisitcaching)
+            .setCacheStripes(cache.stripes)
+            .useCacheAdmission(cache.admission)
+            .setHotStore(std::max(0l, cache.hot.maxbytes), std::max(1, cache.hot.minaccesses));
 }
 
 LogDocumentStore::Config
 deriveConfig(const ProtonConfig::Summary & summary, const ProtonConfig::Flush::Memory & flush, const HwInfo & hwInfo) {
     DocumentStore::Config config(getStoreConfig(summary.cache, hwInfo));
     const ProtonConfig::Summary::Log & log(summary.log);
+    config.useUpdateDeltas(log.updatedeltas);
     const ProtonConfig::Summary::Log::Chunk & chunk(log.chunk);
     WriteableFileChunk::Config fileConfig(deriveCompression(chunk.compression), chunk.maxbytes);
     LogDataStore::Config logConfig;
     logConfig.setMaxFileSize(log.maxfilesize)
             .setMaxDiskBloatFactor(std::min(flush.diskbloatfactor, flush.each.diskbloatfactor))
             .setMaxBucketSpread(log.maxbucketspread).setMinFileSizeFactor(log.minfilesizefactor)
+            .setCompressionDictionarySize(chunk.compression.dictionarysize)
             .compact2ActiveFile(log.compact2activefile).compactCompression(deriveCompression(log.compact.compression))
+            .setCompactMaxBytesPerSecond(log.compact.maxbytespersecond).compactToBucketOrder(log.compact.bucketorder)
             .setFileConfig(fileConfig).disableCrcOnRead(chunk.skipcrconread);
     return LogDocumentStore::Config(config, logConfig);
 }
@@ -67,6 +67,7 @@ DocumentSubDBCollection::DocumentSubDBCollection(
     GrowStrategy notReadyGrowth = makeGrowStrategy(growCfg.initial * (distCfg.redundancy - distCfg.searchablecopies), growCfg);
     size_t attributeGrowNumDocs(growCfg.numdocs);
     size_t numSearcherThreads = protonCfg.numsearcherthreads;
+    size_t docsumBlobMaxBytes = std::max(0l, protonCfg.summary.precompute.maxbytes);
 
     StoreOnlyDocSubDB::Context context(owner,
                                        tlSyncer,
@@ -92,7 +93,8 @@ DocumentSubDBCollection::DocumentSubDBCollection(
                         true,
                         true,
                         false),
-                        numSearcherThreads),
+                        numSearcherThreads,
+                        docsumBlobMaxBytes),
                 SearchableDocSubDB::Context(FastAccessDocSubDB::Context
                         (context,
                          AttributeMetricsCollection(metrics.getTaggedMetrics().ready.attributes,
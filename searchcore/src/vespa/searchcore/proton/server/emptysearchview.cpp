@@ -21,7 +21,7 @@ EmptySearchView::EmptySearchView()
 
 
 DocsumReply::UP
-EmptySearchView::getDocsums(const DocsumRequest &req)
+EmptySearchView::getDocsums(const DocsumRequest &req, ThreadBundle &)
 {
     LOG(debug, "getDocsums(): resultClass(%s), numHits(%zu)",
         req.resultClassName.c_str(), req.hits.size());
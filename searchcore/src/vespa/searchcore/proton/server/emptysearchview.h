@@ -16,7 +16,7 @@ public:
     /**
      * Implements ISearchHandler
      */
-    virtual std::unique_ptr<DocsumReply> getDocsums(const DocsumRequest & req) override;
+    virtual std::unique_ptr<DocsumReply> getDocsums(const DocsumRequest & req, ThreadBundle &threadBundle) override;
 
     virtual std::unique_ptr<SearchReply>
     match(const ISearchHandler::SP &searchHandler,
@@ -9,7 +9,8 @@ using search::SequencedTaskExecutor;
 
 namespace proton {
 
-ExecutorThreadingService::ExecutorThreadingService(uint32_t threads, uint32_t stackSize, uint32_t taskLimit)
+ExecutorThreadingService::ExecutorThreadingService(uint32_t threads, uint32_t stackSize, uint32_t taskLimit,
+                                                   uint32_t feedPrepareThreads)
 
     : _masterExecutor(1, stackSize),
       _indexExecutor(1, stackSize, taskLimit),
@@ -19,7 +20,8 @@ ExecutorThreadingService::ExecutorThreadingService(uint32_t threads, uint32_t st
       _summaryService(_summaryExecutor),
       _indexFieldInverter(std::make_unique<SequencedTaskExecutor>(threads, taskLimit)),
       _indexFieldWriter(std::make_unique<SequencedTaskExecutor>(threads, taskLimit)),
-      _attributeFieldWriter(std::make_unique<SequencedTaskExecutor>(threads, taskLimit))
+      _attributeFieldWriter(std::make_unique<SequencedTaskExecutor>(threads, taskLimit)),
+      _feedPrepare(std::make_unique<SequencedTaskExecutor>(feedPrepareThreads, taskLimit))
 {
 }
 
@@ -29,6 +31,8 @@ vespalib::Syncable &
 ExecutorThreadingService::sync()
 {
     bool isMasterThread = _masterService.isCurrentThread();
+    // Prepared feed operations are handed over to the master thread, drain them first.
+    _feedPrepare->sync();
     if (!isMasterThread) {
         _masterExecutor.sync();
     }
@@ -46,6 +50,7 @@ ExecutorThreadingService::sync()
 void
 ExecutorThreadingService::shutdown()
 {
+    _feedPrepare->sync();
     _masterExecutor.shutdown();
     _masterExecutor.sync();
     _attributeFieldWriter->sync();
@@ -65,6 +70,7 @@ ExecutorThreadingService::setTaskLimit(uint32_t taskLimit, uint32_t summaryTaskL
     _indexFieldInverter->setTaskLimit(taskLimit);
     _indexFieldWriter->setTaskLimit(taskLimit);
     _attributeFieldWriter->setTaskLimit(taskLimit);
+    _feedPrepare->setTaskLimit(taskLimit);
 }
 
 ExecutorThreadingServiceStats
@@ -93,5 +99,10 @@ ExecutorThreadingService::attributeFieldWriter() {
     return *_attributeFieldWriter;
 }
 
+search::ISequencedTaskExecutor &
+ExecutorThreadingService::feedPrepare() {
+    return *_feedPrepare;
+}
+
 } // namespace proton
 
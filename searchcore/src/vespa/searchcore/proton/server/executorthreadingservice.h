@@ -27,6 +27,7 @@ private:
     std::unique_ptr<search::SequencedTaskExecutor> _indexFieldInverter;
     std::unique_ptr<search::SequencedTaskExecutor> _indexFieldWriter;
     std::unique_ptr<search::SequencedTaskExecutor> _attributeFieldWriter;
+    std::unique_ptr<search::SequencedTaskExecutor> _feedPrepare;
 
 public:
     /**
@@ -34,10 +35,13 @@ public:
      *
      * @stackSize The size of the stack of the underlying executors.
      * @taskLimit The task limit for the index executor.
+     * @feedPrepareThreads The number of threads preparing feed operations
+     *                     before the master thread, 0 disables it.
      */
     ExecutorThreadingService(uint32_t threads = 1,
                              uint32_t stackSize = 128 * 1024,
-                             uint32_t taskLimit = 1000);
+                             uint32_t taskLimit = 1000,
+                             uint32_t feedPrepareThreads = 0);
     ~ExecutorThreadingService() override;
 
     /**
@@ -77,6 +81,7 @@ public:
     search::ISequencedTaskExecutor &indexFieldInverter() override;
     search::ISequencedTaskExecutor &indexFieldWriter() override;
     search::ISequencedTaskExecutor &attributeFieldWriter() override;
+    search::ISequencedTaskExecutor &feedPrepare() override;
     ExecutorThreadingServiceStats getStats();
 };
 
@@ -23,7 +23,8 @@ void
 FastAccessFeedView::putAttributes(SerialNum serialNum, search::DocumentIdT lid, const Document &doc,
                                   bool immediateCommit, OnPutDoneType onWriteDone)
 {
-    _attributeWriter->put(serialNum, doc, lid, immediateCommit, onWriteDone);
+    _attributeWriter->put(serialNum, doc, lid, immediateCommit,
+                          OperationDoneContext::trackStage(onWriteDone, FeedLatencyStats::ATTRIBUTE));
     if (immediateCommit && onWriteDone) {
         onWriteDone->registerPutLid(&_docIdLimit);
     }
@@ -33,7 +34,8 @@ void
 FastAccessFeedView::updateAttributes(SerialNum serialNum, search::DocumentIdT lid, const DocumentUpdate &upd,
                                      bool immediateCommit, OnOperationDoneType onWriteDone, IFieldUpdateCallback & onUpdate)
 {
-    _attributeWriter->update(serialNum, upd, lid, immediateCommit, onWriteDone, onUpdate);
+    _attributeWriter->update(serialNum, upd, lid, immediateCommit,
+                             OperationDoneContext::trackStage(onWriteDone, FeedLatencyStats::ATTRIBUTE), onUpdate);
 }
 
 void
@@ -41,7 +43,8 @@ FastAccessFeedView::updateAttributes(SerialNum serialNum, Lid lid, FutureDoc doc
                                      bool immediateCommit, OnOperationDoneType onWriteDone)
 {
     if (_attributeWriter->hasStructFieldAttribute()) {
-        _attributeWriter->update(serialNum, *doc.get(), lid, immediateCommit, onWriteDone);
+        _attributeWriter->update(serialNum, *doc.get(), lid, immediateCommit,
+                                 OperationDoneContext::trackStage(onWriteDone, FeedLatencyStats::ATTRIBUTE));
     }
 }
 
@@ -18,8 +18,10 @@
 #include <vespa/searchcore/proton/common/eventlogger.h>
 #include <vespa/searchcorespi/index/ithreadingservice.h>
 #include <vespa/searchlib/common/gatecallback.h>
+#include <vespa/searchlib/common/isequencedtaskexecutor.h>
 #include <vespa/vespalib/util/exceptions.h>
 #include <vespa/vespalib/util/lambdatask.h>
+#include <vespa/vespalib/util/simple_thread_bundle.h>
 #include <unistd.h>
 
 #include <vespa/log/log.h>
@@ -28,6 +30,7 @@ LOG_SETUP(".proton.server.feedhandler");
 using document::BucketId;
 using document::Document;
 using document::DocumentTypeRepo;
+using document::GlobalId;
 using storage::spi::PartitionId;
 using storage::spi::RemoveResult;
 using storage::spi::Result;
@@ -50,6 +53,25 @@ ignoreOperation(const DocumentOperation &op) {
     return (op.getPrevTimestamp() != 0) && (op.getTimestamp() < op.getPrevTimestamp());
 }
 
+bool
+getPrepareGlobalId(const FeedOperation &op, GlobalId &gid)
+{
+    switch (op.getType()) {
+    case FeedOperation::PUT:
+        gid = static_cast<const PutOperation &>(op).getDocument()->getId().getGlobalId();
+        return true;
+    case FeedOperation::REMOVE:
+        gid = static_cast<const RemoveOperation &>(op).getDocumentId().getGlobalId();
+        return true;
+    case FeedOperation::UPDATE_42:
+    case FeedOperation::UPDATE:
+        gid = static_cast<const UpdateOperation &>(op).getUpdate()->getId().getGlobalId();
+        return true;
+    default:
+        return false;
+    }
+}
+
 }  // namespace
 
 void FeedHandler::TlsMgrWriter::storeOperation(const FeedOperation &op, DoneCallback onDone) {
@@ -84,8 +106,16 @@ void
 FeedHandler::doHandleOperation(FeedToken token, FeedOperation::UP op)
 {
     assert(_writeService.master().isCurrentThread());
+    FeedLatencyTracker::SP tracker = op->getLatencyTracker();
+    FeedLatencyTracker::clock::time_point start = FeedLatencyTracker::clock::now();
+    if (tracker) {
+        tracker->stageDone(FeedLatencyStats::QUEUE, tracker->getReceived());
+    }
     std::lock_guard<std::mutex> guard(_feedLock);
     _feedState->handleOperation(std::move(token), std::move(op));
+    if (tracker) {
+        tracker->stageDone(FeedLatencyStats::MASTER, start);
+    }
 }
 
 void FeedHandler::performPut(FeedToken token, PutOperation &op) {
@@ -248,6 +278,7 @@ FeedHandler::performEof()
     _owner.onTransactionLogReplayDone();
     _tlsMgr.replayDone();
     changeToNormalFeedState();
+    _replayDecodeBundle.reset();
     _owner.enterRedoReprocessState();
 }
 
@@ -349,6 +380,7 @@ FeedHandler::FeedHandler(IThreadingService &writeService,
       _tlsMgrWriter(_tlsMgr, &tlsDirectWriter),
       _tlsWriter(tlsWriter ? *tlsWriter : _tlsMgrWriter),
       _tlsReplayProgress(),
+      _replayDecodeBundle(),
       _serialNum(0),
       _prunedSerialNum(0),
       _delayedPrune(false),
@@ -358,6 +390,9 @@ FeedHandler::FeedHandler(IThreadingService &writeService,
       _repo(nullptr),
       _documentType(nullptr),
       _bucketDBHandler(nullptr),
+      _prepareLock(),
+      _prepareRepo(),
+      _latencyCollector(make_shared<FeedLatencyCollector>()),
       _syncLock(),
       _syncedSerialNum(0),
       _allowSync(false)
@@ -389,13 +424,17 @@ FeedHandler::close()
 void
 FeedHandler::replayTransactionLog(SerialNum flushedIndexMgrSerial, SerialNum flushedSummaryMgrSerial,
                                   SerialNum oldestFlushedSerial, SerialNum newestFlushedSerial,
-                                  ConfigStore &config_store)
+                                  ConfigStore &config_store, uint32_t decodeThreads)
 {
     (void) newestFlushedSerial;
     assert(_activeFeedView);
     assert(_bucketDBHandler);
+    if (decodeThreads > 0) {
+        _replayDecodeBundle = std::make_unique<vespalib::SimpleThreadBundle>(decodeThreads);
+    }
     FeedState::SP state = make_shared<ReplayTransactionLogState>
-                          (getDocTypeName(), _activeFeedView, *_bucketDBHandler, _replayConfig, config_store);
+                          (getDocTypeName(), _activeFeedView, *_bucketDBHandler, _replayConfig, config_store,
+                           _replayDecodeBundle.get());
     changeFeedState(state);
     // Resurrected attribute vector might cause oldestFlushedSerial to
     // be lower than _prunedSerialNum, so don't warn for now.
@@ -427,6 +466,8 @@ FeedHandler::setActiveFeedView(IFeedView *feedView)
     _activeFeedView = feedView;
     _repo = feedView->getDocumentTypeRepo().get();
     _documentType = _repo->getDocumentType(_docTypeName.getName());
+    std::lock_guard<std::mutex> guard(_prepareLock);
+    _prepareRepo = feedView->getDocumentTypeRepo();
 }
 
 bool
@@ -444,7 +485,8 @@ FeedHandler::storeOperation(const FeedOperation &op, TlsWriter::DoneCallback onD
     if (!op.getSerialNum()) {
         const_cast<FeedOperation &>(op).setSerialNum(incSerialNum());
     }
-    _tlsWriter.storeOperation(op, std::move(onDone));
+    _tlsWriter.storeOperation(op, FeedLatencyTracker::trackStage(op.getLatencyTracker(), FeedLatencyStats::TLS,
+                                                                 std::move(onDone)));
 }
 
 void
@@ -583,9 +625,48 @@ FeedHandler::performOperation(FeedToken token, FeedOperation::UP op)
     }
 }
 
+void
+FeedHandler::prepareOperation(FeedOperation &op)
+{
+    if (op.getType() != FeedOperation::PUT) {
+        return;
+    }
+    auto &putOp = static_cast<PutOperation &>(op);
+    std::shared_ptr<const DocumentTypeRepo> repo;
+    {
+        std::lock_guard<std::mutex> guard(_prepareLock);
+        repo = _prepareRepo;
+    }
+    try {
+        if (repo && (repo.get() != putOp.getDocument()->getRepo())) {
+            putOp.deserializeDocument(*repo);
+        }
+        putOp.serializeDocument();
+    } catch (const std::exception &e) {
+        // Redone by the master write thread, which handles the failure.
+        LOG(debug, "prepareOperation(): docId(%s): %s", putOp.getDocument()->getId().toString().c_str(), e.what());
+    }
+}
+
 void
 FeedHandler::handleOperation(FeedToken token, FeedOperation::UP op)
 {
+    vespalib::string traceName = _latencyCollector->sampleTrace() ? op->toString() : vespalib::string();
+    op->setLatencyTracker(make_shared<FeedLatencyTracker>(_latencyCollector, traceName));
+    search::ISequencedTaskExecutor &prepare = _writeService.feedPrepare();
+    GlobalId gid;
+    if ((prepare.getNumExecutors() > 0) && getPrepareGlobalId(*op, gid)) {
+        search::ISequencedTaskExecutor::ExecutorId id(GlobalId::hash()(gid) % prepare.getNumExecutors());
+        prepare.executeLambda(id, [this, token = std::move(token), op = std::move(op)]() mutable {
+            prepareOperation(*op);
+            _writeService.master().execute(makeLambdaTask([this, token = std::move(token), op = std::move(op)]() mutable {
+                doHandleOperation(std::move(token), std::move(op));
+            }));
+        });
+        return;
+    }
+    // Keep the order with respect to the operations already in the feed prepare threads.
+    prepare.sync();
     _writeService.master().execute(makeLambdaTask([this, token = std::move(token), op = std::move(op)]() mutable {
         doHandleOperation(std::move(token), std::move(op));
     }));
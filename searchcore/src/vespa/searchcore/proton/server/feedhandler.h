@@ -11,11 +11,13 @@
 #include "transactionlogmanager.h"
 #include <persistence/spi/types.h>
 #include <vespa/searchcore/proton/common/doctypename.h>
+#include <vespa/searchcore/proton/common/feed_latency_tracker.h>
 #include <vespa/searchcore/proton/common/feedtoken.h>
 #include <vespa/searchlib/transactionlog/translogclient.h>
 #include <mutex>
 
 namespace searchcorespi { namespace index { class IThreadingService; } }
+namespace vespalib { class SimpleThreadBundle; }
 
 namespace proton {
 class ConfigStore;
@@ -82,6 +84,7 @@ private:
     TlsMgrWriter                           _tlsMgrWriter;
     TlsWriter                             &_tlsWriter;
     TlsReplayProgress::UP                  _tlsReplayProgress;
+    std::unique_ptr<vespalib::SimpleThreadBundle> _replayDecodeBundle;
     // the serial num of the last message in the transaction log
     SerialNum                              _serialNum;
     SerialNum                              _prunedSerialNum;
@@ -93,6 +96,10 @@ private:
     const document::DocumentTypeRepo      *_repo;
     const document::DocumentType          *_documentType;
     bucketdb::IBucketDBHandler            *_bucketDBHandler;
+    // used by feed prepare thread tasks
+    mutable std::mutex                     _prepareLock;
+    std::shared_ptr<const document::DocumentTypeRepo> _prepareRepo;
+    FeedLatencyCollector::SP               _latencyCollector;
     std::mutex                             _syncLock;
     SerialNum                              _syncedSerialNum; 
     bool                                   _allowSync; // Sanity check
@@ -103,6 +110,12 @@ private:
      */
     void doHandleOperation(FeedToken token, FeedOperationUP op);
 
+    /**
+     * Work on a feed operation that does not depend on state owned by the
+     * master write thread, done in a feed prepare thread.
+     */
+    void prepareOperation(FeedOperation &op);
+
     bool considerWriteOperationForRejection(FeedToken & token, const FeedOperation &op);
     bool considerUpdateOperationForRejection(FeedToken &token, UpdateOperation &op);
 
@@ -180,6 +193,10 @@ public:
      * @param flushedSummaryMgrSerial The flushed serial number of the
      *                                document store.
      * @param config_store            Reference to the config store.
+     * @param decodeThreads           Number of threads deserializing the
+     *                                replayed operations in parallel.
+     *                                0 deserializes them in the master
+     *                                write thread.
      */
 
     void
@@ -187,7 +204,8 @@ public:
                          SerialNum flushedSummaryMgrSerial,
                          SerialNum oldestFlushedSerial,
                          SerialNum newestFlushedSerial,
-                         ConfigStore &config_store);
+                         ConfigStore &config_store,
+                         uint32_t decodeThreads = 0);
 
     /**
      * Called when a flush is done and allows pruning of the transaction log.
@@ -217,6 +235,7 @@ public:
     SerialNum getPrunedSerialNum() const { return _prunedSerialNum; }
 
     bool isDoingReplay() const;
+    const TlsReplayProgress *getTlsReplayProgress() const { return _tlsReplayProgress.get(); }
     float getReplayProgress() const {
         return _tlsReplayProgress ? _tlsReplayProgress->getProgress() : 0;
     }
@@ -225,8 +244,23 @@ public:
     void tlsPrune(SerialNum oldest_to_keep);
 
     void performOperation(FeedToken token, FeedOperationUP op);
+    /**
+     * Hand a feed operation over to the master write thread. If feed prepare
+     * threads are configured, put, update and remove operations first pass
+     * through the one selected by global id. Other operations wait for the
+     * operations already in the feed prepare threads to be handed over.
+     */
     void handleOperation(FeedToken token, FeedOperationUP op);
 
+    /**
+     * Log the latency breakdown of every traceInterval-th operation handled, 0 disables it.
+     */
+    void setLatencyTraceInterval(uint32_t traceInterval) { _latencyCollector->setTraceInterval(traceInterval); }
+    /**
+     * Return the latencies of the operations handled since the previous call.
+     */
+    FeedLatencyStats takeLatencyStats() { return _latencyCollector->take(); }
+
     void handleMove(MoveOperation &op, std::shared_ptr<search::IDestructorCallback> moveDoneCtx) override;
     void heartBeat() override;
 
@@ -11,6 +11,11 @@
 #include <vespa/searchlib/common/idestructorcallback.h>
 #include <vespa/vespalib/util/closuretask.h>
 #include <vespa/vespalib/util/exceptions.h>
+#include <vespa/vespalib/util/gate.h>
+#include <vespa/vespalib/util/lambdatask.h>
+#include <vespa/vespalib/util/thread_bundle.h>
+#include <condition_variable>
+#include <mutex>
 
 
 #include <vespa/log/log.h>
@@ -23,6 +28,7 @@ using vespalib::Executor;
 using vespalib::IllegalStateException;
 using vespalib::makeClosure;
 using vespalib::makeTask;
+using vespalib::makeLambdaTask;
 using vespalib::make_string;
 using proton::bucketdb::IBucketDBHandler;
 
@@ -33,6 +39,9 @@ typedef vespalib::Closure1<const Packet::Entry &>::UP EntryHandler;
 
 const search::SerialNum REPLAY_PROGRESS_INTERVAL = 50000;
 
+// Max number of decoded packets waiting to be dispatched by the executor thread.
+const uint32_t MAX_PENDING_DECODED_PACKETS = 16;
+
 void
 handleProgress(TlsReplayProgress &progress, SerialNum currentSerial)
 {
@@ -134,6 +143,37 @@ public:
     }
 };
 
+using FeedOperationUP = std::unique_ptr<FeedOperation>;
+using DecodedOperations = std::vector<FeedOperationUP>;
+
+/**
+ * Deserializes a range of the entries of a packet in a decode bundle thread.
+ */
+class DecodeTask : public vespalib::Runnable {
+    const std::vector<Packet::Entry> &_entries;
+    DecodedOperations &_ops;
+    size_t _begin;
+    size_t _end;
+    const document::DocumentTypeRepo &_repo;
+    std::exception_ptr _error;
+
+public:
+    DecodeTask(const std::vector<Packet::Entry> &entries, DecodedOperations &ops,
+               size_t begin, size_t end, const document::DocumentTypeRepo &repo)
+        : _entries(entries), _ops(ops), _begin(begin), _end(end), _repo(repo), _error()
+    { }
+    void run() override {
+        try {
+            for (size_t i = _begin; i < _end; ++i) {
+                _ops[i] = ReplayPacketDispatcher::decodeEntry(_entries[i], _repo);
+            }
+        } catch (...) {
+            _error = std::current_exception();
+        }
+    }
+    const std::exception_ptr &getError() const { return _error; }
+};
+
 void startDispatch(IReplayPacketHandler *packet_handler,
                    const Packet::Entry &entry) {
     // Called by handlePacket() in executor thread.
@@ -147,23 +187,144 @@ void startDispatch(IReplayPacketHandler *packet_handler,
 
 }  // namespace
 
+/**
+ * Limits the number of decoded packets waiting to be dispatched by the
+ * executor thread. Shared with the dispatch tasks, which may outlive the
+ * replay state.
+ */
+class ReplayTransactionLogState::PendingPackets {
+    std::mutex _lock;
+    std::condition_variable _cond;
+    uint32_t _count;
+public:
+    PendingPackets() : _lock(), _cond(), _count(0) {}
+    void acquire() {
+        std::unique_lock<std::mutex> guard(_lock);
+        while (_count >= MAX_PENDING_DECODED_PACKETS) {
+            _cond.wait(guard);
+        }
+        ++_count;
+    }
+    void release() {
+        std::lock_guard<std::mutex> guard(_lock);
+        --_count;
+        _cond.notify_all();
+    }
+};
+
 ReplayTransactionLogState::ReplayTransactionLogState(
         const vespalib::string &name,
         IFeedView *& feed_view_ptr,
         IBucketDBHandler &bucketDBHandler,
         IReplayConfig &replay_config,
-        FeedConfigStore &config_store)
+        FeedConfigStore &config_store,
+        vespalib::ThreadBundle *decode_bundle)
     : FeedState(REPLAY_TRANSACTION_LOG),
       _doc_type_name(name),
-      _packet_handler(new TransactionLogReplayPacketHandler(
+      _feed_view_ptr(feed_view_ptr),
+      _packet_handler(std::make_shared<TransactionLogReplayPacketHandler>(
                       feed_view_ptr, bucketDBHandler,
-                      replay_config, config_store)) {
+                      replay_config, config_store)),
+      _decode_bundle(decode_bundle),
+      _decode_repo(),
+      _pending_packets(std::make_shared<PendingPackets>()) {
 }
 
+ReplayTransactionLogState::~ReplayTransactionLogState() = default;
+
 void ReplayTransactionLogState::receive(const PacketWrapper::SP &wrap,
                                         Executor &executor) {
+    if (_decode_bundle != nullptr) {
+        receiveDecoded(wrap, executor);
+        return;
+    }
     EntryHandler closure = makeClosure(&startDispatch, _packet_handler.get());
     executor.execute(makeTask(makeClosure(&handlePacket, wrap, std::move(closure))));
 }
 
+void
+ReplayTransactionLogState::receiveDecoded(const PacketWrapper::SP &wrap, Executor &executor)
+{
+    try {
+        dispatchDecoded(wrap, executor);
+    } catch (const std::exception &e) {
+        // Called by the transaction log visitor thread, report the failure to it instead of throwing.
+        LOG(error, "Could not decode transaction log packet for document type '%s' (serial %" PRIu64 " - %" PRIu64 "): %s",
+            _doc_type_name.c_str(), wrap->packet.range().from(), wrap->packet.range().to(), e.what());
+        wrap->result = RPC::ERROR;
+        wrap->gate.countDown();
+    }
+}
+
+void
+ReplayTransactionLogState::dispatchDecoded(const PacketWrapper::SP &wrap, Executor &executor)
+{
+    std::vector<Packet::Entry> entries;
+    bool hasConfig = false;
+    vespalib::nbostream_longlivedbuf handle(wrap->packet.getHandle().c_str(), wrap->packet.getHandle().size());
+    while (handle.size() > 0) {
+        entries.emplace_back();
+        entries.back().deserialize(handle);
+        hasConfig = hasConfig || (entries.back().type() == FeedOperation::NEW_CONFIG);
+    }
+    if (hasConfig) {
+        // Operations in later packets must be decoded with the new repo.
+        _decode_repo.reset();
+        EntryHandler closure = makeClosure(&startDispatch, _packet_handler.get());
+        executor.execute(makeTask(makeClosure(&handlePacket, wrap, std::move(closure))));
+        return;
+    }
+    if ( ! _decode_repo) {
+        _decode_repo = getRepo(executor);
+    }
+    auto ops = std::make_shared<DecodedOperations>(entries.size());
+    size_t numTasks = std::max(1ul, std::min(_decode_bundle->size(), entries.size()));
+    std::vector<DecodeTask> tasks;
+    tasks.reserve(numTasks);
+    for (size_t i = 0; i < numTasks; ++i) {
+        tasks.emplace_back(entries, *ops, (i * entries.size()) / numTasks, ((i + 1) * entries.size()) / numTasks,
+                           *_decode_repo);
+    }
+    std::vector<vespalib::Runnable *> targets;
+    for (DecodeTask &task : tasks) {
+        targets.push_back(&task);
+    }
+    _decode_bundle->run(targets);
+    for (const DecodeTask &task : tasks) {
+        if (task.getError()) {
+            std::rethrow_exception(task.getError());
+        }
+    }
+    _pending_packets->acquire();
+    TlsReplayProgress *progress = wrap->progress;
+    executor.execute(makeLambdaTask([handler = _packet_handler, pending = _pending_packets, ops, progress]() {
+        ReplayPacketDispatcher dispatcher(*handler);
+        for (const FeedOperationUP &op : *ops) {
+            LOG(spam, "replay decoded operation: serial(%" PRIu64 "), type(%u)",
+                op->getSerialNum(), op->getType());
+            dispatcher.replayOperation(*op);
+            if (progress != nullptr) {
+                handleProgress(*progress, op->getSerialNum());
+            }
+        }
+        pending->release();
+    }));
+    wrap->result = RPC::OK;
+    wrap->gate.countDown();
+}
+
+ReplayTransactionLogState::DocumentTypeRepoSP
+ReplayTransactionLogState::getRepo(Executor &executor)
+{
+    // The active feed view is changed by the executor thread.
+    DocumentTypeRepoSP repo;
+    vespalib::Gate gate;
+    executor.execute(makeLambdaTask([this, &repo, &gate]() {
+        repo = _feed_view_ptr->getDocumentTypeRepo();
+        gate.countDown();
+    }));
+    gate.await();
+    return repo;
+}
+
 }  // namespace proton
@@ -6,6 +6,9 @@
 #include <vespa/searchcore/proton/server/feedstate.h>
 #include <vespa/searchcore/proton/server/ireplaypackethandler.h>
 
+namespace document { class DocumentTypeRepo; }
+namespace vespalib { class ThreadBundle; }
+
 namespace proton {
 
 /**
@@ -42,17 +45,39 @@ public:
 /**
  * The feed handler is replaying the transaction log.
  * Replayed messages from the transaction log are sent to the active feed view.
+ *
+ * With a decode bundle, the operations of a packet are deserialized in
+ * parallel by the bundle threads in the receiving thread, and only dispatched
+ * by the executor thread. The receiving thread does not wait for the dispatch,
+ * so the next packet is decoded while the executor thread dispatches the
+ * previous ones. Operations are still dispatched one by one in serial number
+ * order, keeping the order of operations on each document. Packets with config
+ * changes are handled as without a decode bundle, since the operations after
+ * them must be decoded with the new document type repo. The dispatch tasks
+ * share the packet handler, so the state can be replaced while they are queued.
  */
 class ReplayTransactionLogState : public FeedState {
+    using DocumentTypeRepoSP = std::shared_ptr<const document::DocumentTypeRepo>;
+    class PendingPackets;
     vespalib::string _doc_type_name;
-    std::unique_ptr<IReplayPacketHandler> _packet_handler;
+    IFeedView *& _feed_view_ptr;
+    std::shared_ptr<IReplayPacketHandler> _packet_handler;
+    vespalib::ThreadBundle *_decode_bundle;
+    DocumentTypeRepoSP _decode_repo;
+    std::shared_ptr<PendingPackets> _pending_packets;
+
+    void receiveDecoded(const PacketWrapper::SP &wrap, vespalib::Executor &executor);
+    void dispatchDecoded(const PacketWrapper::SP &wrap, vespalib::Executor &executor);
+    DocumentTypeRepoSP getRepo(vespalib::Executor &executor);
 
 public:
     ReplayTransactionLogState(const vespalib::string &name,
             IFeedView *& feed_view_ptr,
             bucketdb::IBucketDBHandler &bucketDBHandler,
             IReplayConfig &replay_config,
-            FeedConfigStore &config_store);
+            FeedConfigStore &config_store,
+            vespalib::ThreadBundle *decode_bundle = nullptr);
+    ~ReplayTransactionLogState() override;
 
     void handleOperation(FeedToken, FeedOperationUP op) override {
         throwExceptionInHandleOperation(_doc_type_name, *op);
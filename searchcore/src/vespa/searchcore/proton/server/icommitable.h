@@ -11,6 +11,11 @@ class ICommitable {
 public:
     virtual void commit() = 0;
     virtual void commitAndWait() = 0;
+    /**
+     * Called regularly by the commit job. Commits when the implementation
+     * finds it is time to, by default right away.
+     */
+    virtual void commitIfDue() { commit(); }
 protected:
     virtual ~ICommitable() { }
 };
@@ -7,6 +7,7 @@
 namespace document {
     class Document;
     class DocumentTypeRepo;
+    class DocumentUpdate;
 }
 namespace search { class IDocumentStore; }
 namespace vespalib { class nbostream; }
@@ -30,6 +31,30 @@ public:
     // feed interface
     virtual void put(SerialNum serialNum, const DocumentIdT lid, const Document &doc) = 0;
     virtual void put(SerialNum serialNum, const DocumentIdT lid, const vespalib::nbostream & os) = 0;
+    /**
+     * Put a document that is already serialized, so the serialized form can be
+     * stored as is. Default implementation ignores it.
+     */
+    virtual void put(SerialNum serialNum, const DocumentIdT lid, const Document &doc,
+                     const vespalib::nbostream &serializedDoc) {
+        (void) serializedDoc;
+        put(serialNum, lid, doc);
+    }
+    /**
+     * Store an update of an existing document as a delta, if the document store
+     * supports it. The serialized updated document is kept for readers meanwhile.
+     * Returns false if the complete updated document must be put instead.
+     */
+    virtual bool update(SerialNum serialNum, const DocumentIdT lid, const document::DocumentUpdate &upd,
+                        const std::shared_ptr<const DocumentTypeRepo> &repo,
+                        const vespalib::nbostream &updatedDoc) {
+        (void) serialNum;
+        (void) lid;
+        (void) upd;
+        (void) repo;
+        (void) updatedDoc;
+        return false;
+    }
     virtual void remove(SerialNum serialNum, const DocumentIdT lid) = 0;
     virtual void heartBeat(SerialNum serialNum) = 0;
     virtual const search::IDocumentStore &getDocumentStore() const = 0;
@@ -6,7 +6,8 @@
 namespace proton {
 
 OperationDoneContext::OperationDoneContext(FeedToken token)
-    : _token(std::move(token))
+    : _token(std::move(token)),
+      _latencyTracker()
 {
 }
 
@@ -21,4 +22,13 @@ OperationDoneContext::ack()
     _token.reset();
 }
 
+std::shared_ptr<search::IDestructorCallback>
+OperationDoneContext::trackStage(const std::shared_ptr<OperationDoneContext> &ctx, FeedLatencyStats::Stage stage)
+{
+    if ( ! ctx) {
+        return std::shared_ptr<search::IDestructorCallback>();
+    }
+    return FeedLatencyTracker::trackStage(ctx->_latencyTracker, stage, ctx);
+}
+
 }  // namespace proton
@@ -3,6 +3,7 @@
 #pragma once
 
 #include <vespa/searchlib/common/idestructorcallback.h>
+#include <vespa/searchcore/proton/common/feed_latency_tracker.h>
 #include <vespa/searchcore/proton/common/feedtoken.h>
 
 namespace proton {
@@ -17,6 +18,7 @@ namespace proton {
 class OperationDoneContext : public search::IDestructorCallback
 {
     FeedToken _token;
+    FeedLatencyTracker::SP _latencyTracker;
 protected:
     void ack();
 
@@ -25,6 +27,14 @@ public:
 
     ~OperationDoneContext() override;
     bool hasToken() const { return static_cast<bool>(_token); }
+    void setLatencyTracker(FeedLatencyTracker::SP latencyTracker) { _latencyTracker = std::move(latencyTracker); }
+
+    /**
+     * Return a callback that records the given stage of the operation as
+     * done when it is destroyed, or ctx itself when the operation is not tracked.
+     */
+    static std::shared_ptr<search::IDestructorCallback>
+    trackStage(const std::shared_ptr<OperationDoneContext> &ctx, FeedLatencyStats::Stage stage);
 };
 
 
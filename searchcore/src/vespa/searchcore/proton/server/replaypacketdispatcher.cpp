@@ -10,14 +10,23 @@ using vespalib::IllegalStateException;
 
 namespace proton {
 
+template <typename OperationType>
+std::unique_ptr<FeedOperation>
+ReplayPacketDispatcher::decode(std::unique_ptr<OperationType> op, vespalib::nbostream &is, const Packet::Entry &entry,
+                               const document::DocumentTypeRepo &repo)
+{
+    op->deserialize(is, repo);
+    op->setSerialNum(entry.serial());
+    return op;
+}
+
 template <typename OperationType>
 void
-ReplayPacketDispatcher::replay(OperationType &op, vespalib::nbostream &is, const Packet::Entry &entry)
+ReplayPacketDispatcher::replay(const FeedOperation &op)
 {
-    op.deserialize(is, _handler.getDeserializeRepo());
-    op.setSerialNum(entry.serial());
-    store(op);
-    _handler.replay(op);
+    const OperationType &typedOp = static_cast<const OperationType &>(op);
+    store(typedOp);
+    _handler.replay(typedOp);
 }
 
 
@@ -29,72 +38,75 @@ ReplayPacketDispatcher::ReplayPacketDispatcher(IReplayPacketHandler &handler)
 
 void
 ReplayPacketDispatcher::replayEntry(const Packet::Entry &entry)
+{
+    if (entry.type() == FeedOperation::NEW_CONFIG) {
+        vespalib::nbostream is(entry.data().c_str(), entry.data().size());
+        NewConfigOperation op(entry.serial(), _handler.getNewConfigStreamHandler());
+        op.deserialize(is, _handler.getDeserializeRepo());
+        _handler.replay(op);
+        if (is.size() > 0) {
+            throw document::DeserializeException
+                (make_string("Too much data in packet entry (type id '%u', %ld bytes)",
+                             entry.type(), is.size()));
+        }
+        return;
+    }
+    std::unique_ptr<FeedOperation> op = decodeEntry(entry, _handler.getDeserializeRepo());
+    replayOperation(*op);
+}
+
+
+std::unique_ptr<FeedOperation>
+ReplayPacketDispatcher::decodeEntry(const Packet::Entry &entry, const document::DocumentTypeRepo &repo)
 {
     vespalib::nbostream is(entry.data().c_str(), entry.data().size());
+    std::unique_ptr<FeedOperation> op;
     switch (entry.type()) {
-    case FeedOperation::PUT: {
-        PutOperation op;
-        replay(op, is, entry);
+    case FeedOperation::PUT:
+        op = decode(std::make_unique<PutOperation>(), is, entry, repo);
         break;
-    } case FeedOperation::REMOVE: {
-        RemoveOperation op;
-        replay(op, is, entry);
+    case FeedOperation::REMOVE:
+        op = decode(std::make_unique<RemoveOperation>(), is, entry, repo);
         break;
-    } case FeedOperation::UPDATE_42:
-      case FeedOperation::UPDATE: {
-        UpdateOperation op(static_cast<FeedOperation::Type>(entry.type()));
-        replay(op, is, entry);
+    case FeedOperation::UPDATE_42:
+    case FeedOperation::UPDATE:
+        op = decode(std::make_unique<UpdateOperation>(static_cast<FeedOperation::Type>(entry.type())),
+                    is, entry, repo);
         break;
-    } case FeedOperation::NOOP: {
-        NoopOperation op;
-        replay(op, is, entry);
+    case FeedOperation::NOOP:
+        op = decode(std::make_unique<NoopOperation>(), is, entry, repo);
         break;
-    } case FeedOperation::NEW_CONFIG: {
-        NewConfigOperation op(entry.serial(), _handler.getNewConfigStreamHandler());
-        op.deserialize(is, _handler.getDeserializeRepo());
-        _handler.replay(op);
+    case FeedOperation::WIPE_HISTORY:
+        op = decode(std::make_unique<WipeHistoryOperation>(), is, entry, repo);
         break;
-    } case FeedOperation::WIPE_HISTORY: {
-        WipeHistoryOperation op;
-        replay(op, is, entry);
+    case FeedOperation::DELETE_BUCKET:
+        op = decode(std::make_unique<DeleteBucketOperation>(), is, entry, repo);
         break;
-    } case FeedOperation::DELETE_BUCKET: {
-        DeleteBucketOperation op;
-        replay(op, is, entry);
+    case FeedOperation::SPLIT_BUCKET:
+        op = decode(std::make_unique<SplitBucketOperation>(), is, entry, repo);
         break;
-    } case FeedOperation::SPLIT_BUCKET: {
-        SplitBucketOperation op;
-        replay(op, is, entry);
+    case FeedOperation::JOIN_BUCKETS:
+        op = decode(std::make_unique<JoinBucketsOperation>(), is, entry, repo);
         break;
-    } case FeedOperation::JOIN_BUCKETS: {
-        JoinBucketsOperation op;
-        replay(op, is, entry);
+    case FeedOperation::PRUNE_REMOVED_DOCUMENTS:
+        op = decode(std::make_unique<PruneRemovedDocumentsOperation>(), is, entry, repo);
         break;
-    } case FeedOperation::PRUNE_REMOVED_DOCUMENTS: {
-        PruneRemovedDocumentsOperation op;
-        replay(op, is, entry);
+    case FeedOperation::SPOOLER_REPLAY_START:
+        op = decode(std::make_unique<SpoolerReplayStartOperation>(), is, entry, repo);
         break;
-    } case FeedOperation::SPOOLER_REPLAY_START: {
-        SpoolerReplayStartOperation op;
-        replay(op, is, entry);
+    case FeedOperation::SPOOLER_REPLAY_COMPLETE:
+        op = decode(std::make_unique<SpoolerReplayCompleteOperation>(), is, entry, repo);
         break;
-    } case FeedOperation::SPOOLER_REPLAY_COMPLETE: {
-        SpoolerReplayCompleteOperation op;
-        replay(op, is, entry);
+    case FeedOperation::MOVE:
+        op = decode(std::make_unique<MoveOperation>(), is, entry, repo);
         break;
-    } case FeedOperation::MOVE: {
-        MoveOperation op;
-        replay(op, is, entry);
+    case FeedOperation::CREATE_BUCKET:
+        op = decode(std::make_unique<CreateBucketOperation>(), is, entry, repo);
         break;
-    } case FeedOperation::CREATE_BUCKET: {
-        CreateBucketOperation op;
-        replay(op, is, entry);
+    case FeedOperation::COMPACT_LID_SPACE:
+        op = decode(std::make_unique<CompactLidSpaceOperation>(), is, entry, repo);
         break;
-    } case FeedOperation::COMPACT_LID_SPACE: {
-        CompactLidSpaceOperation op;
-        replay(op, is, entry);
-        break;
-    } default:
+    default:
         throw IllegalStateException
             (make_string("Got packet entry with unknown type id '%u' from TLS",
                          entry.type()));
@@ -104,6 +116,61 @@ ReplayPacketDispatcher::replayEntry(const Packet::Entry &entry)
             (make_string("Too much data in packet entry (type id '%u', %ld bytes)",
                          entry.type(), is.size()));
     }
+    return op;
+}
+
+
+void
+ReplayPacketDispatcher::replayOperation(const FeedOperation &op)
+{
+    switch (op.getType()) {
+    case FeedOperation::PUT:
+        replay<PutOperation>(op);
+        break;
+    case FeedOperation::REMOVE:
+        replay<RemoveOperation>(op);
+        break;
+    case FeedOperation::UPDATE_42:
+    case FeedOperation::UPDATE:
+        replay<UpdateOperation>(op);
+        break;
+    case FeedOperation::NOOP:
+        replay<NoopOperation>(op);
+        break;
+    case FeedOperation::WIPE_HISTORY:
+        replay<WipeHistoryOperation>(op);
+        break;
+    case FeedOperation::DELETE_BUCKET:
+        replay<DeleteBucketOperation>(op);
+        break;
+    case FeedOperation::SPLIT_BUCKET:
+        replay<SplitBucketOperation>(op);
+        break;
+    case FeedOperation::JOIN_BUCKETS:
+        replay<JoinBucketsOperation>(op);
+        break;
+    case FeedOperation::PRUNE_REMOVED_DOCUMENTS:
+        replay<PruneRemovedDocumentsOperation>(op);
+        break;
+    case FeedOperation::SPOOLER_REPLAY_START:
+        replay<SpoolerReplayStartOperation>(op);
+        break;
+    case FeedOperation::SPOOLER_REPLAY_COMPLETE:
+        replay<SpoolerReplayCompleteOperation>(op);
+        break;
+    case FeedOperation::MOVE:
+        replay<MoveOperation>(op);
+        break;
+    case FeedOperation::CREATE_BUCKET:
+        replay<CreateBucketOperation>(op);
+        break;
+    case FeedOperation::COMPACT_LID_SPACE:
+        replay<CompactLidSpaceOperation>(op);
+        break;
+    default:
+        throw IllegalStateException
+            (make_string("Cannot replay feed operation with type id '%u'", op.getType()));
+    }
 }
 
 
@@ -5,6 +5,8 @@
 #include "ireplaypackethandler.h"
 #include <vespa/searchlib/transactionlog/common.h>
 
+namespace document { class DocumentTypeRepo; }
+
 namespace proton {
 
 class FeedOperation;
@@ -20,7 +22,11 @@ private:
     IReplayPacketHandler &_handler;
 
     template <typename OperationType>
-    void replay(OperationType &op, vespalib::nbostream &is, const Packet::Entry &entry);
+    static std::unique_ptr<FeedOperation> decode(std::unique_ptr<OperationType> op, vespalib::nbostream &is,
+                                                 const Packet::Entry &entry,
+                                                 const document::DocumentTypeRepo &repo);
+    template <typename OperationType>
+    void replay(const FeedOperation &op);
 
 protected:
     virtual void store(const FeedOperation &op);
@@ -30,6 +36,20 @@ public:
     virtual ~ReplayPacketDispatcher();
 
     void replayEntry(const Packet::Entry &entry);
+
+    /**
+     * Deserializes a packet entry into a feed operation without dispatching it.
+     * This does not depend on the handler and can be done by any thread.
+     * NEW_CONFIG entries are handled by the replay handler and must be given to
+     * replayEntry() instead.
+     */
+    static std::unique_ptr<FeedOperation> decodeEntry(const Packet::Entry &entry,
+                                                      const document::DocumentTypeRepo &repo);
+
+    /**
+     * Dispatches a feed operation made by decodeEntry() to the handler.
+     */
+    void replayOperation(const FeedOperation &op);
 };
 
 } // namespace proton
@@ -70,14 +70,15 @@ SearchableFeedView::putIndexedFields(SerialNum serialNum, search::DocumentIdT li
         return;
     }
     _writeService.index().execute(
-            makeLambdaTask([=] {
+            makeLambdaTask([serialNum, lid, newDoc, immediateCommit, this,
+                            onWriteDone = OperationDoneContext::trackStage(onWriteDone, FeedLatencyStats::INDEX)] {
                 performIndexPut(serialNum, lid, newDoc, immediateCommit, onWriteDone);
             }));
 }
 
 void
 SearchableFeedView::performIndexPut(SerialNum serialNum, search::DocumentIdT lid, const Document &doc,
-                                    bool immediateCommit, OnOperationDoneType onWriteDone)
+                                    bool immediateCommit, OnWriteDoneType onWriteDone)
 {
     assert(_writeService.index().isCurrentThread());
     VLOG(getDebugLevel(lid, doc.getId()),
@@ -92,14 +93,14 @@ SearchableFeedView::performIndexPut(SerialNum serialNum, search::DocumentIdT lid
 
 void
 SearchableFeedView::performIndexPut(SerialNum serialNum, search::DocumentIdT lid, const Document::SP &doc,
-                                    bool immediateCommit, OnOperationDoneType onWriteDone)
+                                    bool immediateCommit, OnWriteDoneType onWriteDone)
 {
     performIndexPut(serialNum, lid, *doc, immediateCommit, onWriteDone);
 }
 
 void
 SearchableFeedView::performIndexPut(SerialNum serialNum, search::DocumentIdT lid, FutureDoc futureDoc,
-                                    bool immediateCommit, OnOperationDoneType onWriteDone)
+                                    bool immediateCommit, OnWriteDoneType onWriteDone)
 {
     const auto &doc = futureDoc.get();
     if (doc) {
@@ -125,7 +126,8 @@ SearchableFeedView::updateIndexedFields(SerialNum serialNum, search::DocumentIdT
 {
     _writeService.index().execute(
             makeLambdaTask([serialNum, lid, futureDoc = std::move(futureDoc),
-                            immediateCommit, onWriteDone = std::move(onWriteDone), this]() mutable {
+                            immediateCommit, this,
+                            onWriteDone = OperationDoneContext::trackStage(onWriteDone, FeedLatencyStats::INDEX)]() mutable {
                 performIndexPut(serialNum, lid, std::move(futureDoc), immediateCommit, std::move(onWriteDone));
             }));
 }
@@ -35,12 +35,12 @@ private:
     bool hasIndexedFields() const { return _hasIndexedFields; }
 
     void performIndexPut(SerialNum serialNum, search::DocumentIdT lid, const document::Document &doc,
-                         bool immediateCommit, OnOperationDoneType onWriteDone);
+                         bool immediateCommit, OnWriteDoneType onWriteDone);
 
     void performIndexPut(SerialNum serialNum, search::DocumentIdT lid, const document::Document::SP &doc,
-                         bool immediateCommit, OnOperationDoneType onWriteDone);
+                         bool immediateCommit, OnWriteDoneType onWriteDone);
     void performIndexPut(SerialNum serialNum, search::DocumentIdT lid, FutureDoc doc,
-                         bool immediateCommit, OnOperationDoneType onWriteDone);
+                         bool immediateCommit, OnWriteDoneType onWriteDone);
 
     void performIndexRemove(SerialNum serialNum, search::DocumentIdT lid,
                             bool immediateCommit, OnRemoveDoneType onWriteDone);
@@ -49,6 +49,7 @@ SearchableDocSubDB::SearchableDocSubDB(const Config &cfg, const Context &ctx)
       _configurer(_iSummaryMgr, _rSearchView, _rFeedView, ctx._queryLimiter, _constantValueRepo, ctx._clock,
                   getSubDbName(), ctx._fastUpdCtx._storeOnlyCtx._owner.getDistributionKey()),
       _numSearcherThreads(cfg._numSearcherThreads),
+      _docsumBlobMaxBytes(cfg._docsumBlobMaxBytes),
       _warmupExecutor(ctx._warmupExecutor),
       _realGidToLidChangeHandler(std::make_shared<GidToLidChangeHandler>()),
       _flushConfig(),
@@ -100,7 +101,8 @@ createIndexManagerInitializer(const DocumentDBConfig &configSnapshot,
     // Note: const_cast for reconfigurer role
     return std::make_shared<IndexManagerInitializer>
         (vespaIndexDir,
-         searchcorespi::index::WarmupConfig(indexCfg.warmup.time, indexCfg.warmup.unpack),
+         searchcorespi::index::WarmupConfig(indexCfg.warmup.time, indexCfg.warmup.unpack,
+                                            indexCfg.warmup.replaysample),
          indexCfg.maxflushed,
          indexCfg.cache.size,
          *schema,
@@ -137,6 +139,9 @@ void
 SearchableDocSubDB::setup(const DocumentSubDbInitializerResult &initResult)
 {
     Parent::setup(initResult);
+    if (_docsumBlobMaxBytes > 0) {
+        initResult.summaryManager()->enableDocsumBlobs(_docsumBlobMaxBytes);
+    }
     setupIndexManager(initResult.indexManager());
     _docIdLimit.set(_dms->getCommittedDocIdLimit());
     applyFlushConfig(initResult.getFlushConfig());
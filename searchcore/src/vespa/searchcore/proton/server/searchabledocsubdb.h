@@ -46,10 +46,13 @@ public:
     struct Config {
         const FastAccessDocSubDB::Config _fastUpdCfg;
         const size_t _numSearcherThreads;
+        const size_t _docsumBlobMaxBytes;
 
-        Config(const FastAccessDocSubDB::Config &fastUpdCfg, size_t numSearcherThreads)
+        Config(const FastAccessDocSubDB::Config &fastUpdCfg, size_t numSearcherThreads,
+               size_t docsumBlobMaxBytes)
             : _fastUpdCfg(fastUpdCfg),
-              _numSearcherThreads(numSearcherThreads)
+              _numSearcherThreads(numSearcherThreads),
+              _docsumBlobMaxBytes(docsumBlobMaxBytes)
         { }
     };
 
@@ -83,6 +86,7 @@ private:
     matching::ConstantValueRepo                 _constantValueRepo;
     SearchableDocSubDBConfigurer                _configurer;
     const size_t                                _numSearcherThreads;
+    const size_t                                _docsumBlobMaxBytes;
     vespalib::ThreadExecutor                   &_warmupExecutor;
     std::shared_ptr<GidToLidChangeHandler>      _realGidToLidChangeHandler;
     DocumentDBFlushConfig                       _flushConfig;
@@ -19,9 +19,9 @@ SearchHandlerProxy::~SearchHandlerProxy()
 }
 
 std::unique_ptr<search::engine::DocsumReply>
-SearchHandlerProxy::getDocsums(const DocsumRequest & request)
+SearchHandlerProxy::getDocsums(const DocsumRequest & request, vespalib::ThreadBundle &threadBundle)
 {
-    return _documentDB->getDocsums(request);
+    return _documentDB->getDocsums(request, threadBundle);
 }
 
 std::unique_ptr<search::engine::SearchReply>
@@ -16,7 +16,7 @@ public:
     SearchHandlerProxy(const std::shared_ptr<DocumentDB> &documentDB);
 
     virtual~SearchHandlerProxy();
-    std::unique_ptr<DocsumReply> getDocsums(const DocsumRequest & request) override;
+    std::unique_ptr<DocsumReply> getDocsums(const DocsumRequest & request, ThreadBundle &threadBundle) override;
     std::unique_ptr<SearchReply> match(const ISearchHandler::SP &searchHandler, const SearchRequest &req, ThreadBundle &threadBundle) const override;
 };
 
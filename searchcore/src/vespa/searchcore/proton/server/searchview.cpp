@@ -116,7 +116,7 @@ SearchView::SearchView(const ISummaryManager::ISummarySetup::SP & summarySetup,
 SearchView::~SearchView() {}
 
 DocsumReply::UP
-SearchView::getDocsums(const DocsumRequest & req)
+SearchView::getDocsums(const DocsumRequest & req, ThreadBundle &threadBundle)
 {
     LOG(spam, "getDocsums(): resultClass(%s), numHits(%zu)", req.resultClassName.c_str(), req.hits.size());
     if (_summarySetup->getResultConfig().  LookupResultClassId(req.resultClassName.c_str()) == ResultConfig::NoClassID()) {
@@ -124,10 +124,10 @@ SearchView::getDocsums(const DocsumRequest & req)
                      req.resultClassName.c_str(), req.hits.size());
         return createEmptyReply(req);
     }
-    SearchView::InternalDocsumReply reply = getDocsumsInternal(req);
+    SearchView::InternalDocsumReply reply = getDocsumsInternal(req, threadBundle);
     while ( ! reply.second ) {
         LOG(debug, "Must refetch docsums since the lids have moved.");
-        reply = getDocsumsInternal(req);
+        reply = getDocsumsInternal(req, threadBundle);
     }
     if ( ! req.useRootSlime()) {
         convertLidsToGids(*reply.first, req);
@@ -136,7 +136,7 @@ SearchView::getDocsums(const DocsumRequest & req)
 }
 
 SearchView::InternalDocsumReply
-SearchView::getDocsumsInternal(const DocsumRequest & req)
+SearchView::getDocsumsInternal(const DocsumRequest & req, ThreadBundle &threadBundle)
 {
     IDocumentMetaStoreContext::IReadGuard::UP readGuard = _matchView->getDocumentMetaStore()->getReadGuard();
     const search::IDocumentMetaStore & metaStore = readGuard->get();
@@ -150,7 +150,10 @@ SearchView::getDocsumsInternal(const DocsumRequest & req)
     DocsumContext::UP ctx(new DocsumContext(req, _summarySetup->getDocsumWriter(), *store, matcher,
                                             mctx->getSearchContext(), mctx->getAttributeContext(),
                                             *_summarySetup->getAttributeManager(), *getSessionManager()));
-    SearchView::InternalDocsumReply reply(ctx->getDocsums(), true);
+    ISummaryManager::ISummarySetup & summarySetup = *_summarySetup;
+    SearchView::InternalDocsumReply reply(ctx->getDocsums(threadBundle, [&summarySetup, &req]() {
+                                              return summarySetup.createDocsumStore(req.resultClassName);
+                                          }), true);
     uint64_t endGeneration = readGuard->get().getCurrentGeneration();
     if (startGeneration != endGeneration) {
         if (requestHasLidAbove(req, std::min(numUsedLids, metaStore.getNumUsedLids()))) {
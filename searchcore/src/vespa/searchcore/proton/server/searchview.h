@@ -31,10 +31,10 @@ public:
     DocIdLimit &getDocIdLimit() const { return _matchView->getDocIdLimit(); }
     matching::MatchingStats getMatcherStats(const vespalib::string &rankProfile) const { return _matchView->getMatcherStats(rankProfile); }
 
-    std::unique_ptr<DocsumReply> getDocsums(const DocsumRequest & req) override;
+    std::unique_ptr<DocsumReply> getDocsums(const DocsumRequest & req, ThreadBundle &threadBundle) override;
     std::unique_ptr<SearchReply> match(const ISearchHandler::SP &self, const SearchRequest &req, vespalib::ThreadBundle &threadBundle) const override;
 private:
-    InternalDocsumReply getDocsumsInternal(const DocsumRequest & req);
+    InternalDocsumReply getDocsumsInternal(const DocsumRequest & req, ThreadBundle &threadBundle);
     ISummaryManager::ISummarySetup::SP _summarySetup;
     MatchView::SP                      _matchView;
 };
@@ -290,7 +290,8 @@ StoreOnlyFeedView::internalPut(FeedToken token, const PutOperation &putOp)
         std::shared_ptr<PutDoneContext> onWriteDone =
             createPutDoneContext(std::move(token), _gidToLidChangeHandler, doc, gid, putOp.getLid(), serialNum,
                                  putOp.changedDbdId() && useDocumentMetaStore(serialNum));
-        putSummary(serialNum, putOp.getLid(), doc, onWriteDone);
+        onWriteDone->setLatencyTracker(putOp.getLatencyTracker());
+        putSummary(serialNum, putOp.getLid(), doc, putOp.getSerializedDocument(), onWriteDone);
         putAttributes(serialNum, putOp.getLid(), *doc, immediateCommit, onWriteDone);
         putIndexedFields(serialNum, putOp.getLid(), doc, immediateCommit, onWriteDone);
     }
@@ -344,17 +345,18 @@ StoreOnlyFeedView::handleUpdate(FeedToken token, const UpdateOperation &updOp)
     internalUpdate(std::move(token), updOp);
 }
 
-void StoreOnlyFeedView::putSummary(SerialNum serialNum, Lid lid,
-                                   FutureStream futureStream, OnOperationDoneType onDone)
+void StoreOnlyFeedView::updateSummary(SerialNum serialNum, Lid lid, FutureStream futureStream,
+                                      DocumentUpdateSP upd, OnOperationDoneType onDone)
 {
     _pendingLidTracker.produce(lid);
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Winline" // Avoid spurious inlining warning from GCC related to lambda destructor.
     summaryExecutor().execute(
-            makeLambdaTask([serialNum, lid, futureStream = std::move(futureStream), onDone, this] () mutable {
+            makeLambdaTask([serialNum, lid, futureStream = std::move(futureStream), upd = std::move(upd),
+                            onDone = OperationDoneContext::trackStage(onDone, FeedLatencyStats::SUMMARY), this] () mutable {
                 (void) onDone;
                 vespalib::nbostream os = std::move(futureStream.get());
-                if (!os.empty()) {
+                if (!os.empty() && !_summaryAdapter->update(serialNum, lid, *upd, _repo, os)) {
                     _summaryAdapter->put(serialNum, lid, os);
                 }
                 _pendingLidTracker.consume(lid);
@@ -368,13 +370,33 @@ void StoreOnlyFeedView::putSummary(SerialNum serialNum, Lid lid, Document::SP do
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Winline" // Avoid spurious inlining warning from GCC related to lambda destructor.
     summaryExecutor().execute(
-            makeLambdaTask([serialNum, doc = std::move(doc), onDone, lid, this] {
+            makeLambdaTask([serialNum, doc = std::move(doc),
+                            onDone = OperationDoneContext::trackStage(onDone, FeedLatencyStats::SUMMARY), lid, this] {
                 (void) onDone;
                 _summaryAdapter->put(serialNum, lid, *doc);
                 _pendingLidTracker.consume(lid);
             }));
 #pragma GCC diagnostic pop
 }
+void StoreOnlyFeedView::putSummary(SerialNum serialNum, Lid lid, Document::SP doc,
+                                   PutOperation::SerializedDocumentSP serializedDoc, OnOperationDoneType onDone)
+{
+    if ( ! serializedDoc) {
+        putSummary(serialNum, lid, std::move(doc), std::move(onDone));
+        return;
+    }
+    _pendingLidTracker.produce(lid);
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Winline" // Avoid spurious inlining warning from GCC related to lambda destructor.
+    summaryExecutor().execute(
+            makeLambdaTask([serialNum, doc = std::move(doc), serializedDoc = std::move(serializedDoc),
+                            onDone = OperationDoneContext::trackStage(onDone, FeedLatencyStats::SUMMARY), lid, this] {
+                (void) onDone;
+                _summaryAdapter->put(serialNum, lid, *doc, *serializedDoc);
+                _pendingLidTracker.consume(lid);
+            }));
+#pragma GCC diagnostic pop
+}
 void StoreOnlyFeedView::removeSummary(SerialNum serialNum, Lid lid, OnWriteDoneType onDone) {
     _pendingLidTracker.produce(lid);
     summaryExecutor().execute(
@@ -451,6 +473,7 @@ StoreOnlyFeedView::internalUpdate(FeedToken token, const UpdateOperation &updOp)
 
     bool immediateCommit = _commitTimeTracker.needCommit();
     auto onWriteDone = createUpdateDoneContext(std::move(token), updOp.getUpdate());
+    onWriteDone->setLatencyTracker(updOp.getLatencyTracker());
     UpdateScope updateScope(*_schema, upd);
     updateAttributes(serialNum, lid, upd, immediateCommit, onWriteDone, updateScope);
 
@@ -465,7 +488,7 @@ StoreOnlyFeedView::internalUpdate(FeedToken token, const UpdateOperation &updOp)
         PromisedStream promisedStream;
         FutureStream futureStream = promisedStream.get_future();
         if (useDocumentStore(serialNum)) {
-            putSummary(serialNum, lid, std::move(futureStream), onWriteDone);
+            updateSummary(serialNum, lid, std::move(futureStream), updOp.getUpdate(), onWriteDone);
         }
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Winline" // Avoid spurious inlining warning from GCC related to lambda destructor.
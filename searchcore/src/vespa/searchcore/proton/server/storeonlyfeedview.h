@@ -14,6 +14,7 @@
 #include <vespa/searchcore/proton/documentmetastore/documentmetastore.h>
 #include <vespa/searchcore/proton/documentmetastore/documentmetastorecontext.h>
 #include <vespa/searchcore/proton/feedoperation/lidvectorcontext.h>
+#include <vespa/searchcore/proton/feedoperation/putoperation.h>
 #include <vespa/searchcore/proton/persistenceengine/resulthandler.h>
 #include <vespa/searchcore/proton/reference/pending_notify_remove_done.h>
 #include <vespa/searchcorespi/index/ithreadingservice.h>
@@ -158,8 +159,10 @@ private:
     searchcorespi::index::IThreadService & summaryExecutor() {
         return _writeService.summary();
     }
-    void putSummary(SerialNum serialNum,  Lid lid, FutureStream doc, OnOperationDoneType onDone);
+    void updateSummary(SerialNum serialNum,  Lid lid, FutureStream doc, DocumentUpdateSP upd, OnOperationDoneType onDone);
     void putSummary(SerialNum serialNum,  Lid lid, DocumentSP doc, OnOperationDoneType onDone);
+    void putSummary(SerialNum serialNum,  Lid lid, DocumentSP doc, PutOperation::SerializedDocumentSP serializedDoc,
+                    OnOperationDoneType onDone);
     void removeSummary(SerialNum serialNum,  Lid lid, OnWriteDoneType onDone);
     void heartBeatSummary(SerialNum serialNum);
 
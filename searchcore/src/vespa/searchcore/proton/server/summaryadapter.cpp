@@ -48,6 +48,33 @@ SummaryAdapter::put(SerialNum serialNum, const DocumentIdT lid, const vespalib::
     }
 }
 
+void
+SummaryAdapter::put(SerialNum serialNum, const DocumentIdT lid, const Document &doc,
+                    const vespalib::nbostream &serializedDoc)
+{
+    if ( ! ignore(serialNum) ) {
+        LOG(spam, "SummaryAdapter::put(docId = '%s', lid = %u, stream size = '%zd')",
+            doc.getId().toString().c_str(), lid, serializedDoc.size());
+        _mgr->putDocument(serialNum, lid, doc, serializedDoc);
+        _lastSerial = serialNum;
+    }
+}
+
+bool
+SummaryAdapter::update(SerialNum serialNum, const DocumentIdT lid, const DocumentUpdate &upd,
+                       const std::shared_ptr<const DocumentTypeRepo> &repo,
+                       const vespalib::nbostream &updatedDoc)
+{
+    if (ignore(serialNum)) {
+        return true;
+    }
+    if ( ! _mgr->updateDocument(serialNum, lid, upd, repo, updatedDoc)) {
+        return false;
+    }
+    _lastSerial = serialNum;
+    return true;
+}
+
 void
 SummaryAdapter::remove(SerialNum serialNum, const DocumentIdT lid)
 {
@@ -22,6 +22,11 @@ public:
 
     void put(SerialNum serialNum, const DocumentIdT lid, const Document &doc) override;
     void put(SerialNum serialNum, const DocumentIdT lid, const vespalib::nbostream &doc) override;
+    void put(SerialNum serialNum, const DocumentIdT lid, const Document &doc,
+             const vespalib::nbostream &serializedDoc) override;
+    bool update(SerialNum serialNum, const DocumentIdT lid, const document::DocumentUpdate &upd,
+                const std::shared_ptr<const DocumentTypeRepo> &repo,
+                const vespalib::nbostream &updatedDoc) override;
     void remove(SerialNum serialNum, const DocumentIdT lid) override;
     void heartBeat(SerialNum serialNum) override;
     const search::IDocumentStore &getDocumentStore() const override;
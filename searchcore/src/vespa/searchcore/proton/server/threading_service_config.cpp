@@ -10,10 +10,12 @@ using ProtonConfig = ThreadingServiceConfig::ProtonConfig;
 
 ThreadingServiceConfig::ThreadingServiceConfig(uint32_t indexingThreads_,
                                                uint32_t defaultTaskLimit_,
-                                               uint32_t semiUnboundTaskLimit_)
+                                               uint32_t semiUnboundTaskLimit_,
+                                               uint32_t feedPrepareThreads_)
     : _indexingThreads(indexingThreads_),
       _defaultTaskLimit(defaultTaskLimit_),
-      _semiUnboundTaskLimit(semiUnboundTaskLimit_)
+      _semiUnboundTaskLimit(semiUnboundTaskLimit_),
+      _feedPrepareThreads(feedPrepareThreads_)
 {
 }
 
@@ -37,7 +39,8 @@ ThreadingServiceConfig::make(const ProtonConfig &cfg,
     uint32_t indexingThreads = calculateIndexingThreads(cfg, cpuInfo);
     return ThreadingServiceConfig(indexingThreads,
                                   cfg.indexing.tasklimit,
-                                  (cfg.indexing.semiunboundtasklimit / indexingThreads));
+                                  (cfg.indexing.semiunboundtasklimit / indexingThreads),
+                                  std::max(0, cfg.feeding.preparethreads));
 }
 
 }
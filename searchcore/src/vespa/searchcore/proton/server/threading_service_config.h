@@ -18,11 +18,13 @@ private:
     uint32_t _indexingThreads;
     uint32_t _defaultTaskLimit;
     uint32_t _semiUnboundTaskLimit;
+    uint32_t _feedPrepareThreads;
 
 private:
     ThreadingServiceConfig(uint32_t indexingThreads_,
                            uint32_t defaultTaskLimit_,
-                           uint32_t semiUnboundTaskLimit_);
+                           uint32_t semiUnboundTaskLimit_,
+                           uint32_t feedPrepareThreads_);
 
 public:
     static ThreadingServiceConfig make(const ProtonConfig &cfg,
@@ -31,6 +33,7 @@ public:
     uint32_t indexingThreads() const { return _indexingThreads; }
     uint32_t defaultTaskLimit() const { return _defaultTaskLimit; }
     uint32_t semiUnboundTaskLimit() const { return _semiUnboundTaskLimit; }
+    uint32_t feedPrepareThreads() const { return _feedPrepareThreads; }
 };
 
 }
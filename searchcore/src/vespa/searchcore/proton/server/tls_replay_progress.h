@@ -4,16 +4,20 @@
 
 #include <vespa/searchlib/common/serialnum.h>
 #include <vespa/vespalib/stllike/string.h>
+#include <atomic>
+#include <chrono>
 
 namespace proton {
 
 class TlsReplayProgress
 {
 private:
-    const vespalib::string  _domainName;
-    const search::SerialNum _first;
-    const search::SerialNum _last;
-    search::SerialNum       _current;
+    using clock = std::chrono::steady_clock;
+    const vespalib::string          _domainName;
+    const search::SerialNum         _first;
+    const search::SerialNum         _last;
+    std::atomic<search::SerialNum>  _current;
+    const clock::time_point         _startTime;
 
 public:
     typedef std::unique_ptr<TlsReplayProgress> UP;
@@ -24,22 +28,42 @@ public:
         : _domainName(domainName),
           _first(first),
           _last(last),
-          _current(first)
+          _current(first),
+          _startTime(clock::now())
     {
     }
     const vespalib::string &getDomainName() const { return _domainName; }
     search::SerialNum getFirst() const { return _first; }
     search::SerialNum getLast() const { return _last; }
-    search::SerialNum getCurrent() const { return _current; }
+    search::SerialNum getCurrent() const { return _current.load(std::memory_order_relaxed); }
     float getProgress() const {
         if (_first == _last) {
             return 1.0;
         } else {
-            return ((float)(_current - _first)/float(_last - _first));
+            return ((float)(getCurrent() - _first)/float(_last - _first));
         }
     }
-    void updateCurrent(search::SerialNum current) { _current = current; }
+    void updateCurrent(search::SerialNum current) { _current.store(current, std::memory_order_relaxed); }
+
+    double getElapsedSeconds() const {
+        return std::chrono::duration<double>(clock::now() - _startTime).count();
+    }
+    /**
+     * Replayed serial numbers per second since replay started. Each operation
+     * has its own serial number, so this is the operation throughput.
+     */
+    double getOperationsPerSecond() const {
+        double elapsed = getElapsedSeconds();
+        return (elapsed > 0.0) ? (getCurrent() - _first) / elapsed : 0.0;
+    }
+    /**
+     * Estimated seconds left of the replay at the throughput so far, or -1 if
+     * nothing has been replayed yet.
+     */
+    double getEstimatedSecondsLeft() const {
+        double opsPerSecond = getOperationsPerSecond();
+        return (opsPerSecond > 0.0) ? (_last - getCurrent()) / opsPerSecond : -1.0;
+    }
 };
 
 } // namespace proton
-
@@ -3,6 +3,7 @@
 #include "visibilityhandler.h"
 #include <vespa/searchlib/common/isequencedtaskexecutor.h>
 #include <vespa/vespalib/util/closuretask.h>
+#include <cassert>
 
 using vespalib::makeTask;
 using vespalib::makeClosure;
@@ -17,10 +18,17 @@ VisibilityHandler::VisibilityHandler(const IGetSerialNum & serial,
       _feedView(feedView),
       _visibilityDelay(0),
       _lastCommitSerialNum(0),
+      _scheduler(0),
       _lock()
 {
 }
 
+void VisibilityHandler::setVisibilityDelay(TimeStamp visibilityDelay)
+{
+    _visibilityDelay = visibilityDelay;
+    _scheduler.setMaxDelay(visibilityDelay);
+}
+
 void VisibilityHandler::commit()
 {
     if (_visibilityDelay != 0) {
@@ -51,6 +59,14 @@ void VisibilityHandler::commitAndWait()
     _writeService.summary().sync();
 }
 
+void VisibilityHandler::commitIfDue()
+{
+    assert(_writeService.master().isCurrentThread());
+    if ((_visibilityDelay != 0) && _scheduler.tick(_serial.getSerialNum(), fastos::ClockSystem::now())) {
+        performCommit(false);
+    }
+}
+
 bool VisibilityHandler::startCommit(const std::lock_guard<std::mutex> &unused, bool force)
 {
     (void) unused;
@@ -71,6 +87,7 @@ void VisibilityHandler::performCommit(bool force)
         IFeedView::SP feedView(_feedView.get());
         feedView->forceCommit(current);
         _lastCommitSerialNum = current;
+        _scheduler.committed(current, fastos::ClockSystem::now());
     }
 }
 
@@ -5,6 +5,7 @@
 #include <vespa/searchcore/proton/server/ifeedview.h>
 #include <vespa/searchcore/proton/server/icommitable.h>
 #include <vespa/searchcore/proton/server/igetserialnum.h>
+#include <vespa/searchcore/proton/common/commit_scheduler.h>
 #include <vespa/searchcorespi/index/ithreadingservice.h>
 #include <vespa/vespalib/util/varholder.h>
 #include <mutex>
@@ -26,10 +27,15 @@ public:
     VisibilityHandler(const IGetSerialNum &serial,
                       IThreadingService &threadingService,
                       const FeedViewHolder &feedView);
-    void setVisibilityDelay(TimeStamp visibilityDelay) { _visibilityDelay = visibilityDelay; }
+    void setVisibilityDelay(TimeStamp visibilityDelay);
     TimeStamp getVisibilityDelay() const { return _visibilityDelay; } 
     void commit() override;
     virtual void commitAndWait() override;
+    /**
+     * Commit if the commit scheduler finds it is time to, in master write thread.
+     */
+    void commitIfDue() override;
+    CommitStats takeCommitStats() { return _scheduler.takeStats(); }
 private:
     bool startCommit(const std::lock_guard<std::mutex> &unused, bool force);
     void performCommit(bool force);
@@ -38,6 +44,7 @@ private:
     const FeedViewHolder & _feedView;
     TimeStamp              _visibilityDelay;
     SerialNum              _lastCommitSerialNum;
+    CommitScheduler        _scheduler;
     std::mutex             _lock;
 };
 
@@ -35,8 +35,9 @@ public:
 
     /**
      * @return Use the request and produce the document summary result.
+     * @param threadBundle Threads that can be used to produce the docsums of the request in parallel.
      */
-    virtual std::unique_ptr<DocsumReply> getDocsums(const DocsumRequest & request) = 0;
+    virtual std::unique_ptr<DocsumReply> getDocsums(const DocsumRequest & request, ThreadBundle &threadBundle) = 0;
 
     virtual std::unique_ptr<SearchReply>
     match(const ISearchHandler::SP &self, const SearchRequest &req, ThreadBundle &threadBundle) const = 0;
@@ -14,6 +14,29 @@ namespace {
 
 Memory DOCSUMS("docsums");
 
+/**
+ * Hands a thread bundle obtained from the pool back to it when going
+ * out of scope, also when producing the docsums throws.
+ */
+class ThreadBundleGuard {
+private:
+    vespalib::SimpleThreadBundle::Pool & _pool;
+    vespalib::SimpleThreadBundle::UP     _bundle;
+
+public:
+    ThreadBundleGuard(vespalib::SimpleThreadBundle::Pool & pool)
+        : _pool(pool),
+          _bundle(pool.obtain())
+    {
+    }
+    ThreadBundleGuard(const ThreadBundleGuard &) = delete;
+    ThreadBundleGuard & operator=(const ThreadBundleGuard &) = delete;
+    ~ThreadBundleGuard() {
+        _pool.release(std::move(_bundle));
+    }
+    vespalib::ThreadBundle & get() { return *_bundle; }
+};
+
 class DocsumTask : public vespalib::Executor::Task {
 private:
     SummaryEngine       & _engine;
@@ -56,11 +79,12 @@ SummaryEngine::DocsumMetrics::DocsumMetrics()
 
 SummaryEngine::DocsumMetrics::~DocsumMetrics() = default;
 
-SummaryEngine::SummaryEngine(size_t numThreads)
+SummaryEngine::SummaryEngine(size_t numThreads, size_t threadsPerRequest)
     : _lock(),
       _closed(false),
       _handlers(),
       _executor(numThreads, 128 * 1024),
+      _threadBundlePool(std::max(size_t(1), threadsPerRequest)),
       _metrics(std::make_unique<DocsumMetrics>())
 { }
 
@@ -124,17 +148,20 @@ SummaryEngine::getDocsums(DocsumRequest::UP req)
     DocsumReply::UP reply = std::make_unique<DocsumReply>();
 
     if (req) {
-        ISearchHandler::SP searchHandler = getSearchHandler(DocTypeName(*req));
-        if (searchHandler) {
-            reply = searchHandler->getDocsums(*req);
-        } else {
-            vespalib::Sequence<ISearchHandler*>::UP snapshot;
-            {
-                std::lock_guard<std::mutex> guard(_lock);
-                snapshot = _handlers.snapshot();
-            }
-            if (snapshot->valid()) {
-                reply = snapshot->get()->getDocsums(*req); // use the first handler
+        {
+            ThreadBundleGuard threadBundle(_threadBundlePool);
+            ISearchHandler::SP searchHandler = getSearchHandler(DocTypeName(*req));
+            if (searchHandler) {
+                reply = searchHandler->getDocsums(*req, threadBundle.get());
+            } else {
+                vespalib::Sequence<ISearchHandler*>::UP snapshot;
+                {
+                    std::lock_guard<std::mutex> guard(_lock);
+                    snapshot = _handlers.snapshot();
+                }
+                if (snapshot->valid()) {
+                    reply = snapshot->get()->getDocsums(*req, threadBundle.get()); // use the first handler
+                }
             }
         }
         updateDocsumMetrics(req->getTimeUsed().sec(), getNumDocs(*reply));
@@ -6,6 +6,7 @@
 #include <vespa/searchcore/proton/common/handlermap.hpp>
 #include <vespa/searchlib/engine/docsumapi.h>
 #include <vespa/vespalib/util/threadstackexecutor.h>
+#include <vespa/vespalib/util/simple_thread_bundle.h>
 #include <vespa/metrics/valuemetric.h>
 #include <vespa/metrics/countmetric.h>
 #include <vespa/metrics/metricset.h>
@@ -35,6 +36,7 @@ private:
     bool                          _closed;
     HandlerMap<ISearchHandler>    _handlers;
     vespalib::ThreadStackExecutor _executor;
+    vespalib::SimpleThreadBundle::Pool _threadBundlePool;
     std::unique_ptr<metrics::MetricSet> _metrics;
 
 public:
@@ -48,8 +50,9 @@ public:
      * using the putSearchHandler() method.
      *
      * @param numThreads Number of threads allocated for handling summary requests.
+     * @param threadsPerRequest Max number of threads producing the docsums of a single request.
      */
-    SummaryEngine(size_t numThreads);
+    SummaryEngine(size_t numThreads, size_t threadsPerRequest = 1);
 
     /**
      * Frees any allocated resources. This will also stop all internal threads
@@ -45,6 +45,9 @@ public:
     virtual search::ISequencedTaskExecutor &attributeFieldWriter() {
         return _service.attributeFieldWriter();
     }
+    virtual search::ISequencedTaskExecutor &feedPrepare() {
+        return _service.feedPrepare();
+    }
 };
 
 } // namespace test
@@ -19,6 +19,7 @@ private:
     search::SequencedTaskExecutorObserver _indexFieldInverter;
     search::SequencedTaskExecutorObserver _indexFieldWriter;
     search::SequencedTaskExecutorObserver _attributeFieldWriter;
+    search::SequencedTaskExecutorObserver _feedPrepare;
 
 public:
     ThreadingServiceObserver(searchcorespi::index::IThreadingService &service)
@@ -28,7 +29,8 @@ public:
           _summary(service.summary()),
           _indexFieldInverter(_service.indexFieldInverter()),
           _indexFieldWriter(_service.indexFieldWriter()),
-          _attributeFieldWriter(_service.attributeFieldWriter())
+          _attributeFieldWriter(_service.attributeFieldWriter()),
+          _feedPrepare(_service.feedPrepare())
     {
     }
     virtual ~ThreadingServiceObserver() override { }
@@ -51,6 +53,9 @@ public:
     const search::SequencedTaskExecutorObserver &attributeFieldWriterObserver() const {
         return _attributeFieldWriter;
     }
+    const search::SequencedTaskExecutorObserver &feedPrepareObserver() const {
+        return _feedPrepare;
+    }
 
     /**
      * Implements vespalib::Syncable
@@ -81,6 +86,9 @@ public:
     virtual search::ISequencedTaskExecutor &attributeFieldWriter() override {
         return _attributeFieldWriter;
     }
+    virtual search::ISequencedTaskExecutor &feedPrepare() override {
+        return _feedPrepare;
+    }
 };
 
 } // namespace test
@@ -46,6 +46,10 @@ namespace index {
 
 namespace {
 
+// Only every 16th query term is recorded in the warmup query sample, which keeps
+// the cost on the query path low while still following the traffic.
+const uint32_t WARMUP_SAMPLE_RECORD_INTERVAL = 16;
+
 class ReconfigRunnable : public Runnable
 {
 public:
@@ -388,9 +392,12 @@ IndexMaintainer::swapInNewIndex(LockGuard & guard,
     if (_warmupConfig.getDuration() > 0) {
         if (dynamic_cast<const IDiskIndex *>(&source) != NULL) {
             LOG(debug, "Warming up a disk index.");
-            indexes = std::make_shared<WarmupIndexCollection>
-                      (_warmupConfig, getLeaf(guard, _source_list, true), indexes,
-                       static_cast<IDiskIndex &>(source), _ctx.getWarmupExecutor(), *this);
+            auto warmup = std::make_shared<WarmupIndexCollection>
+                          (_warmupConfig, getLeaf(guard, _source_list, true), indexes,
+                           static_cast<IDiskIndex &>(source), _ctx.getWarmupExecutor(), *this,
+                           _warmupQuerySample);
+            warmup->start();
+            indexes = std::move(warmup);
         } else {
             LOG(debug, "No warmup needed as it is a memory index that is mapped in.");
         }
@@ -802,6 +809,10 @@ IndexMaintainer::IndexMaintainer(const IndexMaintainerConfig &config,
                                  IIndexMaintainerOperations &operations)
     : _base_dir(config.getBaseDir()),
       _warmupConfig(config.getWarmup()),
+      _warmupQuerySample(_warmupConfig.getReplaySampleSize() > 0
+                         ? std::make_shared<WarmupQuerySample>(_warmupConfig.getReplaySampleSize(),
+                                                               WARMUP_SAMPLE_RECORD_INTERVAL)
+                         : WarmupQuerySample::SP()),
       _active_indexes(new ActiveDiskIndexes()),
       _layout(config.getBaseDir()),
       _schema(config.getSchema()),
@@ -14,6 +14,7 @@
 #include "ithreadingservice.h"
 #include "indexsearchable.h"
 #include "indexcollection.h"
+#include "querysamplerecorder.h"
 #include <vespa/searchcorespi/flush/iflushtarget.h>
 #include <vespa/searchcorespi/flush/flushstats.h>
 #include <vespa/searchlib/attribute/fixedsourceselector.h>
@@ -86,6 +87,7 @@ class IndexMaintainer : public IIndexManager,
     typedef search::queryeval::ISourceSelector ISourceSelector;
     const vespalib::string _base_dir;
     const WarmupConfig     _warmupConfig;
+    WarmupQuerySample::SP  _warmupQuerySample;
     ActiveDiskIndexes::SP  _active_indexes;
     IndexDiskLayout        _layout;
     Schema                 _schema;             // Protected by SL + IUL
@@ -373,6 +375,9 @@ public:
 
     searchcorespi::IndexSearchable::SP getSearchable() const override {
         vespalib::LockGuard lock(_new_search_lock);
+        if (_warmupQuerySample) {
+            return std::make_shared<QuerySampleRecorder>(_source_list, _warmupQuerySample);
+        }
         return _source_list;
     }
 
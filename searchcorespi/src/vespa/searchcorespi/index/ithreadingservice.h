@@ -57,6 +57,7 @@ struct IThreadingService : public vespalib::Syncable
     virtual search::ISequencedTaskExecutor &indexFieldInverter() = 0;
     virtual search::ISequencedTaskExecutor &indexFieldWriter() = 0;
     virtual search::ISequencedTaskExecutor &attributeFieldWriter() = 0;
+    virtual search::ISequencedTaskExecutor &feedPrepare() = 0;
 };
 
 }
@@ -0,0 +1,54 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "querysamplerecorder.h"
+
+namespace searchcorespi {
+namespace index {
+
+QuerySampleRecorder::QuerySampleRecorder(IndexSearchable::SP searchable, WarmupQuerySample::SP sample)
+    : _searchable(std::move(searchable)),
+      _sample(std::move(sample))
+{
+}
+
+QuerySampleRecorder::~QuerySampleRecorder() = default;
+
+QuerySampleRecorder::Blueprint::UP
+QuerySampleRecorder::createBlueprint(const IRequestContext & requestContext,
+                                     const FieldSpec &field,
+                                     const Node &term)
+{
+    FieldSpecList fields;
+    fields.add(field);
+    return createBlueprint(requestContext, fields, term);
+}
+
+QuerySampleRecorder::Blueprint::UP
+QuerySampleRecorder::createBlueprint(const IRequestContext & requestContext,
+                                     const FieldSpecList &fields,
+                                     const Node &term)
+{
+    _sample->record(fields, term);
+    return _searchable->createBlueprint(requestContext, fields, term);
+}
+
+search::SearchableStats
+QuerySampleRecorder::getSearchableStats() const
+{
+    return _searchable->getSearchableStats();
+}
+
+search::SerialNum
+QuerySampleRecorder::getSerialNum() const
+{
+    return _searchable->getSerialNum();
+}
+
+void
+QuerySampleRecorder::accept(IndexSearchableVisitor &visitor) const
+{
+    _searchable->accept(visitor);
+}
+
+}  // namespace index
+}  // namespace searchcorespi
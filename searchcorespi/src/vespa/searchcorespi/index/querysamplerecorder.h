@@ -0,0 +1,39 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "indexsearchable.h"
+#include "warmupquerysample.h"
+
+namespace searchcorespi {
+namespace index {
+
+/**
+ * Index searchable handed out to the query path, recording the terms of
+ * live queries in the warmup query sample before passing them on.
+ */
+class QuerySampleRecorder : public IndexSearchable {
+public:
+    QuerySampleRecorder(IndexSearchable::SP searchable, WarmupQuerySample::SP sample);
+    ~QuerySampleRecorder();
+
+    Blueprint::UP
+    createBlueprint(const IRequestContext & requestContext,
+                    const FieldSpec &field,
+                    const Node &term) override;
+    Blueprint::UP
+    createBlueprint(const IRequestContext & requestContext,
+                    const FieldSpecList &fields,
+                    const Node &term) override;
+    search::SearchableStats getSearchableStats() const override;
+    search::SerialNum getSerialNum() const override;
+    void accept(IndexSearchableVisitor &visitor) const override;
+
+    const IndexSearchable::SP & getSearchable() const { return _searchable; }
+private:
+    IndexSearchable::SP   _searchable;
+    WarmupQuerySample::SP _sample;
+};
+
+}  // namespace index
+}  // namespace searchcorespi
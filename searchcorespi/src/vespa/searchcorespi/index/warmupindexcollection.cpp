@@ -2,7 +2,11 @@
 #include "warmupindexcollection.h"
 #include "idiskindex.h"
 #include <vespa/vespalib/util/closuretask.h>
+#include <vespa/vespalib/util/lambdatask.h>
 #include <vespa/searchlib/fef/matchdatalayout.h>
+#include <vespa/searchlib/query/tree/intermediatenodes.h>
+#include <vespa/searchlib/query/tree/queryreplicator.h>
+#include <vespa/searchlib/query/tree/simplequery.h>
 #include <vespa/searchlib/query/tree/termnodes.h>
 #include <vespa/vespalib/stllike/hash_map.hpp>
 #include <vespa/vespalib/stllike/hash_set.h>
@@ -12,7 +16,12 @@ LOG_SETUP(".searchcorespi.index.warmupindexcollection");
 
 namespace searchcorespi {
 
+using search::query::Node;
+using search::query::Phrase;
+using search::query::QueryReplicator;
+using search::query::SimpleQueryNodeTypes;
 using search::query::StringBase;
+using vespalib::makeLambdaTask;
 using search::queryeval::Blueprint;
 using search::fef::MatchDataLayout;
 using search::queryeval::SearchIterator;
@@ -29,12 +38,44 @@ class FieldTermMap : public vespalib::hash_map<uint32_t, TermMap>
 
 };
 
+namespace {
+
+bool
+getTermKey(const Node &term, vespalib::string &key)
+{
+    const StringBase * sb(dynamic_cast<const StringBase *>(&term));
+    if (sb != NULL) {
+        key = sb->getTerm();
+        return true;
+    }
+    const Phrase * phrase(dynamic_cast<const Phrase *>(&term));
+    if (phrase != NULL) {
+        key = "\"";
+        for (const Node * child : phrase->getChildren()) {
+            const StringBase * word(dynamic_cast<const StringBase *>(child));
+            if (word == NULL) {
+                return false;
+            }
+            if (key.size() > 1) {
+                key += ' ';
+            }
+            key += word->getTerm();
+        }
+        key += '"';
+        return true;
+    }
+    return false;
+}
+
+}
+
 WarmupIndexCollection::WarmupIndexCollection(const WarmupConfig & warmupConfig,
                                              ISearchableIndexCollection::SP prev,
                                              ISearchableIndexCollection::SP next,
                                              IndexSearchable & warmup,
                                              vespalib::ThreadExecutor & executor,
-                                             IWarmupDone & warmupDone) :
+                                             IWarmupDone & warmupDone,
+                                             index::WarmupQuerySample::SP querySample) :
     _warmupConfig(warmupConfig),
     _prev(prev),
     _next(next),
@@ -42,7 +83,9 @@ WarmupIndexCollection::WarmupIndexCollection(const WarmupConfig & warmupConfig,
     _executor(executor),
     _warmupDone(warmupDone),
     _warmupEndTime(ClockSystem::now() + TimeStamp::Seconds(warmupConfig.getDuration())),
-    _handledTerms(std::make_unique<FieldTermMap>())
+    _handledTerms(std::make_unique<FieldTermMap>()),
+    _querySample(std::move(querySample)),
+    _aborted(false)
 {
     if (next->valid()) {
         setCurrentIndex(next->getCurrentIndex());
@@ -53,6 +96,33 @@ WarmupIndexCollection::WarmupIndexCollection(const WarmupConfig & warmupConfig,
     LOG(debug, "%s", toString().c_str());
 }
 
+void
+WarmupIndexCollection::start()
+{
+    if ( ! _querySample) {
+        return;
+    }
+    // One task per term, so an expired or aborted warmup skips the rest of the
+    // sample. The destructor syncs the executor, so no task can outlive this.
+    _querySample->forEach([this](const FieldSpecList &fields, const Node &term) {
+        std::shared_ptr<Node> copy(QueryReplicator<SimpleQueryNodeTypes>().replicate(term));
+        _executor.execute(makeLambdaTask([this, fields, copy]() { replayTerm(fields, *copy); }));
+    });
+    LOG(debug, "Replaying %zu recorded query terms against '%s'", _querySample->size(), typeid(_warmup).name());
+}
+
+void
+WarmupIndexCollection::replayTerm(const FieldSpecList &fields, const Node &term)
+{
+    if (_aborted || (ClockSystem::now() >= _warmupEndTime)) {
+        return;
+    }
+    Task::UP task = createWarmupTask(fields, term);
+    if (task) {
+        task->run();
+    }
+}
+
 void
 WarmupIndexCollection::setSource(uint32_t docId)
 {
@@ -83,7 +153,8 @@ WarmupIndexCollection::~WarmupIndexCollection()
     if (_warmupEndTime != 0) {
         LOG(info, "Warmup aborted due to new state change or application shutdown");
     }
-   _executor.sync();
+    _aborted = true;
+    _executor.sync();
 }
 
 const ISourceSelector &
@@ -130,15 +201,34 @@ WarmupIndexCollection::fireWarmup(Task::UP task)
 bool
 WarmupIndexCollection::handledBefore(uint32_t fieldId, const Node &term)
 {
-    const StringBase * sb(dynamic_cast<const StringBase *>(&term));
-    if (sb != NULL) {
-        const vespalib::string & s = sb->getTerm();
+    vespalib::string key;
+    if (getTermKey(term, key)) {
         std::lock_guard<std::mutex> guard(_lock);
-        TermMap::insert_result found = (*_handledTerms)[fieldId].insert(s);
+        TermMap::insert_result found = (*_handledTerms)[fieldId].insert(key);
         return ! found.second;
     }
     return true;
 }
+
+WarmupIndexCollection::Task::UP
+WarmupIndexCollection::createWarmupTask(const FieldSpecList &fields, const Node &term)
+{
+    MatchDataLayout mdl;
+    FieldSpecList fsl;
+    bool needWarmUp(false);
+    for(size_t i(0); i < fields.size(); i++) {
+        const FieldSpec & f(fields[i]);
+        FieldSpec fs(f.getName(), f.getFieldId(), mdl.allocTermField(f.getFieldId()), f.isFilter());
+        fsl.add(fs);
+        needWarmUp = needWarmUp || ! handledBefore(fs.getFieldId(), term);
+    }
+    if ( ! needWarmUp) {
+        return Task::UP();
+    }
+    auto task = std::make_unique<WarmupTask>(mdl.createMatchData(), *this);
+    task->createBlueprint(fsl, term);
+    return task;
+}
 Blueprint::UP
 WarmupIndexCollection::createBlueprint(const IRequestContext & requestContext,
                                        const FieldSpec &field,
@@ -158,18 +248,8 @@ WarmupIndexCollection::createBlueprint(const IRequestContext & requestContext,
         // warmup done
         return _next->createBlueprint(requestContext, fields, term);
     }
-    MatchDataLayout mdl;
-    FieldSpecList fsl;
-    bool needWarmUp(false);
-    for(size_t i(0); i < fields.size(); i++) {
-        const FieldSpec & f(fields[i]);
-        FieldSpec fs(f.getName(), f.getFieldId(), mdl.allocTermField(f.getFieldId()), f.isFilter());
-        fsl.add(fs);
-        needWarmUp = needWarmUp || ! handledBefore(fs.getFieldId(), term);
-    }
-    if (needWarmUp) {
-        Task::UP task(new WarmupTask(mdl.createMatchData(), *this));
-        static_cast<WarmupTask &>(*task).createBlueprint(fsl, term);
+    Task::UP task = createWarmupTask(fields, term);
+    if (task) {
         fireWarmup(std::move(task));
     }
     return _prev->createBlueprint(requestContext, fields, term);
@@ -4,6 +4,7 @@
 
 #include "isearchableindexcollection.h"
 #include "warmupconfig.h"
+#include "warmupquerysample.h"
 #include <vespa/vespalib/util/threadexecutor.h>
 #include <vespa/searchlib/queryeval/fake_requestcontext.h>
 
@@ -19,6 +20,11 @@ public:
 /**
  * Index collection that holds a reference to the active one and a new one that
  * is to be warmed up.
+ *
+ * If given a query sample, the terms in it are replayed against the new
+ * index when the warmup is started. The replay runs on the warmup executor,
+ * which proton already dedicates to index warmup, so it does not compete
+ * with query or feed threads.
  */
 class WarmupIndexCollection : public ISearchableIndexCollection,
                               public std::enable_shared_from_this<WarmupIndexCollection>
@@ -31,8 +37,16 @@ public:
                           ISearchableIndexCollection::SP next,
                           IndexSearchable & warmup,
                           vespalib::ThreadExecutor & executor,
-                          IWarmupDone & warmupDone);
+                          IWarmupDone & warmupDone,
+                          index::WarmupQuerySample::SP querySample = index::WarmupQuerySample::SP());
     ~WarmupIndexCollection();
+    /**
+     * Starts replaying the query sample against the new index on the warmup
+     * executor, one task per term. Terms still queued when the warmup period
+     * ends, or when the collection is destroyed, are skipped.
+     * Called once the collection is created.
+     */
+    void start();
     // Implements IIndexCollection
     const ISourceSelector &getSourceSelector() const override;
     size_t getSourceCount() const override;
@@ -91,6 +105,8 @@ private:
 
     void fireWarmup(Task::UP task);
     bool handledBefore(uint32_t fieldId, const Node &term);
+    Task::UP createWarmupTask(const FieldSpecList &fields, const Node &term);
+    void replayTerm(const FieldSpecList &fields, const Node &term);
 
     const WarmupConfig               _warmupConfig;
     ISearchableIndexCollection::SP   _prev;
@@ -101,6 +117,8 @@ private:
     fastos::TimeStamp                _warmupEndTime;
     std::mutex                       _lock;
     std::unique_ptr<FieldTermMap>    _handledTerms;
+    index::WarmupQuerySample::SP     _querySample;
+    std::atomic<bool>                _aborted;
 };
 
 }  // namespace searchcorespi
@@ -0,0 +1,67 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "warmupquerysample.h"
+#include <vespa/searchlib/query/tree/queryreplicator.h>
+#include <vespa/searchlib/query/tree/simplequery.h>
+#include <algorithm>
+
+namespace searchcorespi {
+namespace index {
+
+using search::query::QueryReplicator;
+using search::query::SimpleQueryNodeTypes;
+
+WarmupQuerySample::WarmupQuerySample(size_t maxEntries, uint32_t recordInterval)
+    : _lock(),
+      _maxEntries(maxEntries),
+      _recordInterval(std::max(recordInterval, 1u)),
+      _numSeen(0),
+      _entries(),
+      _rnd()
+{
+    _rnd.srand48(42);
+}
+
+WarmupQuerySample::~WarmupQuerySample() = default;
+
+void
+WarmupQuerySample::record(const FieldSpecList &fields, const Node &term)
+{
+    if ((_maxEntries == 0) || ((_numSeen.fetch_add(1, std::memory_order_relaxed) % _recordInterval) != 0)) {
+        return;
+    }
+    Entry entry{fields, QueryReplicator<SimpleQueryNodeTypes>().replicate(term)};
+    std::lock_guard<std::mutex> guard(_lock);
+    if (_entries.size() < _maxEntries) {
+        _entries.push_back(std::move(entry));
+    } else {
+        uint64_t slot = static_cast<uint64_t>(_rnd.lrand48()) % _maxEntries;
+        _entries[slot] = std::move(entry);
+    }
+}
+
+void
+WarmupQuerySample::forEach(const Visitor &visitor) const
+{
+    std::vector<Entry> entries;
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        entries.reserve(_entries.size());
+        for (const auto &entry : _entries) {
+            entries.push_back(Entry{entry.fields, QueryReplicator<SimpleQueryNodeTypes>().replicate(*entry.term)});
+        }
+    }
+    for (const auto &entry : entries) {
+        visitor(entry.fields, *entry.term);
+    }
+}
+
+size_t
+WarmupQuerySample::size() const
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    return _entries.size();
+}
+
+}  // namespace index
+}  // namespace searchcorespi
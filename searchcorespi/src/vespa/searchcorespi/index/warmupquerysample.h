@@ -0,0 +1,64 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/searchlib/query/tree/node.h>
+#include <vespa/searchlib/queryeval/field_spec.h>
+#include <vespa/searchlib/util/rand48.h>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace searchcorespi {
+namespace index {
+
+/**
+ * Bounded random sample of the query terms seen by live queries, biased
+ * towards recent queries. The sample is replayed against the next disk index
+ * to be warmed up as soon as it is swapped in, before live queries have had a
+ * chance to touch it.
+ */
+class WarmupQuerySample {
+public:
+    using SP = std::shared_ptr<WarmupQuerySample>;
+    using FieldSpecList = search::queryeval::FieldSpecList;
+    using Node = search::query::Node;
+    using Visitor = std::function<void(const FieldSpecList &fields, const Node &term)>;
+
+    /**
+     * @param maxEntries Max number of terms in the sample.
+     * @param recordInterval Only every recordInterval'th term seen is recorded,
+     *                       to keep the cost on the query path low.
+     */
+    WarmupQuerySample(size_t maxEntries, uint32_t recordInterval = 1);
+    ~WarmupQuerySample();
+
+    /**
+     * Record a term. When the sample is full the term replaces a random
+     * entry, so an entry survives the next n recorded terms with probability
+     * (1 - 1/maxEntries)^n, and the sample follows the recent traffic.
+     */
+    void record(const FieldSpecList &fields, const Node &term);
+    /**
+     * Visits a copy of the sample, so recording is not blocked by the visitor.
+     */
+    void forEach(const Visitor &visitor) const;
+    size_t size() const;
+    size_t getMaxEntries() const { return _maxEntries; }
+private:
+    struct Entry {
+        FieldSpecList fields;
+        std::unique_ptr<Node> term;
+    };
+    mutable std::mutex    _lock;
+    const size_t          _maxEntries;
+    const uint32_t        _recordInterval;
+    std::atomic<uint64_t> _numSeen;
+    std::vector<Entry>    _entries;
+    search::Rand48        _rnd;
+};
+
+}  // namespace index
+}  // namespace searchcorespi
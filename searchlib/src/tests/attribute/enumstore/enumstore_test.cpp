@@ -59,6 +59,11 @@ private:
     template <typename EnumStoreType>
     void testReset(bool hasPostings);
 
+    void testHashIndex();
+    template <typename EnumStoreType>
+    void testHashIndex(bool hasPostings);
+    void testFloatHashIndex();
+
     void testHoldListAndGeneration();
     void testMemoryUsage();
     void requireThatAddressSpaceUsageIsReported();
@@ -477,6 +482,86 @@ EnumStoreTest::testCompaction(bool hasPostings, bool disableReEnumerate)
     EXPECT_EQUAL(3 * entrySize, idx.offset());
 }
 
+void
+EnumStoreTest::testHashIndex()
+{
+    testHashIndex<StringEnumStore>(false);
+    testHashIndex<StringEnumStore>(true);
+    testFloatHashIndex();
+}
+
+template <typename EnumStoreType>
+void
+EnumStoreTest::testHashIndex(bool hasPostings)
+{
+    uint32_t entrySize = EnumStoreType::alignEntrySize(15);
+    EnumStoreType ses(entrySize * 5, hasPostings);
+    ses.setUseHashIndex(true);
+    EXPECT_TRUE(ses.getUseHashIndex());
+    EnumIndex idx;
+    std::vector<EnumIndex> indices;
+    std::vector<std::string> uniques = { "enum02", "enum00", "Enum01", "enum01", "enum03" };
+    for (const auto &unique : uniques) {
+        EXPECT_FALSE(ses.findIndex(unique.c_str(), idx));
+        ses.addEnum(unique.c_str(), idx);
+        ses.incRefCount(idx);
+        indices.push_back(idx);
+        EnumIndex foundIdx;
+        EXPECT_TRUE(ses.findIndex(unique.c_str(), foundIdx));
+        EXPECT_TRUE(foundIdx == idx);
+    }
+    EXPECT_FALSE(ses.findIndex("ENUM01", idx));
+    ses.addEnum("enum01", idx);
+    EXPECT_TRUE(idx == indices[3]);
+    EXPECT_EQUAL(4u, ses.getLastEnum());
+    EXPECT_LESS(0u, ses.getTreeMemoryUsage().allocatedBytes());
+
+    // free enum00 and enum03
+    ses.decRefCount(indices[1]);
+    ses.decRefCount(indices[4]);
+    EnumStoreBase::IndexVector toRemove;
+    toRemove.push_back(indices[1]);
+    toRemove.push_back(indices[4]);
+    ses.freeUnusedEnums(toRemove);
+    EXPECT_FALSE(ses.findIndex("enum00", idx));
+    EXPECT_FALSE(ses.findIndex("enum03", idx));
+    EXPECT_TRUE(ses.findIndex("enum02", idx));
+    EXPECT_TRUE(idx == indices[0]);
+
+    // compaction moves all entries, hash index must follow
+    EXPECT_TRUE(ses.performCompaction(3 * entrySize));
+    for (uint32_t i : { 0u, 2u, 3u }) {
+        EnumIndex newIdx;
+        EXPECT_TRUE(ses.getCurrentIndex(indices[i], newIdx));
+        EXPECT_TRUE(ses.findIndex(uniques[i].c_str(), idx));
+        EXPECT_TRUE(idx == newIdx);
+    }
+    ses.addEnum("enum00", idx);
+    EnumIndex foundIdx;
+    EXPECT_TRUE(ses.findIndex("enum00", foundIdx));
+    EXPECT_TRUE(foundIdx == idx);
+    EXPECT_EQUAL(1u, idx.bufferId());
+}
+
+void
+EnumStoreTest::testFloatHashIndex()
+{
+    FloatEnumStore fes(1000, false);
+    fes.setUseHashIndex(true);
+    EnumIndex idx;
+    fes.addEnum(std::numeric_limits<float>::quiet_NaN(), idx);
+    EXPECT_TRUE(fes.findIndex(-std::numeric_limits<float>::quiet_NaN(), idx));
+    fes.addEnum(0.0f, idx);
+    EnumIndex foundIdx;
+    EXPECT_TRUE(fes.findIndex(-0.0f, foundIdx));
+    EXPECT_TRUE(foundIdx == idx);
+    fes.addEnum(1.5f, idx);
+    EXPECT_TRUE(fes.findIndex(1.5f, foundIdx));
+    EXPECT_TRUE(foundIdx == idx);
+    EXPECT_FALSE(fes.findIndex(2.5f, foundIdx));
+    EXPECT_EQUAL(2u, fes.getLastEnum());
+}
+
 void
 EnumStoreTest::testReset()
 {
@@ -876,6 +961,7 @@ EnumStoreTest::Main()
     testFloatEnumStore();
     testAddEnum();
     testCompaction();
+    testHashIndex();
     testReset();
     testHoldListAndGeneration();
     testMemoryUsage();
@@ -4,6 +4,7 @@
 #include <vespa/searchlib/attribute/multi_value_mapping.h>
 #include <vespa/searchlib/attribute/multi_value_mapping.hpp>
 #include <vespa/searchlib/attribute/not_implemented_attribute.h>
+#include <vespa/searchcommon/common/compaction_strategy.h>
 #include <vespa/searchlib/util/rand48.h>
 #include <vespa/vespalib/util/generationhandler.h>
 #include <vespa/vespalib/test/insertion_operators.h>
@@ -137,6 +138,17 @@ public:
         _attr.commit();
         _attr.incGeneration();
     }
+
+    bool considerCompact() {
+        _mvMapping.updateStat();
+        bool result = _mvMapping.considerCompact(search::CompactionStrategy());
+        _attr.commit();
+        _attr.incGeneration();
+        return result;
+    }
+    void setCompactLidsPerStep(uint32_t compactLidsPerStep) { _mvMapping.setCompactLidsPerStep(compactLidsPerStep); }
+    bool compactionInProgress() const { return _mvMapping.compactionInProgress(); }
+    uint32_t getCompactionBacklog() const { return _mvMapping.getCompactionBacklog(); }
 };
 
 class IntFixture : public Fixture<int>
@@ -209,6 +221,12 @@ public:
         set(docId, {});
         _refMapping.erase(docId);
     }
+
+    void setRandomDoc(uint32_t docId) {
+        std::vector<int> values = makeValues();
+        _refMapping[docId] = values;
+        set(docId, values);
+    }
 };
 
 TEST_F("Test that set and get works", Fixture<int>(3))
@@ -329,4 +347,31 @@ TEST_F("Test that compaction works", IntFixture(3, 64, 512, 129))
     EXPECT_LESS(bufferCountAfter, bufferCountBefore);
 }
 
+TEST_F("Test that compaction is spread over multiple commits", IntFixture(3, 64, 512, 129))
+{
+    f.addRandomDocs(40000);
+    uint32_t docIdLimit = f.size();
+    for (uint32_t docId = 0; docId < docIdLimit / 2; ++docId) {
+        f.clearDoc(docId);
+    }
+    f.addDocs(0);
+    uint32_t lidsPerStep = docIdLimit / 4 + 1;
+    f.setCompactLidsPerStep(lidsPerStep);
+    EXPECT_TRUE(f.considerCompact());
+    EXPECT_TRUE(f.compactionInProgress());
+    EXPECT_EQUAL(docIdLimit - lidsPerStep, f.getCompactionBacklog());
+    TEST_DO(f.checkRefMapping());
+    // Modify docs both behind and ahead of the compaction cursor
+    f.setRandomDoc(1);
+    f.setRandomDoc(docIdLimit - 1);
+    uint32_t steps = 1;
+    while (f.compactionInProgress()) {
+        EXPECT_TRUE(f.considerCompact());
+        ++steps;
+        TEST_DO(f.checkRefMapping());
+    }
+    EXPECT_EQUAL(4u, steps);
+    EXPECT_EQUAL(0u, f.getCompactionBacklog());
+}
+
 TEST_MAIN() { TEST_RUN_ALL(); }
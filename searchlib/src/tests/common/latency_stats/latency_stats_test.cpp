@@ -0,0 +1,79 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/searchlib/common/latency_stats.h>
+#include <vespa/searchlib/common/stats_collector.h>
+#include <vespa/vespalib/testkit/test_kit.h>
+
+using search::LatencyStats;
+using search::StatsCollector;
+
+namespace {
+
+struct MyStats {
+    size_t       ops;
+    LatencyStats latency;
+    MyStats() : ops(0), latency() {}
+    MyStats & operator += (const MyStats &rhs) {
+        ops += rhs.ops;
+        latency.add(rhs.latency);
+        return *this;
+    }
+};
+
+}
+
+TEST("require that latency stats track count, average, min and max") {
+    LatencyStats stats;
+    EXPECT_EQUAL(0u, stats.count());
+    EXPECT_EQUAL(0.0, stats.avg());
+    stats.add(2.0);
+    EXPECT_EQUAL(1u, stats.count());
+    EXPECT_EQUAL(2.0, stats.min());
+    EXPECT_EQUAL(2.0, stats.max());
+    stats.add(4.0);
+    stats.add(0.0);
+    EXPECT_EQUAL(3u, stats.count());
+    EXPECT_EQUAL(2.0, stats.avg());
+    EXPECT_EQUAL(0.0, stats.min());
+    EXPECT_EQUAL(4.0, stats.max());
+}
+
+TEST("require that latency stats can be merged") {
+    LatencyStats stats;
+    LatencyStats other;
+    stats.add(other);
+    EXPECT_EQUAL(0u, stats.count());
+    other.add(3.0);
+    other.add(5.0);
+    stats.add(other);
+    EXPECT_EQUAL(2u, stats.count());
+    EXPECT_EQUAL(3.0, stats.min());
+    EXPECT_EQUAL(5.0, stats.max());
+    stats.add(LatencyStats());
+    EXPECT_EQUAL(3.0, stats.min());
+    LatencyStats low;
+    low.add(1.0);
+    stats.add(low);
+    EXPECT_EQUAL(3u, stats.count());
+    EXPECT_EQUAL(3.0, stats.avg());
+    EXPECT_EQUAL(1.0, stats.min());
+    EXPECT_EQUAL(5.0, stats.max());
+}
+
+TEST("require that stats collector hands out the stats collected since the previous take") {
+    StatsCollector<MyStats> collector;
+    collector.update([](MyStats &stats) { ++stats.ops; stats.latency.add(1.0); });
+    MyStats added;
+    added.ops = 2;
+    added.latency.add(3.0);
+    collector.add(added);
+    MyStats taken = collector.take();
+    EXPECT_EQUAL(3u, taken.ops);
+    EXPECT_EQUAL(2u, taken.latency.count());
+    EXPECT_EQUAL(2.0, taken.latency.avg());
+    taken = collector.take();
+    EXPECT_EQUAL(0u, taken.ops);
+    EXPECT_EQUAL(0u, taken.latency.count());
+}
+
+TEST_MAIN() { TEST_RUN_ALL(); }
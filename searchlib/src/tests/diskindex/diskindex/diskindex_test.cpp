@@ -9,6 +9,7 @@
 #include <vespa/searchlib/diskindex/zcposocciterators.h>
 #include <vespa/searchlib/query/tree/simplequery.h>
 #include <vespa/searchlib/queryeval/booleanmatchiteratorwrapper.h>
+#include <vespa/searchlib/queryeval/intermediate_blueprints.h>
 #include <vespa/searchlib/queryeval/leaf_blueprints.h>
 #include <vespa/searchlib/queryeval/emptysearch.h>
 #include <vespa/searchlib/queryeval/fake_requestcontext.h>
@@ -60,6 +61,7 @@ private:
     void requireThatWeCanReadBitVector();
     void requireThatBlueprintIsCreated();
     void requireThatBlueprintCanCreateSearchIterators();
+    void requireThatBlueprintPrefetchesPostingList(const std::string &dir);
     void requireThatSearchIteratorsConforms();
 public:
     Test();
@@ -278,6 +280,31 @@ Test::requireThatBlueprintCanCreateSearchIterators()
     }
 }
 
+void
+Test::requireThatBlueprintPrefetchesPostingList(const std::string &dir)
+{
+    for (bool enabled : {true, false}) {
+        TEST_STATE(enabled ? "prefetch enabled" : "prefetch disabled");
+        TuneFileSearch tuneFileSearch(_index->getTuneFileSearch());
+        tuneFileSearch._prefetchPostings = enabled;
+        DiskIndex index(dir);
+        ASSERT_TRUE(index.setup(tuneFileSearch));
+        AndBlueprint b;
+        b.addChild(index.createBlueprint(_requestContext, FieldSpec("f1", 0, 0), makeTerm("w1")));
+        b.addChild(index.createBlueprint(_requestContext, FieldSpec("f2", 0, 0, true), makeTerm("w2")));
+        const DiskTermBlueprint *postingList = dynamic_cast<const DiskTermBlueprint *>(&b.getChild(0));
+        const DiskTermBlueprint *bitVector = dynamic_cast<const DiskTermBlueprint *>(&b.getChild(1));
+        ASSERT_TRUE(postingList != nullptr);
+        ASSERT_TRUE(bitVector != nullptr);
+        // Not before the blueprint tree is optimized and postings are fetched
+        EXPECT_FALSE(postingList->postingsPrefetched());
+        b.fetchPostings(true);
+        EXPECT_EQUAL(enabled, postingList->postingsPrefetched());
+        // Bit vectors are read in full, nothing to prefetch
+        EXPECT_FALSE(bitVector->postingsPrefetched());
+    }
+}
+
 Test::Test() :
     TestDiskIndex()
 {
@@ -316,6 +343,7 @@ Test::Main()
     TEST_DO(requireThatWeCanReadBitVector());
     TEST_DO(requireThatBlueprintIsCreated());
     TEST_DO(requireThatBlueprintCanCreateSearchIterators());
+    TEST_DO(requireThatBlueprintPrefetchesPostingList("index/1"));
 
     TEST_DO(openIndex("index/2", true, false, false, false, false));
     TEST_DO(requireThatLookupIsWorking(false, false, false));
@@ -323,6 +351,7 @@ Test::Main()
     TEST_DO(requireThatWeCanReadBitVector());
     TEST_DO(requireThatBlueprintIsCreated());
     TEST_DO(requireThatBlueprintCanCreateSearchIterators());
+    TEST_DO(requireThatBlueprintPrefetchesPostingList("index/2"));
 
     TEST_DO(openIndex("index/3", false, true, false, false, false));
     TEST_DO(requireThatLookupIsWorking(false, false, false));
@@ -330,6 +359,7 @@ Test::Main()
     TEST_DO(requireThatWeCanReadBitVector());
     TEST_DO(requireThatBlueprintIsCreated());
     TEST_DO(requireThatBlueprintCanCreateSearchIterators());
+    TEST_DO(requireThatBlueprintPrefetchesPostingList("index/3"));
 
     TEST_DO(openIndex("index/4", true, true, false, false, false));
     TEST_DO(requireThatLookupIsWorking(false, false, false));
@@ -337,6 +367,7 @@ Test::Main()
     TEST_DO(requireThatWeCanReadBitVector());
     TEST_DO(requireThatBlueprintIsCreated());
     TEST_DO(requireThatBlueprintCanCreateSearchIterators());
+    TEST_DO(requireThatBlueprintPrefetchesPostingList("index/4"));
     TEST_DO(requireThatSearchIteratorsConforms());
 
     TEST_DONE();
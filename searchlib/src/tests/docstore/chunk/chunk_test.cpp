@@ -8,11 +8,15 @@
 #include <vespa/searchlib/docstore/chunkformats.h>
 #include <vespa/vespalib/objects/hexdump.h>
 #include <vespa/vespalib/stllike/string.h>
+#include <vespa/vespalib/util/stringfmt.h>
+#include <vespa/vespalib/util/zstdcompressor.h>
 
 LOG_SETUP("chunk_test");
 
 using namespace search;
 using vespalib::compression::CompressionConfig;
+using vespalib::compression::ZStdDictionary;
+using vespalib::make_string;
 
 TEST("require that Chunk obey limits")
 {
@@ -98,4 +102,73 @@ TEST("require that V2 can create and handle lz4, zstd, and none") {
     verifyChunkCompression(CompressionConfig::ZSTD, MY_LONG_STRING, strlen(MY_LONG_STRING), 282);
 }
 
+vespalib::string
+makeDocument(uint32_t id) {
+    return make_string("{\"title\":\"Document number %u\",\"category\":\"category-%u\","
+                       "\"body\":\"%s\",\"popularity\":%u}", id, id % 17, MY_LONG_STRING + (id % 64), id * 7);
+}
+
+std::unique_ptr<ZStdDictionary>
+trainDictionary() {
+    std::vector<vespalib::string> samples;
+    for (uint32_t id(0); id < 2000; id++) {
+        samples.push_back(makeDocument(id));
+    }
+    std::vector<vespalib::ConstBufferRef> refs;
+    for (const vespalib::string & sample : samples) {
+        refs.emplace_back(sample.c_str(), sample.size());
+    }
+    return ZStdDictionary::train(refs, 4096);
+}
+
+size_t
+packChunk(Chunk & chunk, vespalib::DataBuffer & buffer) {
+    for (uint32_t lid(0); lid < 4; lid++) {
+        vespalib::string doc = makeDocument(100000 + lid);
+        chunk.append(lid, doc.c_str(), doc.size());
+    }
+    chunk.pack(7, buffer, CompressionConfig(CompressionConfig::ZSTD));
+    return buffer.getDataLen();
+}
+
+TEST("require that V3 compresses with dictionary and can be read back") {
+    std::unique_ptr<ZStdDictionary> dictionary = trainDictionary();
+    ASSERT_TRUE(dictionary);
+    EXPECT_NOT_EQUAL(0u, dictionary->getId());
+
+    Chunk withDictionary(0, Chunk::Config(0x10000, dictionary.get()));
+    vespalib::DataBuffer buffer;
+    size_t dictionaryLen = packChunk(withDictionary, buffer);
+    Chunk plain(0, Chunk::Config(0x10000));
+    vespalib::DataBuffer plainBuffer;
+    size_t plainLen = packChunk(plain, plainBuffer);
+    EXPECT_LESS(dictionaryLen, plainLen);
+
+    Chunk deserialized(0, buffer.getData(), buffer.getDataLen(), false, dictionary.get());
+    EXPECT_EQUAL(4u, deserialized.count());
+    for (uint32_t lid(0); lid < 4; lid++) {
+        vespalib::string expected = makeDocument(100000 + lid);
+        vespalib::ConstBufferRef data = deserialized.getLid(lid);
+        EXPECT_EQUAL(expected, vespalib::string(data.c_str(), data.size()));
+    }
+    EXPECT_EXCEPTION(Chunk(0, buffer.getData(), buffer.getDataLen(), false), ChunkException,
+                     "Missing compression dictionary");
+    ZStdDictionary copy(dictionary->getData().c_str(), dictionary->getData().size());
+    EXPECT_EQUAL(dictionary->getId(), copy.getId());
+    Chunk fromCopy(0, buffer.getData(), buffer.getDataLen(), false, &copy);
+    EXPECT_EQUAL(4u, fromCopy.count());
+}
+
+TEST("require that only valid dictionaries can be created from stored data") {
+    std::unique_ptr<ZStdDictionary> dictionary = trainDictionary();
+    ASSERT_TRUE(dictionary);
+    vespalib::ConstBufferRef data = dictionary->getData();
+    std::unique_ptr<ZStdDictionary> created = ZStdDictionary::create(data.c_str(), data.size());
+    ASSERT_TRUE(created);
+    EXPECT_EQUAL(dictionary->getId(), created->getId());
+    EXPECT_FALSE(ZStdDictionary::create(data.c_str(), 16));
+    EXPECT_FALSE(ZStdDictionary::create(MY_LONG_STRING, strlen(MY_LONG_STRING)));
+    EXPECT_FALSE(ZStdDictionary::create(data.c_str(), 0));
+}
+
 TEST_MAIN() { TEST_RUN_ALL(); }
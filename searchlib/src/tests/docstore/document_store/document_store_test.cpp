@@ -2,8 +2,20 @@
 #include <vespa/vespalib/testkit/test_kit.h>
 #include <vespa/searchlib/docstore/logdocumentstore.h>
 #include <vespa/searchlib/docstore/cachestats.h>
+#include <vespa/searchlib/docstore/hot_store.h>
+#include <vespa/vespalib/data/databuffer.h>
+#include <vespa/document/repo/configbuilder.h>
 #include <vespa/document/repo/documenttyperepo.h>
+#include <vespa/document/datatype/documenttype.h>
 #include <vespa/document/fieldvalue/document.h>
+#include <vespa/document/fieldvalue/stringfieldvalue.h>
+#include <vespa/document/fieldset/fieldsets.h>
+#include <vespa/document/update/assignvalueupdate.h>
+#include <vespa/document/update/documentupdate.h>
+#include <vespa/vespalib/objects/nbostream.h>
+#include <vespa/vespalib/test/insertion_operators.h>
+#include <vespa/vespalib/util/stringfmt.h>
+#include <map>
 
 using namespace search;
 using CompressionConfig = vespalib::compression::CompressionConfig;
@@ -44,6 +56,40 @@ struct NullDataStore : IDataStore {
     void shrinkLidSpace() override {}
 };
 
+struct BatchCountingDataStore : NullDataStore {
+    mutable size_t batches;
+    mutable LidVector lastLids;
+    BatchCountingDataStore() : NullDataStore(), batches(0), lastLids() {}
+    void read(const LidVector & lids, IBufferVisitor &) const override {
+        batches++;
+        lastLids = lids;
+    }
+};
+
+TEST_FFF("require that batched uncached docstore lookups use a single backing store read",
+         DocumentStore::Config(CompressionConfig::NONE, 0, 0),
+         BatchCountingDataStore(), DocumentStore(f1, f2))
+{
+    IDocumentStore::LidVector lids({3, 1, 2});
+    std::vector<IDocumentStore::DocumentUP> docs = f3.read(lids, repo, document::AllFields());
+    EXPECT_EQUAL(3u, docs.size());
+    EXPECT_EQUAL(1u, f2.batches);
+    EXPECT_TRUE(lids == f2.lastLids);
+    EXPECT_EQUAL(3u, f3.getCacheStats().misses);
+}
+
+TEST_FFF("require that batched cached docstore lookups read all misses in one go",
+         DocumentStore::Config(CompressionConfig::NONE, 100000, 100),
+         BatchCountingDataStore(), DocumentStore(f1, f2))
+{
+    IDocumentStore::LidVector lids({5, 7});
+    std::vector<IDocumentStore::DocumentUP> docs = f3.read(lids, repo, document::AllFields());
+    EXPECT_EQUAL(2u, docs.size());
+    EXPECT_TRUE(!docs[0] && !docs[1]);
+    EXPECT_EQUAL(1u, f2.batches);
+    EXPECT_TRUE(lids == f2.lastLids);
+}
+
 TEST_FFF("require that uncache docstore lookups are counted",
          DocumentStore::Config(CompressionConfig::NONE, 0, 0),
          NullDataStore(), DocumentStore(f1, f2))
@@ -69,6 +115,315 @@ TEST("require that DocumentStore::Config equality operator detects inequality")
     EXPECT_FALSE(C(CompressionConfig::NONE, 100000, 100) == C(CompressionConfig::NONE, 100000, 99));
     EXPECT_FALSE(C(CompressionConfig::NONE, 100000, 100) == C(CompressionConfig::NONE, 100001, 100));
     EXPECT_FALSE(C(CompressionConfig::NONE, 100000, 100) == C(CompressionConfig::LZ4, 100000, 100));
+    EXPECT_FALSE(C(CompressionConfig::NONE, 100000, 100).setCacheStripes(4) == C(CompressionConfig::NONE, 100000, 100));
+    EXPECT_FALSE(C(CompressionConfig::NONE, 100000, 100).useCacheAdmission(true) == C(CompressionConfig::NONE, 100000, 100));
+    EXPECT_FALSE(C(CompressionConfig::NONE, 100000, 100).setHotStore(1000, 3) == C(CompressionConfig::NONE, 100000, 100));
+    EXPECT_FALSE(C().setHotStore(1000, 3) == C().setHotStore(1000, 4));
+    EXPECT_FALSE(C().useUpdateDeltas(true) == C());
+}
+
+DocumentStore::Config
+makeStripedConfig() {
+    DocumentStore::Config config(CompressionConfig::NONE, 100000, 100);
+    config.setCacheStripes(3).useCacheAdmission(true);
+    return config;
+}
+
+TEST_FFF("require that striped cache with admission counts lookups",
+         DocumentStore::Config(makeStripedConfig()), NullDataStore(), DocumentStore(f1, f2))
+{
+    EXPECT_EQUAL(3u, f1.getCacheStripes());
+    f3.read(1, repo);
+    f3.read(2, repo);
+    CacheStats stats = f3.getCacheStats();
+    EXPECT_EQUAL(0u, stats.hits);
+    EXPECT_EQUAL(2u, stats.misses);
+    EXPECT_EQUAL(0u, stats.admission_rejects);
+}
+
+using docstore::HotStore;
+
+struct HotStoreFixture {
+    HotStore store;
+    std::string doc;
+    HotStoreFixture(size_t maxBytes, size_t numStripes = 1)
+        : store(maxBytes, 2, CompressionConfig(CompressionConfig::LZ4, 9, 70), numStripes),
+          doc(1000, 'a')
+    { }
+    HotStore::Lookup read(uint32_t lid, std::string * content = nullptr) {
+        vespalib::DataBuffer buf;
+        HotStore::Lookup lookup = store.read(lid, buf);
+        if (content != nullptr) {
+            content->assign(buf.getData(), buf.getDataLen());
+        }
+        return lookup;
+    }
+    void promote(uint32_t lid, bool keep = true) {
+        store.promote(lid, CompressionConfig::NONE, doc.size(), vespalib::ConstBufferRef(doc.data(), doc.size()),
+                      [keep]() { return keep; });
+    }
+};
+
+TEST_F("require that hot store promotes documents read often enough", HotStoreFixture(100000))
+{
+    EXPECT_TRUE(f.store.enabled());
+    EXPECT_TRUE(HotStore::Lookup::MISS == f.read(1));
+    EXPECT_TRUE(HotStore::Lookup::PROMOTE == f.read(1));
+    f.promote(1);
+    std::string content;
+    EXPECT_TRUE(HotStore::Lookup::HIT == f.read(1, &content));
+    EXPECT_EQUAL(f.doc, content);
+    CacheStats stats = f.store.getStats();
+    EXPECT_EQUAL(1u, stats.hits);
+    EXPECT_EQUAL(2u, stats.misses);
+    EXPECT_EQUAL(1u, stats.elements);
+    EXPECT_LESS(stats.memory_used, f.doc.size());
+}
+
+TEST_F("require that hot store drops invalidated and concurrently written documents", HotStoreFixture(100000))
+{
+    f.read(1);
+    f.read(1);
+    f.promote(1, false);
+    EXPECT_EQUAL(0u, f.store.getStats().elements);
+    f.promote(1);
+    EXPECT_EQUAL(1u, f.store.getStats().elements);
+    f.store.invalidate(1);
+    EXPECT_EQUAL(0u, f.store.getStats().elements);
+    EXPECT_TRUE(HotStore::Lookup::PROMOTE == f.read(1));
+}
+
+TEST_F("require that full hot store only replaces less frequently read documents", HotStoreFixture(100))
+{
+    for (size_t i(0); i < 3; i++) {
+        f.read(1);
+    }
+    f.promote(1);
+    EXPECT_EQUAL(1u, f.store.getStats().elements);
+    f.read(2);
+    f.read(2);
+    f.promote(2);
+    EXPECT_EQUAL(1u, f.store.getStats().admission_rejects);
+    EXPECT_TRUE(HotStore::Lookup::HIT == f.read(1));
+    for (size_t i(0); i < 4; i++) {
+        f.read(2);
+    }
+    f.promote(2);
+    EXPECT_TRUE(HotStore::Lookup::HIT == f.read(2));
+    EXPECT_TRUE(HotStore::Lookup::HIT != f.read(1));
+    EXPECT_EQUAL(1u, f.store.getStats().elements);
+}
+
+TEST_F("require that striped hot store keeps documents in all stripes", HotStoreFixture(100000, 3))
+{
+    EXPECT_EQUAL(4u, f.store.numStripes());
+    for (uint32_t lid(1); lid <= 16; lid++) {
+        f.read(lid);
+        EXPECT_TRUE(HotStore::Lookup::PROMOTE == f.read(lid));
+        f.promote(lid);
+    }
+    for (uint32_t lid(1); lid <= 16; lid++) {
+        std::string content;
+        EXPECT_TRUE(HotStore::Lookup::HIT == f.read(lid, &content));
+        EXPECT_EQUAL(f.doc, content);
+    }
+    f.store.invalidate(7);
+    EXPECT_TRUE(HotStore::Lookup::HIT != f.read(7));
+    CacheStats stats = f.store.getStats();
+    EXPECT_EQUAL(15u, stats.elements);
+    EXPECT_EQUAL(16u, stats.hits);
+    EXPECT_EQUAL(33u, stats.misses);
+    f.store.reconfigure(0, 2, CompressionConfig());
+    EXPECT_FALSE(f.store.enabled());
+    EXPECT_EQUAL(0u, f.store.getStats().elements);
+}
+
+TEST_F("require that disabled hot store keeps nothing", HotStoreFixture(0))
+{
+    EXPECT_FALSE(f.store.enabled());
+    f.read(1);
+    f.read(1);
+    f.promote(1);
+    EXPECT_TRUE(HotStore::Lookup::MISS == f.read(1));
+    EXPECT_EQUAL(0u, f.store.getStats().elements);
+}
+
+struct MapDataStore : NullDataStore {
+    std::map<uint32_t, std::string> docs;
+    std::vector<uint64_t> serials;
+    mutable size_t numReads;
+    MapDataStore() : NullDataStore(), docs(), serials(), numReads(0) {}
+    ssize_t read(uint32_t lid, vespalib::DataBuffer & buf) const override {
+        ++numReads;
+        auto found = docs.find(lid);
+        if (found == docs.end()) {
+            return 0;
+        }
+        buf.writeBytes(found->second.data(), found->second.size());
+        return found->second.size();
+    }
+    void read(const LidVector & lids, IBufferVisitor & visitor) const override {
+        for (uint32_t lid : lids) {
+            auto found = docs.find(lid);
+            if (found != docs.end()) {
+                visitor.visit(lid, vespalib::ConstBufferRef(found->second.data(), found->second.size()));
+            }
+        }
+    }
+    void write(uint64_t serialNum, uint32_t lid, const void * buffer, size_t len) override {
+        docs[lid].assign(static_cast<const char *>(buffer), len);
+        serials.push_back(serialNum);
+    }
+    void remove(uint64_t serialNum, uint32_t lid) override {
+        docs.erase(lid);
+        serials.push_back(serialNum);
+    }
+};
+
+document::DocumenttypesConfig
+makeDocTypeRepoConfig()
+{
+    document::config_builder::DocumenttypesConfigBuilderHelper builder;
+    builder.document(787121340, "test",
+                     document::config_builder::Struct("test.header"),
+                     document::config_builder::Struct("test.body").
+                     addField("main", document::DataType::T_STRING));
+    return builder.config();
+}
+
+struct UpdateDeltaFixture {
+    std::shared_ptr<const document::DocumentTypeRepo> repo;
+    const document::DocumentType & docType;
+    MapDataStore backing;
+    DocumentStore store;
+    UpdateDeltaFixture(bool useDeltas = true)
+        : repo(std::make_shared<document::DocumentTypeRepo>(makeDocTypeRepoConfig())),
+          docType(*repo->getDocumentType("test")),
+          backing(),
+          store(DocumentStore::Config(CompressionConfig::NONE, 100000, 100).useUpdateDeltas(useDeltas), backing)
+    { }
+    document::DocumentId id(uint32_t lid) const {
+        return document::DocumentId(vespalib::make_string("id:test:test::%u", lid));
+    }
+    void put(uint64_t serialNum, uint32_t lid, const vespalib::string & main) {
+        document::Document doc(docType, id(lid));
+        doc.set("main", main);
+        store.write(serialNum, lid, doc);
+    }
+    bool update(uint64_t serialNum, uint32_t lid, const vespalib::string & main, bool withUpdatedDoc = false) {
+        document::DocumentUpdate upd(*repo, docType, id(lid));
+        upd.addUpdate(document::FieldUpdate(docType.getField("main")).
+                      addUpdate(document::AssignValueUpdate(document::StringFieldValue(main))));
+        vespalib::nbostream updatedDoc;
+        if (withUpdatedDoc) {
+            IDocumentStore::DocumentUP doc = store.read(lid, *repo);
+            upd.applyTo(*doc);
+            doc->serialize(updatedDoc);
+        }
+        return store.writeUpdate(serialNum, lid, upd, repo, updatedDoc);
+    }
+    vespalib::string getMain(const document::Document & doc) const {
+        return doc.getValue("main")->getAsString();
+    }
+    vespalib::string readMain(uint32_t lid) const {
+        IDocumentStore::DocumentUP doc = store.read(lid, *repo);
+        return doc ? getMain(*doc) : "";
+    }
+    vespalib::string storedMain(uint32_t lid) const {
+        const std::string & stored = backing.docs.find(lid)->second;
+        vespalib::nbostream is(stored.data(), stored.size());
+        return getMain(document::Document(*repo, is));
+    }
+};
+
+TEST_F("require that updates are kept as deltas and applied on read", UpdateDeltaFixture)
+{
+    f.put(10, 1, "first");
+    EXPECT_TRUE(f.update(11, 1, "second"));
+    EXPECT_EQUAL(1u, f.backing.serials.size());
+    EXPECT_EQUAL("first", f.storedMain(1));
+    EXPECT_EQUAL("second", f.readMain(1));
+    EXPECT_EQUAL("second", f.readMain(1));
+    IDocumentStore::LidVector lids({1});
+    std::vector<IDocumentStore::DocumentUP> docs = f.store.read(lids, *f.repo, document::AllFields());
+    EXPECT_EQUAL("second", f.getMain(*docs[0]));
+    EXPECT_EQUAL(11u, f.store.tentativeLastSyncToken());
+}
+
+TEST_F("require that the updated document is served without applying the deltas again", UpdateDeltaFixture)
+{
+    f.put(10, 1, "first");
+    EXPECT_TRUE(f.update(11, 1, "second", true));
+    EXPECT_TRUE(f.update(12, 1, "third", true));
+    EXPECT_EQUAL(1u, f.backing.numReads);
+    EXPECT_EQUAL("third", f.readMain(1));
+    EXPECT_EQUAL("third", f.readMain(1));
+    EXPECT_EQUAL(1u, f.backing.numReads);
+    EXPECT_EQUAL(12u, f.store.initFlush(12));
+    EXPECT_EQUAL(1u, f.backing.numReads);
+    EXPECT_EQUAL("third", f.storedMain(1));
+}
+
+TEST_F("require that updates are rejected when update deltas are not used", UpdateDeltaFixture(false))
+{
+    f.put(10, 1, "first");
+    EXPECT_FALSE(f.update(11, 1, "second"));
+    EXPECT_EQUAL("first", f.readMain(1));
+}
+
+TEST_F("require that a put replaces pending update deltas", UpdateDeltaFixture)
+{
+    f.put(10, 1, "first");
+    f.update(11, 1, "second");
+    f.put(12, 1, "third");
+    EXPECT_EQUAL(12u, f.backing.serials.back());
+    EXPECT_EQUAL("third", f.readMain(1));
+    EXPECT_EQUAL(12u, f.store.initFlush(12));
+    EXPECT_EQUAL(2u, f.backing.serials.size());
+    EXPECT_EQUAL("third", f.storedMain(1));
+}
+
+TEST_F("require that writes are held below pending deltas until they are folded on flush", UpdateDeltaFixture)
+{
+    f.put(10, 1, "first");
+    f.update(11, 1, "second");
+    f.put(12, 2, "other");
+    EXPECT_EQUAL(10u, f.backing.serials.back());
+    EXPECT_EQUAL(12u, f.store.initFlush(12));
+    EXPECT_EQUAL(3u, f.backing.serials.size());
+    EXPECT_EQUAL(11u, f.backing.serials.back());
+    EXPECT_EQUAL("second", f.storedMain(1));
+    EXPECT_EQUAL("second", f.readMain(1));
+    f.put(13, 2, "more");
+    EXPECT_EQUAL(13u, f.backing.serials.back());
+}
+
+TEST_F("require that deltas reaching past the flush hold it back", UpdateDeltaFixture)
+{
+    f.put(10, 1, "a");
+    f.put(11, 2, "b");
+    f.update(12, 1, "c");
+    f.update(13, 2, "d");
+    f.update(14, 1, "e");
+    EXPECT_EQUAL(11u, f.store.initFlush(13));
+    EXPECT_EQUAL(2u, f.backing.serials.size());
+    EXPECT_EQUAL(14u, f.store.initFlush(14));
+    EXPECT_EQUAL(4u, f.backing.serials.size());
+    EXPECT_EQUAL("e", f.storedMain(1));
+    EXPECT_EQUAL("d", f.storedMain(2));
+}
+TEST_F("require that folded documents are tagged with the last update they contain", UpdateDeltaFixture)
+{
+    f.put(10, 1, "a");
+    f.put(11, 2, "b");
+    f.update(12, 1, "c");
+    f.update(13, 2, "d");
+    f.update(14, 1, "e");
+    f.update(16, 3, "f");
+    EXPECT_EQUAL(15u, f.store.initFlush(15));
+    EXPECT_EQUAL((std::vector<uint64_t>{10, 11, 13, 14}), f.backing.serials);
+    EXPECT_EQUAL("e", f.storedMain(1));
+    EXPECT_EQUAL("d", f.storedMain(2));
 }
 
 TEST("require that LogDocumentStore::Config equality operator detects inequality") {
@@ -3,10 +3,12 @@
 
 #include <vespa/searchlib/common/fileheadercontext.h>
 #include <vespa/searchlib/docstore/filechunk.h>
+#include <vespa/searchlib/docstore/summaryexceptions.h>
 #include <vespa/searchlib/docstore/writeablefilechunk.h>
 #include <vespa/searchlib/test/directory_handler.h>
 #include <vespa/vespalib/test/insertion_operators.h>
 #include <vespa/vespalib/util/threadstackexecutor.h>
+#include <vespa/fastos/file.h>
 #include <iomanip>
 #include <iostream>
 
@@ -212,6 +214,40 @@ TEST("require that entries with lid >= docIdLimit are skipped in updateLidMap()"
     }
 }
 
+void
+writeDictionaryFile(const vespalib::string &baseName, const vespalib::string &content)
+{
+    vespalib::string fileName = FileChunk::createDictFileName(FileChunk::NameId(1234).createName(baseName));
+    FastOS_File file(fileName.c_str());
+    ASSERT_TRUE(file.OpenWriteOnlyTruncate());
+    file.WriteBuf(content.c_str(), content.size());
+    ASSERT_TRUE(file.Close());
+}
+
+TEST("require that corrupt dictionary file is reported when opening file chunk")
+{
+    {
+        test::DirectoryHandler dir("tmp");
+        writeDictionaryFile("tmp", "not a dictionary");
+        EXPECT_EXCEPTION(ReadFixture("tmp", false), SummaryException, "Corrupt dictionary file");
+    }
+    {
+        test::DirectoryHandler dir("tmp");
+        // Dictionary magic and id, but the entropy tables are cut off.
+        const char truncated[] = { '\x37', '\xa4', '\x30', '\xec', 1, 2, 3, 4, 5, 6, 7, 8 };
+        writeDictionaryFile("tmp", vespalib::string(truncated, sizeof(truncated)));
+        EXPECT_EXCEPTION(ReadFixture("tmp", false), SummaryException, "Corrupt dictionary file");
+    }
+}
+
+TEST("require that empty dictionary file means no dictionary")
+{
+    test::DirectoryHandler dir("tmp");
+    writeDictionaryFile("tmp", "");
+    ReadFixture f("tmp", false);
+    EXPECT_FALSE(f.chunk.getCompressionDictionary());
+}
+
 using vespalib::compression::CompressionConfig;
 
 TEST("require that operator == detects inequality") {
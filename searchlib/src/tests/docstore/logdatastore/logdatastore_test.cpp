@@ -5,6 +5,7 @@
 #include <vespa/document/repo/documenttyperepo.h>
 #include <vespa/document/datatype/documenttype.h>
 #include <vespa/document/fieldvalue/document.h>
+#include <vespa/searchlib/docstore/bandwidth_throttle.h>
 #include <vespa/searchlib/docstore/chunkformats.h>
 #include <vespa/searchlib/docstore/logdocumentstore.h>
 #include <vespa/searchlib/docstore/storebybucket.h>
@@ -694,6 +695,29 @@ TEST("requireThatFlushTimeIsAvailableAfterFlush") {
 }
 
 
+TEST("require that write path stats are collected and reset when taken") {
+    TmpDirectory testDir("writestats");
+    DummyFileHeaderContext fileHeaderContext;
+    LogDataStore::Config config;
+    vespalib::ThreadStackExecutor executor(1, 128*1024);
+    MyTlSyncer tlSyncer;
+    LogDataStore store(executor, testDir.getDir(), config, GrowStrategy(),
+                       TuneFileSummary(), fileHeaderContext, tlSyncer, nullptr);
+    vespalib::string data("some document data");
+    store.write(1, 1, data.c_str(), data.size());
+    store.flush(store.initFlush(1));
+    DataStoreWriteStats stats = store.getWriteStats();
+    EXPECT_LESS_EQUAL(1u, stats.compress().count());
+    EXPECT_LESS_EQUAL(1u, stats.write().count());
+    EXPECT_EQUAL(1u, stats.sync().count());
+    EXPECT_LESS_EQUAL(stats.sync().count(), stats.syncRequests());
+    EXPECT_LESS_EQUAL(stats.sync().min(), stats.sync().max());
+    stats = store.getWriteStats();
+    EXPECT_EQUAL(0u, stats.compress().count());
+    EXPECT_EQUAL(0u, stats.sync().count());
+    EXPECT_EQUAL(0u, stats.syncRequests());
+}
+
 class DummyBucketizer : public IBucketizer
 {
 public:
@@ -979,6 +1003,26 @@ TEST("require that config equality operator detects inequality") {
     EXPECT_FALSE(C() == C().disableCrcOnRead(true));
     EXPECT_FALSE(C() == C().compact2ActiveFile(false));
     EXPECT_FALSE(C() == C().compactCompression({CompressionConfig::ZSTD}));
+    EXPECT_FALSE(C() == C().setCompactMaxBytesPerSecond(1000000));
+    EXPECT_FALSE(C() == C().compactToBucketOrder(false));
+}
+
+TEST("require that bandwidth throttle delays consumption above budget") {
+    using docstore::BandwidthThrottle;
+    using namespace std::chrono;
+    BandwidthThrottle::Clock::time_point start;
+    BandwidthThrottle throttle(1000, start);
+    EXPECT_TRUE(throttle.account(500, start + milliseconds(500)) == BandwidthThrottle::Clock::duration::zero());
+    EXPECT_TRUE(throttle.account(500, start + milliseconds(500)) == milliseconds(500));
+    EXPECT_TRUE(throttle.account(1000, start + seconds(3)) == BandwidthThrottle::Clock::duration::zero());
+    EXPECT_EQUAL(2000u, throttle.getConsumedBytes());
+}
+
+TEST("require that bandwidth throttle without budget never delays") {
+    using docstore::BandwidthThrottle;
+    BandwidthThrottle::Clock::time_point start;
+    BandwidthThrottle throttle(0, start);
+    EXPECT_TRUE(throttle.account(1000000000, start) == BandwidthThrottle::Clock::duration::zero());
 }
 
 TEST_MAIN() {
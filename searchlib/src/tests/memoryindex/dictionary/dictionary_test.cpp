@@ -632,6 +632,26 @@ TEST_F("requireThatMultiplePostingListsCanExist", Fixture)
     EXPECT_TRUE(assertPostingList("[]", d.find("c", 0)));
 }
 
+TEST_F("require that new words are ordered among existing words", Fixture)
+{
+    Dictionary d(f.getSchema());
+    WrapInserter(d, 0).word("b").add(10).word("d").add(10).flush();
+    WrapInserter(d, 0).rewind().word("a").add(11).word("b").add(11).word("c").add(11).
+        word("d").add(11).word("e").add(11).flush();
+    EXPECT_EQUAL(5u, d.getNumUniqueWords());
+    EXPECT_TRUE(assertPostingList("[11]", d.find("a", 0)));
+    EXPECT_TRUE(assertPostingList("[10,11]", d.find("b", 0)));
+    EXPECT_TRUE(assertPostingList("[11]", d.find("c", 0)));
+    EXPECT_TRUE(assertPostingList("[10,11]", d.find("d", 0)));
+    EXPECT_TRUE(assertPostingList("[11]", d.find("e", 0)));
+    MemoryFieldIndex &fieldIndex = *d.getFieldIndex(0);
+    vespalib::string words;
+    for (auto itr = fieldIndex.getDictionaryTree().begin(); itr.valid(); ++itr) {
+        words += fieldIndex.getWordStore().getWord(itr.getKey()._wordRef);
+    }
+    EXPECT_EQUAL("abcde", words);
+}
+
 TEST_F("requireThatRemoveWorks", Fixture)
 {
     Dictionary d(f.getSchema());
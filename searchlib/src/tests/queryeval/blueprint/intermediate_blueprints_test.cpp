@@ -19,7 +19,9 @@ LOG_SETUP("blueprint_test");
 #include <vespa/searchlib/queryeval/ranksearch.h>
 #include <vespa/searchlib/queryeval/wand/weak_and_search.h>
 #include <vespa/searchlib/queryeval/fake_requestcontext.h>
+#include <vespa/searchlib/queryeval/emptysearch.h>
 #include <vespa/vespalib/io/fileutil.h>
+#include <vespa/vespalib/test/insertion_operators.h>
 #include <vespa/searchlib/test/diskindex/testdiskindex.h>
 #include <vespa/searchlib/query/tree/simplequery.h>
 #include <vespa/searchlib/common/bitvectoriterator.h>
@@ -1335,4 +1337,35 @@ TEST("require that ANDNOT without children is optimized to empty search") {
     EXPECT_EQUAL(expect_up->asString(), top_up->asString());
 }
 
+class PostingsLoggingLeaf : public SimpleLeafBlueprint
+{
+    vespalib::string                _name;
+    std::vector<vespalib::string> & _log;
+public:
+    PostingsLoggingLeaf(const vespalib::string &name, std::vector<vespalib::string> &log)
+        : SimpleLeafBlueprint(FieldSpecBaseList()),
+          _name(name),
+          _log(log)
+    {}
+    void prefetchPostings() override { _log.push_back("prefetch " + _name); }
+    void fetchPostings(bool) override { _log.push_back("fetch " + _name); }
+    SearchIterator::UP createLeafSearch(const TermFieldMatchDataArray &, bool) const override {
+        return SearchIterator::UP(new EmptySearch());
+    }
+};
+
+TEST("require that all postings are prefetched before any are fetched") {
+    std::vector<vespalib::string> log;
+    OrBlueprint top;
+    top.addChild(Blueprint::UP(new PostingsLoggingLeaf("a", log)));
+    AndBlueprint *child = new AndBlueprint();
+    child->addChild(Blueprint::UP(new PostingsLoggingLeaf("b", log)));
+    top.addChild(Blueprint::UP(child));
+    top.addChild(Blueprint::UP(new PostingsLoggingLeaf("c", log)));
+    top.fetchPostings(true);
+    std::vector<vespalib::string> expect = {"prefetch a", "prefetch b", "prefetch c",
+                                            "fetch a", "prefetch b", "fetch b", "fetch c"};
+    EXPECT_EQUAL(expect, log);
+}
+
 TEST_MAIN() { TEST_DEBUG("lhs.out", "rhs.out"); TEST_RUN_ALL(); }
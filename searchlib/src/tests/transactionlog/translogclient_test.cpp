@@ -4,6 +4,8 @@
 #include <vespa/vespalib/testkit/testapp.h>
 #include <vespa/vespalib/objects/identifiable.h>
 #include <vespa/searchlib/index/dummyfileheadercontext.h>
+#include <vespa/searchlib/common/gatecallback.h>
+#include <vespa/vespalib/util/sync.h>
 #include <vespa/fastos/file.h>
 #include <map>
 
@@ -50,6 +52,8 @@ private:
     void testCrcVersions();
     bool testVisitOverPreExistingDomain();
     void testMany();
+    void testCompressedBlocks();
+    void testGroupCommit();
     void testErase();
     void testSync();
     void testTruncateOnShortRead();
@@ -651,6 +655,72 @@ void Test::testMany()
     }
 }
 
+void Test::testCompressedBlocks()
+{
+    const unsigned int NUM_PACKETS = 1000;
+    const unsigned int NUM_ENTRIES = 100;
+    const unsigned int TOTAL_NUM_ENTRIES = NUM_PACKETS * NUM_ENTRIES;
+    DomainPart::CompressionConfig lz4(DomainPart::CompressionConfig::LZ4, 9, 90);
+    {
+        DummyFileHeaderContext fileHeaderContext;
+        TransLogServer tlss("testcompressed", 18377, ".", fileHeaderContext,
+                            DomainConfig().setPartSizeLimit(0x80000).setCompression(lz4), 4);
+        TransLogClient tls("tcp/localhost:18377");
+
+        createDomainTest(tls, "compressed", 0);
+        TransLogClient::Session::UP s1 = openDomainTest(tls, "compressed");
+        fillDomainTest(s1.get(), NUM_PACKETS, NUM_ENTRIES);
+        TEST_DO(assertStatus(*s1, 1, TOTAL_NUM_ENTRIES, TOTAL_NUM_ENTRIES));
+        TEST_DO(assertVisitStats(tls, "compressed", 1, TOTAL_NUM_ENTRIES,
+                                 2, TOTAL_NUM_ENTRIES, TOTAL_NUM_ENTRIES - 1, TOTAL_NUM_ENTRIES - 2));
+    }
+    {
+        // Blocks are read back, and visited from serial numbers in the middle of a block.
+        DummyFileHeaderContext fileHeaderContext;
+        TransLogServer tlss("testcompressed", 18377, ".", fileHeaderContext, 0x80000);
+        TransLogClient tls("tcp/localhost:18377");
+
+        TransLogClient::Session::UP s1 = openDomainTest(tls, "compressed");
+        TEST_DO(assertStatus(*s1, 1, TOTAL_NUM_ENTRIES, TOTAL_NUM_ENTRIES));
+        TEST_DO(assertVisitStats(tls, "compressed", 1, TOTAL_NUM_ENTRIES,
+                                 2, TOTAL_NUM_ENTRIES, TOTAL_NUM_ENTRIES - 1, TOTAL_NUM_ENTRIES - 2));
+        TEST_DO(assertVisitStats(tls, "compressed", 5050, 70025,
+                                 5051, 70025, 70025 - 5050, 70025 - 5051));
+        EXPECT_TRUE(tls.remove("compressed"));
+    }
+}
+
+void Test::testGroupCommit()
+{
+    const unsigned int NUM_COMMITS = 10000;
+    DummyFileHeaderContext fileHeaderContext;
+    TransLogServer tlss("testgroupcommit", 18377, ".", fileHeaderContext,
+                        DomainConfig().setPartSizeLimit(0x80000).setFSyncOnCommit(true)
+                                      .setCommitLatencyTarget(std::chrono::milliseconds(5)), 4);
+    TransLogClient tls("tcp/localhost:18377");
+    createDomainTest(tls, "groupcommit", 0);
+    TransLogClient::Session::UP s1 = openDomainTest(tls, "groupcommit");
+    {
+        vespalib::Gate gate;
+        auto onDone = std::make_shared<search::GateCallback>(gate);
+        for (SerialNum serial(1); serial <= NUM_COMMITS; serial++) {
+            Packet packet;
+            ASSERT_TRUE(packet.add(Packet::Entry(serial, 1, vespalib::ConstBufferRef(&serial, sizeof(serial)))));
+            tlss.commit("groupcommit", packet, onDone);
+        }
+        onDone.reset();
+        // All commits are acknowledged when written and synced.
+        gate.await();
+    }
+    DomainInfo info = tlss.getDomainStats()["groupcommit"];
+    EXPECT_EQUAL(NUM_COMMITS, info.commitStats.numCommits);
+    EXPECT_GREATER_EQUAL(NUM_COMMITS, info.commitStats.numBatches);
+    EXPECT_LESS(0u, info.commitStats.numBatches);
+    TEST_DO(assertStatus(*s1, 1, NUM_COMMITS, NUM_COMMITS));
+    TEST_DO(assertVisitStats(tls, "groupcommit", 0, NUM_COMMITS, 1, NUM_COMMITS, NUM_COMMITS, NUM_COMMITS));
+    EXPECT_TRUE(tls.remove("groupcommit"));
+}
+
 void Test::testErase()
 {
     const unsigned int NUM_PACKETS = 1000;
@@ -882,6 +952,8 @@ int Test::Main()
     testVisitOverGeneratedDomain();
     testVisitOverPreExistingDomain();
     testMany();
+    testCompressedBlocks();
+    testGroupCommit();
     testErase();
     partialUpdateTest();
 
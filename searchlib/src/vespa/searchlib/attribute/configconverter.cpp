@@ -69,6 +69,9 @@ ConfigConverter::convert(const AttributesConfig::Attribute & cfg)
     retval.setEnableOnlyBitVector(cfg.enableonlybitvector);
     retval.setIsFilter(cfg.enableonlybitvector);
     retval.setFastAccess(cfg.fastaccess);
+    retval.setDictionaryType(cfg.dictionary.type == AttributesConfig::Attribute::Dictionary::BTREE_AND_HASH
+                             ? Config::DictionaryType::BTREE_AND_HASH
+                             : Config::DictionaryType::BTREE);
     predicateParams.setArity(cfg.arity);
     predicateParams.setBounds(cfg.lowerbound, cfg.upperbound);
     predicateParams.setDensePostingListThreshold(cfg.densepostinglistthreshold);
@@ -15,6 +15,7 @@ EnumAttribute(const vespalib::string &baseFileName,
       _enumStore(0, cfg.fastSearch())
 {
     this->setEnum(true);
+    _enumStore.setUseHashIndex(cfg.dictionaryType() == AttributeVector::Config::DictionaryType::BTREE_AND_HASH);
 }
 
 template <typename B>
@@ -7,6 +7,7 @@
 #include <vespa/vespalib/util/buffer.h>
 #include <vespa/vespalib/util/array.h>
 #include <vespa/vespalib/util/stringfmt.h>
+#include <vespa/vespalib/stllike/hash_set.h>
 #include <cmath>
 #include <vespa/searchlib/datastore/entryref.h>
 #include <vespa/searchlib/btree/btreenode.h>
@@ -69,6 +70,34 @@ struct FloatingPointCompareHelper
 };
 
 
+/**
+ * Hash function for values in an enum store. Values that are equal
+ * according to the enum store comparator get the same hash value.
+ **/
+template <typename T>
+struct EnumStoreValueHash {
+    size_t operator()(T value) const { return vespalib::hash<T>()(value); }
+};
+
+template <>
+struct EnumStoreValueHash<const char *> {
+    size_t operator()(const char *value) const { return vespalib::hashValue(value); }
+};
+
+template <typename T>
+struct EnumStoreFloatValueHash {
+    size_t operator()(T value) const {
+        if (std::isnan(value) || value == 0) {
+            return 0; // all NaNs are equal, as are 0.0 and -0.0
+        }
+        return vespalib::hash<T>()(value);
+    }
+};
+
+template <> struct EnumStoreValueHash<float> : public EnumStoreFloatValueHash<float> { };
+template <> struct EnumStoreValueHash<double> : public EnumStoreFloatValueHash<double> { };
+
+
 //-----------------------------------------------------------------------------
 // EnumStoreT
 //-----------------------------------------------------------------------------
@@ -111,13 +140,53 @@ protected:
     void printEntry(vespalib::asciistream & os, const Entry & e) const;
 
     void freeUnusedEnum(Index idx, IndexSet & unused) override;
+    MemoryUsage getHashIndexMemoryUsage() const override;
+
+private:
+    struct IndexHash {
+        const EnumStoreT *_store;
+        IndexHash(const EnumStoreT &store) : _store(&store) { }
+        size_t operator()(const Index &idx) const { return EnumStoreValueHash<Type>()(_store->getValue(idx)); }
+    };
+    struct ValueExtract {
+        const EnumStoreT *_store;
+        ValueExtract(const EnumStoreT &store) : _store(&store) { }
+        Type operator()(const Index &idx) const { return _store->getValue(idx); }
+    };
+    struct ValueEqual {
+        bool operator()(Type lhs, Type rhs) const;
+    };
+    using HashIndex = vespalib::hash_set<Index, IndexHash, std::equal_to<Index>>;
+
+    /*
+     * Optional hash index from value to enum index, owned by the
+     * writer thread. It gives exact value lookups in constant time
+     * when feeding, while the ordered dictionary is still used for
+     * posting lists, enumeration and range lookups.
+     */
+    bool              _useHashIndex;
+    mutable HashIndex _hashIndex;
+
+    void ensureHashIndex() const;
+    template <typename Dictionary>
+    void rebuildHashIndex(const Dictionary &dict) const;
+    bool findHashedIndex(Type value, Index &idx) const;
 
 public:
     EnumStoreT(uint64_t initBufferSize, bool hasPostings)
-        : EnumStoreBase(initBufferSize, hasPostings)
+        : EnumStoreBase(initBufferSize, hasPostings),
+          _useHashIndex(false),
+          _hashIndex(0, IndexHash(*this), std::equal_to<Index>())
     {
     }
 
+    /**
+     * Enable hash index used for exact value lookups from the writer
+     * thread (findIndex and addEnum).
+     **/
+    void setUseHashIndex(bool useHashIndex);
+    bool getUseHashIndex() const { return _useHashIndex; }
+
     bool getValue(Index idx, Type & value) const;
     Type     getValue(uint32_t idx) const { return getValue(Index(datastore::EntryRef(idx))); }
     Type     getValue(Index idx)    const { return getEntry(idx).getValue(); }
@@ -14,6 +14,7 @@
 #include <vespa/searchlib/btree/btree.hpp>
 #include <vespa/searchlib/util/bufferwriter.h>
 #include <vespa/vespalib/util/array.hpp>
+#include <vespa/vespalib/stllike/hash_set.hpp>
 
 namespace search {
 
@@ -202,15 +203,91 @@ template <typename EntryType>
 bool
 EnumStoreT<EntryType>::findIndex(Type value, Index &idx) const
 {
+    if (_useHashIndex) {
+        return findHashedIndex(value, idx);
+    }
     ComparatorType cmp(*this, value);
     return _enumDict->findIndex(cmp, idx);
 }
 
 
+template <typename EntryType>
+bool
+EnumStoreT<EntryType>::ValueEqual::operator()(Type lhs, Type rhs) const
+{
+    return ComparatorType::compare(lhs, rhs) == 0;
+}
+
+
+template <typename EntryType>
+void
+EnumStoreT<EntryType>::setUseHashIndex(bool useHashIndex)
+{
+    _useHashIndex = useHashIndex;
+    _hashIndex.clear();
+    _hashIndexStale = true;
+}
+
+
+template <typename EntryType>
+template <typename Dictionary>
+void
+EnumStoreT<EntryType>::rebuildHashIndex(const Dictionary &dict) const
+{
+    HashIndex hashIndex(dict.size() * 2, IndexHash(*this), std::equal_to<Index>());
+    for (typename Dictionary::ConstIterator iter = dict.begin(); iter.valid(); ++iter) {
+        hashIndex.insert(iter.getKey());
+    }
+    _hashIndex.swap(hashIndex);
+    _hashIndexStale = false;
+}
+
+
+template <typename EntryType>
+void
+EnumStoreT<EntryType>::ensureHashIndex() const
+{
+    if (!_hashIndexStale) {
+        return;
+    }
+    if (_enumDict->hasData())
+        rebuildHashIndex(static_cast<const EnumStoreDict<EnumPostingTree> *>(_enumDict)->getDictionary());
+    else
+        rebuildHashIndex(static_cast<const EnumStoreDict<EnumTree> *>(_enumDict)->getDictionary());
+}
+
+
+template <typename EntryType>
+bool
+EnumStoreT<EntryType>::findHashedIndex(Type value, Index &idx) const
+{
+    ensureHashIndex();
+    auto itr = _hashIndex.template find<Type, ValueExtract, EnumStoreValueHash<Type>, ValueEqual>(value, ValueExtract(*this));
+    if (itr == _hashIndex.end()) {
+        return false;
+    }
+    idx = *itr;
+    return true;
+}
+
+
+template <typename EntryType>
+MemoryUsage
+EnumStoreT<EntryType>::getHashIndexMemoryUsage() const
+{
+    if (!_useHashIndex) {
+        return MemoryUsage();
+    }
+    size_t allocated = _hashIndex.getMemoryConsumption();
+    return MemoryUsage(allocated, allocated, 0, 0);
+}
+
+
 template <typename EntryType>
 void
 EnumStoreT<EntryType>::freeUnusedEnums(bool movePostingIdx)
 {
+    _hashIndexStale = true;
     ComparatorType cmp(*this);
     if (EntryType::hasFold() && movePostingIdx) {
         FoldedComparatorType fcmp(*this);
@@ -225,6 +302,13 @@ template <typename EntryType>
 void
 EnumStoreT<EntryType>::freeUnusedEnums(const IndexVector &toRemove)
 {
+    if (_useHashIndex && !_hashIndexStale) {
+        for (const auto &idx : toRemove) {
+            if (getRefCount(idx) == 0) {
+                _hashIndex.erase(idx);
+            }
+        }
+    }
     ComparatorType cmp(*this);
     if (EntryType::hasFold()) {
         FoldedComparatorType fcmp(*this);
@@ -260,6 +344,9 @@ EnumStoreT<EntryType>::addEnum(Type value,
     }
 
     // check if already present
+    if (_useHashIndex && findHashedIndex(value, newIdx)) {
+        return;
+    }
     ComparatorType cmp(*this, value);
     DictionaryIterator it(btree::BTreeNode::Ref(), dict.getAllocator());
     it.lower_bound(dict.getRoot(), Index(), cmp);
@@ -277,6 +364,9 @@ EnumStoreT<EntryType>::addEnum(Type value,
 
     // update tree with new index
     dict.insert(it, newIdx, typename Dictionary::DataType());
+    if (_useHashIndex) {
+        _hashIndex.insert(newIdx);
+    }
 
     // Copy posting list idx from next entry if same
     // folded value.
@@ -65,7 +65,8 @@ EnumStoreBase::EnumStoreBase(uint64_t initBufferSize,
       _nextEnum(0),
       _indexMap(),
       _toHoldBuffers(),
-      _disabledReEnumerate(false)
+      _disabledReEnumerate(false),
+      _hashIndexStale(true)
 {
     if (hasPostings)
         _enumDict = new EnumStoreDict<EnumPostingTree>(*this);
@@ -93,6 +94,7 @@ EnumStoreBase::reset(uint64_t initBufferSize)
     clearIndexMap();
     _enumDict->onReset();
     _nextEnum = 0;
+    _hashIndexStale = true;
 }
 
 uint32_t
@@ -202,6 +204,7 @@ EnumStoreBase::postCompact(uint32_t newEnum)
 {
     _store.finishCompact(_toHoldBuffers);
     _nextEnum = newEnum;
+    _hashIndexStale = true;
 }
 
 void
@@ -274,6 +277,7 @@ EnumStoreBase::deserialize(const void *src,
             builder.insert(*i, typename Tree::DataType());
         }
         tree.assign(builder);
+        _hashIndexStale = true;
     }
     return sz;
 }
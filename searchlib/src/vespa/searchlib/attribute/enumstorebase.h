@@ -236,6 +236,8 @@ protected:
     std::vector<uint32_t> _toHoldBuffers; // used during compaction
     // set before backgound flush, cleared during background flush
     mutable std::atomic<bool> _disabledReEnumerate;
+    // set when enum indexes have been reassigned, e.g. by compaction
+    mutable bool          _hashIndexStale;
 
     static const uint32_t TYPE_ID = 0;
 
@@ -259,6 +261,7 @@ protected:
     uint32_t getBufferIndex(datastore::BufferState::State status);
     void postCompact(uint32_t newEnum);
     bool preCompact(uint64_t bytesNeeded);
+    virtual MemoryUsage getHashIndexMemoryUsage() const { return MemoryUsage(); }
 
 public:
     void reset(uint64_t initBufferSize);
@@ -292,7 +295,11 @@ public:
         return _store.getBufferState(_store.getActiveBufferId(TYPE_ID)).capacity();
     }
     MemoryUsage getMemoryUsage() const;
-    MemoryUsage getTreeMemoryUsage() const { return _enumDict->getTreeMemoryUsage(); }
+    MemoryUsage getTreeMemoryUsage() const {
+        MemoryUsage usage = _enumDict->getTreeMemoryUsage();
+        usage.merge(getHashIndexMemoryUsage());
+        return usage;
+    }
 
     AddressSpace getAddressSpaceUsage() const;
 
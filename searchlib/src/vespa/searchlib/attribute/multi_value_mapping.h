@@ -24,6 +24,11 @@ private:
     using ConstArrayRef = vespalib::ConstArrayRef<EntryT>;
 
     ArrayStore _store;
+    datastore::ICompactionContext::UP _compactionContext;
+
+    void startCompactWorst(bool compactMemory, bool compactAddressSpace) override;
+    void compactRefs(uint32_t lidLow, uint32_t lidLimit) override;
+    void finishCompactWorst() override;
 public:
     MultiValueMapping(const MultiValueMapping &) = delete;
     MultiValueMapping & operator = (const MultiValueMapping &) = delete;
@@ -45,7 +50,7 @@ public:
 
     void doneLoadFromMultiValue() { _store.setInitializing(false); }
 
-    virtual void compactWorst(bool compactMemory, bool compactAddressSpace) override;
+    bool compactionInProgress() const override { return static_cast<bool>(_compactionContext); }
 
     virtual AddressSpace getAddressSpaceUsage() const override;
     virtual MemoryUsage getArrayStoreMemoryUsage() const override;
@@ -12,7 +12,8 @@ namespace attribute {
 template <typename EntryT, typename RefT>
 MultiValueMapping<EntryT,RefT>::MultiValueMapping(const datastore::ArrayStoreConfig &storeCfg, const GrowStrategy &gs)
     : MultiValueMappingBase(gs, _store.getGenerationHolder()),
-      _store(storeCfg)
+      _store(storeCfg),
+      _compactionContext()
 {
 }
 
@@ -48,15 +49,29 @@ MultiValueMapping<EntryT,RefT>::replace(uint32_t docId, ConstArrayRef values)
 
 template <typename EntryT, typename RefT>
 void
-MultiValueMapping<EntryT,RefT>::compactWorst(bool compactMemory, bool compactAddressSpace)
+MultiValueMapping<EntryT,RefT>::startCompactWorst(bool compactMemory, bool compactAddressSpace)
 {
-    datastore::ICompactionContext::UP compactionContext(_store.compactWorst(compactMemory, compactAddressSpace));
-    if (compactionContext) {
-        compactionContext->compact(vespalib::ArrayRef<EntryRef>(&_indices[0],
-                                                                _indices.size()));
+    _compactionContext = _store.compactWorst(compactMemory, compactAddressSpace);
+}
+
+template <typename EntryT, typename RefT>
+void
+MultiValueMapping<EntryT,RefT>::compactRefs(uint32_t lidLow, uint32_t lidLimit)
+{
+    if (_compactionContext && lidLow < lidLimit) {
+        _compactionContext->compact(vespalib::ArrayRef<EntryRef>(&_indices[lidLow],
+                                                                lidLimit - lidLow));
     }
 }
 
+template <typename EntryT, typename RefT>
+void
+MultiValueMapping<EntryT,RefT>::finishCompactWorst()
+{
+    // Compacted buffers are put on hold when the context is destroyed.
+    _compactionContext.reset();
+}
+
 template <typename EntryT, typename RefT>
 MemoryUsage
 MultiValueMapping<EntryT,RefT>::getArrayStoreMemoryUsage() const
@@ -2,6 +2,7 @@
 
 #include "multi_value_mapping_base.h"
 #include <vespa/searchcommon/common/compaction_strategy.h>
+#include <limits>
 
 namespace search {
 namespace attribute {
@@ -11,6 +12,8 @@ namespace {
 // minimum dead bytes in multi value mapping before consider compaction
 constexpr size_t DEAD_BYTES_SLACK = 0x10000u;
 constexpr size_t DEAD_CLUSTERS_SLACK = 0x10000u;
+// max number of lids scanned by incremental compaction per commit
+constexpr uint32_t DEFAULT_COMPACT_LIDS_PER_STEP = 0x10000u;
 
 }
 
@@ -19,7 +22,9 @@ MultiValueMappingBase::MultiValueMappingBase(const GrowStrategy &gs,
     : _indices(gs, genHolder),
       _totalValues(0u),
       _cachedArrayStoreMemoryUsage(),
-      _cachedArrayStoreAddressSpaceUsage(0, 0, (1ull << 32))
+      _cachedArrayStoreAddressSpaceUsage(0, 0, (1ull << 32)),
+      _compactLidCursor(0u),
+      _compactLidsPerStep(DEFAULT_COMPACT_LIDS_PER_STEP)
 {
 }
 
@@ -84,9 +89,40 @@ MultiValueMappingBase::updateStat()
     return retval;
 }
 
+void
+MultiValueMappingBase::compactStep(uint32_t maxLids)
+{
+    uint32_t lidLimit = size();
+    if (_compactLidCursor < lidLimit) {
+        if (lidLimit - _compactLidCursor > maxLids) {
+            lidLimit = _compactLidCursor + maxLids;
+        }
+        compactRefs(_compactLidCursor, lidLimit);
+        _compactLidCursor = lidLimit;
+    }
+    if (_compactLidCursor >= size()) {
+        finishCompactWorst();
+        _compactLidCursor = 0u;
+    }
+}
+
+void
+MultiValueMappingBase::compactWorst(bool compactMemory, bool compactAddressSpace)
+{
+    if (!compactionInProgress()) {
+        startCompactWorst(compactMemory, compactAddressSpace);
+        _compactLidCursor = 0u;
+    }
+    compactStep(std::numeric_limits<uint32_t>::max());
+}
+
 bool
 MultiValueMappingBase::considerCompact(const CompactionStrategy &compactionStrategy)
 {
+    if (compactionInProgress()) {
+        compactStep(_compactLidsPerStep);
+        return true;
+    }
     size_t usedBytes = _cachedArrayStoreMemoryUsage.usedBytes();
     size_t deadBytes = _cachedArrayStoreMemoryUsage.deadBytes();
     size_t usedClusters = _cachedArrayStoreAddressSpaceUsage.used();
@@ -96,7 +132,9 @@ MultiValueMappingBase::considerCompact(const CompactionStrategy &compactionStrat
     bool compactAddressSpace = ((deadClusters >= DEAD_CLUSTERS_SLACK) &&
                                 (usedClusters * compactionStrategy.getMaxDeadAddressSpaceRatio() < deadClusters));
     if (compactMemory || compactAddressSpace) {
-        compactWorst(compactMemory, compactAddressSpace);
+        startCompactWorst(compactMemory, compactAddressSpace);
+        _compactLidCursor = 0u;
+        compactStep(_compactLidsPerStep);
         return true;
     }
     return false;
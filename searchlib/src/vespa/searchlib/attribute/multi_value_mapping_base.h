@@ -27,6 +27,8 @@ protected:
     size_t    _totalValues;
     MemoryUsage _cachedArrayStoreMemoryUsage;
     AddressSpace _cachedArrayStoreAddressSpaceUsage;
+    uint32_t  _compactLidCursor;   // next lid to scan by ongoing compaction
+    uint32_t  _compactLidsPerStep;
 
     MultiValueMappingBase(const GrowStrategy &gs, vespalib::GenerationHolder &genHolder);
     virtual ~MultiValueMappingBase();
@@ -34,6 +36,10 @@ protected:
     void updateValueCount(size_t oldValues, size_t newValues) {
         _totalValues += newValues - oldValues;
     }
+    virtual void startCompactWorst(bool compactMemory, bool compactAddressSpace) = 0;
+    virtual void compactRefs(uint32_t lidLow, uint32_t lidLimit) = 0;
+    virtual void finishCompactWorst() = 0;
+    void compactStep(uint32_t maxLids);
 public:
     using RefCopyVector = vespalib::Array<EntryRef>;
 
@@ -53,8 +59,28 @@ public:
 
     uint32_t getNumKeys() const { return _indices.size(); }
     uint32_t getCapacityKeys() const { return _indices.capacity(); }
-    virtual void compactWorst(bool compatMemory, bool compactAddressSpace) = 0;
+
+    /**
+     * Compact the worst buffers in one go, completing any ongoing
+     * incremental compaction first.
+     */
+    void compactWorst(bool compactMemory, bool compactAddressSpace);
+
+    /**
+     * Called from the write thread on each commit.  Starts a new
+     * compaction if the cached statistics show too much dead space, and
+     * moves at most compactLidsPerStep entries of an ongoing compaction.
+     * The compacted buffers are put on hold when all lids have been
+     * scanned.  Returns true if anything was done, in which case the
+     * caller must bump the generation.
+     */
     bool considerCompact(const CompactionStrategy &compactionStrategy);
+    virtual bool compactionInProgress() const = 0;
+    uint32_t getCompactionBacklog() const {
+        return (compactionInProgress() && _compactLidCursor < size()) ? (size() - _compactLidCursor) : 0u;
+    }
+    void setCompactLidsPerStep(uint32_t compactLidsPerStep) { _compactLidsPerStep = compactLidsPerStep; }
+    uint32_t getCompactLidsPerStep() const { return _compactLidsPerStep; }
 };
 
 } // namespace search::attribute
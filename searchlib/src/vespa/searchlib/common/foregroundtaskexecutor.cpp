@@ -15,7 +15,8 @@ ForegroundTaskExecutor::ForegroundTaskExecutor()
 
 ForegroundTaskExecutor::ForegroundTaskExecutor(uint32_t threads)
     : _threads(threads),
-      _ids()
+      _ids(),
+      _numScheduledTasks(threads)
 {
 }
 
@@ -40,9 +41,17 @@ void
 ForegroundTaskExecutor::executeTask(ExecutorId id, vespalib::Executor::Task::UP task)
 {
     assert(id.getId() < _threads);
+    ++_numScheduledTasks[id.getId()];
     task->run();
 }
 
+uint64_t
+ForegroundTaskExecutor::getNumScheduledTasks(ExecutorId id) const
+{
+    assert(id.getId() < _threads);
+    return _numScheduledTasks[id.getId()];
+}
+
 void
 ForegroundTaskExecutor::sync()
 {
@@ -3,6 +3,8 @@
 
 #include "isequencedtaskexecutor.h"
 #include <vespa/vespalib/stllike/hash_map.h>
+#include <atomic>
+#include <vector>
 
 namespace vespalib { class ThreadStackExecutorBase; }
 
@@ -18,6 +20,7 @@ class ForegroundTaskExecutor : public ISequencedTaskExecutor
 {
     const uint32_t                       _threads;
     vespalib::hash_map<size_t, ExecutorId> _ids;
+    std::vector<std::atomic<uint64_t>>   _numScheduledTasks;
 public:
     using ISequencedTaskExecutor::getExecutorId;
 
@@ -28,6 +31,7 @@ public:
     uint32_t getNumExecutors() const override { return _threads; }
     ExecutorId getExecutorId(uint64_t componentId) override;
     void executeTask(ExecutorId id, vespalib::Executor::Task::UP task) override;
+    uint64_t getNumScheduledTasks(ExecutorId id) const override;
     void sync() override;
 };
 
@@ -51,6 +51,15 @@ public:
      */
     virtual void executeTask(ExecutorId id, vespalib::Executor::Task::UP task) = 0;
 
+    /**
+     * Number of tasks scheduled with the given id so far. Lets a caller
+     * that appends work to a task it has already scheduled detect that
+     * other tasks have been scheduled behind it since.
+     *
+     * @param id     which internal executor to check
+     */
+    virtual uint64_t getNumScheduledTasks(ExecutorId id) const = 0;
+
     /**
      * Wrap lambda function into a task and schedule it to be run.
      * Caller must ensure that pointers and references are valid and
@@ -0,0 +1,36 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "latency_stats.h"
+#include <algorithm>
+
+namespace search {
+
+void
+LatencyStats::add(double seconds)
+{
+    if (_count == 0) {
+        _min = seconds;
+        _max = seconds;
+    } else {
+        _min = std::min(_min, seconds);
+        _max = std::max(_max, seconds);
+    }
+    _total += seconds;
+    ++_count;
+}
+
+void
+LatencyStats::add(const LatencyStats &rhs)
+{
+    if (_count == 0) {
+        _min = rhs._min;
+        _max = rhs._max;
+    } else if (rhs._count > 0) {
+        _min = std::min(_min, rhs._min);
+        _max = std::max(_max, rhs._max);
+    }
+    _total += rhs._total;
+    _count += rhs._count;
+}
+
+} // namespace search
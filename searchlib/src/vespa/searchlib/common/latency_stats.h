@@ -0,0 +1,30 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include <cstddef>
+
+namespace search {
+
+/**
+ * Count, average, min and max of a number of latencies in seconds.
+ * The metrics framework has no histogram type, so latencies are exported
+ * as average metrics built from these values.
+ */
+class LatencyStats
+{
+private:
+    double _total;
+    size_t _count;
+    double _min;
+    double _max;
+public:
+    LatencyStats() : _total(0.0), _count(0), _min(0.0), _max(0.0) {}
+    void add(double seconds);
+    void add(const LatencyStats &rhs);
+    double avg() const { return (_count > 0) ? (_total / _count) : 0.0; }
+    size_t count() const { return _count; }
+    double min() const { return _min; }
+    double max() const { return _max; }
+};
+
+} // namespace search
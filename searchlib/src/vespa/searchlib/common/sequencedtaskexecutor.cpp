@@ -16,7 +16,8 @@ constexpr uint32_t stackSize = 128 * 1024;
 
 
 SequencedTaskExecutor::SequencedTaskExecutor(uint32_t threads, uint32_t taskLimit)
-    : _executors()
+    : _executors(),
+      _numScheduledTasks(threads)
 {
     for (uint32_t id = 0; id < threads; ++id) {
         auto executor = std::make_unique<BlockingThreadStackExecutor>(1, stackSize, taskLimit);
@@ -55,10 +56,18 @@ SequencedTaskExecutor::executeTask(ExecutorId id, vespalib::Executor::Task::UP t
 {
     assert(id.getId() < _executors.size());
     vespalib::ThreadStackExecutorBase &executor(*_executors[id.getId()]);
+    ++_numScheduledTasks[id.getId()];
     auto rejectedTask = executor.execute(std::move(task));
     assert(!rejectedTask);
 }
 
+uint64_t
+SequencedTaskExecutor::getNumScheduledTasks(ExecutorId id) const
+{
+    assert(id.getId() < _numScheduledTasks.size());
+    return _numScheduledTasks[id.getId()];
+}
+
 
 void
 SequencedTaskExecutor::sync()
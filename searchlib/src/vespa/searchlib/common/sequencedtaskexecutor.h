@@ -3,6 +3,7 @@
 
 #include "isequencedtaskexecutor.h"
 #include <vespa/vespalib/stllike/hash_map.h>
+#include <atomic>
 #include <vector>
 
 namespace vespalib {
@@ -21,6 +22,7 @@ class SequencedTaskExecutor : public ISequencedTaskExecutor
     using Stats = vespalib::ExecutorStats;
     std::vector<std::shared_ptr<vespalib::BlockingThreadStackExecutor>> _executors;
     vespalib::hash_map<size_t, ExecutorId> _ids;
+    std::vector<std::atomic<uint64_t>> _numScheduledTasks;
 public:
     using ISequencedTaskExecutor::getExecutorId;
 
@@ -31,6 +33,7 @@ public:
     uint32_t getNumExecutors() const override { return _executors.size(); }
     ExecutorId getExecutorId(uint64_t componentId) override;
     void executeTask(ExecutorId id, vespalib::Executor::Task::UP task) override;
+    uint64_t getNumScheduledTasks(ExecutorId id) const override;
     void sync() override;
     Stats getStats();
 };
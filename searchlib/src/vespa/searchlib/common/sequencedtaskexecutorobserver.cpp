@@ -40,7 +40,7 @@ SequencedTaskExecutorObserver::sync()
 }
 
 std::vector<uint32_t>
-SequencedTaskExecutorObserver::getExecuteHistory()
+SequencedTaskExecutorObserver::getExecuteHistory() const
 {
     std::lock_guard<std::mutex> guard(_mutex);
     return _executeHistory;
@@ -18,7 +18,7 @@ class SequencedTaskExecutorObserver : public ISequencedTaskExecutor
     std::atomic<uint32_t> _executeCnt;
     std::atomic<uint32_t> _syncCnt;
     std::vector<uint32_t> _executeHistory;
-    std::mutex            _mutex;
+    mutable std::mutex    _mutex;
 public:
     using ISequencedTaskExecutor::getExecutorId;
 
@@ -28,11 +28,12 @@ public:
     uint32_t getNumExecutors() const override { return _executor.getNumExecutors(); }
     ExecutorId getExecutorId(uint64_t componentId) override;
     void executeTask(ExecutorId id, vespalib::Executor::Task::UP task) override;
+    uint64_t getNumScheduledTasks(ExecutorId id) const override { return _executor.getNumScheduledTasks(id); }
     void sync() override;
 
     uint32_t getExecuteCnt() const { return _executeCnt; }
     uint32_t getSyncCnt() const { return _syncCnt; }
-    std::vector<uint32_t> getExecuteHistory();
+    std::vector<uint32_t> getExecuteHistory() const;
 };
 
 } // namespace search
@@ -0,0 +1,41 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include <mutex>
+
+namespace search {
+
+/**
+ * Thread safe accumulation of stats that are periodically taken out,
+ * e.g. to update metrics. StatsT must be default constructible, and
+ * support += if add() is used.
+ */
+template <typename StatsT>
+class StatsCollector
+{
+private:
+    std::mutex _lock;
+    StatsT     _stats;
+public:
+    StatsCollector() : _lock(), _stats() {}
+
+    void add(const StatsT &stats) {
+        std::lock_guard<std::mutex> guard(_lock);
+        _stats += stats;
+    }
+    /** Apply func to the collected stats while holding the lock. */
+    template <typename FuncT>
+    void update(FuncT &&func) {
+        std::lock_guard<std::mutex> guard(_lock);
+        func(_stats);
+    }
+    /** Return the stats collected since the previous call. */
+    StatsT take() {
+        std::lock_guard<std::mutex> guard(_lock);
+        StatsT stats(_stats);
+        _stats = StatsT();
+        return stats;
+    }
+};
+
+} // namespace search
@@ -163,11 +163,14 @@ class TuneFileSearch
 {
 public:
     TuneFileRandRead _read;
+    bool             _prefetchPostings; // Start posting list readahead before fetching postings
 
-    TuneFileSearch() : _read() { }
-    TuneFileSearch(const TuneFileRandRead &r) : _read(r) { }
-    bool operator==(const TuneFileSearch &rhs) const { return _read == rhs._read; }
-    bool operator!=(const TuneFileSearch &rhs) const { return _read != rhs._read; }
+    TuneFileSearch() : _read(), _prefetchPostings(false) { }
+    TuneFileSearch(const TuneFileRandRead &r) : _read(r), _prefetchPostings(false) { }
+    bool operator==(const TuneFileSearch &rhs) const {
+        return _read == rhs._read && _prefetchPostings == rhs._prefetchPostings;
+    }
+    bool operator!=(const TuneFileSearch &rhs) const { return !(*this == rhs); }
 };
 
 
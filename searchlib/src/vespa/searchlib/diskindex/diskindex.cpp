@@ -314,6 +314,21 @@ DiskIndex::readPostingList(const LookupResult &lookupRes) const
 }
 
 
+void
+DiskIndex::prefetchPostingList(const LookupResult &lookupRes) const
+{
+    SchemaUtil::IndexIterator it(_schema, lookupRes.indexId);
+    const DiskPostingFile *file = _postingFiles[it.getIndex()].get();
+    if (file == NULL) {
+        return;
+    }
+    PostingListHandle handle;
+    handle._bitOffset = lookupRes.bitOffset;
+    handle._bitLength = lookupRes.counts._bitLength;
+    file->prefetchPostingList(handle);
+}
+
+
 BitVector::UP
 DiskIndex::readBitVector(const LookupResult &lookupRes) const
 {
@@ -123,6 +123,14 @@ public:
      **/
     index::PostingListHandle::UP readPostingList(const LookupResult &lookupRes) const;
 
+    /**
+     * Start asynchronous readahead of the posting list corresponding to
+     * the given lookup result, without waiting for it to complete.
+     *
+     * @param lookupRes the result of the previous dictionary lookup.
+     **/
+    void prefetchPostingList(const LookupResult &lookupRes) const;
+
     /**
      * Read the bit vector corresponding to the given lookup result.
      *
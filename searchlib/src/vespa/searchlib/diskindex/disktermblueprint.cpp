@@ -43,6 +43,7 @@ DiskTermBlueprint::DiskTermBlueprint(const FieldSpecBase & field,
     _lookupRes(std::move(lookupRes)),
     _useBitVector(useBitVector),
     _fetchPostingsDone(false),
+    _prefetchPostingsDone(false),
     _hasEquivParent(false),
     _postingHandle(),
     _bitVector()
@@ -77,6 +78,19 @@ DiskTermBlueprint::fetchPostings(bool strict)
     _fetchPostingsDone = true;
 }
 
+void
+DiskTermBlueprint::prefetchPostings()
+{
+    // Nested intermediate blueprints prefetch their subtrees again, only issue it once
+    if (!_prefetchPostingsDone && !_fetchPostingsDone &&
+        _diskIndex.getTuneFileSearch()._prefetchPostings &&
+        !_useBitVector && (_lookupRes->counts._numDocs != 0))
+    {
+        _diskIndex.prefetchPostingList(*_lookupRes);
+        _prefetchPostingsDone = true;
+    }
+}
+
 SearchIterator::UP
 DiskTermBlueprint::createLeafSearch(const TermFieldMatchDataArray & tfmda, bool strict) const
 {
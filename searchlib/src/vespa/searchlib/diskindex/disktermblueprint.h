@@ -18,6 +18,7 @@ private:
     DiskIndex::LookupResult::UP                  _lookupRes;
     bool                                         _useBitVector;
     bool                                         _fetchPostingsDone;
+    bool                                         _prefetchPostingsDone;
     bool                                         _hasEquivParent;
     search::index::PostingListHandle::UP         _postingHandle;
     search::BitVector::UP                        _bitVector;
@@ -41,6 +42,12 @@ public:
     std::unique_ptr<queryeval::SearchIterator> createLeafSearch(const fef::TermFieldMatchDataArray & tfmda, bool strict) const override;
 
     void fetchPostings(bool strict) override;
+    /**
+     * Starts readahead of the posting list, if enabled by the tune settings
+     * of the disk index and the term is not searched using a bit vector.
+     **/
+    void prefetchPostings() override;
+    bool postingsPrefetched() const { return _prefetchPostingsDone; }
 };
 
 }
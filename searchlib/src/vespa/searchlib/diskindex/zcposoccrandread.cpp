@@ -169,6 +169,25 @@ ZcPosOccRandRead::readPostingList(const PostingListCounts &counts,
 }
 
 
+void
+ZcPosOccRandRead::prefetchPostingList(const PostingListHandle &handle) const
+{
+    if (handle._bitLength == 0) {
+        return;
+    }
+    size_t memoryAlignment;
+    size_t transferGranularity;
+    size_t transferMaximum;
+    if (_file->GetDirectIORestrictions(memoryAlignment, transferGranularity, transferMaximum)) {
+        // Direct I/O bypasses the FS cache, readahead would only pollute it.
+        return;
+    }
+    uint64_t startOffset = (handle._bitOffset + _headerBitSize) >> 3;
+    uint64_t endOffset = (handle._bitOffset + _headerBitSize + handle._bitLength + 7) >> 3;
+    _file->prefetch(startOffset, endOffset - startOffset);
+}
+
+
 bool
 ZcPosOccRandRead::
 open(const vespalib::string &name, const TuneFileRandRead &tuneFileRead)
@@ -54,6 +54,8 @@ public:
                     uint32_t numSegments,
                     PostingListHandle &handle) override;
 
+    void prefetchPostingList(const PostingListHandle &handle) const override;
+
     bool open(const vespalib::string &name, const TuneFileRandRead &tuneFileRead) override;
     bool close() override;
     virtual void readHeader();
@@ -0,0 +1,39 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "bandwidth_throttle.h"
+#include <thread>
+
+namespace search::docstore {
+
+BandwidthThrottle::BandwidthThrottle(size_t maxBytesPerSecond, Clock::time_point start)
+    : _maxBytesPerSecond(maxBytesPerSecond),
+      _start(start),
+      _consumedBytes(0)
+{ }
+
+BandwidthThrottle::BandwidthThrottle(size_t maxBytesPerSecond)
+    : BandwidthThrottle(maxBytesPerSecond, Clock::now())
+{ }
+
+BandwidthThrottle::Clock::duration
+BandwidthThrottle::account(size_t bytes, Clock::time_point now)
+{
+    _consumedBytes += bytes;
+    if (_maxBytesPerSecond == 0) {
+        return Clock::duration::zero();
+    }
+    std::chrono::duration<double> allowedAt(double(_consumedBytes) / _maxBytesPerSecond);
+    Clock::time_point earliest = _start + std::chrono::duration_cast<Clock::duration>(allowedAt);
+    return (earliest > now) ? (earliest - now) : Clock::duration::zero();
+}
+
+void
+BandwidthThrottle::consume(size_t bytes)
+{
+    Clock::duration delay = account(bytes, Clock::now());
+    if (delay > Clock::duration::zero()) {
+        std::this_thread::sleep_for(delay);
+    }
+}
+
+}
@@ -0,0 +1,41 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+
+namespace search::docstore {
+
+/**
+ * Keeps the average rate of a sequence of io operations below a byte
+ * budget per second by delaying the caller. A budget of 0 means no limit.
+ **/
+class BandwidthThrottle
+{
+public:
+    using Clock = std::chrono::steady_clock;
+    BandwidthThrottle(size_t maxBytesPerSecond, Clock::time_point start);
+    explicit BandwidthThrottle(size_t maxBytesPerSecond);
+
+    /**
+     * Account for the given number of bytes, and sleep until doing so
+     * keeps within the budget.
+     **/
+    void consume(size_t bytes);
+
+    /**
+     * Account for the given number of bytes, and return for how long the
+     * caller must wait at time 'now' to stay within the budget.
+     **/
+    Clock::duration account(size_t bytes, Clock::time_point now);
+
+    size_t getMaxBytesPerSecond() const { return _maxBytesPerSecond; }
+    size_t getConsumedBytes() const { return _consumedBytes; }
+private:
+    size_t            _maxBytesPerSecond;
+    Clock::time_point _start;
+    size_t            _consumedBytes;
+};
+
+}
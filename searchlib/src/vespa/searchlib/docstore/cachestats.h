@@ -12,19 +12,22 @@ struct CacheStats {
     size_t misses;
     size_t elements;
     size_t memory_used;
+    size_t admission_rejects;
 
     CacheStats()
         : hits(0),
           misses(0),
           elements(0),
-          memory_used(0)
+          memory_used(0),
+          admission_rejects(0)
     { }
 
-    CacheStats(size_t hit, size_t miss, size_t elem, size_t mem)
+    CacheStats(size_t hit, size_t miss, size_t elem, size_t mem, size_t rejects = 0)
         : hits(hit),
           misses(miss),
           elements(elem),
-          memory_used(mem)
+          memory_used(mem),
+          admission_rejects(rejects)
     { }
 
     CacheStats &
@@ -34,6 +37,7 @@ struct CacheStats {
         misses += rhs.misses;
         elements += rhs.elements;
         memory_used += rhs.memory_used;
+        admission_rejects += rhs.admission_rejects;
         return *this;
     }
 };
@@ -58,16 +58,18 @@ Chunk::Chunk(uint32_t id, const Config & config) :
     _id(id),
     _nextOffset(0),
     _lastSerial(static_cast<uint64_t>(-1l)),
-    _format(new ChunkFormatV2(config.getMaxBytes()))
+    _format(config.getDictionary() != nullptr
+            ? static_cast<ChunkFormat *>(new ChunkFormatV3(config.getMaxBytes(), *config.getDictionary()))
+            : static_cast<ChunkFormat *>(new ChunkFormatV2(config.getMaxBytes())))
 {
     _lids.reserve(4096/sizeof(Entry));
 }
 
-Chunk::Chunk(uint32_t id, const void * buffer, size_t len, bool skipcrc) :
+Chunk::Chunk(uint32_t id, const void * buffer, size_t len, bool skipcrc, const Dictionary * dictionary) :
     _id(id),
     _nextOffset(0),
     _lastSerial(static_cast<uint64_t>(-1l)),
-    _format(ChunkFormat::deserialize(buffer, len, skipcrc))
+    _format(ChunkFormat::deserialize(buffer, len, skipcrc, dictionary))
 {
     vespalib::nbostream &os = getData();
     while (os.size() > sizeof(_lastSerial)) {
@@ -11,6 +11,7 @@
 namespace vespalib {
     class nbostream;
     class DataBuffer;
+    namespace compression { class ZStdDictionary; }
 }
 
 namespace search {
@@ -62,12 +63,16 @@ class Chunk {
 public:
     using UP = std::unique_ptr<Chunk>;
     using CompressionConfig = vespalib::compression::CompressionConfig;
+    using Dictionary = vespalib::compression::ZStdDictionary;
     class Config {
     public:
-        Config(size_t maxBytes) : _maxBytes(maxBytes) { }
+        Config(size_t maxBytes) : _maxBytes(maxBytes), _dictionary(nullptr) { }
+        Config(size_t maxBytes, const Dictionary * dictionary) : _maxBytes(maxBytes), _dictionary(dictionary) { }
         size_t getMaxBytes() const { return _maxBytes; }
+        const Dictionary * getDictionary() const { return _dictionary; }
     private:
-      size_t _maxBytes;
+      size_t             _maxBytes;
+      const Dictionary * _dictionary;
     };
     class Entry {
     public:
@@ -85,7 +90,7 @@ public:
     };
     typedef std::vector<Entry> LidList;
     Chunk(uint32_t id, const Config & config);
-    Chunk(uint32_t id, const void * buffer, size_t len, bool skipcrc=false);
+    Chunk(uint32_t id, const void * buffer, size_t len, bool skipcrc=false, const Dictionary * dictionary=nullptr);
     ~Chunk();
     LidMeta append(uint32_t lid, const void * buffer, size_t len);
     ssize_t read(uint32_t lid, vespalib::DataBuffer & buffer) const;
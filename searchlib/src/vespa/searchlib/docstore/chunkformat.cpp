@@ -33,7 +33,7 @@ ChunkFormat::pack(uint64_t lastSerial, vespalib::DataBuffer & compressed, const
     const size_t oldPos(compressed.getDataLen());
     compressed.writeInt8(compression.type);
     compressed.writeInt32(os.size());
-    CompressionConfig::Type type(compress(compression, vespalib::ConstBufferRef(os.c_str(), os.size()), compressed, false));
+    CompressionConfig::Type type(compressBody(compression, vespalib::ConstBufferRef(os.c_str(), os.size()), compressed));
     if (compression.type != type) {
         compressed.getData()[oldPos] = type;
     }
@@ -66,8 +66,22 @@ ChunkFormat::verifyCompression(uint8_t type)
     }
 }
 
+CompressionConfig::Type
+ChunkFormat::compressBody(const CompressionConfig & compression, const vespalib::ConstBufferRef & org,
+                          vespalib::DataBuffer & dest) const
+{
+    return compress(compression, org, dest, false);
+}
+
+void
+ChunkFormat::decompressBody(CompressionConfig::Type type, size_t uncompressedLen,
+                            const vespalib::ConstBufferRef & org, vespalib::DataBuffer & dest) const
+{
+    decompress(type, uncompressedLen, org, dest, true);
+}
+
 ChunkFormat::UP
-ChunkFormat::deserialize(const void * buffer, size_t len, bool skipcrc)
+ChunkFormat::deserialize(const void * buffer, size_t len, bool skipcrc, const Dictionary * dictionary)
 {
     uint8_t version(0);
     vespalib::nbostream raw(buffer, len);
@@ -94,6 +108,12 @@ ChunkFormat::deserialize(const void * buffer, size_t len, bool skipcrc)
         } else {
             format.reset(new ChunkFormatV2(raw, crc32));
         }
+    } else if (version == ChunkFormatV3::VERSION) {
+        if (skipcrc) {
+            format.reset(new ChunkFormatV3(raw, dictionary));
+        } else {
+            format.reset(new ChunkFormatV3(raw, crc32, dictionary));
+        }
     } else {
         throw ChunkException(make_string("Unknown version %d", version), VESPA_STRLOC);
     }
@@ -143,7 +163,7 @@ ChunkFormat::deserializeBody(vespalib::nbostream & is)
     // This is a dirty trick to fool some odd sanity checking in DataBuffer::swap
     vespalib::DataBuffer uncompressed(const_cast<char *>(is.peek()), (size_t)0);
     vespalib::ConstBufferRef data(is.peek(), is.size() - sizeof(uint32_t));
-    decompress(CompressionConfig::Type(type), uncompressedLen, data, uncompressed, true);
+    decompressBody(CompressionConfig::Type(type), uncompressedLen, data, uncompressed);
     assert(uncompressed.getData() == uncompressed.getDead());
     if (uncompressed.getData() != data.c_str()) {
         const size_t sz(uncompressed.getDataLen());
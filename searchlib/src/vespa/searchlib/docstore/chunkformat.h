@@ -7,6 +7,8 @@
 #include <vespa/vespalib/data/databuffer.h>
 #include <vespa/vespalib/util/exception.h>
 
+namespace vespalib::compression { class ZStdDictionary; }
+
 namespace search {
 
 class ChunkException : public vespalib::Exception
@@ -22,6 +24,7 @@ public:
     virtual ~ChunkFormat();
     using UP = std::unique_ptr<ChunkFormat>;
     using CompressionConfig = vespalib::compression::CompressionConfig;
+    using Dictionary = vespalib::compression::ZStdDictionary;
     vespalib::nbostream & getBuffer() { return _dataBuf; }
     const vespalib::nbostream & getBuffer() const { return _dataBuf; }
 
@@ -37,8 +40,11 @@ public:
      * param buffer Pointer to the serialized data
      * @param len Length of serialized data
      * @param indicate if crc verification shall be skipped.
+     * @param dictionary The compression dictionary of the file the chunk was read from, if any.
+     *                   Required to deserialize chunks compressed with a dictionary.
      */
-    static ChunkFormat::UP deserialize(const void * buffer, size_t len, bool skipcrc);
+    static ChunkFormat::UP deserialize(const void * buffer, size_t len, bool skipcrc,
+                                       const Dictionary * dictionary = nullptr);
     /**
      * return the maximum size a packet can have. It allows correct size estimation
      * need for direct io alignment.
@@ -67,6 +73,18 @@ protected:
      * Thows exception if check fails.
      */
     void verifyCrc(const vespalib::nbostream & is, uint32_t expected) const;
+    /**
+     * Compresses the body. Formats may override to compress differently.
+     * @return the compression type actually used.
+     */
+    virtual CompressionConfig::Type compressBody(const CompressionConfig & compression,
+                                                 const vespalib::ConstBufferRef & org,
+                                                 vespalib::DataBuffer & dest) const;
+    /**
+     * Decompresses the body compressed by @compressBody into dest.
+     */
+    virtual void decompressBody(CompressionConfig::Type type, size_t uncompressedLen,
+                                const vespalib::ConstBufferRef & org, vespalib::DataBuffer & dest) const;
 private:
     /**
      * Used when serializing to obtain correct version.
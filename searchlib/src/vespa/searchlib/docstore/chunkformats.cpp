@@ -4,10 +4,13 @@
 #include <vespa/vespalib/util/crc.h>
 #include <vespa/vespalib/xxhash/xxhash.h>
 #include <vespa/vespalib/util/stringfmt.h>
+#include <vespa/vespalib/util/zstdcompressor.h>
 
 namespace search {
 
 using vespalib::make_string;
+using vespalib::compression::CompressionConfig;
+using vespalib::compression::computeMaxCompressedsize;
 
 ChunkFormatV1::ChunkFormatV1(vespalib::nbostream & is) :
     ChunkFormat()
@@ -70,4 +73,97 @@ ChunkFormatV2::verifyMagic(vespalib::nbostream & is) const
     }
 }
 
+ChunkFormatV3::ChunkFormatV3(vespalib::nbostream & is, const Dictionary * dictionary) :
+    ChunkFormat(),
+    _dictionary(dictionary)
+{
+    verifyHeader(is);
+    deserializeBody(is);
+}
+
+ChunkFormatV3::ChunkFormatV3(vespalib::nbostream & is, uint32_t expectedCrc, const Dictionary * dictionary) :
+    ChunkFormat(),
+    _dictionary(dictionary)
+{
+    verifyCrc(is, expectedCrc);
+    verifyHeader(is);
+    deserializeBody(is);
+}
+
+ChunkFormatV3::ChunkFormatV3(size_t maxSize, const Dictionary & dictionary) :
+    ChunkFormat(maxSize),
+    _dictionary(&dictionary)
+{
+}
+
+uint32_t
+ChunkFormatV3::computeCrc(const void * buf, size_t sz) const
+{
+    return XXH32(buf, sz, 0);
+}
+
+void
+ChunkFormatV3::writeHeader(vespalib::DataBuffer & buf) const
+{
+    buf.writeInt32(MAGIC);
+    buf.writeInt32(_dictionary->getId());
+}
+
+void
+ChunkFormatV3::verifyHeader(vespalib::nbostream & is) const
+{
+    uint32_t magic;
+    is >> magic;
+    if (magic != MAGIC) {
+        throw ChunkException(make_string("Unknown magic %0x, expected %0x", magic, MAGIC), VESPA_STRLOC);
+    }
+    uint32_t dictionaryId;
+    is >> dictionaryId;
+    if (_dictionary == nullptr) {
+        throw ChunkException(make_string("Missing compression dictionary %u", dictionaryId), VESPA_STRLOC);
+    }
+    if (dictionaryId != _dictionary->getId()) {
+        throw ChunkException(make_string("Compression dictionary mismatch. Expected %u, have %u",
+                                         dictionaryId, _dictionary->getId()), VESPA_STRLOC);
+    }
+}
+
+CompressionConfig::Type
+ChunkFormatV3::compressBody(const CompressionConfig & compression, const vespalib::ConstBufferRef & org,
+                            vespalib::DataBuffer & dest) const
+{
+    if ((compression.type != CompressionConfig::ZSTD) || (org.size() < compression.minSize)) {
+        return ChunkFormat::compressBody(compression, org, dest);
+    }
+    dest.ensureFree(computeMaxCompressedsize(CompressionConfig::ZSTD, org.size()));
+    size_t compressedSize(dest.getFreeLen());
+    if (_dictionary->compress(compression.compressionLevel, org.c_str(), org.size(), dest.getFree(), compressedSize) &&
+        (compressedSize < ((org.size() * compression.threshold)/100)))
+    {
+        dest.moveFreeToData(compressedSize);
+        return CompressionConfig::ZSTD;
+    }
+    dest.writeBytes(org.c_str(), org.size());
+    return CompressionConfig::NONE;
+}
+
+void
+ChunkFormatV3::decompressBody(CompressionConfig::Type type, size_t uncompressedLen,
+                              const vespalib::ConstBufferRef & org, vespalib::DataBuffer & dest) const
+{
+    if (type != CompressionConfig::ZSTD) {
+        ChunkFormat::decompressBody(type, uncompressedLen, org, dest);
+        return;
+    }
+    dest.ensureFree(uncompressedLen);
+    size_t realUncompressedLen(dest.getFreeLen());
+    if ( ! _dictionary->decompress(org.c_str(), org.size(), dest.getFree(), realUncompressedLen) ||
+         (realUncompressedLen != uncompressedLen))
+    {
+        throw ChunkException(make_string("Failed decompressing chunk with dictionary %u", _dictionary->getId()),
+                             VESPA_STRLOC);
+    }
+    dest.moveFreeToData(realUncompressedLen);
+}
+
 } // namespace search
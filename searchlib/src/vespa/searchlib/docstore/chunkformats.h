@@ -44,5 +44,35 @@ private:
     void verifyMagic(vespalib::nbostream & is) const;
 };
 
+/**
+ * As ChunkFormatV2, but ZSTD compression uses the zstd dictionary of the file
+ * the chunk is stored in. The id of the dictionary follows the magic.
+ */
+class ChunkFormatV3 : public ChunkFormat
+{
+public:
+    enum {VERSION=2, MAGIC=0x7c3a19e5};
+    ChunkFormatV3(vespalib::nbostream & is, const Dictionary * dictionary);
+    ChunkFormatV3(vespalib::nbostream & is, uint32_t expectedCrc, const Dictionary * dictionary);
+    ChunkFormatV3(size_t maxSize, const Dictionary & dictionary);
+private:
+    bool includeSerializedSize() const override { return true; }
+    size_t getHeaderSize() const override {
+        // MAGIC + dictionary id
+        return 8;
+    }
+    uint8_t getVersion() const override { return VERSION; }
+    uint32_t computeCrc(const void * buf, size_t sz) const override;
+    void writeHeader(vespalib::DataBuffer & buf) const override;
+    CompressionConfig::Type compressBody(const CompressionConfig & compression,
+                                         const vespalib::ConstBufferRef & org,
+                                         vespalib::DataBuffer & dest) const override;
+    void decompressBody(CompressionConfig::Type type, size_t uncompressedLen,
+                        const vespalib::ConstBufferRef & org, vespalib::DataBuffer & dest) const override;
+    void verifyHeader(vespalib::nbostream & is) const;
+
+    const Dictionary * _dictionary;
+};
+
 } // namespace search
 
@@ -0,0 +1,57 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "data_store_write_stats.h"
+
+namespace search {
+
+DataStoreWriteStats &
+DataStoreWriteStats::operator += (const DataStoreWriteStats & rhs)
+{
+    _compress.add(rhs._compress);
+    _write.add(rhs._write);
+    _sync.add(rhs._sync);
+    _syncRequests += rhs._syncRequests;
+    return *this;
+}
+
+namespace docstore {
+
+WriteStatsCollector::WriteStatsCollector()
+    : _stats()
+{ }
+
+WriteStatsCollector::~WriteStatsCollector() = default;
+
+void
+WriteStatsCollector::addCompress(double seconds)
+{
+    _stats.update([seconds](DataStoreWriteStats & stats) { stats.compress().add(seconds); });
+}
+
+void
+WriteStatsCollector::addWrite(double seconds)
+{
+    _stats.update([seconds](DataStoreWriteStats & stats) { stats.write().add(seconds); });
+}
+
+void
+WriteStatsCollector::addSync(double seconds)
+{
+    _stats.update([seconds](DataStoreWriteStats & stats) { stats.sync().add(seconds); });
+}
+
+void
+WriteStatsCollector::addSyncRequest()
+{
+    _stats.update([](DataStoreWriteStats & stats) { stats.addSyncRequest(); });
+}
+
+DataStoreWriteStats
+WriteStatsCollector::take()
+{
+    return _stats.take();
+}
+
+}
+
+}
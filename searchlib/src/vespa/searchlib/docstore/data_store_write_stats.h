@@ -0,0 +1,64 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/searchlib/common/latency_stats.h>
+#include <vespa/searchlib/common/stats_collector.h>
+
+namespace search {
+
+/**
+ * Latencies in seconds of the stages a chunk passes through on its way
+ * to disk in a data store, and how well syncs are coalesced.
+ **/
+class DataStoreWriteStats
+{
+public:
+    using Latency = LatencyStats;
+
+    DataStoreWriteStats() : _compress(), _write(), _sync(), _syncRequests(0) {}
+    DataStoreWriteStats & operator += (const DataStoreWriteStats & rhs);
+
+    /** Time compressing a chunk. */
+    Latency & compress() { return _compress; }
+    const Latency & compress() const { return _compress; }
+    /** Time writing a batch of compressed chunks. */
+    Latency & write() { return _write; }
+    const Latency & write() const { return _write; }
+    /** Time syncing data and index to disk. */
+    Latency & sync() { return _sync; }
+    const Latency & sync() const { return _sync; }
+    /** Number of times a caller asked for written chunks to be synced. */
+    size_t syncRequests() const { return _syncRequests; }
+    void addSyncRequest() { ++_syncRequests; }
+private:
+    Latency _compress;
+    Latency _write;
+    Latency _sync;
+    size_t  _syncRequests;
+};
+
+namespace docstore {
+
+/**
+ * Thread safe accumulation of DataStoreWriteStats, shared by the
+ * writeable file chunks of a data store.
+ **/
+class WriteStatsCollector
+{
+public:
+    WriteStatsCollector();
+    ~WriteStatsCollector();
+    void addCompress(double seconds);
+    void addWrite(double seconds);
+    void addSync(double seconds);
+    void addSyncRequest();
+    /** Return the stats collected since the previous call. */
+    DataStoreWriteStats take();
+private:
+    StatsCollector<DataStoreWriteStats> _stats;
+};
+
+}
+
+}
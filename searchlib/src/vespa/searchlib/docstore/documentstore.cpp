@@ -2,10 +2,14 @@
 
 #include "cachestats.h"
 #include "documentstore.h"
+#include "hot_store.h"
+#include "update_deltas.h"
 #include "visitcache.h"
 #include "ibucketizer.h"
 #include <vespa/document/fieldvalue/document.h>
-#include <vespa/vespalib/stllike/cache.hpp>
+#include <vespa/document/fieldset/fieldsets.h>
+#include <vespa/vespalib/stllike/striped_cache.hpp>
+#include <vespa/vespalib/stllike/hash_map.hpp>
 #include <vespa/vespalib/data/databuffer.h>
 #include <vespa/vespalib/util/compressor.h>
 
@@ -40,6 +44,30 @@ DocumentVisitorAdapter::visit(uint32_t lid, vespalib::ConstBufferRef buf) {
     }
 }
 
+document::Document::UP
+deserializeDocument(const vespalib::DataBuffer & buf, const DocumentTypeRepo & repo, const document::FieldSet & fields) {
+    vespalib::nbostream is(buf.getData(), buf.getDataLen());
+    document::Document::UP doc(new document::Document());
+    doc->deserialize(repo, is, fields);
+    return doc;
+}
+
+document::Document::UP
+deserializeDocument(const std::vector<char> & buf, const DocumentTypeRepo & repo, const document::FieldSet & fields) {
+    vespalib::nbostream is(buf.data(), buf.size());
+    document::Document::UP doc(new document::Document());
+    doc->deserialize(repo, is, fields);
+    return doc;
+}
+
+CompressionConfig
+getHotStoreCompression(const DocumentStore::Config & config) {
+    // Documents are kept compressed in the hot store even when the cache is not.
+    return (config.getCompression().type != CompressionConfig::NONE)
+           ? config.getCompression()
+           : CompressionConfig(CompressionConfig::LZ4, 9, 70);
+}
+
 }
 
 using vespalib::nbostream;
@@ -96,7 +124,7 @@ public:
      * Decompress value into temporary buffer and deserialize document from
      * the temporary buffer.
      */
-    document::Document::UP deserializeDocument(const DocumentTypeRepo &repo);
+    document::Document::UP deserializeDocument(const DocumentTypeRepo &repo, const document::FieldSet & fields);
 
     size_t size() const { return _compressedSize; }
     bool empty() const { return size() == 0; }
@@ -156,11 +184,13 @@ Value::set(vespalib::DataBuffer &&buf, ssize_t len, const CompressionConfig &com
 
 
 document::Document::UP
-Value::deserializeDocument(const DocumentTypeRepo &repo) {
+Value::deserializeDocument(const DocumentTypeRepo &repo, const document::FieldSet & fields) {
     vespalib::DataBuffer uncompressed((char *) _buf.get(), (size_t) 0);
     decompress(getCompression(), getUncompressedSize(), vespalib::ConstBufferRef(*this, size()), uncompressed, true);
     vespalib::nbostream is(uncompressed.getData(), uncompressed.getDataLen());
-    return document::Document::UP(new document::Document(repo, is));
+    document::Document::UP doc(new document::Document());
+    doc->deserialize(repo, is, fields);
+    return doc;
 }
 
 
@@ -188,6 +218,39 @@ BackingStore::reconfigure(const CompressionConfig &compression) {
     _compression = compression;
 }
 
+/**
+ * Collects the serialized documents handed out by a batched read of the backing store,
+ * compressed as they would be in the cache.
+ */
+class ValueCollector : public IBufferVisitor
+{
+public:
+    using Values = vespalib::hash_map<uint32_t, Value>;
+    ValueCollector(const CompressionConfig & compression) :
+        _compression(compression),
+        _values()
+    { }
+    void visit(uint32_t lid, vespalib::ConstBufferRef buf) override;
+    Value * find(uint32_t lid) {
+        auto found = _values.find(lid);
+        return (found != _values.end()) ? &found->second : nullptr;
+    }
+private:
+    CompressionConfig _compression;
+    Values            _values;
+};
+
+void
+ValueCollector::visit(uint32_t lid, vespalib::ConstBufferRef buf) {
+    if (buf.size() > 0) {
+        vespalib::DataBuffer data(buf.size());
+        data.writeBytes(buf.c_str(), buf.size());
+        Value value;
+        value.set(std::move(data), buf.size(), _compression);
+        _values[lid] = std::move(value);
+    }
+}
+
 }
 
 using CacheParams = vespalib::CacheParam<
@@ -197,12 +260,16 @@ using CacheParams = vespalib::CacheParam<
         vespalib::size<docstore::Value>
 >;
 
-class Cache : public vespalib::cache<CacheParams> {
+class Cache : public vespalib::striped_cache<CacheParams> {
 public:
-    Cache(BackingStore & b, size_t maxBytes) : vespalib::cache<CacheParams>(b, maxBytes) { }
+    Cache(BackingStore & b, size_t maxBytes, size_t numStripes)
+        : vespalib::striped_cache<CacheParams>(b, maxBytes, numStripes)
+    { }
 };
 
 using VisitCache = docstore::VisitCache;
+using docstore::HotStore;
+using docstore::UpdateDeltas;
 using docstore::Value;
 
 bool
@@ -210,6 +277,11 @@ DocumentStore::Config::operator == (const Config &rhs) const {
     return (_maxCacheBytes == rhs._maxCacheBytes) &&
             (_allowVisitCaching == rhs._allowVisitCaching) &&
             (_initialCacheEntries == rhs._initialCacheEntries) &&
+            (_cacheStripes == rhs._cacheStripes) &&
+            (_cacheAdmission == rhs._cacheAdmission) &&
+            (_hotStoreMaxBytes == rhs._hotStoreMaxBytes) &&
+            (_hotStoreMinAccesses == rhs._hotStoreMinAccesses) &&
+            (_updateDeltas == rhs._updateDeltas) &&
             (_compression == rhs._compression);
 }
 
@@ -219,11 +291,20 @@ DocumentStore::DocumentStore(const Config & config, IDataStore & store)
       _config(config),
       _backingStore(store),
       _store(new docstore::BackingStore(_backingStore, config.getCompression())),
-      _cache(new Cache(*_store, config.getMaxCacheBytes())),
+      _cache(new Cache(*_store, config.getMaxCacheBytes(), config.getCacheStripes())),
       _visitCache(new VisitCache(store, config.getMaxCacheBytes(), config.getCompression())),
+      _hotStore(std::make_unique<HotStore>(config.getHotStoreMaxBytes(), config.getHotStoreMinAccesses(),
+                                           getHotStoreCompression(config), config.getCacheStripes())),
+      _updateDeltas(std::make_unique<UpdateDeltas>()),
+      _writeLock(),
       _uncached_lookups(0)
 {
+    for (auto & generation : _writeGenerations) {
+        generation = 0;
+    }
     _cache->reserveElements(config.getInitialCacheEntries());
+    _cache->setAdmission(getCacheAdmissionElements(config));
+    _visitCache->setAdmission(getCacheAdmissionElements(config));
 }
 
 DocumentStore::~DocumentStore() {}
@@ -233,33 +314,133 @@ DocumentStore::reconfigure(const Config & config) {
     _cache->setCapacityBytes(config.getMaxCacheBytes());
     _store->reconfigure(config.getCompression());
     _visitCache->reconfigure(_config.getMaxCacheBytes(), config.getCompression());
+    _cache->setAdmission(getCacheAdmissionElements(config));
+    _visitCache->setAdmission(getCacheAdmissionElements(config));
+    _hotStore->reconfigure(config.getHotStoreMaxBytes(), config.getHotStoreMinAccesses(),
+                           getHotStoreCompression(config));
 
     _config = config;
 }
 
+size_t
+DocumentStore::getCacheAdmissionElements(const Config & config) const {
+    // Assume compressed documents of around 4k when sizing the frequency sketch.
+    return config.useCacheAdmission()
+           ? std::max(config.getInitialCacheEntries(), config.getMaxCacheBytes()/4096)
+           : 0;
+}
+
+void
+DocumentStore::promoteToHotStore(DocumentIdT lid, const Value & value, uint32_t generation) const {
+    _hotStore->promote(lid, value.getCompression(), value.getUncompressedSize(),
+                       vespalib::ConstBufferRef(value.get(), value.size()),
+                       [this, lid, generation]() { return getWriteGeneration(lid) == generation; });
+}
+
 bool
 DocumentStore::useCache() const {
     return (_cache->capacityBytes() != 0) && (_cache->capacity() != 0);
 }
 
+/**
+ * Hands out the visited documents with their pending update deltas applied.
+ */
+class DocumentStore::UpdatedDocumentVisitor : public IDocumentVisitor
+{
+public:
+    UpdatedDocumentVisitor(const DocumentStore & ds, const DocumentTypeRepo & repo, IDocumentVisitor & visitor) :
+        _ds(ds),
+        _repo(repo),
+        _visitor(visitor)
+    { }
+    void visit(uint32_t lid, DocumentUP doc) override {
+        DocumentUP updated;
+        if (_ds.readUpdated(lid, _repo, document::AllFields(), updated)) {
+            doc = std::move(updated);
+        }
+        _visitor.visit(lid, std::move(doc));
+    }
+    bool allowVisitCaching() const override { return _visitor.allowVisitCaching(); }
+private:
+    const DocumentStore    & _ds;
+    const DocumentTypeRepo & _repo;
+    IDocumentVisitor       & _visitor;
+};
+
 void
 DocumentStore::visit(const LidVector & lids, const DocumentTypeRepo &repo, IDocumentVisitor & visitor) const
 {
+    UpdatedDocumentVisitor updatedVisitor(*this, repo, visitor);
+    IDocumentVisitor & target = _updateDeltas->empty() ? visitor : updatedVisitor;
     if (useCache() && _config.allowVisitCaching() && visitor.allowVisitCaching()) {
         docstore::BlobSet blobSet = _visitCache->read(lids).getBlobSet();
-        DocumentVisitorAdapter adapter(repo, visitor);
+        DocumentVisitorAdapter adapter(repo, target);
         for (DocumentIdT lid : lids) {
             adapter.visit(lid, blobSet.get(lid));
         }
     } else {
-        _store->visit(lids, repo, visitor);
+        _store->visit(lids, repo, target);
     }
 }
 
 document::Document::UP
 DocumentStore::read(DocumentIdT lid, const DocumentTypeRepo &repo) const
+{
+    return read(lid, repo, document::AllFields());
+}
+
+document::Document::UP
+DocumentStore::read(DocumentIdT lid, const DocumentTypeRepo &repo, const document::FieldSet & fields) const
+{
+    DocumentUP doc;
+    if (readUpdated(lid, repo, fields, doc)) {
+        return doc;
+    }
+    return readStored(lid, repo, fields);
+}
+
+bool
+DocumentStore::readUpdated(DocumentIdT lid, const DocumentTypeRepo &repo, const document::FieldSet & fields,
+                           DocumentUP & doc) const
+{
+    if (_updateDeltas->empty()) {
+        return false;
+    }
+    UpdateDeltas::Chain chain;
+    while (_updateDeltas->get(lid, chain)) {
+        if ( ! chain.getMaterialized().empty()) {
+            doc = deserializeDocument(chain.getMaterialized(), repo, fields);
+            return true;
+        }
+        DocumentUP updated = chain.apply(readStored(lid, repo, document::AllFields()), repo);
+        std::vector<char> serialized;
+        if (updated) {
+            nbostream os;
+            updated->serialize(os);
+            serialized.assign(os.peek(), os.peek() + os.size());
+        }
+        doc = updated ? deserializeDocument(serialized, repo, fields) : DocumentUP();
+        if (_updateDeltas->setMaterialized(lid, chain.getGeneration(), std::move(serialized))) {
+            return true;
+        }
+        // The document was rewritten while the deltas were applied, try again.
+    }
+    return false;
+}
+
+document::Document::UP
+DocumentStore::readStored(DocumentIdT lid, const DocumentTypeRepo &repo, const document::FieldSet & fields) const
 {
     document::Document::UP retval;
+    HotStore::Lookup hot(HotStore::Lookup::MISS);
+    uint32_t generation = getWriteGeneration(lid);
+    if (_hotStore->enabled()) {
+        vespalib::DataBuffer buf(4096);
+        hot = _hotStore->read(lid, buf);
+        if (hot == HotStore::Lookup::HIT) {
+            return deserializeDocument(buf, repo, fields);
+        }
+    }
     Value value;
     if (useCache()) {
         value = _cache->read(lid);
@@ -268,11 +449,112 @@ DocumentStore::read(DocumentIdT lid, const DocumentTypeRepo &repo) const
         _store->read(lid, value);
     }
     if ( ! value.empty() ) {
-        retval = value.deserializeDocument(repo);
+        if (hot == HotStore::Lookup::PROMOTE) {
+            promoteToHotStore(lid, value, generation);
+        }
+        retval = value.deserializeDocument(repo, fields);
     }
     return retval;
 }
 
+std::vector<DocumentStore::DocumentUP>
+DocumentStore::read(const LidVector & lids, const DocumentTypeRepo &repo, const document::FieldSet & fields) const
+{
+    if (_updateDeltas->empty()) {
+        return readStored(lids, repo, fields);
+    }
+    std::vector<DocumentUP> docs(lids.size());
+    LidVector storedLids;
+    std::vector<size_t> stored;
+    for (size_t i(0); i < lids.size(); i++) {
+        if ( ! readUpdated(lids[i], repo, fields, docs[i])) {
+            storedLids.push_back(lids[i]);
+            stored.push_back(i);
+        }
+    }
+    std::vector<DocumentUP> storedDocs = readStored(storedLids, repo, fields);
+    for (size_t i(0); i < stored.size(); i++) {
+        docs[stored[i]] = std::move(storedDocs[i]);
+    }
+    return docs;
+}
+
+std::vector<DocumentStore::DocumentUP>
+DocumentStore::readStored(const LidVector & lids, const DocumentTypeRepo &repo, const document::FieldSet & fields) const
+{
+    std::vector<DocumentUP> docs(lids.size());
+    std::vector<uint32_t> generations(lids.size());
+    std::vector<bool> promote(lids.size(), false);
+    std::vector<size_t> pending;
+    pending.reserve(lids.size());
+    for (size_t i(0); i < lids.size(); i++) {
+        generations[i] = getWriteGeneration(lids[i]);
+    }
+    if (_hotStore->enabled()) {
+        vespalib::DataBuffer buf(4096);
+        for (size_t i(0); i < lids.size(); i++) {
+            buf.clear();
+            HotStore::Lookup hot = _hotStore->read(lids[i], buf);
+            if (hot == HotStore::Lookup::HIT) {
+                docs[i] = deserializeDocument(buf, repo, fields);
+            } else {
+                promote[i] = (hot == HotStore::Lookup::PROMOTE);
+                pending.push_back(i);
+            }
+        }
+    } else {
+        for (size_t i(0); i < lids.size(); i++) {
+            pending.push_back(i);
+        }
+    }
+    std::vector<size_t> missing;
+    bool cached(useCache());
+    if (cached) {
+        for (size_t i : pending) {
+            if (_cache->hasKey(lids[i])) {
+                Value value = _cache->read(lids[i]);
+                if ( ! value.empty() ) {
+                    if (promote[i]) {
+                        promoteToHotStore(lids[i], value, generations[i]);
+                    }
+                    docs[i] = value.deserializeDocument(repo, fields);
+                }
+            } else {
+                missing.push_back(i);
+            }
+        }
+    } else {
+        _uncached_lookups.fetch_add(pending.size());
+        missing.swap(pending);
+    }
+    if (missing.empty()) {
+        return docs;
+    }
+
+    LidVector missingLids;
+    missingLids.reserve(missing.size());
+    for (size_t i : missing) {
+        missingLids.push_back(lids[i]);
+    }
+    docstore::ValueCollector collector(cached ? _store->getCompression() : CompressionConfig());
+    _backingStore.read(missingLids, collector);
+    for (size_t i : missing) {
+        DocumentIdT lid = lids[i];
+        Value * value = collector.find(lid);
+        if (value != nullptr) {
+            uint32_t generation = generations[i];
+            if (cached) {
+                _cache->populate(lid, *value, [this, lid, generation]() { return getWriteGeneration(lid) == generation; });
+            }
+            if (promote[i]) {
+                promoteToHotStore(lid, *value, generation);
+            }
+            docs[i] = value->deserializeDocument(repo, fields);
+        }
+    }
+    return docs;
+}
+
 void
 DocumentStore::write(uint64_t syncToken, DocumentIdT lid, const document::Document& doc) {
     nbostream stream(12345);
@@ -282,23 +564,95 @@ DocumentStore::write(uint64_t syncToken, DocumentIdT lid, const document::Docume
 
 void
 DocumentStore::write(uint64_t syncToken, DocumentIdT lid, const vespalib::nbostream & stream) {
-    _backingStore.write(syncToken, lid, stream.peek(), stream.size());
-    if (useCache()) {
-        _cache->invalidate(lid);
-        _visitCache->invalidate(lid);
+    std::lock_guard<std::mutex> guard(_writeLock);
+    writeStored(syncToken, lid, stream, false);
+}
+
+void
+DocumentStore::writeStored(uint64_t syncToken, DocumentIdT lid, const vespalib::nbostream & stream, bool keepUpdates) {
+    _updateDeltas->rebase(lid, syncToken, keepUpdates, [&](uint64_t serialNum) {
+        _backingStore.write(serialNum, lid, stream.peek(), stream.size());
+    });
+    invalidate(lid);
+}
+
+bool
+DocumentStore::writeUpdate(uint64_t syncToken, DocumentIdT lid, const document::DocumentUpdate & update,
+                           const std::shared_ptr<const DocumentTypeRepo> & repo,
+                           const vespalib::nbostream & updatedDoc)
+{
+    if ( ! _config.useUpdateDeltas()) {
+        return false;
     }
+    std::lock_guard<std::mutex> guard(_writeLock);
+    _updateDeltas->add(syncToken, lid, update, repo, updatedDoc);
+    return true;
+}
+
+void
+DocumentStore::rewrite(uint64_t syncToken, DocumentIdT lid, const document::Document & doc)
+{
+    nbostream stream(12345);
+    doc.serialize(stream);
+    std::lock_guard<std::mutex> guard(_writeLock);
+    writeStored(syncToken, lid, stream, true);
 }
 
 void
 DocumentStore::remove(uint64_t syncToken, DocumentIdT lid)
 {
-    _backingStore.remove(syncToken, lid);
+    std::lock_guard<std::mutex> guard(_writeLock);
+    _updateDeltas->rebase(lid, syncToken, false, [&](uint64_t serialNum) { _backingStore.remove(serialNum, lid); });
+    invalidate(lid);
+}
+
+void
+DocumentStore::invalidate(DocumentIdT lid)
+{
+    bumpWriteGeneration(lid);
+    if (_hotStore->enabled()) {
+        _hotStore->invalidate(lid);
+    }
     if (useCache()) {
         _cache->invalidate(lid);
         _visitCache->invalidate(lid);
     }
 }
 
+uint64_t
+DocumentStore::foldUpdates(uint64_t syncToken)
+{
+    if (_updateDeltas->empty()) {
+        return syncToken;
+    }
+    std::lock_guard<std::mutex> guard(_writeLock);
+    std::vector<uint32_t> lids;
+    uint64_t foldedSyncToken = _updateDeltas->startFold(syncToken, lids);
+    UpdateDeltas::Chain chain;
+    for (uint32_t lid : lids) {
+        if ( ! _updateDeltas->get(lid, chain)) {
+            continue;
+        }
+        nbostream stream(12345);
+        if (chain.getMaterialized().empty()) {
+            const DocumentTypeRepo & repo = *chain.getRepo();
+            DocumentUP doc = chain.apply(readStored(lid, repo, document::AllFields()), repo);
+            if (doc) {
+                doc->serialize(stream);
+            }
+        } else {
+            stream.write(chain.getMaterialized().data(), chain.getMaterialized().size());
+        }
+        if (stream.empty()) {
+            // Nothing stored below the deltas, just drop them.
+            _updateDeltas->rebase(lid, chain.getLastSerialNum(), false, [](uint64_t) { });
+        } else {
+            writeStored(chain.getLastSerialNum(), lid, stream, false);
+        }
+    }
+    return foldedSyncToken;
+}
+
 void
 DocumentStore::compact(uint64_t syncToken)
 {
@@ -315,7 +669,7 @@ DocumentStore::flush(uint64_t syncToken)
 uint64_t
 DocumentStore::initFlush(uint64_t syncToken)
 {
-    return _backingStore.initFlush(syncToken);
+    return _backingStore.initFlush(foldUpdates(syncToken));
 }
 
 uint64_t
@@ -327,7 +681,7 @@ DocumentStore::lastSyncToken() const
 uint64_t
 DocumentStore::tentativeLastSyncToken() const
 {
-    return _backingStore.tentativeLastSyncToken();
+    return std::max(_backingStore.tentativeLastSyncToken(), _updateDeltas->getLastSerialNum());
 }
 
 fastos::TimeStamp
@@ -342,7 +696,7 @@ class DocumentStore::WrapVisitor : public IDataStoreVisitor
     Visitor                 &_visitor;
     const DocumentTypeRepo  &_repo;
     const CompressionConfig &_compression;
-    IDocumentStore          &_ds;
+    DocumentStore           &_ds;
     uint64_t                 _syncToken;
     
 public:
@@ -351,9 +705,10 @@ public:
     WrapVisitor(Visitor &visitor,
                 const DocumentTypeRepo &repo,
                 const CompressionConfig &compresion,
-                IDocumentStore &ds,
+                DocumentStore &ds,
                 uint64_t syncToken);
     
+    inline DocumentUP updated(uint32_t lid, DocumentUP doc);
     inline void rewrite(uint32_t lid, const document::Document &doc);
     inline void rewrite(uint32_t lid);
     inline void visitRemove(uint32_t lid);
@@ -375,6 +730,15 @@ public:
 };
 
 
+template <>
+DocumentStore::DocumentUP
+DocumentStore::WrapVisitor<IDocumentStoreReadVisitor>::
+updated(uint32_t lid, DocumentUP doc)
+{
+    DocumentUP updatedDoc;
+    return _ds.readUpdated(lid, _repo, document::AllFields(), updatedDoc) ? std::move(updatedDoc) : std::move(doc);
+}
+
 template <>
 void
 DocumentStore::WrapVisitor<IDocumentStoreReadVisitor>::
@@ -402,12 +766,22 @@ visitRemove(uint32_t lid)
 }
 
 
+// Rewrite visitors see and rewrite the stored documents, pending update deltas stay on top.
+template <>
+DocumentStore::DocumentUP
+DocumentStore::WrapVisitor<IDocumentStoreRewriteVisitor>::
+updated(uint32_t lid, DocumentUP doc)
+{
+    (void) lid;
+    return doc;
+}
+
 template <>
 void
 DocumentStore::WrapVisitor<IDocumentStoreRewriteVisitor>::
 rewrite(uint32_t lid, const document::Document &doc)
 {
-    _ds.write(_syncToken, lid, doc);
+    _ds.rewrite(_syncToken, lid, doc);
 }
 
 template <>
@@ -448,7 +822,7 @@ DocumentStore::WrapVisitor<Visitor>::visit(uint32_t lid,
         value.set(std::move(buf), len);
     }
     if (! value.empty()) {
-        std::shared_ptr<document::Document> doc(value.deserializeDocument(_repo));
+        std::shared_ptr<document::Document> doc(updated(lid, value.deserializeDocument(_repo, document::AllFields())));
         _visitor.visit(lid, doc);
         rewrite(lid, *doc);
     } else {
@@ -463,7 +837,7 @@ DocumentStore::WrapVisitor<Visitor>::
 WrapVisitor(Visitor &visitor,
             const DocumentTypeRepo &repo,
             const CompressionConfig &compression,
-            IDocumentStore &ds,
+            DocumentStore &ds,
             uint64_t syncToken)
     : _visitor(visitor),
       _repo(repo),
@@ -517,10 +891,26 @@ DocumentStore::getStorageStats() const
     return _backingStore.getStorageStats();
 }
 
+DataStoreWriteStats
+DocumentStore::getWriteStats()
+{
+    return _backingStore.getWriteStats();
+}
+
+size_t
+DocumentStore::memoryUsed() const
+{
+    return _backingStore.memoryUsed() + _updateDeltas->memoryUsed();
+}
+
 MemoryUsage
 DocumentStore::getMemoryUsage() const
 {
-    return _backingStore.getMemoryUsage();
+    MemoryUsage usage = _backingStore.getMemoryUsage();
+    size_t updateBytes = _updateDeltas->memoryUsed();
+    usage.incAllocatedBytes(updateBytes);
+    usage.incUsedBytes(updateBytes);
+    return usage;
 }
 
 std::vector<DataStoreFileChunkStats>
@@ -532,11 +922,16 @@ DocumentStore::getFileChunkStats() const
 CacheStats DocumentStore::getCacheStats() const {
     CacheStats visitStats = _visitCache->getCacheStats();
     CacheStats singleStats(_cache->getHit(), _cache->getMiss() + _uncached_lookups,
-                           _cache->size(), _cache->sizeBytes());
+                           _cache->size(), _cache->sizeBytes(), _cache->getRejected());
     singleStats += visitStats;
     return singleStats;
 }
 
+CacheStats
+DocumentStore::getHotStoreStats() const {
+    return _hotStore->getStats();
+}
+
 void
 DocumentStore::compactLidSpace(uint32_t wantedDocLidLimit)
 {
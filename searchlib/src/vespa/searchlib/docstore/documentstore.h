@@ -4,6 +4,8 @@
 
 #include "idocumentstore.h"
 #include <vespa/vespalib/util/compressionconfig.h>
+#include <algorithm>
+#include <mutex>
 
 
 namespace search {
@@ -12,6 +14,9 @@ namespace docstore {
     class VisitCache;
     class BackingStore;
     class Cache;
+    class HotStore;
+    class UpdateDeltas;
+    class Value;
 }
 using docstore::VisitCache;
 using docstore::BackingStore;
@@ -32,25 +37,58 @@ public:
             _compression(CompressionConfig::LZ4, 9, 70),
             _maxCacheBytes(1000000000),
             _initialCacheEntries(0),
-            _allowVisitCaching(false)
+            _cacheStripes(1),
+            _cacheAdmission(false),
+            _allowVisitCaching(false),
+            _hotStoreMaxBytes(0),
+            _hotStoreMinAccesses(3),
+            _updateDeltas(false)
         { }
         Config(const CompressionConfig & compression, size_t maxCacheBytes, size_t initialCacheEntries) :
             _compression((maxCacheBytes != 0) ? compression : CompressionConfig::NONE),
             _maxCacheBytes(maxCacheBytes),
             _initialCacheEntries(initialCacheEntries),
-            _allowVisitCaching(false)
+            _cacheStripes(1),
+            _cacheAdmission(false),
+            _allowVisitCaching(false),
+            _hotStoreMaxBytes(0),
+            _hotStoreMinAccesses(3),
+            _updateDeltas(false)
         { }
         const CompressionConfig & getCompression() const { return _compression; }
         size_t getMaxCacheBytes()   const { return _maxCacheBytes; }
         size_t getInitialCacheEntries() const { return _initialCacheEntries; }
+        /// Number of independently locked stripes the document cache and the hot store are split into.
+        size_t getCacheStripes() const { return _cacheStripes; }
+        Config & setCacheStripes(size_t stripes) { _cacheStripes = std::max(stripes, 1ul); return *this; }
+        /// Use frequency based admission (TinyLFU) to keep scans from flushing the caches.
+        bool useCacheAdmission() const { return _cacheAdmission; }
+        Config & useCacheAdmission(bool use) { _cacheAdmission = use; return *this; }
         bool allowVisitCaching() const { return _allowVisitCaching; }
         Config & allowVisitCaching(bool allow) { _allowVisitCaching = allow; return *this; }
+        /// Memory budget of the in memory hot tier pinning frequently read documents. 0 disables it.
+        size_t getHotStoreMaxBytes() const { return _hotStoreMaxBytes; }
+        /// Number of recent reads needed before a document is considered for the hot tier.
+        uint32_t getHotStoreMinAccesses() const { return _hotStoreMinAccesses; }
+        Config & setHotStore(size_t maxBytes, uint32_t minAccesses) {
+            _hotStoreMaxBytes = maxBytes;
+            _hotStoreMinAccesses = std::max(minAccesses, 1u);
+            return *this;
+        }
+        /// Keep updates as deltas on top of the stored documents until flush instead of rewriting them.
+        bool useUpdateDeltas() const { return _updateDeltas; }
+        Config & useUpdateDeltas(bool use) { _updateDeltas = use; return *this; }
         bool operator == (const Config &) const;
     private:
         CompressionConfig _compression;
         size_t _maxCacheBytes;
         size_t _initialCacheEntries;
+        size_t _cacheStripes;
+        bool   _cacheAdmission;
         bool   _allowVisitCaching;
+        size_t   _hotStoreMaxBytes;
+        uint32_t _hotStoreMinAccesses;
+        bool     _updateDeltas;
     };
 
     /**
@@ -64,9 +102,15 @@ public:
     ~DocumentStore();
 
     DocumentUP read(DocumentIdT lid, const document::DocumentTypeRepo &repo) const override;
+    DocumentUP read(DocumentIdT lid, const document::DocumentTypeRepo &repo, const document::FieldSet & fields) const override;
+    std::vector<DocumentUP> read(const LidVector & lids, const document::DocumentTypeRepo &repo,
+                                 const document::FieldSet & fields) const override;
     void visit(const LidVector & lids, const document::DocumentTypeRepo &repo, IDocumentVisitor & visitor) const override;
     void write(uint64_t synkToken, DocumentIdT lid, const document::Document& doc) override;
     void write(uint64_t synkToken, DocumentIdT lid, const vespalib::nbostream & os) override;
+    bool writeUpdate(uint64_t syncToken, DocumentIdT lid, const document::DocumentUpdate & update,
+                     const std::shared_ptr<const document::DocumentTypeRepo> & repo,
+                     const vespalib::nbostream & updatedDoc) override;
     void remove(uint64_t syncToken, DocumentIdT lid) override;
     void flush(uint64_t syncToken) override;
     uint64_t initFlush(uint64_t synctoken) override;
@@ -75,11 +119,12 @@ public:
     uint64_t tentativeLastSyncToken() const override;
     fastos::TimeStamp getLastFlushTime() const override;
     uint32_t getDocIdLimit() const override { return _backingStore.getDocIdLimit(); }
-    size_t        memoryUsed() const override { return _backingStore.memoryUsed(); }
+    size_t        memoryUsed() const override;
     size_t  getDiskFootprint() const override { return _backingStore.getDiskFootprint(); }
     size_t      getDiskBloat() const override { return _backingStore.getDiskBloat(); }
     size_t getMaxCompactGain() const override { return _backingStore.getMaxCompactGain(); }
     CacheStats getCacheStats() const override;
+    CacheStats getHotStoreStats() const override;
     size_t memoryMeta() const override { return _backingStore.memoryMeta(); }
     const vespalib::string & getBaseDir() const override { return _backingStore.getBaseDir(); }
     void
@@ -92,6 +137,7 @@ public:
            const document::DocumentTypeRepo &repo) override;
     double getVisitCost() const override;
     DataStoreStorageStats getStorageStats() const override;
+    DataStoreWriteStats getWriteStats() override;
     MemoryUsage getMemoryUsage() const override;
     std::vector<DataStoreFileChunkStats> getFileChunkStats() const override;
 
@@ -104,17 +150,54 @@ public:
     void shrinkLidSpace() override;
     void reconfigure(const Config & config);
 
+protected:
+    /**
+     * Folds the pending update deltas that can be folded at the given sync token
+     * into the backing store.
+     * @return The sync token the backing store can be flushed to.
+     */
+    uint64_t foldUpdates(uint64_t syncToken);
+
 private:
     bool useCache() const;
+    size_t getCacheAdmissionElements(const Config & config) const;
+    void promoteToHotStore(DocumentIdT lid, const docstore::Value & value, uint32_t generation) const;
+    DocumentUP readStored(DocumentIdT lid, const document::DocumentTypeRepo &repo, const document::FieldSet & fields) const;
+    std::vector<DocumentUP> readStored(const LidVector & lids, const document::DocumentTypeRepo &repo,
+                                       const document::FieldSet & fields) const;
+    /// Reads the document with its pending update deltas applied, returns false if there are none.
+    bool readUpdated(DocumentIdT lid, const document::DocumentTypeRepo &repo, const document::FieldSet & fields,
+                     DocumentUP & doc) const;
+    void writeStored(uint64_t syncToken, DocumentIdT lid, const vespalib::nbostream & os, bool keepUpdates);
+    /// Rewrites the stored document, keeping any pending update deltas on top of it.
+    void rewrite(uint64_t syncToken, DocumentIdT lid, const document::Document & doc);
+    void invalidate(DocumentIdT lid);
+    /**
+     * Write generations guard documents read in batch outside the cache from being
+     * inserted into the cache or hot store after a concurrent write has invalidated them.
+     * They are striped on lid, and bumped after the write and before the invalidation.
+     */
+    static constexpr size_t NUM_WRITE_GENERATIONS = 256;
+    uint32_t getWriteGeneration(DocumentIdT lid) const {
+        return _writeGenerations[lid % NUM_WRITE_GENERATIONS].load(std::memory_order_acquire);
+    }
+    void bumpWriteGeneration(DocumentIdT lid) {
+        _writeGenerations[lid % NUM_WRITE_GENERATIONS].fetch_add(1, std::memory_order_release);
+    }
 
     template <class> class WrapVisitor;
     class WrapVisitorProgress;
+    class UpdatedDocumentVisitor;
     Config                         _config;
     IDataStore &                   _backingStore;
     std::unique_ptr<BackingStore>  _store;
     std::shared_ptr<Cache>         _cache;
     std::shared_ptr<VisitCache>    _visitCache;
+    std::unique_ptr<docstore::HotStore> _hotStore;
+    std::unique_ptr<docstore::UpdateDeltas> _updateDeltas;
+    std::mutex                     _writeLock;
     mutable std::atomic<uint64_t>  _uncached_lookups;
+    std::atomic<uint32_t>          _writeGenerations[NUM_WRITE_GENERATIONS];
 };
 
 } // namespace search
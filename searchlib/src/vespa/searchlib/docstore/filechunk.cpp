@@ -1,6 +1,7 @@
 // Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "filechunk.h"
+#include "bandwidth_throttle.h"
 #include "data_store_file_chunk_stats.h"
 #include "summaryexceptions.h"
 #include "randreaders.h"
@@ -10,6 +11,7 @@
 #include <vespa/vespalib/data/databuffer.h>
 #include <vespa/vespalib/stllike/asciistream.h>
 #include <vespa/vespalib/util/blockingthreadstackexecutor.h>
+#include <vespa/vespalib/util/zstdcompressor.h>
 #include <vespa/vespalib/objects/nbostream.h>
 #include <vespa/vespalib/util/array.hpp>
 #include <vespa/vespalib/stllike/hash_map.hpp>
@@ -30,6 +32,24 @@ constexpr size_t ALIGNMENT=0x1000;
 constexpr size_t ENTRY_BIAS_SIZE=8;
 const vespalib::string DOC_ID_LIMIT_KEY("docIdLimit");
 
+FileChunk::DictionarySP
+readDictionary(const vespalib::string & fileName)
+{
+    FastOS_File file(fileName.c_str());
+    if ( ! file.OpenReadOnlyExisting() || (file.GetSize() == 0)) {
+        return FileChunk::DictionarySP();
+    }
+    std::vector<char> data(file.GetSize());
+    if (file.Read(&data[0], data.size()) != ssize_t(data.size())) {
+        throw SummaryException("Failed reading dictionary file", file, VESPA_STRLOC);
+    }
+    FileChunk::DictionarySP dictionary = vespalib::compression::ZStdDictionary::create(&data[0], data.size());
+    if ( ! dictionary) {
+        throw SummaryException("Corrupt dictionary file", file, VESPA_STRLOC);
+    }
+    return dictionary;
+}
+
 }
 
 using vespalib::make_string;
@@ -59,6 +79,11 @@ FileChunk::createDatFileName(const vespalib::string & name) {
     return name + ".dat";
 }
 
+vespalib::string
+FileChunk::createDictFileName(const vespalib::string & name) {
+    return name + ".dict";
+}
+
 FileChunk::FileChunk(FileId fileId, NameId nameId, const vespalib::string & baseName,
                      const TuneFileSummary & tune, const IBucketizer * bucketizer, bool skipCrcOnRead)
     : _fileId(fileId),
@@ -77,6 +102,8 @@ FileChunk::FileChunk(FileId fileId, NameId nameId, const vespalib::string & base
       _tune(tune),
       _dataFileName(createDatFileName(_name)),
       _idxFileName(createIdxFileName(_name)),
+      _dictFileName(createDictFileName(_name)),
+      _dictionary(readDictionary(_dictFileName)),
       _chunkInfo(),
       _dataHeaderLen(0u),
       _idxHeaderLen(0u),
@@ -157,6 +184,9 @@ FileChunk::erase()
     if (!FastOS_File::Delete(_dataFileName.c_str()) && (errno != ENOENT)) {
         throw std::runtime_error(eraseErrorMsg(_dataFileName, errno));
     }
+    if (!FastOS_File::Delete(_dictFileName.c_str()) && (errno != ENOENT)) {
+        throw std::runtime_error(eraseErrorMsg(_dictFileName, errno));
+    }
 }
 
 size_t
@@ -335,7 +365,8 @@ appendChunks(FixedParams * args, Chunk::UP chunk)
 
 void
 FileChunk::appendTo(vespalib::ThreadExecutor & executor, const IGetLid & db, IWriteData & dest,
-                    uint32_t numChunks, IFileChunkVisitorProgress *visitorProgress)
+                    uint32_t numChunks, IFileChunkVisitorProgress *visitorProgress,
+                    docstore::BandwidthThrottle * throttle)
 {
     assert(frozen() || visitorProgress);
     vespalib::GenerationHandler::Guard lidReadGuard(db.getLidReadGuard());
@@ -343,13 +374,17 @@ FileChunk::appendTo(vespalib::ThreadExecutor & executor, const IGetLid & db, IWr
     FixedParams fixedParams = {db, dest, lidReadGuard, getFileId().getId(), visitorProgress};
     vespalib::BlockingThreadStackExecutor singleExecutor(1, 64*1024, executor.getNumThreads()*2);
     for (size_t chunkId(0); chunkId < numChunks; chunkId++) {
+        if (throttle != nullptr) {
+            throttle->consume(_chunkInfo[chunkId].getSize());
+        }
         std::promise<Chunk::UP> promisedChunk;
         std::future<Chunk::UP> futureChunk = promisedChunk.get_future();
         executor.execute(vespalib::makeLambdaTask([promise = std::move(promisedChunk), chunkId, this]() mutable {
             const ChunkInfo & cInfo(_chunkInfo[chunkId]);
             vespalib::DataBuffer whole(0ul, ALIGNMENT);
             FileRandRead::FSP keepAlive(_file->read(cInfo.getOffset(), whole, cInfo.getSize()));
-            promise.set_value(std::make_unique<Chunk>(chunkId, whole.getData(), whole.getDataLen()));
+            promise.set_value(std::make_unique<Chunk>(chunkId, whole.getData(), whole.getDataLen(), false,
+                                                      _dictionary.get()));
         }));
 
         singleExecutor.execute(vespalib::makeLambdaTask([args = &fixedParams, chunk = std::move(futureChunk)]() mutable {
@@ -384,7 +419,7 @@ FileChunk::read(LidInfoWithLidV::const_iterator begin, size_t count, ChunkInfo c
 {
     vespalib::DataBuffer whole(0ul, ALIGNMENT);
     FileRandRead::FSP keepAlive = _file->read(ci.getOffset(), whole, ci.getSize());
-    Chunk chunk(begin->getChunkId(), whole.getData(), whole.getDataLen(), _skipCrcOnRead);
+    Chunk chunk(begin->getChunkId(), whole.getData(), whole.getDataLen(), _skipCrcOnRead, _dictionary.get());
     for (size_t i(0); i < count; i++) {
         const LidInfoWithLid & li = *(begin + i);
         vespalib::ConstBufferRef buf = chunk.getLid(li.getLid());
@@ -409,7 +444,7 @@ FileChunk::read(uint32_t lid, SubChunkId chunkId, const ChunkInfo & chunkInfo,
 {
     vespalib::DataBuffer whole(0ul, ALIGNMENT);
     FileRandRead::FSP keepAlive(_file->read(chunkInfo.getOffset(), whole, chunkInfo.getSize()));
-    Chunk chunk(chunkId, whole.getData(), whole.getDataLen(), _skipCrcOnRead);
+    Chunk chunk(chunkId, whole.getData(), whole.getDataLen(), _skipCrcOnRead, _dictionary.get());
     return chunk.read(lid, buffer);
 }
 
@@ -485,7 +520,7 @@ FileChunk::verify(bool reportOnly) const
         vespalib::DataBuffer whole(0ul, ALIGNMENT);
         FileRandRead::FSP keepAlive(_file->read(ci.getOffset(), whole, ci.getSize()));
         try {
-            Chunk chunk(chunkId++, whole.getData(), whole.getDataLen());
+            Chunk chunk(chunkId++, whole.getData(), whole.getDataLen(), false, _dictionary.get());
             assert(chunk.getLastSerial() >= lastSerial);
             lastSerial = chunk.getLastSerial();
             if (errorInPrev) {
@@ -508,6 +543,31 @@ FileChunk::getNumChunks() const
     return _chunkInfo.size();
 }
 
+std::vector<vespalib::string>
+FileChunk::sampleEntries(size_t maxBytes) const
+{
+    std::vector<vespalib::string> samples;
+    if (_chunkInfo.empty() || (maxBytes == 0)) {
+        return samples;
+    }
+    size_t stride = std::max(1ul, getDiskFootprint() / maxBytes);
+    size_t sampledBytes(0);
+    for (size_t chunkId(0); (chunkId < _chunkInfo.size()) && (sampledBytes < maxBytes); chunkId += stride) {
+        const ChunkInfo & ci = _chunkInfo[chunkId];
+        vespalib::DataBuffer whole(0ul, ALIGNMENT);
+        FileRandRead::FSP keepAlive(_file->read(ci.getOffset(), whole, ci.getSize()));
+        Chunk chunk(chunkId, whole.getData(), whole.getDataLen(), _skipCrcOnRead, _dictionary.get());
+        for (const Chunk::Entry & e : chunk.getUniqueLids()) {
+            vespalib::ConstBufferRef data(chunk.getLid(e.getLid()));
+            if (data.size() != 0) {
+                samples.emplace_back(data.c_str(), data.size());
+                sampledBytes += data.size();
+            }
+        }
+    }
+    return samples;
+}
+
 size_t
 FileChunk::getMemoryFootprint() const
 {
@@ -575,6 +635,15 @@ FileChunk::eraseDatFile(const vespalib::string & name)
     }
 }
 
+void
+FileChunk::eraseDictFile(const vespalib::string & name)
+{
+    vespalib::string fileName(createDictFileName(name));
+    if ( ! FastOS_File::Delete(fileName.c_str()) && (errno != ENOENT)) {
+        throw std::runtime_error(make_string("Failed to delete '%s'", fileName.c_str()));
+    }
+}
+
 
 DataStoreFileChunkStats
 FileChunk::getStats() const
@@ -19,10 +19,12 @@ namespace vespalib {
     class DataBuffer;
     class GenericHeader;
     class ThreadExecutor;
+    namespace compression { class ZStdDictionary; }
 }
 
 namespace search {
 
+namespace docstore { class BandwidthThrottle; }
 class DataStoreFileChunkStats;
 
 class IWriteData
@@ -105,6 +107,7 @@ public:
     typedef vespalib::hash_map<uint32_t, std::unique_ptr<vespalib::DataBuffer>> LidBufferMap;
     typedef std::unique_ptr<FileChunk> UP;
     typedef uint32_t SubChunkId;
+    using DictionarySP = std::shared_ptr<const vespalib::compression::ZStdDictionary>;
     FileChunk(FileId fileId, NameId nameId, const vespalib::string &baseName, const TuneFileSummary &tune,
               const IBucketizer *bucketizer, bool skipCrcOnRead);
     virtual ~FileChunk();
@@ -162,8 +165,14 @@ public:
     virtual bool frozen() const { return true; }
     const vespalib::string & getName() const { return _name; }
     void compact(const IGetLid & iGetLid);
+    /**
+     * Read and decompress the chunks on the executor and hand the live
+     * entries to dest in chunk order. A throttle, if given, limits the
+     * rate the chunks are read from disk.
+     */
     void appendTo(vespalib::ThreadExecutor & executor, const IGetLid & db, IWriteData & dest,
-                  uint32_t numChunks, IFileChunkVisitorProgress *visitorProgress);
+                  uint32_t numChunks, IFileChunkVisitorProgress *visitorProgress,
+                  docstore::BandwidthThrottle * throttle);
     /**
      * Must be called after chunk has been created to allow correct
      * underlying file object to be created.  Must be called before
@@ -182,6 +191,17 @@ public:
     void verify(bool reportOnly) const;
 
     uint32_t      getNumChunks() const;
+    /**
+     * The zstd dictionary used for compressing the chunks in this file, if any.
+     * It is stored next to the data in a '.dict' file.
+     */
+    const DictionarySP & getCompressionDictionary() const { return _dictionary; }
+    /**
+     * Collects the content of entries from chunks spread evenly across the file
+     * until at least maxBytes has been collected or the file is exhausted.
+     * Used as training samples for compression dictionaries.
+     */
+    std::vector<vespalib::string> sampleEntries(size_t maxBytes) const;
     size_t       getNumBuckets() const { return _sumNumBuckets; }
     size_t getNumUniqueBuckets() const { return _numUniqueBuckets; }
 
@@ -195,8 +215,10 @@ public:
     static bool isIdxFileEmpty(const vespalib::string & name);
     static void eraseIdxFile(const vespalib::string & name);
     static void eraseDatFile(const vespalib::string & name);
+    static void eraseDictFile(const vespalib::string & name);
     static vespalib::string createIdxFileName(const vespalib::string & name);
     static vespalib::string createDatFileName(const vespalib::string & name);
+    static vespalib::string createDictFileName(const vespalib::string & name);
 private:
     typedef std::unique_ptr<FileRandRead> File;
     void loadChunkInfo();
@@ -243,6 +265,8 @@ protected:
     TuneFileSummary     _tune;
     vespalib::string    _dataFileName;
     vespalib::string    _idxFileName;
+    vespalib::string    _dictFileName;
+    DictionarySP        _dictionary;
     ChunkInfoVector     _chunkInfo;
     uint32_t            _dataHeaderLen;
     uint32_t            _idxHeaderLen;
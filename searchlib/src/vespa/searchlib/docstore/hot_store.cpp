@@ -0,0 +1,335 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "hot_store.h"
+#include <vespa/vespalib/stllike/frequency_sketch.h>
+#include <vespa/vespalib/stllike/hash_map.hpp>
+#include <vespa/vespalib/data/databuffer.h>
+#include <vespa/vespalib/util/compressor.h>
+#include <limits>
+#include <mutex>
+
+using vespalib::compression::compress;
+using vespalib::compression::decompress;
+
+namespace search::docstore {
+
+namespace {
+
+// Assume compressed documents of around 4k when sizing the frequency sketch.
+// It must also track the lids that are not resident, hence the factor.
+size_t
+expectedElements(size_t maxBytes) {
+    return 4 * (maxBytes / 4096);
+}
+
+}
+
+class HotStore::Stripe
+{
+public:
+    Stripe(size_t maxBytes, uint32_t minAccesses, const CompressionConfig & compression);
+    ~Stripe();
+
+    Lookup read(uint32_t lid, vespalib::DataBuffer & buf);
+    void promote(uint32_t lid, CompressionConfig::Type type, size_t uncompressedSize,
+                 vespalib::ConstBufferRef data, const KeepPredicate & keep);
+    void invalidate(uint32_t lid);
+    void reconfigure(size_t maxBytes, uint32_t minAccesses, const CompressionConfig & compression);
+    void addStats(CacheStats & stats) const;
+private:
+    struct Entry {
+        size_t                  _offset;
+        uint32_t                _size;
+        uint32_t                _uncompressedSize;
+        uint32_t                _residentIndex;
+        CompressionConfig::Type _type;
+    };
+    using EntryMap = vespalib::hash_map<uint32_t, Entry>;
+    static constexpr size_t ENTRY_OVERHEAD = sizeof(Entry) + 2 * sizeof(uint32_t);
+    static constexpr size_t VICTIM_SAMPLES = 8;
+
+    void removeLocked(uint32_t lid);
+    void evictLocked(size_t maxBytes);
+    bool findVictimLocked(uint32_t & victim);
+    void appendLocked(uint32_t lid, Entry entry, const char * data);
+    void compactLocked(size_t capacity);
+    void resizeSketchLocked(size_t maxBytes);
+
+    size_t                                     _maxBytes;
+    uint32_t                                   _minAccesses;
+    CompressionConfig                          _compression;
+    mutable std::mutex                         _lock;
+    std::unique_ptr<vespalib::FrequencySketch> _sketch;
+    EntryMap                                   _entries;
+    std::vector<uint32_t>                      _residents;
+    std::vector<char>                          _arena;
+    size_t                                     _liveBytes;
+    size_t                                     _deadBytes;
+    uint64_t                                   _victimSeed;
+    size_t                                     _hits;
+    size_t                                     _misses;
+    size_t                                     _rejects;
+};
+
+HotStore::Stripe::Stripe(size_t maxBytes, uint32_t minAccesses, const CompressionConfig & compression)
+    : _maxBytes(maxBytes),
+      _minAccesses(minAccesses),
+      _compression(compression),
+      _lock(),
+      _sketch(),
+      _entries(),
+      _residents(),
+      _arena(),
+      _liveBytes(0),
+      _deadBytes(0),
+      _victimSeed(0x9e3779b97f4a7c15ul),
+      _hits(0),
+      _misses(0),
+      _rejects(0)
+{
+    resizeSketchLocked(maxBytes);
+}
+
+HotStore::Stripe::~Stripe() { }
+
+void
+HotStore::Stripe::resizeSketchLocked(size_t maxBytes)
+{
+    if (maxBytes == 0) {
+        _sketch.reset();
+    } else if ( ! _sketch || (_sketch->width() < expectedElements(maxBytes))) {
+        _sketch = std::make_unique<vespalib::FrequencySketch>(expectedElements(maxBytes));
+    }
+}
+
+HotStore::Lookup
+HotStore::Stripe::read(uint32_t lid, vespalib::DataBuffer & buf)
+{
+    Entry entry;
+    vespalib::DataBuffer compressed(0);
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        if ( ! _sketch) {
+            return Lookup::MISS;
+        }
+        _sketch->record(lid);
+        auto found = _entries.find(lid);
+        if (found == _entries.end()) {
+            _misses++;
+            return (_sketch->estimate(lid) >= _minAccesses) ? Lookup::PROMOTE : Lookup::MISS;
+        }
+        _hits++;
+        entry = found->second;
+        if (entry._type == CompressionConfig::NONE) {
+            buf.writeBytes(&_arena[entry._offset], entry._size);
+            return Lookup::HIT;
+        }
+        compressed.writeBytes(&_arena[entry._offset], entry._size);
+    }
+    decompress(entry._type, entry._uncompressedSize,
+               vespalib::ConstBufferRef(compressed.getData(), compressed.getDataLen()), buf, false);
+    return Lookup::HIT;
+}
+
+void
+HotStore::Stripe::promote(uint32_t lid, CompressionConfig::Type type, size_t uncompressedSize,
+                          vespalib::ConstBufferRef data, const KeepPredicate & keep)
+{
+    vespalib::DataBuffer compressed(0);
+    if (type == CompressionConfig::NONE) {
+        CompressionConfig compression;
+        {
+            std::lock_guard<std::mutex> guard(_lock);
+            compression = _compression;
+        }
+        type = compress(compression, data, compressed, false);
+        data = vespalib::ConstBufferRef(compressed.getData(), compressed.getDataLen());
+    }
+    Entry entry;
+    entry._offset = 0;
+    entry._size = data.size();
+    entry._uncompressedSize = uncompressedSize;
+    entry._residentIndex = 0;
+    entry._type = type;
+    size_t needed = data.size() + ENTRY_OVERHEAD;
+
+    std::lock_guard<std::mutex> guard(_lock);
+    if ( ! _sketch || ! keep() || (_entries.find(lid) != _entries.end())) {
+        return;
+    }
+    size_t maxBytes = _maxBytes;
+    uint32_t frequency = _sketch->estimate(lid);
+    while (_liveBytes + needed > maxBytes) {
+        uint32_t victim(0);
+        if ( ! findVictimLocked(victim) || (frequency <= _sketch->estimate(victim))) {
+            _rejects++;
+            return;
+        }
+        removeLocked(victim);
+    }
+    appendLocked(lid, entry, data.c_str());
+}
+
+bool
+HotStore::Stripe::findVictimLocked(uint32_t & victim)
+{
+    if (_residents.empty()) {
+        return false;
+    }
+    uint32_t lowest = std::numeric_limits<uint32_t>::max();
+    for (size_t i(0); i < std::min(VICTIM_SAMPLES, _residents.size()); i++) {
+        // xorshift, only used for picking samples
+        _victimSeed ^= _victimSeed << 13;
+        _victimSeed ^= _victimSeed >> 7;
+        _victimSeed ^= _victimSeed << 17;
+        uint32_t candidate = _residents[_victimSeed % _residents.size()];
+        uint32_t frequency = _sketch->estimate(candidate);
+        if (frequency < lowest) {
+            lowest = frequency;
+            victim = candidate;
+        }
+    }
+    return true;
+}
+
+void
+HotStore::Stripe::appendLocked(uint32_t lid, Entry entry, const char * data)
+{
+    if (_arena.size() + entry._size > _arena.capacity()) {
+        size_t wanted = (_arena.size() - _deadBytes) + entry._size;
+        compactLocked(std::max(wanted, std::min(2 * _arena.capacity(), _maxBytes)));
+    }
+    entry._offset = _arena.size();
+    entry._residentIndex = _residents.size();
+    _arena.insert(_arena.end(), data, data + entry._size);
+    _residents.push_back(lid);
+    _liveBytes += entry._size + ENTRY_OVERHEAD;
+    _entries[lid] = entry;
+}
+
+void
+HotStore::Stripe::compactLocked(size_t capacity)
+{
+    std::vector<char> arena;
+    arena.reserve(capacity);
+    for (uint32_t lid : _residents) {
+        Entry & entry = _entries[lid];
+        size_t offset = arena.size();
+        arena.insert(arena.end(), _arena.begin() + entry._offset, _arena.begin() + entry._offset + entry._size);
+        entry._offset = offset;
+    }
+    _arena.swap(arena);
+    _deadBytes = 0;
+}
+
+void
+HotStore::Stripe::removeLocked(uint32_t lid)
+{
+    auto found = _entries.find(lid);
+    if (found == _entries.end()) {
+        return;
+    }
+    const Entry & entry = found->second;
+    uint32_t moved = _residents.back();
+    _residents[entry._residentIndex] = moved;
+    _entries[moved]._residentIndex = entry._residentIndex;
+    _residents.pop_back();
+    _liveBytes -= entry._size + ENTRY_OVERHEAD;
+    _deadBytes += entry._size;
+    _entries.erase(lid);
+}
+
+void
+HotStore::Stripe::invalidate(uint32_t lid)
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    removeLocked(lid);
+}
+
+void
+HotStore::Stripe::evictLocked(size_t maxBytes)
+{
+    while (_liveBytes > maxBytes) {
+        uint32_t victim(0);
+        findVictimLocked(victim);
+        removeLocked(victim);
+    }
+    if (_arena.capacity() > maxBytes) {
+        compactLocked(_arena.size() - _deadBytes);
+    }
+}
+
+void
+HotStore::Stripe::reconfigure(size_t maxBytes, uint32_t minAccesses, const CompressionConfig & compression)
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    _maxBytes = maxBytes;
+    _minAccesses = minAccesses;
+    _compression = compression;
+    evictLocked(maxBytes);
+    resizeSketchLocked(maxBytes);
+}
+
+void
+HotStore::Stripe::addStats(CacheStats & stats) const
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    stats += CacheStats(_hits, _misses, _entries.size(),
+                        _arena.capacity() + _entries.size() * ENTRY_OVERHEAD, _rejects);
+}
+
+HotStore::HotStore(size_t maxBytes, uint32_t minAccesses, const CompressionConfig & compression, size_t numStripes)
+    : _maxBytes(maxBytes),
+      _stripes()
+{
+    size_t n(1);
+    while (n < numStripes) {
+        n <<= 1;
+    }
+    _stripes.reserve(n);
+    for (size_t i(0); i < n; i++) {
+        _stripes.push_back(std::make_unique<Stripe>((maxBytes + n - 1) / n, minAccesses, compression));
+    }
+}
+
+HotStore::~HotStore() { }
+
+HotStore::Lookup
+HotStore::read(uint32_t lid, vespalib::DataBuffer & buf)
+{
+    return getStripe(lid).read(lid, buf);
+}
+
+void
+HotStore::promote(uint32_t lid, CompressionConfig::Type type, size_t uncompressedSize,
+                  vespalib::ConstBufferRef data, const KeepPredicate & keep)
+{
+    getStripe(lid).promote(lid, type, uncompressedSize, data, keep);
+}
+
+void
+HotStore::invalidate(uint32_t lid)
+{
+    getStripe(lid).invalidate(lid);
+}
+
+void
+HotStore::reconfigure(size_t maxBytes, uint32_t minAccesses, const CompressionConfig & compression)
+{
+    _maxBytes.store(maxBytes, std::memory_order_relaxed);
+    for (auto & stripe : _stripes) {
+        stripe->reconfigure(perStripe(maxBytes), minAccesses, compression);
+    }
+}
+
+CacheStats
+HotStore::getStats() const
+{
+    CacheStats stats;
+    for (const auto & stripe : _stripes) {
+        stripe->addStats(stats);
+    }
+    return stats;
+}
+
+}
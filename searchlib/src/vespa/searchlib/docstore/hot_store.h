@@ -0,0 +1,82 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "cachestats.h"
+#include <vespa/vespalib/util/compressionconfig.h>
+#include <vespa/vespalib/util/buffer.h>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace vespalib { class DataBuffer; }
+
+namespace search::docstore {
+
+/**
+ * In memory hot tier of the document store.
+ *
+ * Pins the serialized documents of the most frequently read lids, compressed,
+ * in an append only arena with its own memory budget. Reads are counted in a
+ * frequency sketch, and a lid read at least minAccesses times in the recent
+ * window is a candidate for promotion. When the budget is exhausted a candidate
+ * only replaces the least frequently read of a few sampled residents, and only
+ * if it is read more often. Unlike the cache it is not flushed by a burst of
+ * reads of other documents. Space of evicted and invalidated documents is
+ * reclaimed when the arena is compacted on growth.
+ *
+ * Like the cache it is split into stripes on lid, each with its own lock, sketch
+ * and an equal share of the memory budget, so reads of different lids rarely contend.
+ */
+class HotStore
+{
+public:
+    using CompressionConfig = vespalib::compression::CompressionConfig;
+    using KeepPredicate = std::function<bool()>;
+    enum class Lookup { HIT, MISS, PROMOTE };
+
+    /**
+     * @param numStripes is the number of stripes the store is split into. Rounded up to a power of 2.
+     */
+    HotStore(size_t maxBytes, uint32_t minAccesses, const CompressionConfig & compression, size_t numStripes = 1);
+    ~HotStore();
+
+    /**
+     * Records a read of the lid and, if it is resident, copies its uncompressed
+     * serialized document into buf.
+     *
+     * @return HIT if resident, PROMOTE if the caller should offer the document
+     *         it reads elsewhere to promote(), MISS otherwise.
+     */
+    Lookup read(uint32_t lid, vespalib::DataBuffer & buf);
+
+    /**
+     * Offers a serialized document for promotion. It is compressed with the
+     * configured compression unless it already is. It is dropped if keep() is
+     * false when the lock is held, which guards against concurrent writes.
+     */
+    void promote(uint32_t lid, CompressionConfig::Type type, size_t uncompressedSize,
+                 vespalib::ConstBufferRef data, const KeepPredicate & keep);
+    void invalidate(uint32_t lid);
+    void reconfigure(size_t maxBytes, uint32_t minAccesses, const CompressionConfig & compression);
+
+    bool enabled() const { return getMaxBytes() != 0; }
+    size_t getMaxBytes() const { return _maxBytes.load(std::memory_order_relaxed); }
+    size_t numStripes() const { return _stripes.size(); }
+    CacheStats getStats() const;
+private:
+    class Stripe;
+
+    Stripe & getStripe(uint32_t lid) const {
+        // Same remix as the striped cache, so both agree on which lids share a stripe.
+        uint64_t h = uint64_t(lid) * 0x9e3779b97f4a7c15ul;
+        return *_stripes[(h >> 32) & (_stripes.size() - 1)];
+    }
+    size_t perStripe(size_t maxBytes) const { return (maxBytes + _stripes.size() - 1) / _stripes.size(); }
+
+    std::atomic<size_t>                  _maxBytes;
+    std::vector<std::unique_ptr<Stripe>> _stripes;
+};
+
+}
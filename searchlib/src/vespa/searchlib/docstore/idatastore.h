@@ -3,6 +3,7 @@
 #pragma once
 
 #include "data_store_file_chunk_stats.h"
+#include "data_store_write_stats.h"
 #include <vespa/fastos/timestamp.h>
 #include <vespa/searchlib/common/i_compactable_lid_space.h>
 #include <vespa/searchlib/util/memoryusage.h>
@@ -162,6 +163,11 @@ public:
      */
     virtual DataStoreStorageStats getStorageStats() const = 0;
 
+    /*
+     * Return write path latency stats collected since the previous call.
+     */
+    virtual DataStoreWriteStats getWriteStats() { return DataStoreWriteStats(); }
+
     /*
      * Return the memory usage for data store.
      */
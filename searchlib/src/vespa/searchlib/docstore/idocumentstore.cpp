@@ -1,6 +1,7 @@
 // Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "idocumentstore.h"
+#include "cachestats.h"
 #include <vespa/document/fieldvalue/document.h>
 
 namespace search {
@@ -9,10 +10,38 @@ IDocumentStore::IDocumentStore() = default;
 
 IDocumentStore::~IDocumentStore() = default;
 
+IDocumentStore::DocumentUP
+IDocumentStore::read(DocumentIdT lid, const document::DocumentTypeRepo &repo, const document::FieldSet &) const {
+    return read(lid, repo);
+}
+
+std::vector<IDocumentStore::DocumentUP>
+IDocumentStore::read(const LidVector & lids, const document::DocumentTypeRepo &repo,
+                     const document::FieldSet & fields) const {
+    std::vector<DocumentUP> docs;
+    docs.reserve(lids.size());
+    for (uint32_t lid : lids) {
+        docs.push_back(read(lid, repo, fields));
+    }
+    return docs;
+}
+
+bool
+IDocumentStore::writeUpdate(uint64_t, DocumentIdT, const document::DocumentUpdate &,
+                            const std::shared_ptr<const document::DocumentTypeRepo> &,
+                            const vespalib::nbostream &) {
+    return false;
+}
+
 void IDocumentStore::visit(const LidVector & lids, const document::DocumentTypeRepo &repo, IDocumentVisitor & visitor) const {
     for (uint32_t lid : lids) {
         visitor.visit(lid, read(lid, repo));
     }
 }
 
+CacheStats
+IDocumentStore::getHotStoreStats() const {
+    return CacheStats();
+}
+
 } // namespace search
@@ -10,6 +10,8 @@
 namespace document {
     class Document;
     class DocumentTypeRepo;
+    class DocumentUpdate;
+    class FieldSet;
 }
 
 namespace vespalib { class nbostream; }
@@ -85,6 +87,21 @@ public:
      * @return NULL if there is no document associated with the lid.
      **/
     virtual DocumentUP read(DocumentIdT lid, const document::DocumentTypeRepo &repo) const = 0;
+    /**
+     * Make a Document with only the given fields from a stored serialized data blob.
+     * The serialized data of other fields is not deserialized.
+     * Default implementation makes the complete Document.
+     **/
+    virtual DocumentUP read(DocumentIdT lid, const document::DocumentTypeRepo &repo, const document::FieldSet & fields) const;
+    /**
+     * Make Documents for a set of lids in one go. Implementations can use this to read each
+     * underlying chunk only once for all the lids it contains.
+     * @param lids The local IDs to read.
+     * @param fields The fields to deserialize, use document::AllFields to get complete Documents.
+     * @return One entry per requested lid in the same order, NULL where there is no document.
+     **/
+    virtual std::vector<DocumentUP> read(const LidVector & lids, const document::DocumentTypeRepo &repo,
+                                         const document::FieldSet & fields) const;
     virtual void visit(const LidVector & lidVector, const document::DocumentTypeRepo &repo, IDocumentVisitor & visitor) const;
 
     /**
@@ -95,6 +112,18 @@ public:
     virtual void write(uint64_t syncToken, DocumentIdT lid, const document::Document& doc) = 0;
     virtual void write(uint64_t synkToken, DocumentIdT lid, const vespalib::nbostream & os) = 0;
 
+    /**
+     * Store an update of an existing document as a delta on top of the stored document,
+     * instead of writing the complete updated document.
+     * Default implementation does not keep deltas.
+     * @param updatedDoc The serialized document with the update applied, served to readers
+     *                   until the delta is folded. May be empty if not available.
+     * @return false if the delta was not stored, and the updated document must be written instead.
+     **/
+    virtual bool writeUpdate(uint64_t syncToken, DocumentIdT lid, const document::DocumentUpdate & update,
+                             const std::shared_ptr<const document::DocumentTypeRepo> & repo,
+                             const vespalib::nbostream & updatedDoc);
+
     /**
      * Mark a document as removed. A later read() will return NULL for the given lid.
      * @param lid The local ID associated with the document
@@ -176,6 +205,11 @@ public:
      */
     virtual CacheStats getCacheStats() const = 0;
 
+    /**
+     * Returns statistics about the in memory hot tier, if any.
+     */
+    virtual CacheStats getHotStoreStats() const;
+
     /**
      * Returns the base directory from which all structures are stored.
      **/
@@ -207,6 +241,11 @@ public:
      */
     virtual DataStoreStorageStats getStorageStats() const = 0;
 
+    /*
+     * Return write path latency stats collected since the previous call.
+     */
+    virtual DataStoreWriteStats getWriteStats() { return DataStoreWriteStats(); }
+
     /*
      * Return the memory usage for document store.
      */
@@ -3,12 +3,14 @@
 #include "storebybucket.h"
 #include "compacter.h"
 #include "logdatastore.h"
+#include "bandwidth_throttle.h"
 #include <vespa/vespalib/stllike/asciistream.h>
 #include <vespa/vespalib/util/benchmark_timer.h>
 #include <vespa/vespalib/data/fileheader.h>
 #include <vespa/vespalib/stllike/hash_map.hpp>
 #include <vespa/searchlib/common/rcuvector.hpp>
 #include <vespa/vespalib/util/exceptions.h>
+#include <vespa/vespalib/util/zstdcompressor.h>
 #include <thread>
 
 #include <vespa/log/log.h>
@@ -34,9 +36,12 @@ LogDataStore::Config::Config()
       _maxDiskBloatFactor(0.2),
       _maxBucketSpread(2.5),
       _minFileSizeFactor(0.2),
+      _compressionDictionarySize(0),
       _skipCrcOnRead(false),
       _compact2ActiveFile(true),
       _compactCompression(CompressionConfig::LZ4),
+      _compactMaxBytesPerSecond(0),
+      _compactToBucketOrder(true),
       _fileConfig()
 { }
 
@@ -46,9 +51,12 @@ LogDataStore::Config::operator == (const Config & rhs) const {
             (_maxDiskBloatFactor == rhs._maxDiskBloatFactor) &&
             (_maxFileSize == rhs._maxFileSize) &&
             (_minFileSizeFactor == rhs._minFileSizeFactor) &&
+            (_compressionDictionarySize == rhs._compressionDictionarySize) &&
             (_compact2ActiveFile == rhs._compact2ActiveFile) &&
             (_skipCrcOnRead == rhs._skipCrcOnRead) &&
             (_compactCompression == rhs._compactCompression) &&
+            (_compactMaxBytesPerSecond == rhs._compactMaxBytesPerSecond) &&
+            (_compactToBucketOrder == rhs._compactToBucketOrder) &&
             (_fileConfig == rhs._fileConfig);
 }
 
@@ -60,6 +68,7 @@ LogDataStore::LogDataStore(vespalib::ThreadExecutor &executor, const vespalib::s
       _config(config),
       _tune(tune),
       _fileHeaderContext(fileHeaderContext),
+      _writeStats(),
       _genHandler(),
       _lidInfo(growStrategy.getDocsInitialCapacity(),
                growStrategy.getDocsGrowPercent(),
@@ -74,7 +83,8 @@ LogDataStore::LogDataStore(vespalib::ThreadExecutor &executor, const vespalib::s
       _tlSyncer(tlSyncer),
       _bucketizer(bucketizer),
       _currentlyCompacting(),
-      _compactLidSpaceGeneration()
+      _compactLidSpaceGeneration(),
+      _compressionDictionary()
 {
     // Reserve space for 1TB summary in order to avoid locking.
     _fileChunks.reserve(LidInfo::getFileIdLimit());
@@ -318,7 +328,7 @@ LogDataStore::getMaxCompactGain() const
         bloat = 0;
     }
     size_t spreadAsBloat = diskFootPrint * (1.0 - 1.0/maxSpread);
-    if ( maxSpread < _config.getMaxBucketSpread()) {
+    if ( maxSpread < _config.getMaxBucketSpread() || !compactToBucketOrder()) {
         spreadAsBloat = 0;
     }
     return (bloat + spreadAsBloat);
@@ -332,11 +342,12 @@ LogDataStore::flush(uint64_t syncToken)
     assert(syncToken == _initFlushSyncToken);
     {
         LockGuard guard(_updateLock);
-        // Note: Feed latency spike
-        getActive(guard).flush(true, syncToken);
+        getActive(guard).flush(false, syncToken);
         active = &getActive(guard);
         activeHolder = holdFileChunk(active->getFileId());
     }
+    // Wait for the chunk to be compressed and written without blocking writers.
+    active->waitForDiskToCatchUpToNow();
     active->flushPendingChunks(syncToken);
     activeHolder.reset();
     LOG(info, "Flushing. %s",bloatMsg(getDiskBloat(), getDiskFootprint()).c_str());
@@ -379,7 +390,7 @@ LogDataStore::findNextToCompact(double bloatLimit, double spreadLimit)
         if (fc && fc->frozen() && (_currentlyCompacting.find(fc->getNameId()) == _currentlyCompacting.end())) {
             uint64_t usage = fc->getDiskFootprint();
             uint64_t bloat = fc->getDiskBloat();
-            if (_bucketizer) {
+            if (compactToBucketOrder()) {
                 worstSpread.emplace(fc->getBucketSpread(), FileId(i));
             }
             if (usage > 0) {
@@ -446,6 +457,10 @@ void LogDataStore::flushActiveAndWait(SerialNum syncToken) {
     return flushFileAndWait(std::move(guard), active, syncToken);
 }
 
+bool LogDataStore::compactToBucketOrder() const {
+    return _bucketizer && _config.compactToBucketOrder();
+}
+
 bool LogDataStore::shouldCompactToActiveFile(size_t compactedSize) const {
     return _config.compact2ActiveFile()
            || (_config.getMinFileSizeFactor() * _config.getMaxFileSize() > compactedSize);
@@ -466,9 +481,12 @@ void LogDataStore::compactFile(FileId fileId)
     NameId compactedNameId = fc->getNameId();
     LOG(info, "Compacting file '%s' which has bloat '%2.2f' and bucket-spread '%1.4f",
               fc->getName().c_str(), 100*fc->getDiskBloat()/double(fc->getDiskFootprint()), fc->getBucketSpread());
+    if (useCompressionDictionary()) {
+        trainCompressionDictionary(*fc);
+    }
     IWriteData::UP compacter;
     FileId destinationFileId = FileId::active();
-    if (_bucketizer) {
+    if (compactToBucketOrder()) {
         if ( ! shouldCompactToActiveFile(fc->getDiskFootprint() - fc->getDiskBloat())) {
             LockGuard guard(_updateLock);
             destinationFileId = allocateFileId(guard);
@@ -481,7 +499,8 @@ void LogDataStore::compactFile(FileId fileId)
         compacter.reset(new docstore::Compacter(*this));
     }
 
-    fc->appendTo(_executor, *this, *compacter, fc->getNumChunks(), nullptr);
+    docstore::BandwidthThrottle throttle(_config.getCompactMaxBytesPerSecond());
+    fc->appendTo(_executor, *this, *compacter, fc->getNumChunks(), nullptr, &throttle);
 
     if (destinationFileId.isActive()) {
         flushActiveAndWait(0);
@@ -649,11 +668,43 @@ LogDataStore::createWritableFile(FileId fileId, SerialNum serialNum, NameId name
     FileChunk::UP file(new WriteableFileChunk(_executor, fileId, nameId, getBaseDir(),
                                               serialNum, docIdLimit,
                                               _config.getFileConfig(), _tune, _fileHeaderContext,
-                                              _bucketizer.get(), _config.crcOnReadDisabled()));
+                                              _bucketizer.get(), _config.crcOnReadDisabled(),
+                                              useCompressionDictionary() ? _compressionDictionary : FileChunk::DictionarySP(),
+                                              &_writeStats));
     file->enableRead();
     return file;
 }
 
+bool
+LogDataStore::useCompressionDictionary() const
+{
+    return (_config.getCompressionDictionarySize() > 0) &&
+           (_config.getFileConfig().getCompression().type == CompressionConfig::ZSTD);
+}
+
+void
+LogDataStore::trainCompressionDictionary(const FileChunk & source)
+{
+    // Train on ~100 times the dictionary size, which is what zstd recommends.
+    size_t dictionarySize = _config.getCompressionDictionarySize();
+    std::vector<vespalib::string> samples = source.sampleEntries(dictionarySize * 100);
+    std::vector<vespalib::ConstBufferRef> sampleRefs;
+    sampleRefs.reserve(samples.size());
+    for (const vespalib::string & sample : samples) {
+        sampleRefs.emplace_back(sample.c_str(), sample.size());
+    }
+    FileChunk::DictionarySP dictionary(vespalib::compression::ZStdDictionary::train(sampleRefs, dictionarySize));
+    if (dictionary) {
+        LOG(info, "Trained compression dictionary %u of %zu bytes from %zu entries in file '%s'",
+            dictionary->getId(), dictionary->getData().size(), samples.size(), source.getName().c_str());
+        LockGuard guard(_updateLock);
+        _compressionDictionary = std::move(dictionary);
+    } else {
+        LOG(warning, "Failed training compression dictionary from %zu entries in file '%s'",
+            samples.size(), source.getName().c_str());
+    }
+}
+
 FileChunk::UP
 LogDataStore::createWritableFile(FileId fileId, SerialNum serialNum)
 {
@@ -783,10 +834,16 @@ LogDataStore::preload()
         typedef NameIdSet::const_iterator It;
         for (It it(partList.begin()), mt(--partList.end()); it != mt; it++) {
             _fileChunks.push_back(createReadOnlyFile(FileId(_fileChunks.size()), *it));
+            if (_fileChunks.back()->getCompressionDictionary()) {
+                _compressionDictionary = _fileChunks.back()->getCompressionDictionary();
+            }
         }
         _fileChunks.push_back(isReadOnly()
             ? createReadOnlyFile(FileId(_fileChunks.size()), *partList.rbegin())
             : createWritableFile(FileId(_fileChunks.size()), getMinLastPersistedSerialNum(), *partList.rbegin()));
+        if (_fileChunks.back()->getCompressionDictionary()) {
+            _compressionDictionary = _fileChunks.back()->getCompressionDictionary();
+        }
     } else {
         if ( ! isReadOnly() ) {
             _fileChunks.push_back(createWritableFile(FileId::first(), 0));
@@ -864,6 +921,7 @@ LogDataStore::eraseIncompleteCompactedFiles(NameIdSet partList)
         LOG(warning, "'%s' has been detected as an incompletely compacted file. Erasing it.", name.c_str());
         FileChunk::eraseIdxFile(name);
         FileChunk::eraseDatFile(name);
+        FileChunk::eraseDictFile(name);
     }
 
     return std::move(partList);
@@ -900,6 +958,7 @@ LogDataStore::eraseDanglingDatFiles(const NameIdSet &partList, const NameIdSet &
             vespalib::string fileName = createFileName(dbase);
             LOG(warning, "Removing dangling file '%s'", FileChunk::createDatFileName(fileName).c_str());
             FileChunk::eraseDatFile(fileName);
+            FileChunk::eraseDictFile(fileName);
             ++di;
         } else {
             ++ii;
@@ -1088,7 +1147,7 @@ LogDataStore::accept(IDataStoreVisitor &visitor,
     WrapVisitorProgress wrapProgress(visitorProgress, totalChunks);
     for (FileId fcId : fileChunks) {
         FileChunk & fc = *_fileChunks[fcId.getId()];
-        fc.appendTo(_executor, *this, wrap, fc.getNumChunks(), &wrapProgress);
+        fc.appendTo(_executor, *this, wrap, fc.getNumChunks(), &wrapProgress, nullptr);
         if (prune) {
             internalFlushAll();
             FileChunk::UP toDie;
@@ -1099,7 +1158,7 @@ LogDataStore::accept(IDataStoreVisitor &visitor,
             toDie->erase();
         }
     }
-    lfc.appendTo(_executor, *this, wrap, lastChunks, &wrapProgress);
+    lfc.appendTo(_executor, *this, wrap, lastChunks, &wrapProgress, nullptr);
     if (prune) {
         internalFlushAll();
     }
@@ -1145,6 +1204,12 @@ LogDataStore::unholdFileChunk(FileId fileId)
     // No signalling, compactWorst() sleeps and retries
 }
 
+DataStoreWriteStats
+LogDataStore::getWriteStats()
+{
+    return _writeStats.take();
+}
+
 DataStoreStorageStats
 LogDataStore::getStorageStats() const
 {
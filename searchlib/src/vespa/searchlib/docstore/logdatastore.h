@@ -5,6 +5,7 @@
 #include "idatastore.h"
 #include "lid_info.h"
 #include "writeablefilechunk.h"
+#include "data_store_write_stats.h"
 #include <vespa/vespalib/util/compressionconfig.h>
 #include <vespa/searchlib/common/rcuvector.h>
 #include <vespa/searchlib/common/tunefileinfo.h>
@@ -42,18 +43,35 @@ public:
         Config & setMaxDiskBloatFactor(double v) { _maxDiskBloatFactor = v; return *this; }
         Config & setMaxBucketSpread(double v) { _maxBucketSpread = v; return *this; }
         Config & setMinFileSizeFactor(double v) { _minFileSizeFactor = v; return *this; }
+        Config & setCompressionDictionarySize(size_t v) { _compressionDictionarySize = v; return *this; }
 
         Config & compactCompression(CompressionConfig v) { _compactCompression = v; return *this; }
+        Config & setCompactMaxBytesPerSecond(size_t v) { _compactMaxBytesPerSecond = v; return *this; }
+        Config & compactToBucketOrder(bool v) { _compactToBucketOrder = v; return *this; }
         Config & setFileConfig(WriteableFileChunk::Config v) { _fileConfig = v; return *this; }
 
         size_t getMaxFileSize() const { return _maxFileSize; }
         double getMaxDiskBloatFactor() const { return _maxDiskBloatFactor; }
         double getMaxBucketSpread() const { return _maxBucketSpread; }
         double getMinFileSizeFactor() const { return _minFileSizeFactor; }
+        /**
+         * Max size of the zstd dictionary trained when compacting a file.
+         * 0 disables dictionary compression.
+         */
+        size_t getCompressionDictionarySize() const { return _compressionDictionarySize; }
 
         bool crcOnReadDisabled() const { return _skipCrcOnRead; }
         bool compact2ActiveFile() const { return _compact2ActiveFile; }
         const CompressionConfig & compactCompression() const { return _compactCompression; }
+        /**
+         * Max rate compaction reads a file from disk. 0 means unlimited.
+         */
+        size_t getCompactMaxBytesPerSecond() const { return _compactMaxBytesPerSecond; }
+        /**
+         * Rewrite the documents in bucket order when compacting, given a bucketizer.
+         * Without it bucket spread will not trigger compaction.
+         */
+        bool compactToBucketOrder() const { return _compactToBucketOrder; }
 
         const WriteableFileChunk::Config & getFileConfig() const { return _fileConfig; }
         Config & disableCrcOnRead(bool v) { _skipCrcOnRead = v; return *this;}
@@ -65,9 +83,12 @@ public:
         double                      _maxDiskBloatFactor;
         double                      _maxBucketSpread;
         double                      _minFileSizeFactor;
+        size_t                      _compressionDictionarySize;
         bool                        _skipCrcOnRead;
         bool                        _compact2ActiveFile;
         CompressionConfig           _compactCompression;
+        size_t                      _compactMaxBytesPerSecond;
+        bool                        _compactToBucketOrder;
         WriteableFileChunk::Config  _fileConfig;
     };
 public:
@@ -166,6 +187,7 @@ public:
     }
 
     DataStoreStorageStats getStorageStats() const override;
+    DataStoreWriteStats getWriteStats() override;
     MemoryUsage getMemoryUsage() const override;
     std::vector<DataStoreFileChunkStats> getFileChunkStats() const override;
 
@@ -236,6 +258,8 @@ private:
     FileChunk::UP createReadOnlyFile(FileId fileId, NameId nameId);
     FileChunk::UP createWritableFile(FileId fileId, SerialNum serialNum);
     FileChunk::UP createWritableFile(FileId fileId, SerialNum serialNum, NameId nameId);
+    bool useCompressionDictionary() const;
+    void trainCompressionDictionary(const FileChunk & source);
     vespalib::string createFileName(NameId id) const;
     vespalib::string createDatFileName(NameId id) const;
     vespalib::string createIdxFileName(NameId id) const;
@@ -264,6 +288,7 @@ private:
     SerialNum getMinLastPersistedSerialNum() const {
         return (_fileChunks.empty() ? 0 : _fileChunks.back()->getLastPersistedSerialNum());
     }
+    bool compactToBucketOrder() const;
     bool shouldCompactToActiveFile(size_t compactedSize) const;
     std::pair<bool, FileId> findNextToCompact(double bloatLimit, double spreadLimit);
     void incGeneration();
@@ -273,6 +298,7 @@ private:
     Config                                   _config;
     TuneFileSummary                          _tune;
     const search::common::FileHeaderContext &_fileHeaderContext;
+    docstore::WriteStatsCollector            _writeStats;
     mutable vespalib::GenerationHandler      _genHandler;
     LidInfoVector                            _lidInfo;
     FileChunkVector                          _fileChunks;
@@ -287,6 +313,7 @@ private:
     IBucketizer::SP                          _bucketizer;
     NameIdSet                                _currentlyCompacting;
     uint64_t                                 _compactLidSpaceGeneration;
+    FileChunk::DictionarySP                  _compressionDictionary;
 };
 
 } // namespace search
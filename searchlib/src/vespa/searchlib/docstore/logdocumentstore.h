@@ -51,7 +51,7 @@ public:
     ~LogDocumentStore();
     void reconfigure(const Config & config);
 private:
-    void compact(uint64_t syncToken) override       { _backingStore.compact(syncToken); }
+    void compact(uint64_t syncToken) override       { _backingStore.compact(foldUpdates(syncToken)); }
     LogDataStore _backingStore;
 };
 
@@ -2,6 +2,7 @@
 
 #include "storebybucket.h"
 #include <vespa/vespalib/util/closuretask.h>
+#include <vespa/vespalib/util/lambdatask.h>
 #include <vespa/vespalib/stllike/hash_map.hpp>
 #include <vespa/vespalib/data/databuffer.h>
 #include <algorithm>
@@ -11,6 +12,7 @@ namespace search::docstore {
 using document::BucketId;
 using vespalib::makeTask;
 using vespalib::makeClosure;
+using vespalib::makeLambdaTask;
 
 StoreByBucket::StoreByBucket(MemoryDataStore & backingMemory, ThreadExecutor & executor, const CompressionConfig & compression) :
     _chunkSerial(0),
@@ -72,8 +74,13 @@ StoreByBucket::drain(IWrite & drainer)
     chunks.resize(_chunks.size());
     for (const auto & it : _chunks) {
         ConstBufferRef buf(it.second);
-        chunks[it.first].reset(new Chunk(it.first, buf.data(), buf.size()));
+        Chunk::UP & chunk = chunks[it.first];
+        uint64_t chunkId = it.first;
+        _executor.execute(makeLambdaTask([&chunk, chunkId, buf]() {
+            chunk = std::make_unique<Chunk>(chunkId, buf.data(), buf.size());
+        }));
     }
+    _executor.sync();
     _chunks.clear();
     for (auto & it : _where) {
         std::sort(it.second.begin(), it.second.end());
@@ -0,0 +1,195 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "update_deltas.h"
+#include <vespa/document/fieldvalue/document.h>
+#include <vespa/document/update/documentupdate.h>
+#include <vespa/vespalib/objects/nbostream.h>
+#include <vespa/vespalib/stllike/hash_map.hpp>
+#include <algorithm>
+
+namespace search::docstore {
+
+UpdateDeltas::Chain::Chain()
+    : _firstSerialNum(0),
+      _lastSerialNum(0),
+      _generation(0),
+      _numDeltas(0),
+      _deltas(),
+      _materialized(),
+      _repo()
+{ }
+
+UpdateDeltas::Chain::~Chain() { }
+
+UpdateDeltas::DocumentUP
+UpdateDeltas::Chain::apply(DocumentUP doc, const document::DocumentTypeRepo & repo) const
+{
+    if ( ! doc) {
+        return doc;
+    }
+    vespalib::nbostream is(_deltas.data(), _deltas.size());
+    while ( ! is.empty()) {
+        uint32_t len(0);
+        is >> len;
+        auto update = document::DocumentUpdate::createHEAD(repo, vespalib::nbostream(is.peek(), len));
+        is.adjustReadPos(len);
+        update->applyTo(*doc);
+    }
+    return doc;
+}
+
+UpdateDeltas::UpdateDeltas()
+    : _lock(),
+      _chains(),
+      _firstSerialNums(),
+      _numChains(0),
+      _lastSerialNum(0),
+      _generation(0),
+      _bytes(0)
+{ }
+
+UpdateDeltas::~UpdateDeltas() { }
+
+void
+UpdateDeltas::add(uint64_t serialNum, uint32_t lid, const document::DocumentUpdate & update, RepoSP repo,
+                  const vespalib::nbostream & updatedDoc)
+{
+    vespalib::nbostream os;
+    update.serializeHEAD(os);
+    uint32_t len = os.size();
+    vespalib::nbostream header;
+    header << len;
+
+    std::lock_guard<std::mutex> guard(_lock);
+    Chain & chain = _chains[lid];
+    _bytes -= chain.memoryUsed();
+    if (chain._numDeltas == 0) {
+        chain._firstSerialNum = serialNum;
+        _firstSerialNums[serialNum] = lid;
+        _numChains.store(_chains.size(), std::memory_order_release);
+    }
+    chain._lastSerialNum = serialNum;
+    chain._generation = ++_generation;
+    chain._numDeltas++;
+    chain._deltas.insert(chain._deltas.end(), header.peek(), header.peek() + header.size());
+    chain._deltas.insert(chain._deltas.end(), os.peek(), os.peek() + os.size());
+    if (updatedDoc.empty()) {
+        std::vector<char>().swap(chain._materialized);
+    } else {
+        chain._materialized.assign(updatedDoc.peek(), updatedDoc.peek() + updatedDoc.size());
+    }
+    chain._repo = std::move(repo);
+    _bytes += chain.memoryUsed();
+    _lastSerialNum.store(std::max(serialNum, getLastSerialNum()), std::memory_order_relaxed);
+}
+
+bool
+UpdateDeltas::get(uint32_t lid, Chain & chain) const
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    auto found = _chains.find(lid);
+    if (found == _chains.end()) {
+        return false;
+    }
+    chain = found->second;
+    return true;
+}
+
+bool
+UpdateDeltas::setMaterialized(uint32_t lid, uint64_t generation, std::vector<char> doc)
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    auto found = _chains.find(lid);
+    if ((found == _chains.end()) || (found->second._generation != generation)) {
+        return false;
+    }
+    Chain & chain = found->second;
+    _bytes -= chain.memoryUsed();
+    chain._materialized = std::move(doc);
+    _bytes += chain.memoryUsed();
+    return true;
+}
+
+void
+UpdateDeltas::rebase(uint32_t lid, uint64_t serialNum, bool keepChain, const WriteFunction & write)
+{
+    std::unique_lock<std::mutex> guard(_lock);
+    auto found = _chains.find(lid);
+    if (found == _chains.end()) {
+        // Nothing for readers to combine with the new document, and the caller
+        // serializes writes, so no chain can appear meanwhile.
+        serialNum = capSerialNum(guard, serialNum);
+        guard.unlock();
+        write(serialNum);
+        return;
+    }
+    Chain & chain = found->second;
+    if ( ! keepChain) {
+        // The new document replaces the chain, so the chain must not hold it back.
+        auto first = _firstSerialNums.find(chain._firstSerialNum);
+        if ((first != _firstSerialNums.end()) && (first->second == lid)) {
+            _firstSerialNums.erase(first);
+        }
+    }
+    write(capSerialNum(guard, serialNum));
+    _bytes -= chain.memoryUsed();
+    if (keepChain) {
+        std::vector<char>().swap(chain._materialized);
+        chain._generation = ++_generation;
+        _bytes += chain.memoryUsed();
+    } else {
+        _chains.erase(lid);
+        _numChains.store(_chains.size(), std::memory_order_release);
+    }
+}
+
+uint64_t
+UpdateDeltas::capSerialNum(const std::unique_lock<std::mutex> &guard, uint64_t serialNum) const
+{
+    (void) guard;
+    return _firstSerialNums.empty()
+           ? serialNum
+           : std::min(serialNum, _firstSerialNums.begin()->first - 1);
+}
+
+uint64_t
+UpdateDeltas::startFold(uint64_t syncToken, std::vector<uint32_t> & lids)
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    // A chain reaching past the limit holds the limit below its first serial number,
+    // which again can hold back chains overlapping that one.
+    bool lowered(true);
+    while (lowered) {
+        lowered = false;
+        for (const auto & entry : _chains) {
+            const Chain & chain = entry.second;
+            if ((chain._lastSerialNum > syncToken) && (chain._firstSerialNum <= syncToken)) {
+                syncToken = chain._firstSerialNum - 1;
+                lowered = true;
+            }
+        }
+    }
+    std::vector<std::pair<uint64_t, uint32_t>> folded;
+    for (const auto & entry : _chains) {
+        if (entry.second._lastSerialNum <= syncToken) {
+            folded.emplace_back(entry.second._lastSerialNum, entry.first);
+            _firstSerialNums.erase(entry.second._firstSerialNum);
+        }
+    }
+    // The remaining chains all start after the limit, so every folded document
+    // is tagged with the last serial number it contains.
+    std::sort(folded.begin(), folded.end());
+    for (const auto & entry : folded) {
+        lids.push_back(entry.second);
+    }
+    return syncToken;
+}
+
+size_t
+UpdateDeltas::memoryUsed() const
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    return _bytes + _chains.getMemoryConsumption();
+}
+
+}
@@ -0,0 +1,127 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/vespalib/stllike/hash_map.h>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace vespalib { class nbostream; }
+namespace document {
+    class Document;
+    class DocumentTypeRepo;
+    class DocumentUpdate;
+}
+
+namespace search::docstore {
+
+/**
+ * Chains of serialized document updates kept per lid on top of the document
+ * in the backing store, so an update does not rewrite the complete document.
+ *
+ * The chains only live in memory until they are folded into the backing store.
+ * To stay replayable after a crash the backing store must never report a sync
+ * token at or above the first serial number of a pending chain, so writes to it
+ * are tagged with a serial number capped below those chains, see rebase(). A
+ * chain can only be folded when no other pending chain overlaps its serial
+ * numbers, see startFold().
+ */
+class UpdateDeltas
+{
+public:
+    using DocumentUP = std::unique_ptr<document::Document>;
+    using RepoSP = std::shared_ptr<const document::DocumentTypeRepo>;
+    using WriteFunction = std::function<void(uint64_t serialNum)>;
+
+    class Chain {
+    public:
+        Chain();
+        ~Chain();
+        uint64_t getFirstSerialNum() const { return _firstSerialNum; }
+        uint64_t getLastSerialNum() const { return _lastSerialNum; }
+        /// Changes whenever the chain or the document below it changes.
+        uint64_t getGeneration() const { return _generation; }
+        size_t getNumDeltas() const { return _numDeltas; }
+        const RepoSP & getRepo() const { return _repo; }
+        /// Serialized document with all deltas applied, empty if not materialized yet.
+        const std::vector<char> & getMaterialized() const { return _materialized; }
+        /**
+         * Applies the deltas in order to the base document. Returns the base
+         * unchanged if there is none.
+         */
+        DocumentUP apply(DocumentUP base, const document::DocumentTypeRepo & repo) const;
+        size_t memoryUsed() const { return _deltas.capacity() + _materialized.capacity(); }
+    private:
+        friend class UpdateDeltas;
+        uint64_t          _firstSerialNum;
+        uint64_t          _lastSerialNum;
+        uint64_t          _generation;
+        uint32_t          _numDeltas;
+        std::vector<char> _deltas;
+        std::vector<char> _materialized;
+        RepoSP            _repo;
+    };
+
+    UpdateDeltas();
+    ~UpdateDeltas();
+
+    /// Cheap check that can be done without taking the lock.
+    bool empty() const { return _numChains.load(std::memory_order_acquire) == 0; }
+    size_t size() const { return _numChains.load(std::memory_order_relaxed); }
+
+    /**
+     * Appends the update to the chain of the lid. The updated document, if not empty,
+     * becomes the materialized document of the chain, so readers need not apply the
+     * chain again.
+     */
+    void add(uint64_t serialNum, uint32_t lid, const document::DocumentUpdate & update, RepoSP repo,
+             const vespalib::nbostream & updatedDoc);
+    /// Copies the chain of the lid, if any.
+    bool get(uint32_t lid, Chain & chain) const;
+    /**
+     * Caches the materialized document of the chain, unless the chain or the
+     * document below it has changed since the chain was read.
+     * @return false if it has changed, and the document must be read again.
+     */
+    bool setMaterialized(uint32_t lid, uint64_t generation, std::vector<char> doc);
+    /**
+     * Runs write, which writes the document of the lid to the backing store, atomically
+     * with respect to setMaterialized(). The chain of the lid is then erased, or kept on
+     * top of the new document if keepChain is true. Writes must be serialized by the caller.
+     *
+     * write gets the serial number to tag the write with. That is serialNum capped below
+     * the pending chains, not counting the chain of the lid unless it is kept.
+     */
+    void rebase(uint32_t lid, uint64_t serialNum, bool keepChain, const WriteFunction & write);
+
+    /**
+     * Finds the chains that can be folded into the backing store for a flush at
+     * the given sync token, and returns the sync token the backing store can be
+     * flushed to. That is the sync token itself, or the serial number before the
+     * first remaining chain.
+     *
+     * The lids are ordered by the last serial number of their chains. The chains no
+     * longer cap other writes, so each must be folded with rebase() at its last serial
+     * number before the writes are serialized by the caller again.
+     */
+    uint64_t startFold(uint64_t syncToken, std::vector<uint32_t> & lids);
+    /// Highest serial number added so far.
+    uint64_t getLastSerialNum() const { return _lastSerialNum.load(std::memory_order_relaxed); }
+    size_t memoryUsed() const;
+private:
+    uint64_t capSerialNum(const std::unique_lock<std::mutex> &guard, uint64_t serialNum) const;
+
+    mutable std::mutex                  _lock;
+    vespalib::hash_map<uint32_t, Chain> _chains;
+    std::map<uint64_t, uint32_t>        _firstSerialNums;
+    std::atomic<size_t>                 _numChains;
+    std::atomic<uint64_t>               _lastSerialNum;
+    uint64_t                            _generation;
+    size_t                              _bytes;
+};
+
+}
@@ -107,6 +107,11 @@ public:
 
     CacheStats getCacheStats() const;
     void reconfigure(size_t cacheSize, const CompressionConfig &compression);
+    /**
+     * Enables frequency based admission of new sets when the cache is full.
+     * 0 disables it. See vespalib::cache::setAdmission.
+     */
+    void setAdmission(size_t expectedElements);
 private:
     /**
      * This implments the interface the cache uses when it has a cache miss.
@@ -3,6 +3,7 @@
 #include "writeablefilechunk.h"
 #include "data_store_file_chunk_stats.h"
 #include "summaryexceptions.h"
+#include "data_store_write_stats.h"
 #include <vespa/vespalib/util/closuretask.h>
 #include <vespa/vespalib/util/array.hpp>
 #include <vespa/vespalib/data/fileheader.h>
@@ -10,6 +11,7 @@
 #include <vespa/searchlib/common/fileheadercontext.h>
 #include <vespa/vespalib/stllike/hash_map.hpp>
 #include <vespa/vespalib/objects/nbostream.h>
+#include <vespa/vespalib/util/zstdcompressor.h>
 
 #include <vespa/log/log.h>
 LOG_SETUP(".search.writeablefilechunk");
@@ -86,7 +88,9 @@ WriteableFileChunk(vespalib::ThreadExecutor &executor,
                    const TuneFileSummary &tune,
                    const FileHeaderContext &fileHeaderContext,
                    const IBucketizer * bucketizer,
-                   bool skipCrcOnRead)
+                   bool skipCrcOnRead,
+                   const DictionarySP & dictionary,
+                   docstore::WriteStatsCollector * writeStats)
     : FileChunk(fileId, nameId, baseName, tune, bucketizer, skipCrcOnRead),
       _config(config),
       _serialNum(initialSerialNum),
@@ -102,14 +106,16 @@ WriteableFileChunk(vespalib::ThreadExecutor &executor,
       _idxFileSize(0),
       _currentDiskFootprint(0),
       _nextChunkId(1),
-      _active(new Chunk(0, Chunk::Config(config.getMaxChunkBytes()))),
+      _active(),
       _alignment(1),
       _granularity(1),
       _maxChunkSize(0x100000),
       _firstChunkIdToBeWritten(0),
       _writeTaskIsRunning(false),
       _executor(executor),
-      _bucketMap(bucketizer)
+      _bucketMap(bucketizer),
+      _requestedSyncSerialNum(0),
+      _writeStats(writeStats)
 {
     _docIdLimit = docIdLimit;
     if (tune._write.getWantDirectIO()) {
@@ -121,6 +127,7 @@ WriteableFileChunk(vespalib::ThreadExecutor &executor,
     if (_dataFile.OpenReadWrite()) {
         readDataHeader();
         if (_dataHeaderLen == 0) {
+            writeDictionary(dictionary);
             writeDataHeader(fileHeaderContext);
         }
         _dataFile.SetPosition(_dataFile.GetSize());
@@ -140,10 +147,30 @@ WriteableFileChunk(vespalib::ThreadExecutor &executor,
     } else {
         throw SummaryException("Failed opening data file", _dataFile, VESPA_STRLOC);
     }
+    _active.reset(new Chunk(0, Chunk::Config(config.getMaxChunkBytes(), _dictionary.get())));
     _firstChunkIdToBeWritten = _active->getId();
     updateCurrentDiskFootprint();
 }
 
+void
+WriteableFileChunk::writeDictionary(const DictionarySP & dictionary)
+{
+    // The dictionary must be durable before any chunk depending on it is written.
+    if (dictionary) {
+        FastOS_File file(_dictFileName.c_str());
+        if ( ! file.OpenWriteOnlyTruncate()) {
+            throw SummaryException("Failed opening dictionary file", file, VESPA_STRLOC);
+        }
+        vespalib::ConstBufferRef data(dictionary->getData());
+        if ( ! file.CheckedWrite(data.c_str(), data.size()) || ! file.Sync() || ! file.Close()) {
+            throw SummaryException("Failed writing dictionary file", file, VESPA_STRLOC);
+        }
+    } else {
+        eraseDictFile(getName());
+    }
+    _dictionary = dictionary;
+}
+
 std::unique_ptr<FastOS_FileInterface>
 WriteableFileChunk::openIdx() {
     auto file = std::make_unique<FastOS_File>(_idxFileName.c_str());
@@ -177,7 +204,7 @@ WriteableFileChunk::updateLidMap(const LockGuard &guard, ISetLid &ds, uint64_t s
 {
     size_t sz = FileChunk::updateLidMap(guard, ds, serialNum, docIdLimit);
     _nextChunkId = _chunkInfo.size();
-    _active.reset( new Chunk(_nextChunkId++, Chunk::Config(_config.getMaxChunkBytes())));
+    _active.reset( new Chunk(_nextChunkId++, Chunk::Config(_config.getMaxChunkBytes(), _dictionary.get())));
     _serialNum = getLastPersistedSerialNum();
     _firstChunkIdToBeWritten = _active->getId();
     setDiskFootprint(0);
@@ -278,7 +305,13 @@ WriteableFileChunk::internalFlush(uint32_t chunkId, uint64_t serialNum)
     if (_alignment > 1) {
         tmp->getBuf().ensureFree(active->getMaxPackSize(_config.getCompression()) + _alignment - 1);
     }
+    fastos::StopWatch stopWatch;
+    stopWatch.start();
     active->pack(serialNum, tmp->getBuf(), _config.getCompression());
+    stopWatch.stop();
+    if (_writeStats != nullptr) {
+        _writeStats->addCompress(stopWatch.elapsed().sec());
+    }
     tmp->setPayLoad();
     if (_alignment > 1) {
         const size_t padAfter((_alignment - tmp->getPayLoad() % _alignment) % _alignment);
@@ -460,12 +493,18 @@ WriteableFileChunk::writeData(const ProcessedChunkQ & chunks, size_t sz)
     }
 
     LockGuard guard(_writeLock);
+    fastos::StopWatch stopWatch;
+    stopWatch.start();
     ssize_t wlen = _dataFile.Write2(buf.getData(), buf.getDataLen());
     if (wlen != static_cast<ssize_t>(buf.getDataLen())) {
         throw SummaryException(make_string("Failed writing %ld bytes to dat file. Only %ld written",
                                            buf.getDataLen(), wlen),
                                _dataFile, VESPA_STRLOC);
     }
+    stopWatch.stop();
+    if (_writeStats != nullptr) {
+        _writeStats->addWrite(stopWatch.elapsed().sec());
+    }
     updateCurrentDiskFootprint();
 }
 
@@ -639,7 +678,7 @@ int32_t WriteableFileChunk::flushLastIfNonEmpty(bool force)
         chunkId = _active->getId();
         _chunkMap[chunkId] = std::move(_active);
         assert(_nextChunkId < LidInfo::getChunkIdLimit());
-        _active.reset(new Chunk(_nextChunkId++, Chunk::Config(_config.getMaxChunkBytes())));
+        _active.reset(new Chunk(_nextChunkId++, Chunk::Config(_config.getMaxChunkBytes(), _dictionary.get())));
     }
     return chunkId;
 }
@@ -847,13 +886,32 @@ WriteableFileChunk::updateCurrentDiskFootprint() {
  */
 void
 WriteableFileChunk::flushPendingChunks(uint64_t serialNum) {
+    if (_writeStats != nullptr) {
+        _writeStats->addSyncRequest();
+    }
+    {
+        // Callers have their chunks written before asking for them to be synced,
+        // so whoever gets the flush lock first can sync on behalf of all of them.
+        LockGuard guard(_lock);
+        _requestedSyncSerialNum = std::max(_requestedSyncSerialNum, serialNum);
+    }
     LockGuard flushGuard(_flushLock);
     if (frozen())
         return;
+    {
+        LockGuard guard(_lock);
+        serialNum = std::max(serialNum, _requestedSyncSerialNum);
+    }
     uint64_t datFileLen = _dataFile.getSize();
     fastos::TimeStamp timeStamp(fastos::ClockSystem::now());
     if (needFlushPendingChunks(serialNum, datFileLen)) {
+        fastos::StopWatch stopWatch;
+        stopWatch.start();
         timeStamp = unconditionallyFlushPendingChunks(flushGuard, serialNum, datFileLen);
+        stopWatch.stop();
+        if (_writeStats != nullptr) {
+            _writeStats->addSync(stopWatch.elapsed().sec());
+        }
     }
     LockGuard guard(_lock);
     _modificationTime = std::max(timeStamp, _modificationTime);
@@ -15,6 +15,7 @@ class PendingChunk;
 class ProcessedChunk;
 
 namespace common { class FileHeaderContext; }
+namespace docstore { class WriteStatsCollector; }
 
 class WriteableFileChunk : public FileChunk
 {
@@ -46,7 +47,9 @@ public:
                        const vespalib::string & baseName, uint64_t initialSerialNum,
                        uint32_t docIdLimit, const Config & config,
                        const TuneFileSummary &tune, const common::FileHeaderContext &fileHeaderContext,
-                       const IBucketizer * bucketizer, bool crcOnReadDisabled);
+                       const IBucketizer * bucketizer, bool crcOnReadDisabled,
+                       const DictionarySP & dictionary = DictionarySP(),
+                       docstore::WriteStatsCollector * writeStats = nullptr);
     ~WriteableFileChunk();
 
     ssize_t read(uint32_t lid, SubChunkId chunk, vespalib::DataBuffer & buffer) const override;
@@ -65,6 +68,11 @@ public:
     MemoryUsage getMemoryUsage() const override;
     size_t updateLidMap(const LockGuard &guard, ISetLid &lidMap, uint64_t serialNum, uint32_t docIdLimit) override;
     void waitForDiskToCatchUpToNow() const;
+    /**
+     * Sync the written chunks up to serialNum and persist their index.
+     * Concurrent callers are coalesced: the caller doing the sync covers
+     * every serial number requested before it started.
+     */
     void flushPendingChunks(uint64_t serialNum);
     DataStoreFileChunkStats getStats() const override;
 
@@ -76,6 +84,7 @@ private:
     typedef std::vector<ProcessedChunkUP> ProcessedChunkQ;
 
     bool frozen() const override { return _frozen; }
+    void writeDictionary(const DictionarySP & dictionary);
     void waitForChunkFlushedToDisk(uint32_t chunkId) const;
     void waitForAllChunksFlushedToDisk() const;
     void fileWriter(const uint32_t firstChunkId);
@@ -131,6 +140,8 @@ private:
     vespalib::ThreadExecutor & _executor;
     ProcessedChunkMap _orderedChunks;
     BucketDensityComputer _bucketMap;
+    uint64_t          _requestedSyncSerialNum;
+    docstore::WriteStatsCollector * _writeStats;
 };
 
 } // namespace search
@@ -96,6 +96,13 @@ PostingListFileRandRead::~PostingListFileRandRead()
 }
 
 
+void
+PostingListFileRandRead::prefetchPostingList(const PostingListHandle &handle) const
+{
+    (void) handle;
+}
+
+
 void
 PostingListFileRandRead::afterOpen(FastOS_FileInterface &file)
 {
@@ -142,6 +149,14 @@ readPostingList(const PostingListCounts &counts,
 }
 
 
+void
+PostingListFileRandReadPassThrough::
+prefetchPostingList(const PostingListHandle &handle) const
+{
+    _lower->prefetchPostingList(handle);
+}
+
+
 bool
 PostingListFileRandReadPassThrough::open(const vespalib::string &name,
         const TuneFileRandRead &tuneFileRead)
@@ -195,6 +195,15 @@ public:
                     uint32_t numSegments,
                     PostingListHandle &handle) = 0;
 
+    /**
+     * Hint that the posting list described by handle will be read soon.
+     * Starts asynchronous readahead of the underlying file range, such
+     * that reading the posting lists for all terms in a query costs
+     * roughly one I/O latency instead of the sum of them.
+     * The default implementation does nothing.
+     */
+    virtual void prefetchPostingList(const PostingListHandle &handle) const;
+
     /**
      * Open posting list file for random read.
      */
@@ -233,6 +242,7 @@ public:
 
     void readPostingList(const PostingListCounts &counts, uint32_t firstSegment,
                          uint32_t numSegments, PostingListHandle &handle) override;
+    void prefetchPostingList(const PostingListHandle &handle) const override;
 
     bool open(const vespalib::string &name, const TuneFileRandRead &tuneFileRead) override;
     bool close() override;
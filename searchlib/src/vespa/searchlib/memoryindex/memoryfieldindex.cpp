@@ -14,6 +14,7 @@
 #include <vespa/searchlib/btree/btreeroot.hpp>
 #include <vespa/searchlib/btree/btree.hpp>
 #include "ordereddocumentinserter.h"
+#include <vespa/vespalib/stllike/hash_map.hpp>
 #include <vespa/vespalib/util/array.hpp>
 
 namespace search {
@@ -35,7 +36,10 @@ MemoryFieldIndex::MemoryFieldIndex(const Schema & schema, uint32_t fieldId)
     : _wordStore(),
       _numUniqueWords(0),
       _generationHandler(),
+      _genHolder(),
       _dict(),
+      _wordHash(),
+      _postingListRefs(1024, 50, 0, _genHolder),
       _postingListStore(),
       _featureStore(schema),
       _fieldId(fieldId),
@@ -50,26 +54,35 @@ MemoryFieldIndex::~MemoryFieldIndex()
     _dict.disableFreeLists();
     _dict.disableElemHoldList();
     // XXX: Kludge
-    for (DictionaryTree::Iterator it = _dict.begin();
-         it.valid(); ++it) {
-        datastore::EntryRef pidx(it.getData());
+    for (WordIndex wordIndex = 0; wordIndex < _postingListRefs.size(); ++wordIndex) {
+        datastore::EntryRef pidx(getPostingListRef(wordIndex));
         if (pidx.valid()) {
             _postingListStore.clear(pidx);
-            // Before updating ref
-            std::atomic_thread_fence(std::memory_order_release);
-            it.writeData(datastore::EntryRef().ref());
+            setPostingListRef(wordIndex, datastore::EntryRef());
         }
     }
     _postingListStore.clearBuilder();
     freeze();   // Flush all pending posting list tree freezes
     transferHoldLists();
     _dict.clear();  // Clear dictionary
+    _wordHash.clear();
     freeze();   // Flush pending freeze for dictionary tree.
     transferHoldLists();
     incGeneration();
     trimHoldLists();
 }
 
+MemoryFieldIndex::WordEntry
+MemoryFieldIndex::addWord(const vespalib::stringref word)
+{
+    _numUniqueWords++;
+    datastore::EntryRef wordRef = _wordStore.addWord(word);
+    WordEntry entry(wordRef, _postingListRefs.size());
+    _postingListRefs.push_back(datastore::EntryRef().ref());
+    _wordHash.insert(std::make_pair(vespalib::stringref(_wordStore.getWord(wordRef), word.size()), entry));
+    return entry;
+}
+
 MemoryFieldIndex::PostingList::Iterator
 MemoryFieldIndex::find(const vespalib::stringref word) const
 {
@@ -77,7 +90,7 @@ MemoryFieldIndex::find(const vespalib::stringref word) const
         _dict.find(WordKey(datastore::EntryRef()),
                   KeyComp(_wordStore, word));
     if (itr.valid()) {
-        return _postingListStore.begin(itr.getData());
+        return _postingListStore.begin(getPostingListRef(itr.getData()));
     }
     return PostingList::Iterator();
 }
@@ -89,7 +102,7 @@ MemoryFieldIndex::findFrozen(const vespalib::stringref word) const
         _dict.getFrozenView().find(WordKey(datastore::EntryRef()),
                                    KeyComp(_wordStore, word));
     if (itr.valid()) {
-        return _postingListStore.beginFrozen(itr.getData());
+        return _postingListStore.beginFrozen(getPostingListRef(itr.getData()));
     }
     return PostingList::Iterator();
 }
@@ -101,10 +114,9 @@ MemoryFieldIndex::compactFeatures()
     std::vector<uint32_t> toHold;
 
     toHold = _featureStore.startCompact();
-    DictionaryTree::Iterator itr(_dict.begin());
     uint32_t packedIndex = _fieldId;
-    for (; itr.valid(); ++itr) {
-        PostingListStore::RefType pidx(itr.getData());
+    for (WordIndex wordIndex = 0; wordIndex < _postingListRefs.size(); ++wordIndex) {
+        PostingListStore::RefType pidx(getPostingListRef(wordIndex));
         if (!pidx.valid())
             continue;
         uint32_t clusterSize = _postingListStore.getClusterSize(pidx);
@@ -166,7 +178,7 @@ MemoryFieldIndex::dump(search::index::IndexBuilder & indexBuilder)
     _featureStore.setupForField(_fieldId, decoder);
     for (DictionaryTree::Iterator itr = _dict.begin(); itr.valid(); ++itr) {
         const WordKey & wk = itr.getKey();
-        PostingListStore::RefType plist(itr.getData());
+        PostingListStore::RefType plist(getPostingListRef(itr.getData()));
         word = _wordStore.getWord(wk._wordRef);
         if (!plist.valid())
             continue;
@@ -236,6 +248,8 @@ MemoryFieldIndex::getMemoryUsage() const
     MemoryUsage usage;
     usage.merge(_wordStore.getMemoryUsage());
     usage.merge(_dict.getMemoryUsage());
+    usage.merge(MemoryUsage(_wordHash.getMemoryConsumption(), _wordHash.getMemoryUsed(), 0, 0));
+    usage.merge(_postingListRefs.getMemoryUsage());
     usage.merge(_postingListStore.getMemoryUsage());
     usage.merge(_featureStore.getMemoryUsage());
     usage.merge(_remover.getStore().getMemoryUsage());
@@ -269,7 +283,7 @@ class BTreeNodeTT<memoryindex::MemoryFieldIndex::WordKey,
 
 template
 class BTreeNodeTT<memoryindex::MemoryFieldIndex::WordKey,
-                  memoryindex::MemoryFieldIndex::PostingListPtr,
+                  memoryindex::MemoryFieldIndex::WordIndex,
                   search::btree::NoAggregated,
                   BTreeDefaultTraits::LEAF_SLOTS>;
 
@@ -280,48 +294,48 @@ class BTreeInternalNode<memoryindex::MemoryFieldIndex::WordKey,
 
 template
 class BTreeLeafNode<memoryindex::MemoryFieldIndex::WordKey,
-                    memoryindex::MemoryFieldIndex::PostingListPtr,
+                    memoryindex::MemoryFieldIndex::WordIndex,
                     search::btree::NoAggregated,
                     BTreeDefaultTraits::LEAF_SLOTS>;
 
 template
 class BTreeNodeStore<memoryindex::MemoryFieldIndex::WordKey,
-                     memoryindex::MemoryFieldIndex::PostingListPtr,
+                     memoryindex::MemoryFieldIndex::WordIndex,
                      search::btree::NoAggregated,
                      BTreeDefaultTraits::INTERNAL_SLOTS,
                      BTreeDefaultTraits::LEAF_SLOTS>;
 
 template
 class BTreeIterator<memoryindex::MemoryFieldIndex::WordKey,
-                    memoryindex::MemoryFieldIndex::PostingListPtr,
+                    memoryindex::MemoryFieldIndex::WordIndex,
                     search::btree::NoAggregated,
                     const memoryindex::MemoryFieldIndex::KeyComp,
                     BTreeDefaultTraits>;
 
 template
 class BTree<memoryindex::MemoryFieldIndex::WordKey,
-                   memoryindex::MemoryFieldIndex::PostingListPtr,
+                   memoryindex::MemoryFieldIndex::WordIndex,
             search::btree::NoAggregated,
                    const memoryindex::MemoryFieldIndex::KeyComp,
                    BTreeDefaultTraits>;
 
 template
 class BTreeRoot<memoryindex::MemoryFieldIndex::WordKey,
-                memoryindex::MemoryFieldIndex::PostingListPtr,
+                memoryindex::MemoryFieldIndex::WordIndex,
                 search::btree::NoAggregated,
                 const memoryindex::MemoryFieldIndex::KeyComp,
                 BTreeDefaultTraits>;
 
 template
 class BTreeRootBase<memoryindex::MemoryFieldIndex::WordKey,
-                    memoryindex::MemoryFieldIndex::PostingListPtr,
+                    memoryindex::MemoryFieldIndex::WordIndex,
                     search::btree::NoAggregated,
                     BTreeDefaultTraits::INTERNAL_SLOTS,
                     BTreeDefaultTraits::LEAF_SLOTS>;
 
 template
 class BTreeNodeAllocator<memoryindex::MemoryFieldIndex::WordKey,
-                         memoryindex::MemoryFieldIndex::PostingListPtr,
+                         memoryindex::MemoryFieldIndex::WordIndex,
                          search::btree::NoAggregated,
                          BTreeDefaultTraits::INTERNAL_SLOTS,
                          BTreeDefaultTraits::LEAF_SLOTS>;
@@ -9,16 +9,24 @@
 #include <vespa/searchlib/btree/btree.h>
 #include <vespa/searchlib/btree/btreenodeallocator.h>
 #include <vespa/searchlib/btree/btreestore.h>
+#include <vespa/searchlib/common/rcuvector.h>
 #include <vespa/searchlib/index/docidandfeatures.h>
 #include <vespa/searchlib/index/indexbuilder.h>
 #include <vespa/searchlib/util/memoryusage.h>
+#include <vespa/vespalib/stllike/hash_map.h>
 #include <vespa/vespalib/stllike/string.h>
+#include <vespa/vespalib/util/generationholder.h>
 
 namespace search::memoryindex {
 
 class OrderedDocumentInserter;
 /*
  * Memory index for a single field.
+ *
+ * The dictionary tree maps each word to a dense word index, and the
+ * posting list of a word is found through that index. Insertion finds
+ * existing words through a hash index, so the ordered tree is only
+ * searched and updated when a new word is added.
  */
 class MemoryFieldIndex {
 public:
@@ -69,17 +77,35 @@ public:
         }
     };
 
-    typedef uint32_t PostingListPtr;
-    typedef btree::BTree<WordKey, PostingListPtr,
+    typedef uint32_t WordIndex;
+    typedef btree::BTree<WordKey, WordIndex,
                          search::btree::NoAggregated,
                          const KeyComp> DictionaryTree;
+
+    struct WordEntry {
+        datastore::EntryRef _wordRef;
+        WordIndex           _wordIndex;
+
+        WordEntry(datastore::EntryRef wordRef, WordIndex wordIndex)
+            : _wordRef(wordRef),
+              _wordIndex(wordIndex)
+        { }
+        WordEntry() : WordEntry(datastore::EntryRef(), 0u) { }
+    };
 private:
     typedef vespalib::GenerationHandler GenerationHandler;
 
+    // Words are owned by the word store, which never moves them.
+    typedef vespalib::hash_map<vespalib::stringref, WordEntry> WordHash;
+
     WordStore               _wordStore;
     uint64_t                _numUniqueWords;
     GenerationHandler       _generationHandler;
+    vespalib::GenerationHolder _genHolder;
     DictionaryTree          _dict;
+    WordHash                _wordHash;
+    // word index -> posting list ref
+    attribute::RcuVectorBase<uint32_t> _postingListRefs;
     PostingListStore        _postingListStore;
     FeatureStore            _featureStore;
     uint32_t                _fieldId;
@@ -87,9 +113,28 @@ private:
     std::unique_ptr<OrderedDocumentInserter> _inserter;
 
 public:
-    datastore::EntryRef addWord(const vespalib::stringref word) {
-        _numUniqueWords++;
-        return _wordStore.addWord(word);
+    /**
+     * Add a new word, returning its word ref and word index. The caller
+     * inserts it in the dictionary tree.
+     */
+    WordEntry addWord(const vespalib::stringref word);
+
+    /**
+     * Look up a word in the hash index, only used by the writer thread.
+     */
+    const WordEntry *findWord(const vespalib::stringref word) const {
+        auto itr = _wordHash.find(word);
+        return (itr != _wordHash.end()) ? &itr->second : nullptr;
+    }
+
+    datastore::EntryRef getPostingListRef(WordIndex wordIndex) const {
+        return datastore::EntryRef(_postingListRefs[wordIndex]);
+    }
+
+    void setPostingListRef(WordIndex wordIndex, datastore::EntryRef ref) {
+        // Before updating ref
+        std::atomic_thread_fence(std::memory_order_release);
+        _postingListRefs[wordIndex] = ref.ref();
     }
 
     datastore::EntryRef
@@ -123,6 +168,7 @@ private:
             _generationHandler.getFirstUsedGeneration();
         _postingListStore.trimHoldLists(usedGen);
         _dict.getAllocator().trimHoldLists(usedGen);
+        _genHolder.trimHoldLists(usedGen);
         _featureStore.trimHoldLists(usedGen);
     }
 
@@ -133,6 +179,7 @@ private:
             _generationHandler.getCurrentGeneration();
         _postingListStore.transferHoldLists(generation);
         _dict.getAllocator().transferHoldLists(generation);
+        _genHolder.transferHoldLists(generation);
         _featureStore.transferHoldLists(generation);
     }
 
@@ -208,7 +255,7 @@ class BTreeNodeTT<memoryindex::MemoryFieldIndex::WordKey,
 
 extern template
 class BTreeNodeTT<memoryindex::MemoryFieldIndex::WordKey,
-                  memoryindex::MemoryFieldIndex::PostingListPtr,
+                  memoryindex::MemoryFieldIndex::WordIndex,
                   search::btree::NoAggregated,
                   BTreeDefaultTraits::LEAF_SLOTS>;
 
@@ -219,48 +266,48 @@ class BTreeInternalNode<memoryindex::MemoryFieldIndex::WordKey,
 
 extern template
 class BTreeLeafNode<memoryindex::MemoryFieldIndex::WordKey,
-                    memoryindex::MemoryFieldIndex::PostingListPtr,
+                    memoryindex::MemoryFieldIndex::WordIndex,
                     search::btree::NoAggregated,
                     BTreeDefaultTraits::LEAF_SLOTS>;
 
 extern template
 class BTreeNodeStore<memoryindex::MemoryFieldIndex::WordKey,
-                     memoryindex::MemoryFieldIndex::PostingListPtr,
+                     memoryindex::MemoryFieldIndex::WordIndex,
                      search::btree::NoAggregated,
                      BTreeDefaultTraits::INTERNAL_SLOTS,
                      BTreeDefaultTraits::LEAF_SLOTS>;
 
 extern template
 class BTreeIterator<memoryindex::MemoryFieldIndex::WordKey,
-                    memoryindex::MemoryFieldIndex::PostingListPtr,
+                    memoryindex::MemoryFieldIndex::WordIndex,
                     search::btree::NoAggregated,
                     const memoryindex::MemoryFieldIndex::KeyComp,
                     BTreeDefaultTraits>;
 
 extern template
 class BTree<memoryindex::MemoryFieldIndex::WordKey,
-            memoryindex::MemoryFieldIndex::PostingListPtr,
+            memoryindex::MemoryFieldIndex::WordIndex,
             search::btree::NoAggregated,
             const memoryindex::MemoryFieldIndex::KeyComp,
             BTreeDefaultTraits>;
 
 extern template
 class BTreeRoot<memoryindex::MemoryFieldIndex::WordKey,
-               memoryindex::MemoryFieldIndex::PostingListPtr,
+               memoryindex::MemoryFieldIndex::WordIndex,
                 search::btree::NoAggregated,
                const memoryindex::MemoryFieldIndex::KeyComp,
                BTreeDefaultTraits>;
 
 extern template
 class BTreeRootBase<memoryindex::MemoryFieldIndex::WordKey,
-                    memoryindex::MemoryFieldIndex::PostingListPtr,
+                    memoryindex::MemoryFieldIndex::WordIndex,
                     search::btree::NoAggregated,
                     BTreeDefaultTraits::INTERNAL_SLOTS,
                     BTreeDefaultTraits::LEAF_SLOTS>;
 
 extern template
 class BTreeNodeAllocator<memoryindex::MemoryFieldIndex::WordKey,
-                       memoryindex::MemoryFieldIndex::PostingListPtr,
+                       memoryindex::MemoryFieldIndex::WordIndex,
                          search::btree::NoAggregated,
                        BTreeDefaultTraits::INTERNAL_SLOTS,
                        BTreeDefaultTraits::LEAF_SLOTS>;
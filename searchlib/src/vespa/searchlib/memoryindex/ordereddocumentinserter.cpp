@@ -30,6 +30,8 @@ OrderedDocumentInserter::OrderedDocumentInserter(MemoryFieldIndex &fieldIndex)
       _prevAdd(false),
       _fieldIndex(fieldIndex),
       _dItr(_fieldIndex.getDictionaryTree().begin()),
+      _wordRef(),
+      _wordIndex(0u),
       _listener(_fieldIndex.getDocumentRemover()),
       _removes(),
       _adds()
@@ -50,16 +52,15 @@ OrderedDocumentInserter::flushWord()
     }
     //XXX: Feature store leak, removed features not marked dead
     PostingListStore &postingListStore(_fieldIndex.getPostingListStore());
-    datastore::EntryRef pidx(_dItr.getData());
+    datastore::EntryRef oldPidx(_fieldIndex.getPostingListRef(_wordIndex));
+    datastore::EntryRef pidx(oldPidx);
     postingListStore.apply(pidx,
                            &_adds[0],
                            &_adds[0] + _adds.size(),
                            &_removes[0],
                            &_removes[0] + _removes.size());
-    if (pidx.ref() != _dItr.getData()) {
-        // Before updating ref
-        std::atomic_thread_fence(std::memory_order_release);
-        _dItr.writeData(pidx.ref());
+    if (pidx != oldPidx) {
+        _fieldIndex.setPostingListRef(_wordIndex, pidx);
     }
     _removes.clear();
     _adds.clear();
@@ -83,20 +84,27 @@ OrderedDocumentInserter::setNextWord(const vespalib::stringref word)
     _prevDocId = noDocId;
     _prevAdd = false;
     flushWord();
+    const MemoryFieldIndex::WordEntry *entry = _fieldIndex.findWord(_word);
+    if (entry != nullptr) {
+        _wordRef = entry->_wordRef;
+        _wordIndex = entry->_wordIndex;
+        return;
+    }
     const WordStore &wordStore(_fieldIndex.getWordStore());
     KeyComp cmp(wordStore, _word);
     WordKey key;
     if (_dItr.valid() && cmp(_dItr.getKey(), key)) {
         _dItr.binarySeek(key, cmp);
     }
-    if (!_dItr.valid() || cmp(key, _dItr.getKey())) {
-        datastore::EntryRef wordRef = _fieldIndex.addWord(_word);
-        WordKey insertKey(wordRef);
-        DictionaryTree &dTree(_fieldIndex.getDictionaryTree());
-        dTree.insert(_dItr, insertKey, datastore::EntryRef().ref());
-    }
+    assert(!_dItr.valid() || cmp(key, _dItr.getKey()));
+    MemoryFieldIndex::WordEntry newEntry = _fieldIndex.addWord(_word);
+    WordKey insertKey(newEntry._wordRef);
+    DictionaryTree &dTree(_fieldIndex.getDictionaryTree());
+    dTree.insert(_dItr, insertKey, newEntry._wordIndex);
     assert(_dItr.valid());
     assert(_word == wordStore.getWord(_dItr.getKey()._wordRef));
+    _wordRef = newEntry._wordRef;
+    _wordIndex = newEntry._wordIndex;
 }
 
 
@@ -109,7 +117,7 @@ OrderedDocumentInserter::add(uint32_t docId,
            (_prevDocId == docId && !_prevAdd));
     datastore::EntryRef featureRef = _fieldIndex.addFeatures(features);
     _adds.push_back(PostingListKeyDataType(docId, featureRef.ref()));
-    _listener.insert(_dItr.getKey()._wordRef, docId);
+    _listener.insert(_wordRef, docId);
     _prevDocId = docId;
     _prevAdd = true;
 }
@@ -134,13 +142,15 @@ OrderedDocumentInserter::rewind()
     _prevDocId = noDocId;
     _prevAdd = false;
     _dItr.begin();
+    _wordRef = datastore::EntryRef();
+    _wordIndex = 0u;
 }
 
 
 datastore::EntryRef
 OrderedDocumentInserter::getWordRef() const
 {
-    return _dItr.getKey()._wordRef;
+    return _wordRef;
 }
 
 }
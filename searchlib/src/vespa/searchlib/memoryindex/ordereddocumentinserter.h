@@ -20,6 +20,9 @@ class IDocumentInsertListener;
  * (single pass scan of dictionary tree)
  *
  * Insert order must be properly sorted, by (word, docId)
+ *
+ * Existing words are found through the hash index of the field index, the
+ * dictionary tree iterator is only advanced to insert new words.
  */
 class OrderedDocumentInserter : public IOrderedDocumentInserter
 {
@@ -31,8 +34,11 @@ class OrderedDocumentInserter : public IOrderedDocumentInserter
     using KeyComp = MemoryFieldIndex::KeyComp;
     using WordKey = MemoryFieldIndex::WordKey;
     using PostingListKeyDataType = MemoryFieldIndex::PostingListKeyDataType;
+    using WordIndex = MemoryFieldIndex::WordIndex;
     MemoryFieldIndex        &_fieldIndex;
     DictionaryTree::Iterator _dItr;
+    datastore::EntryRef      _wordRef;
+    WordIndex                _wordIndex;
     IDocumentInsertListener &_listener;
 
     // Pending changes to posting list for (_word)
@@ -45,8 +51,6 @@ class OrderedDocumentInserter : public IOrderedDocumentInserter
 
     /*
      * Flush pending changes to postinglist for (_word).
-     *
-     * _dItr is located at correct position.
      */
     void flushWord();
 
@@ -61,8 +65,6 @@ public:
     /*
      * Flush pending changes to postinglist for (_word).  Also flush
      * insert listener.
-     *
-     * _dItr is located at correct position.
      */
     virtual void flush() override;
 
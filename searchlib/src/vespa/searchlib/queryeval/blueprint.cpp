@@ -95,6 +95,11 @@ Blueprint::optimize_self()
 {
 }
 
+void
+Blueprint::prefetchPostings()
+{
+}
+
 Blueprint::UP
 Blueprint::get_replacement()
 {
@@ -387,12 +392,22 @@ IntermediateBlueprint::visitMembers(vespalib::ObjectVisitor &visitor) const
 void
 IntermediateBlueprint::fetchPostings(bool strict)
 {
+    // Get the reads for all children in flight before blocking on any of them
+    prefetchPostings();
     for (size_t i = 0; i < _children.size(); ++i) {
         bool strictChild = (strict && inheritStrict(i));
         _children[i]->fetchPostings(strictChild);
     }
 }
 
+void
+IntermediateBlueprint::prefetchPostings()
+{
+    for (size_t i = 0; i < _children.size(); ++i) {
+        _children[i]->prefetchPostings();
+    }
+}
+
 void
 IntermediateBlueprint::freeze()
 {
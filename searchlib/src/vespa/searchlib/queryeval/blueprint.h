@@ -166,6 +166,14 @@ public:
     double hit_ratio() const { return getState().hit_ratio(_docid_limit); }        
 
     virtual void fetchPostings(bool strict) = 0;
+    /**
+     * Hint that the postings of this blueprint will be fetched soon, so disk
+     * backed blueprints can start reading them asynchronously. Intermediate
+     * blueprints call this for all their children before fetching postings
+     * for any of them, which is after the blueprint tree has been optimized.
+     * The default implementation does nothing.
+     **/
+    virtual void prefetchPostings();
     virtual void freeze() = 0;
     bool frozen() const { return _frozen; }
 
@@ -265,6 +273,7 @@ public:
 
     void visitMembers(vespalib::ObjectVisitor &visitor) const override;
     void fetchPostings(bool strict) override;
+    void prefetchPostings() override;
     void freeze() override final;
 
     UnpackInfo calculateUnpackInfo(const fef::MatchData & md) const;
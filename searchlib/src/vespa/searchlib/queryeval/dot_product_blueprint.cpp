@@ -67,11 +67,20 @@ void
 DotProductBlueprint::fetchPostings(bool strict)
 {
     (void) strict;
+    prefetchPostings();
     for (size_t i = 0; i < _terms.size(); ++i) {
         _terms[i]->fetchPostings(true);
     }    
 }
 
+void
+DotProductBlueprint::prefetchPostings()
+{
+    for (size_t i = 0; i < _terms.size(); ++i) {
+        _terms[i]->prefetchPostings();
+    }
+}
+
 void
 DotProductBlueprint::visitMembers(vespalib::ObjectVisitor &visitor) const
 {
@@ -35,6 +35,7 @@ public:
 
     void visitMembers(vespalib::ObjectVisitor &visitor) const override;
     void fetchPostings(bool strict) override;
+    void prefetchPostings() override;
 };
 
 }
@@ -49,11 +49,20 @@ EquivBlueprint::visitMembers(vespalib::ObjectVisitor &visitor) const
 void
 EquivBlueprint::fetchPostings(bool strict)
 {
+    prefetchPostings();
     for (size_t i = 0; i < _terms.size(); ++i) {
         _terms[i]->fetchPostings(strict);
     }
 }
 
+void
+EquivBlueprint::prefetchPostings()
+{
+    for (size_t i = 0; i < _terms.size(); ++i) {
+        _terms[i]->prefetchPostings();
+    }
+}
+
 EquivBlueprint&
 EquivBlueprint::addTerm(Blueprint::UP term, double exactness)
 {
@@ -28,6 +28,7 @@ public:
 
     void visitMembers(vespalib::ObjectVisitor &visitor) const override;
     void fetchPostings(bool strict) override;
+    void prefetchPostings() override;
     bool isEquiv() const override { return true; }
 };
 
@@ -50,11 +50,20 @@ SameElementBlueprint::optimize_self()
 void
 SameElementBlueprint::fetchPostings(bool strict)
 {
+    prefetchPostings();
     for (size_t i = 0; i < _terms.size(); ++i) {
         _terms[i]->fetchPostings(strict && (i == 0));
     }
 }
 
+void
+SameElementBlueprint::prefetchPostings()
+{
+    for (size_t i = 0; i < _terms.size(); ++i) {
+        _terms[i]->prefetchPostings();
+    }
+}
+
 SearchIterator::UP
 SameElementBlueprint::createLeafSearch(const search::fef::TermFieldMatchDataArray &tfmda,
                                        bool strict) const
@@ -33,6 +33,7 @@ public:
 
     void optimize_self() override;
     void fetchPostings(bool strict) override;
+    void prefetchPostings() override;
 
     SearchIteratorUP createLeafSearch(const search::fef::TermFieldMatchDataArray &tfmda,
                                       bool strict) const override;
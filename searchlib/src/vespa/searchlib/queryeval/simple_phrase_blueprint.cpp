@@ -84,11 +84,20 @@ SimplePhraseBlueprint::createLeafSearch(const search::fef::TermFieldMatchDataArr
 void
 SimplePhraseBlueprint::fetchPostings(bool strict)
 {
+    prefetchPostings();
     for (size_t i = 0; i < _terms.size(); ++i) {
         _terms[i]->fetchPostings(strict);
     }
 }
 
+void
+SimplePhraseBlueprint::prefetchPostings()
+{
+    for (size_t i = 0; i < _terms.size(); ++i) {
+        _terms[i]->prefetchPostings();
+    }
+}
+
 void
 SimplePhraseBlueprint::visitMembers(vespalib::ObjectVisitor &visitor) const
 {
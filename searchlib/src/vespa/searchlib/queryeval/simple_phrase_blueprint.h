@@ -37,6 +37,7 @@ public:
                      bool strict) const override;
     void visitMembers(vespalib::ObjectVisitor &visitor) const override;
     void fetchPostings(bool strict) override;
+    void prefetchPostings() override;
 };
 
 }
@@ -60,11 +60,20 @@ void
 WeightedSetTermBlueprint::fetchPostings(bool strict)
 {
     (void) strict;
+    prefetchPostings();
     for (size_t i = 0; i < _terms.size(); ++i) {
         _terms[i]->fetchPostings(true);
     }
 }
 
+void
+WeightedSetTermBlueprint::prefetchPostings()
+{
+    for (size_t i = 0; i < _terms.size(); ++i) {
+        _terms[i]->prefetchPostings();
+    }
+}
+
 void
 WeightedSetTermBlueprint::visitMembers(vespalib::ObjectVisitor &visitor) const
 {
@@ -38,6 +38,7 @@ public:
 
 private:
     void fetchPostings(bool strict) override;
+    void prefetchPostings() override;
 };
 
 }
@@ -0,0 +1,41 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "commitchunk.h"
+#include <stdexcept>
+
+namespace search::transactionlog {
+
+CommitResult::CommitResult()
+    : _error()
+{ }
+
+CommitResult::~CommitResult() = default;
+
+CommitChunk::CommitChunk(size_t reserveBytes)
+    : _data(reserveBytes),
+      _callBacks(),
+      _numCommits(0),
+      _firstArrival(),
+      _result(std::make_shared<CommitResult>()),
+      _failureIsFatal(false)
+{ }
+
+CommitChunk::~CommitChunk() = default;
+
+void
+CommitChunk::add(const Packet & packet, Writer::DoneCallback onDone, bool failureIsFatal)
+{
+    if (empty()) {
+        _firstArrival = clock::now();
+    }
+    if ( ! _data.merge(packet)) {
+        throw std::runtime_error("Failed adding packet to commit chunk, serial numbers out of order.");
+    }
+    if (onDone) {
+        _callBacks.emplace_back(std::move(onDone));
+    }
+    _failureIsFatal = _failureIsFatal || failureIsFatal;
+    _numCommits++;
+}
+
+}
@@ -0,0 +1,55 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include "common.h"
+#include <chrono>
+#include <memory>
+#include <vector>
+
+namespace search::transactionlog {
+
+/**
+ * The outcome of writing a batch of commits, shared by the commits in it.
+ * The outcome is set before the done callbacks of the batch are released.
+ */
+class CommitResult {
+public:
+    using SP = std::shared_ptr<CommitResult>;
+    CommitResult();
+    ~CommitResult();
+    bool ok() const { return _error.empty(); }
+    const vespalib::string & getError() const { return _error; }
+    void setError(const vespalib::string & error) { _error = error; }
+private:
+    vespalib::string _error;
+};
+
+/**
+ * A batch of commits to a domain that are written, and synced, together.
+ * The done callbacks of the commits are released when the batch is destroyed.
+ * A failed write is fatal for the batch if any of its commits has no way of
+ * learning the outcome through the result.
+ */
+class CommitChunk {
+public:
+    using clock = std::chrono::steady_clock;
+    CommitChunk(size_t reserveBytes);
+    ~CommitChunk();
+    void add(const Packet & packet, Writer::DoneCallback onDone, bool failureIsFatal);
+    bool empty() const { return _data.empty(); }
+    size_t sizeBytes() const { return _data.sizeBytes(); }
+    size_t getNumCommits() const { return _numCommits; }
+    const Packet & getPacket() const { return _data; }
+    clock::time_point getFirstArrival() const { return _firstArrival; }
+    const CommitResult::SP & getResult() const { return _result; }
+    bool failureIsFatal() const { return _failureIsFatal; }
+private:
+    Packet                            _data;
+    std::vector<Writer::DoneCallback> _callBacks;
+    size_t                            _numCommits;
+    clock::time_point                 _firstArrival;
+    CommitResult::SP                  _result;
+    bool                              _failureIsFatal;
+};
+
+}
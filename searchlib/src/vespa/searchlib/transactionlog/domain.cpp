@@ -1,8 +1,11 @@
 // Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "domain.h"
+#include <vespa/searchlib/common/gatecallback.h>
 #include <vespa/vespalib/util/stringfmt.h>
 #include <vespa/vespalib/util/closuretask.h>
+#include <vespa/vespalib/util/lambdatask.h>
+#include <vespa/vespalib/util/sync.h>
 #include <vespa/fastos/file.h>
 #include <algorithm>
 #include <thread>
@@ -15,25 +18,55 @@ using vespalib::make_string;
 using vespalib::LockGuard;
 using vespalib::makeTask;
 using vespalib::makeClosure;
+using vespalib::makeLambdaTask;
 using vespalib::Monitor;
 using vespalib::MonitorGuard;
 using search::common::FileHeaderContext;
 using std::runtime_error;
 using namespace std::chrono_literals;
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
 
 namespace search::transactionlog {
 
+CommitStats::CommitStats()
+    : numBatches(0),
+      numCommits(0),
+      batchSize(),
+      latencyMicros()
+{
+    batchSize.fill(0);
+    latencyMicros.fill(0);
+}
+
+size_t
+CommitStats::bucket(uint64_t value)
+{
+    size_t bits(0);
+    for (; value != 0; value >>= 1) {
+        bits++;
+    }
+    return std::min(bits, NUM_BUCKETS - 1);
+}
+
+void
+CommitStats::add(size_t commits, microseconds latency)
+{
+    numBatches++;
+    numCommits += commits;
+    batchSize[bucket(commits)]++;
+    latencyMicros[bucket(std::max(latency.count(), 0l))]++;
+}
+
 Domain::Domain(const string &domainName, const string & baseDir, Executor & commitExecutor,
-               Executor & sessionExecutor, uint64_t domainPartSize, DomainPart::Crc defaultCrcType,
-               const FileHeaderContext &fileHeaderContext) :
-    _defaultCrcType(defaultCrcType),
+               Executor & sessionExecutor, const DomainConfig & config, const FileHeaderContext &fileHeaderContext) :
+    _config(config),
     _commitExecutor(commitExecutor),
     _sessionExecutor(sessionExecutor),
     _sessionId(1),
     _syncMonitor(),
     _pendingSync(false),
     _name(domainName),
-    _domainPartSize(domainPartSize),
     _parts(),
     _lock(),
     _sessionLock(),
@@ -41,7 +74,17 @@ Domain::Domain(const string &domainName, const string & baseDir, Executor & comm
     _maxSessionRunTime(),
     _baseDir(baseDir),
     _fileHeaderContext(fileHeaderContext),
-    _markedDeleted(false)
+    _markedDeleted(false),
+    _batchLock(),
+    _batchCond(),
+    _currentBatch(std::make_unique<CommitChunk>(config.getBatchSizeLimit())),
+    _batchInFlight(false),
+    _singleCommitter(1, 128*1024),
+    _lastCommitted(0),
+    _failure(),
+    _lastBatchCommits(0),
+    _avgWriteTime(0),
+    _commitStats()
 {
     int retval(0);
     if ((retval = makeDirectory(_baseDir.c_str())) != 0) {
@@ -59,12 +102,13 @@ Domain::Domain(const string &domainName, const string & baseDir, Executor & comm
     }
     _sessionExecutor.sync();
     if (_parts.empty() || _parts.crbegin()->second->isClosed()) {
-        _parts[lastPart].reset(new DomainPart(_name, dir(), lastPart, _defaultCrcType, _fileHeaderContext, false));
+        _parts[lastPart].reset(new DomainPart(_name, dir(), lastPart, _config.getCrc(), _config.getCompression(), _fileHeaderContext, false));
     }
+    _lastCommitted = end();
 }
 
 void Domain::addPart(int64_t partId, bool isLastPart) {
-    DomainPart::SP dp(new DomainPart(_name, dir(), partId, _defaultCrcType, _fileHeaderContext, isLastPart));
+    DomainPart::SP dp(new DomainPart(_name, dir(), partId, _config.getCrc(), _config.getCompression(), _fileHeaderContext, isLastPart));
     if (dp->size() == 0) {
         // Only last domain part is allowed to be truncated down to
         // empty size.
@@ -102,7 +146,11 @@ private:
     bool              & _pendingSync;
 };
 
-Domain::~Domain() { }
+Domain::~Domain()
+{
+    _singleCommitter.sync();
+    _singleCommitter.shutdown();
+}
 
 DomainInfo
 Domain::getDomainInfo() const
@@ -113,6 +161,8 @@ Domain::getDomainInfo() const
         const DomainPart &part = *entry.second;
         info.parts.emplace_back(PartInfo(part.range(), part.size(), part.byteSize(), part.fileName()));
     }
+    std::lock_guard<std::mutex> batchGuard(_batchLock);
+    info.commitStats = _commitStats;
     return info;
 }
 
@@ -279,23 +329,134 @@ void waitPendingSync(vespalib::Monitor &syncMonitor, bool &pendingSync)
 
 void Domain::commit(const Packet & packet)
 {
+    vespalib::Gate gate;
+    CommitResult::SP result = queueCommit(packet, std::make_shared<GateCallback>(gate), false);
+    gate.await();
+    if ( ! result->ok()) {
+        throw runtime_error(result->getError());
+    }
+}
+
+void Domain::commit(const Packet & packet, Writer::DoneCallback onDone)
+{
+    queueCommit(packet, std::move(onDone), true);
+}
+
+CommitResult::SP Domain::queueCommit(const Packet & packet, Writer::DoneCallback onDone, bool failureIsFatal)
+{
+    if (packet.empty()) {
+        return std::make_shared<CommitResult>();
+    }
+    std::lock_guard<std::mutex> guard(_batchLock);
+    if ( ! _failure.empty()) {
+        // The serial numbers of the failed write are lost, there can be no gap in the log.
+        throw runtime_error(make_string("Domain '%s' rejects commits after a failed write: %s",
+                                        _name.c_str(), _failure.c_str()));
+    }
+    if (packet.range().from() <= _lastCommitted) {
+        throw runtime_error(make_string("Incomming serial number(%ld) must be bigger than the last one (%ld).",
+                                        packet.range().from(), _lastCommitted));
+    }
+    _currentBatch->add(packet, std::move(onDone), failureIsFatal);
+    _lastCommitted = packet.range().to();
+    CommitResult::SP result = _currentBatch->getResult();
+    if ( ! _batchInFlight) {
+        _batchInFlight = true;
+        _singleCommitter.execute(makeLambdaTask([this]() { commitBatches(); }));
+    } else if (_currentBatch->sizeBytes() >= _config.getBatchSizeLimit()) {
+        _batchCond.notify_all();
+    }
+    return result;
+}
+
+void Domain::awaitBatch(std::unique_lock<std::mutex> & guard)
+{
+    // Holding the batch open only pays off when commits arrive concurrently.
+    if (_currentBatch->empty() || (_lastBatchCommits < 2) || (_avgWriteTime >= _config.getCommitLatencyTarget())) {
+        return;
+    }
+    auto deadline = _currentBatch->getFirstArrival() + (_config.getCommitLatencyTarget() - _avgWriteTime);
+    _batchCond.wait_until(guard, deadline, [this]() {
+        return _currentBatch->sizeBytes() >= _config.getBatchSizeLimit();
+    });
+}
+
+void Domain::commitBatches()
+{
+    for (;;) {
+        std::unique_ptr<CommitChunk> batch;
+        string failure;
+        {
+            std::unique_lock<std::mutex> guard(_batchLock);
+            awaitBatch(guard);
+            if (_currentBatch->empty()) {
+                _batchInFlight = false;
+                return;
+            }
+            batch = std::move(_currentBatch);
+            _currentBatch = std::make_unique<CommitChunk>(_config.getBatchSizeLimit());
+            failure = _failure;
+        }
+        if ( ! failure.empty()) {
+            // Queued before the domain failed, must not be written after the lost serial numbers.
+            failBatch(*batch, failure);
+            continue;
+        }
+        auto start = CommitChunk::clock::now();
+        try {
+            commitBatch(*batch);
+        } catch (const std::exception & e) {
+            failure = make_string("Failed committing serial numbers [%" PRIu64 ", %" PRIu64 "] to domain '%s': %s",
+                                  batch->getPacket().range().from(), batch->getPacket().range().to(),
+                                  _name.c_str(), e.what());
+            LOG(error, "%s", failure.c_str());
+            {
+                std::lock_guard<std::mutex> guard(_batchLock);
+                _failure = failure;
+            }
+            failBatch(*batch, failure);
+            continue;
+        }
+        auto done = CommitChunk::clock::now();
+        std::lock_guard<std::mutex> guard(_batchLock);
+        _avgWriteTime = (7 * _avgWriteTime + duration_cast<microseconds>(done - start)) / 8;
+        _lastBatchCommits = batch->getNumCommits();
+        _commitStats.add(batch->getNumCommits(), duration_cast<microseconds>(done - batch->getFirstArrival()));
+    }
+}
+
+void Domain::failBatch(const CommitChunk & batch, const string & error)
+{
+    if (batch.failureIsFatal()) {
+        // Releasing the callbacks would ack the commits as persisted.
+        LOG(error, "Can not report failed commit of serial numbers [%" PRIu64 ", %" PRIu64 "] to domain '%s', aborting: %s",
+            batch.getPacket().range().from(), batch.getPacket().range().to(), _name.c_str(), error.c_str());
+        abort();
+    }
+    batch.getResult()->setError(error);
+}
+
+void Domain::commitBatch(const CommitChunk & batch)
+{
+    const Packet & packet = batch.getPacket();
+    SerialNum firstSerial = packet.range().from();
     DomainPart::SP dp(_parts.rbegin()->second);
-    vespalib::nbostream_longlivedbuf is(packet.getHandle().c_str(), packet.getHandle().size());
-    Packet::Entry entry;
-    entry.deserialize(is);
-    if (dp->byteSize() > _domainPartSize) {
+    if (dp->byteSize() > _config.getPartSizeLimit()) {
         waitPendingSync(_syncMonitor, _pendingSync);
         triggerSyncNow();
         waitPendingSync(_syncMonitor, _pendingSync);
         dp->close();
-        dp.reset(new DomainPart(_name, dir(), entry.serial(), _defaultCrcType, _fileHeaderContext, false));
+        dp.reset(new DomainPart(_name, dir(), firstSerial, _config.getCrc(), _config.getCompression(), _fileHeaderContext, false));
         {
             LockGuard guard(_lock);
-            _parts[entry.serial()] = dp;
+            _parts[firstSerial] = dp;
         }
         dp = _parts.rbegin()->second;
     }
-    dp->commit(entry.serial(), packet);
+    dp->commit(firstSerial, packet);
+    if (_config.getFSyncOnCommit()) {
+        dp->sync();
+    }
     cleanSessions();
 }
 
@@ -1,10 +1,16 @@
 // Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 #pragma once
 
+#include "commitchunk.h"
+#include "domainconfig.h"
 #include "domainpart.h"
 #include "session.h"
 #include <vespa/vespalib/util/threadexecutor.h>
+#include <vespa/vespalib/util/threadstackexecutor.h>
+#include <array>
 #include <chrono>
+#include <condition_variable>
+#include <mutex>
 
 namespace search::transactionlog {
 
@@ -20,6 +26,24 @@ struct PartInfo {
           file(file_in) {}
 };
 
+/**
+ * Statistics about the batches of commits written to a domain. The histograms
+ * have power of two buckets, bucket i counting values in [2^(i-1), 2^i).
+ */
+struct CommitStats {
+    static constexpr size_t NUM_BUCKETS = 40;
+    using Histogram = std::array<uint64_t, NUM_BUCKETS>;
+    uint64_t  numBatches;
+    uint64_t  numCommits;
+    Histogram batchSize;      // commits per batch
+    Histogram latencyMicros;  // from the first commit of a batch arrived until it was written
+    CommitStats();
+    void add(size_t commits, std::chrono::microseconds latency);
+    static size_t bucket(uint64_t value);
+    /// Exclusive upper bound of the values in a bucket.
+    static uint64_t bucketLimit(size_t bucket) { return 1ul << bucket; }
+};
+
 struct DomainInfo {
     using DurationSeconds = std::chrono::duration<double>;
     SerialNumRange range;
@@ -27,10 +51,11 @@ struct DomainInfo {
     size_t byteSize;
     DurationSeconds maxSessionRunTime;
     std::vector<PartInfo> parts;
+    CommitStats commitStats;
     DomainInfo(SerialNumRange range_in, size_t numEntries_in, size_t byteSize_in, DurationSeconds maxSessionRunTime_in)
-        : range(range_in), numEntries(numEntries_in), byteSize(byteSize_in), maxSessionRunTime(maxSessionRunTime_in), parts() {}
+        : range(range_in), numEntries(numEntries_in), byteSize(byteSize_in), maxSessionRunTime(maxSessionRunTime_in), parts(), commitStats() {}
     DomainInfo()
-        : range(), numEntries(0), byteSize(0), maxSessionRunTime(), parts() {}
+        : range(), numEntries(0), byteSize(0), maxSessionRunTime(), parts(), commitStats() {}
 };
 
 typedef std::map<vespalib::string, DomainInfo> DomainStats;
@@ -41,8 +66,7 @@ public:
     using SP = std::shared_ptr<Domain>;
     using Executor = vespalib::ThreadExecutor;
     Domain(const vespalib::string &name, const vespalib::string &baseDir, Executor & commitExecutor,
-           Executor & sessionExecutor, uint64_t domainPartSize, DomainPart::Crc defaultCrcType,
-           const common::FileHeaderContext &fileHeaderContext);
+           Executor & sessionExecutor, const DomainConfig & config, const common::FileHeaderContext &fileHeaderContext);
 
     virtual ~Domain();
 
@@ -50,7 +74,23 @@ public:
     const vespalib::string & name() const { return _name; }
     bool erase(SerialNum to);
 
+    /**
+     * Commits the packet and waits until it is written, and synced if configured.
+     * Throws if the packet could not be written. A failed write fails the
+     * domain, and all later commits are rejected.
+     */
     void commit(const Packet & packet);
+    /**
+     * Adds the packet to the batch of commits to write next and returns. The
+     * callback is released when the batch is written, and synced if configured.
+     * Concurrent commits are coalesced into batches this way, and under
+     * concurrent load a batch is held open for more commits as long as the
+     * recent write latency leaves room for it within the latency target.
+     *
+     * The callback can not carry a failure, so failing to write the packet
+     * is fatal, as it would otherwise be acked as persisted.
+     */
+    void commit(const Packet & packet, Writer::DoneCallback onDone);
     int visit(const Domain::SP & self, SerialNum from, SerialNum to, FRT_Supervisor & supervisor, FNET_Connection *conn);
 
     SerialNum begin() const;
@@ -86,6 +126,11 @@ private:
     void cleanSessions();
     vespalib::string dir() const { return getDir(_baseDir, _name); }
     void addPart(int64_t partId, bool isLastPart);
+    CommitResult::SP queueCommit(const Packet & packet, Writer::DoneCallback onDone, bool failureIsFatal);
+    void commitBatches();
+    void failBatch(const CommitChunk & batch, const vespalib::string & error);
+    void awaitBatch(std::unique_lock<std::mutex> & guard);
+    void commitBatch(const CommitChunk & batch);
 
     using SerialNumList = std::vector<SerialNum>;
 
@@ -95,14 +140,13 @@ private:
     using DomainPartList = std::map<int64_t, DomainPart::SP>;
     using DurationSeconds = std::chrono::duration<double>;
 
-    DomainPart::Crc     _defaultCrcType;
+    const DomainConfig  _config;
     Executor          & _commitExecutor;
     Executor          & _sessionExecutor;
     std::atomic<int>    _sessionId;
     vespalib::Monitor   _syncMonitor;
     bool                _pendingSync;
     vespalib::string    _name;
-    uint64_t            _domainPartSize;
     DomainPartList      _parts;
     vespalib::Lock      _lock;
     vespalib::Lock      _sessionLock;
@@ -111,6 +155,16 @@ private:
     vespalib::string    _baseDir;
     const common::FileHeaderContext &_fileHeaderContext;
     bool                _markedDeleted;
+    mutable std::mutex           _batchLock;
+    std::condition_variable      _batchCond;
+    std::unique_ptr<CommitChunk> _currentBatch;
+    bool                         _batchInFlight;
+    vespalib::ThreadStackExecutor _singleCommitter;  // writes the batches, off the shared commit executor
+    SerialNum                    _lastCommitted;  // last serial number accepted by commit
+    vespalib::string             _failure;        // set by the first failed write, fails all later commits
+    size_t                       _lastBatchCommits;
+    std::chrono::microseconds    _avgWriteTime;
+    CommitStats                  _commitStats;
 };
 
 }
@@ -0,0 +1,16 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "domainconfig.h"
+
+namespace search::transactionlog {
+
+DomainConfig::DomainConfig()
+    : _crc(DomainPart::xxh64),
+      _compression(),
+      _partSizeLimit(0x10000000),
+      _fSyncOnCommit(false),
+      _commitLatencyTarget(0),
+      _batchSizeLimit(0x40000)
+{ }
+
+}
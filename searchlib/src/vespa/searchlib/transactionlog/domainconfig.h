@@ -0,0 +1,37 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include "domainpart.h"
+#include <chrono>
+
+namespace search::transactionlog {
+
+/**
+ * How a domain writes its parts and groups its commits.
+ */
+class DomainConfig {
+public:
+    using duration = std::chrono::microseconds;
+    DomainConfig();
+    DomainConfig & setCrc(DomainPart::Crc v) { _crc = v; return *this; }
+    DomainConfig & setCompression(const DomainPart::CompressionConfig & v) { _compression = v; return *this; }
+    DomainConfig & setPartSizeLimit(uint64_t v) { _partSizeLimit = v; return *this; }
+    DomainConfig & setFSyncOnCommit(bool v) { _fSyncOnCommit = v; return *this; }
+    DomainConfig & setCommitLatencyTarget(duration v) { _commitLatencyTarget = v; return *this; }
+    DomainConfig & setBatchSizeLimit(size_t v) { _batchSizeLimit = v; return *this; }
+    DomainPart::Crc getCrc() const { return _crc; }
+    const DomainPart::CompressionConfig & getCompression() const { return _compression; }
+    uint64_t getPartSizeLimit() const { return _partSizeLimit; }
+    bool getFSyncOnCommit() const { return _fSyncOnCommit; }
+    duration getCommitLatencyTarget() const { return _commitLatencyTarget; }
+    size_t getBatchSizeLimit() const { return _batchSizeLimit; }
+private:
+    DomainPart::Crc               _crc;
+    DomainPart::CompressionConfig _compression;
+    uint64_t                      _partSizeLimit;
+    bool                          _fSyncOnCommit;
+    duration                      _commitLatencyTarget;
+    size_t                        _batchSizeLimit;
+};
+
+}
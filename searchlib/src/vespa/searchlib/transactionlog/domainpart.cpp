@@ -1,6 +1,7 @@
 // Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "domainpart.h"
+#include <vespa/vespalib/util/compressor.h>
 #include <vespa/vespalib/util/crc.h>
 #include <vespa/vespalib/xxhash/xxhash.h>
 #include <vespa/vespalib/util/stringfmt.h>
@@ -20,6 +21,8 @@ using vespalib::LockGuard;
 using vespalib::nbostream;
 using vespalib::nbostream_longlivedbuf;
 using vespalib::alloc::Alloc;
+using vespalib::compression::compress;
+using vespalib::compression::decompress;
 using search::common::FileHeaderContext;
 using std::runtime_error;
 
@@ -27,6 +30,12 @@ namespace search::transactionlog {
 
 namespace {
 
+/**
+ * Flags a record holding a compressed block of entries rather than a single
+ * entry. The rest of the version byte is the crc method.
+ */
+constexpr uint8_t COMPRESSED_BLOCK = 0x80;
+
 void
 handleSync(FastOS_FileInterface &file) __attribute__ ((noinline));
 
@@ -34,8 +43,8 @@ string
 handleWriteError(const char *text,
                  FastOS_FileInterface &file,
                  int64_t lastKnownGoodPos,
-                 const Packet::Entry &entry,
-                 int bufLen) __attribute__ ((noinline));
+                 SerialNum lastSerial,
+                 size_t bufLen) __attribute__ ((noinline));
 
 bool
 handleReadError(const char *text,
@@ -75,13 +84,13 @@ string
 handleWriteError(const char *text,
                  FastOS_FileInterface &file,
                  int64_t lastKnownGoodPos,
-                 const Packet::Entry &entry,
-                 int bufLen)
+                 SerialNum lastSerial,
+                 size_t bufLen)
 {
     string last(FastOS_File::getLastErrorString());
-    string e(make_string("%s. File '%s' at position %" PRId64 " for entry %" PRIu64 " of length %u. "
+    string e(make_string("%s. File '%s' at position %" PRId64 " for entries up to %" PRIu64 " of length %zu. "
                          "OS says '%s'. Rewind to last known good position %" PRId64 ".",
-                         text, file.GetFileName(), file.GetPosition(), entry.serial(), bufLen,
+                         text, file.GetFileName(), file.GetPosition(), lastSerial, bufLen,
                          last.c_str(), lastKnownGoodPos));
     LOG(error, "%s",  e.c_str());
     if ( ! file.SetPosition(lastKnownGoodPos) ) {
@@ -208,20 +217,26 @@ DomainPart::buildPacketMapping(bool allowTruncate)
             handleReadError("file header", transLog, 0, FileHeader::getMinSize(), 0, allowTruncate);
         }
     }
+    SerialNum lastAdded(0);
     while ((currPos < fSize)) {
         Packet packet;
         SerialNum firstSerial(0);
         SerialNum lastSerial(0);
         int64_t firstPos(currPos);
         bool full(false);
-        Alloc buf;
-        for(size_t i(0); !full && (currPos < fSize); i++) {
+        EntryReader reader(transLog, allowTruncate);
+        while ( ! full && (currPos < fSize)) {
             Packet::Entry e;
-            if (read(transLog, e, buf, allowTruncate)) {
+            if (reader.read(e)) {
                 if (e.valid()) {
-                    if (i == 0) {
+                    if ((_sz > 0) && (e.serial() <= lastAdded)) {
+                        // Added to the previous packet before rereading the block.
+                        continue;
+                    }
+                    if (packet.empty()) {
                         firstSerial = e.serial();
-                        if (currPos == _headerLen) {
+                        firstPos = reader.recordPos();
+                        if (_sz == 0) {
                             _range.from(firstSerial);
                         }
                     }
@@ -229,9 +244,11 @@ DomainPart::buildPacketMapping(bool allowTruncate)
                         full = addPacket(packet, e);
                         if ( ! full ) {
                             lastSerial = e.serial();
+                            lastAdded = lastSerial;
                             currPos = transLog.GetPosition();
                             _sz++;
                         } else {
+                            currPos = reader.recordPos();
                             transLog.SetPosition(currPos);
                         }
                     } catch (const std::exception & ex) {
@@ -266,8 +283,10 @@ DomainPart::buildPacketMapping(bool allowTruncate)
 }
 
 DomainPart::DomainPart(const string & name, const string & baseDir, SerialNum s, Crc defaultCrc,
-                       const FileHeaderContext &fileHeaderContext, bool allowTruncate) :
+                       const CompressionConfig &compression, const FileHeaderContext &fileHeaderContext,
+                       bool allowTruncate) :
     _defaultCrc(defaultCrc),
+    _compression(compression),
     _lock(),
     _fileLock(),
     _range(s),
@@ -407,21 +426,32 @@ DomainPart::commit(SerialNum firstSerial, const Packet &packet)
     if (_range.from() == 0) {
         _range.from(firstSerial);
     }
-    for (size_t i(0); h.size() > 0; i++) {
-        //LOG(spam,
-        //"Pos(%d) Len(%d), Lim(%d), Remaining(%d)",
-        //h.getPos(), h.getLength(), h.getLimit(), h.getRemaining());
+    std::vector<Packet::Entry> entries;
+    for (SerialNum lastSerial(_range.to()); h.size() > 0; ) {
         Packet::Entry entry;
         entry.deserialize(h);
-        if (_range.to() < entry.serial()) {
-            write(*_transLog, entry);
-            _sz++;
-            _range.to(entry.serial());
+        if (lastSerial < entry.serial()) {
+            lastSerial = entry.serial();
+            entries.push_back(entry);
         } else {
             throw runtime_error(make_string("Incomming serial number(%ld) must be bigger than the last one (%ld).",
-                                            entry.serial(), _range.to()));
+                                            entry.serial(), lastSerial));
+        }
+    }
+    if (entries.empty()) {
+        return;
+    }
+    // The packet buffer is the entries serialized back to back, which is also the content of a block.
+    vespalib::ConstBufferRef serialized(packet.getHandle().c_str(), packet.getHandle().size());
+    nbostream os(serialized.size() + entries.size() * (sizeof(uint8_t) + sizeof(uint32_t) + sizeof(int32_t)));
+    if ( ! _compression.useCompression() || ! serializeBlock(os, serialized)) {
+        for (const Packet::Entry & entry : entries) {
+            serialize(os, entry);
         }
     }
+    write(*_transLog, os, entries.back().serial());
+    _sz += entries.size();
+    _range.to(entries.back().serial());
 
     bool merged(false);
     LockGuard guard(_lock);
@@ -541,11 +571,12 @@ DomainPart::visit(FastOS_FileInterface &file, SerialNumRange &r, Packet &packet)
     }
     if (retval) {
         Packet newPacket;
-        Alloc buf;
-        for (bool full(false);!full && retval && (r.from() < r.to());) {
+        EntryReader reader(file, false);
+        bool full(false);
+        while (!full && retval && (r.from() < r.to())) {
             Packet::Entry e;
-            int64_t fPos = file.GetPosition();
-            retval = read(file, e, buf, false);
+            retval = reader.read(e);
+            int64_t fPos = reader.recordPos();
             if (retval &&
                 e.valid() &&
                 (r.from() < e.serial()) &&
@@ -558,14 +589,17 @@ DomainPart::visit(FastOS_FileInterface &file, SerialNumRange &r, Packet &packet)
                 }
                 if ( !full ) {
                     r.from(e.serial());
-                } else {
-                    if ( ! file.SetPosition(fPos) ) {
-                        throw runtime_error(make_string("Failed setting read position for file '%s' of size %" PRId64 " from %" PRId64 " to %" PRId64 ".",
-                                                        file.GetFileName(), file.GetSize(), file.GetPosition(), fPos));
-                    }
                 }
             }
         }
+        if (full || reader.hasBlockEntries()) {
+            // Next visit rereads the record, skipping the entries already visited.
+            int64_t fPos = reader.recordPos();
+            if ( ! file.SetPosition(fPos) ) {
+                throw runtime_error(make_string("Failed setting read position for file '%s' of size %" PRId64 " from %" PRId64 " to %" PRId64 ".",
+                                                file.GetFileName(), file.GetSize(), file.GetPosition(), fPos));
+            }
+        }
         newPacket.close();
         packet = newPacket;
     }
@@ -574,12 +608,10 @@ DomainPart::visit(FastOS_FileInterface &file, SerialNumRange &r, Packet &packet)
 }
 
 void
-DomainPart::write(FastOS_FileInterface &file, const Packet::Entry &entry)
+DomainPart::serialize(nbostream &os, const Packet::Entry &entry) const
 {
-    int64_t lastKnownGoodPos(file.GetPosition());
     int32_t crc(0);
     uint32_t len(entry.serializedSize() + sizeof(crc));
-    nbostream os;
     os << static_cast<uint8_t>(_defaultCrc);
     os << len;
     size_t start(os.size());
@@ -587,72 +619,150 @@ DomainPart::write(FastOS_FileInterface &file, const Packet::Entry &entry)
     size_t end(os.size());
     crc = calcCrc(_defaultCrc, os.c_str()+start, end - start);
     os << crc;
-    size_t osSize = os.size();
-    assert(osSize == len + sizeof(len) + sizeof(uint8_t));
+    assert(os.size() - start == len);
+}
+
+bool
+DomainPart::serializeBlock(nbostream &os, vespalib::ConstBufferRef entries) const
+{
+    vespalib::DataBuffer compressed;
+    CompressionConfig::Type type = compress(_compression, entries, compressed, false);
+    if ( ! CompressionConfig::isCompressed(type)) {
+        return false;
+    }
+    int32_t crc(0);
+    uint32_t len(sizeof(uint8_t) + sizeof(uint32_t) + compressed.getDataLen() + sizeof(crc));
+    os << static_cast<uint8_t>(_defaultCrc | COMPRESSED_BLOCK);
+    os << len;
+    size_t start(os.size());
+    os << static_cast<uint8_t>(type);
+    os << static_cast<uint32_t>(entries.size());
+    os.write(compressed.getData(), compressed.getDataLen());
+    size_t end(os.size());
+    crc = calcCrc(_defaultCrc, os.c_str()+start, end - start);
+    os << crc;
+    assert(os.size() - start == len);
+    return true;
+}
 
+void
+DomainPart::write(FastOS_FileInterface &file, const nbostream &os, SerialNum lastSerial)
+{
+    int64_t lastKnownGoodPos(file.GetPosition());
     LockGuard guard(_writeLock);
-    if ( ! file.CheckedWrite(os.c_str(), osSize) ) {
-        throw runtime_error(handleWriteError("Failed writing the entry.", file, lastKnownGoodPos, entry, end - start));
+    if ( ! file.CheckedWrite(os.c_str(), os.size()) ) {
+        throw runtime_error(handleWriteError("Failed writing the entries.", file, lastKnownGoodPos, lastSerial, os.size()));
     }
-    _writtenSerial = entry.serial();
-    _byteSize.store(lastKnownGoodPos + osSize, std::memory_order_release);
+    _writtenSerial = lastSerial;
+    _byteSize.store(lastKnownGoodPos + os.size(), std::memory_order_release);
 }
 
+DomainPart::EntryReader::EntryReader(FastOS_FileInterface &file, bool allowTruncate)
+    : _file(file),
+      _allowTruncate(allowTruncate),
+      _buf(),
+      _block(0),
+      _recordPos(file.GetPosition())
+{ }
+
+DomainPart::EntryReader::~EntryReader() = default;
+
 bool
-DomainPart::read(FastOS_FileInterface &file,
-                 Packet::Entry &entry,
-                 Alloc & buf,
-                 bool allowTruncate)
+DomainPart::EntryReader::read(Packet::Entry &entry)
 {
+    if (hasBlockEntries()) {
+        readFromBlock(entry);
+        return true;
+    }
     bool retval(true);
     char tmp[5];
-    int64_t lastKnownGoodPos(file.GetPosition());
-    size_t rlen = file.Read(tmp, sizeof(tmp));
+    int64_t lastKnownGoodPos(_file.GetPosition());
+    _recordPos = lastKnownGoodPos;
+    size_t rlen = _file.Read(tmp, sizeof(tmp));
     nbostream his(tmp, sizeof(tmp));
     uint8_t version(-1);
     uint32_t len(0);
     his >> version >> len;
     if ((retval = (rlen == sizeof(tmp)))) {
-        if ( ! (retval = (version == ccitt_crc32) || version == xxh64)) {
+        uint8_t crcMethod(version & ~COMPRESSED_BLOCK);
+        if ( ! (retval = (crcMethod == ccitt_crc32) || crcMethod == xxh64)) {
             string msg(make_string("Version mismatch. Expected 'ccitt_crc32=1' or 'xxh64=2',"
-                                             " got %d from '%s' at position %ld",
-                                             version, file.GetFileName(), lastKnownGoodPos));
-            if ((version == 0) && (len == 0) && tailOfFileIsZero(file, lastKnownGoodPos)) {
+                                             " optionally flagged as compressed block, got %d from '%s' at position %ld",
+                                             version, _file.GetFileName(), lastKnownGoodPos));
+            if ((version == 0) && (len == 0) && tailOfFileIsZero(_file, lastKnownGoodPos)) {
                 LOG(warning, "%s", msg.c_str());
-                return handleReadError("packet version", file, sizeof(tmp), rlen, lastKnownGoodPos, allowTruncate);
+                return handleReadError("packet version", _file, sizeof(tmp), rlen, lastKnownGoodPos, _allowTruncate);
             } else {
                 throw runtime_error(msg);
             }
         }
-        if (len > buf.size()) {
-            Alloc::alloc(len).swap(buf);
+        if (len > _buf.size()) {
+            Alloc::alloc(len).swap(_buf);
         }
-        rlen = file.Read(buf.get(), len);
+        rlen = _file.Read(_buf.get(), len);
         retval = rlen == len;
         if (!retval) {
-            retval = handleReadError("packet blob", file, len, rlen, lastKnownGoodPos, allowTruncate);
+            retval = handleReadError("packet blob", _file, len, rlen, lastKnownGoodPos, _allowTruncate);
         } else {
-            nbostream_longlivedbuf is(buf.get(), len);
-            entry.deserialize(is);
             int32_t crc(0);
-            is >> crc;
-            int32_t crcVerify(calcCrc(static_cast<Crc>(version), buf.get(), len - sizeof(crc)));
+            if (len < sizeof(crc)) {
+                throw runtime_error(make_string("Got too short packet from '%s' (len pos=%" PRId64 ", len=%d)",
+                                                _file.GetFileName(), _file.GetPosition() - len - sizeof(len),
+                                                static_cast<int>(len)));
+            }
+            const char * payload = static_cast<const char *>(_buf.get());
+            size_t payloadLen(len - sizeof(crc));
+            nbostream_longlivedbuf cis(payload + payloadLen, sizeof(crc));
+            cis >> crc;
+            int32_t crcVerify(calcCrc(static_cast<Crc>(crcMethod), payload, payloadLen));
             if (crc != crcVerify) {
                 throw runtime_error(make_string("Got bad crc for packet from '%s' (len pos=%" PRId64 ", len=%d) : crcVerify = %d, expected %d",
-                                                file.GetFileName(), file.GetPosition() - len - sizeof(len),
+                                                _file.GetFileName(), _file.GetPosition() - len - sizeof(len),
                                                 static_cast<int>(len), static_cast<int>(crcVerify), static_cast<int>(crc)));
             }
+            if (version & COMPRESSED_BLOCK) {
+                decodeBlock(payloadLen);
+                readFromBlock(entry);
+            } else {
+                nbostream_longlivedbuf is(payload, payloadLen);
+                entry.deserialize(is);
+            }
         }
     } else {
         if (rlen == 0) {
            // Eof
         } else {
-           retval = handleReadError("packet length", file, sizeof(len), rlen, lastKnownGoodPos, allowTruncate);
+           retval = handleReadError("packet length", _file, sizeof(len), rlen, lastKnownGoodPos, _allowTruncate);
         }
     }
     return retval;
 }
 
+void
+DomainPart::EntryReader::decodeBlock(size_t len)
+{
+    nbostream_longlivedbuf is(_buf.get(), len);
+    uint8_t type(0);
+    uint32_t uncompressedLen(0);
+    is >> type >> uncompressedLen;
+    _block.clear();
+    decompress(CompressionConfig::toType(type), uncompressedLen, vespalib::ConstBufferRef(is.peek(), is.size()),
+               _block, false);
+    if ((_block.getDataLen() != uncompressedLen) || (uncompressedLen == 0)) {
+        throw runtime_error(make_string("Block from '%s' at position %" PRId64 " decompressed to %zu bytes, expected %u",
+                                        _file.GetFileName(), _recordPos, _block.getDataLen(), uncompressedLen));
+    }
+}
+
+void
+DomainPart::EntryReader::readFromBlock(Packet::Entry &entry)
+{
+    // The entry refers to the block, which is not overwritten until all its entries are read.
+    nbostream_longlivedbuf is(_block.getData(), _block.getDataLen());
+    entry.deserialize(is);
+    _block.moveDataToDead(is.rp());
+}
+
 int32_t DomainPart::calcCrc(Crc version, const void * buf, size_t sz)
 {
     if (version == xxh64) {
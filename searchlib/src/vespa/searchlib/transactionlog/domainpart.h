@@ -2,6 +2,8 @@
 #pragma once
 
 #include "common.h"
+#include <vespa/vespalib/data/databuffer.h>
+#include <vespa/vespalib/util/compressionconfig.h>
 #include <vespa/vespalib/util/sync.h>
 #include <vespa/vespalib/util/memory.h>
 #include <map>
@@ -24,8 +26,15 @@ public:
         xxh64=2
     };
     typedef std::shared_ptr<DomainPart> SP;
+    using CompressionConfig = vespalib::compression::CompressionConfig;
+    /**
+     * With compression the entries of each commit are written as one compressed
+     * block, unless compression does not pay off. Files with and without blocks
+     * are read alike.
+     */
     DomainPart(const vespalib::string &name, const vespalib::string &baseDir, SerialNum s, Crc defaultCrc,
-               const common::FileHeaderContext &FileHeaderContext, bool allowTruncate);
+               const CompressionConfig &compression, const common::FileHeaderContext &FileHeaderContext,
+               bool allowTruncate);
 
     ~DomainPart();
 
@@ -52,9 +61,34 @@ private:
     bool openAndFind(FastOS_FileInterface &file, const SerialNum &from);
     int64_t buildPacketMapping(bool allowTruncate);
 
-    static bool read(FastOS_FileInterface &file, Packet::Entry &entry, vespalib::alloc::Alloc &buf, bool allowTruncate);
+    /**
+     * Reads the entries of a domain part file in order, whether a record holds a
+     * single entry or a compressed block of entries.
+     */
+    class EntryReader {
+    public:
+        EntryReader(FastOS_FileInterface &file, bool allowTruncate);
+        ~EntryReader();
+        bool read(Packet::Entry &entry);
+        /// File position of the record holding the entry last read.
+        int64_t recordPos() const { return _recordPos; }
+        /// Whether entries of the last block read are not yet returned.
+        bool hasBlockEntries() const { return _block.getDataLen() > 0; }
+    private:
+        void decodeBlock(size_t len);
+        void readFromBlock(Packet::Entry &entry);
+
+        FastOS_FileInterface   &_file;
+        bool                    _allowTruncate;
+        vespalib::alloc::Alloc  _buf;
+        vespalib::DataBuffer    _block;
+        int64_t                 _recordPos;
+    };
 
-    void write(FastOS_FileInterface &file, const Packet::Entry &entry);
+    void serialize(vespalib::nbostream &os, const Packet::Entry &entry) const;
+    bool serializeBlock(vespalib::nbostream &os, vespalib::ConstBufferRef entries) const;
+    /// Writes the serialized records of the entries up to lastSerial in one go.
+    void write(FastOS_FileInterface &file, const vespalib::nbostream &os, SerialNum lastSerial);
     static int32_t calcCrc(Crc crc, const void * buf, size_t len);
     void writeHeader(const common::FileHeaderContext &fileHeaderContext);
 
@@ -78,6 +112,7 @@ private:
     typedef std::vector<SkipInfo> SkipList;
     typedef std::map<SerialNum, Packet> PacketList;
     const Crc      _defaultCrc;
+    const CompressionConfig _compression;
     vespalib::Lock _lock;
     vespalib::Lock _fileLock;
     SerialNumRange _range;
@@ -12,6 +12,18 @@ namespace search::transactionlog {
 
 namespace {
 
+void
+convertHistogram(const CommitStats::Histogram &histogram, Cursor &array)
+{
+    for (size_t i(0); i < histogram.size(); ++i) {
+        if (histogram[i] != 0) {
+            Cursor &bucket = array.addObject();
+            bucket.setLong("below", CommitStats::bucketLimit(i));
+            bucket.setLong("count", histogram[i]);
+        }
+    }
+}
+
 struct DomainExplorer : vespalib::StateExplorer {
     Domain::SP domain;
     DomainExplorer(Domain::SP domain_in) : domain(std::move(domain_in)) {}
@@ -22,7 +34,12 @@ struct DomainExplorer : vespalib::StateExplorer {
         state.setLong("to", info.range.to());
         state.setLong("numEntries", info.numEntries);
         state.setLong("byteSize", info.byteSize);
+        Cursor &commit = state.setObject("commit");
+        commit.setLong("batches", info.commitStats.numBatches);
+        commit.setLong("commits", info.commitStats.numCommits);
         if (full) {
+            convertHistogram(info.commitStats.batchSize, commit.setArray("batchSize"));
+            convertHistogram(info.commitStats.latencyMicros, commit.setArray("latencyMicros"));
             Cursor &array = state.setArray("parts");
             for (const PartInfo &part_in: info.parts) {
                 Cursor &part = array.addObject();
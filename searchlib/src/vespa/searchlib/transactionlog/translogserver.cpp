@@ -88,11 +88,17 @@ TransLogServer::TransLogServer(const vespalib::string &name, int listenPort, con
 TransLogServer::TransLogServer(const vespalib::string &name, int listenPort, const vespalib::string &baseDir,
                                const FileHeaderContext &fileHeaderContext, uint64_t domainPartSize,
                                size_t maxThreads, DomainPart::Crc defaultCrcType)
+    : TransLogServer(name, listenPort, baseDir, fileHeaderContext,
+                     DomainConfig().setPartSizeLimit(domainPartSize).setCrc(defaultCrcType), maxThreads)
+{}
+
+TransLogServer::TransLogServer(const vespalib::string &name, int listenPort, const vespalib::string &baseDir,
+                               const FileHeaderContext &fileHeaderContext, const DomainConfig & domainConfig,
+                               size_t maxThreads)
     : FRT_Invokable(),
       _name(name),
       _baseDir(baseDir),
-      _domainPartSize(domainPartSize),
-      _defaultCrcType(defaultCrcType),
+      _domainConfig(domainConfig),
       _commitExecutor(maxThreads, 128*1024),
       _sessionExecutor(maxThreads, 128*1024),
       _threadPool(8192, 1),
@@ -111,7 +117,7 @@ TransLogServer::TransLogServer(const vespalib::string &name, int listenPort, con
                 if ( ! domainName.empty()) {
                     try {
                         auto domain = std::make_shared<Domain>(domainName, dir(), _commitExecutor, _sessionExecutor,
-                                                               _domainPartSize, _defaultCrcType,_fileHeaderContext);
+                                                               _domainConfig, _fileHeaderContext);
                         _domains[domain->name()] = domain;
                     } catch (const std::exception & e) {
                         LOG(warning, "Failed creating %s domain on startup. Exception = %s", domainName.c_str(), e.what());
@@ -350,7 +356,7 @@ void TransLogServer::createDomain(FRT_RPCRequest *req)
     if ( !domain ) {
         try {
             domain = std::make_shared<Domain>(domainName, dir(), _commitExecutor, _sessionExecutor,
-                                              _domainPartSize, _defaultCrcType, _fileHeaderContext);
+                                              _domainConfig, _fileHeaderContext);
             {
                 Guard domainGuard(_lock);
                 _domains[domain->name()] = domain;
@@ -459,10 +465,9 @@ void TransLogServer::domainStatus(FRT_RPCRequest *req)
 
 void TransLogServer::commit(const vespalib::string & domainName, const Packet & packet, DoneCallback done)
 {
-    (void) done;
     Domain::SP domain(findDomain(domainName));
     if (domain) {
-        domain->commit(packet);
+        domain->commit(packet, std::move(done));
     } else {
         throw IllegalArgumentException("Could not find domain " + domainName);
     }
@@ -21,6 +21,9 @@ public:
     typedef std::unique_ptr<TransLogServer> UP;
     typedef std::shared_ptr<TransLogServer> SP;
 
+    TransLogServer(const vespalib::string &name, int listenPort, const vespalib::string &baseDir,
+                   const common::FileHeaderContext &fileHeaderContext,
+                   const DomainConfig & domainConfig, size_t maxThreads);
     TransLogServer(const vespalib::string &name, int listenPort, const vespalib::string &baseDir,
                    const common::FileHeaderContext &fileHeaderContext,
                    uint64_t domainPartSize, size_t maxThreads, DomainPart::Crc defaultCrc);
@@ -79,8 +82,7 @@ private:
 
     vespalib::string                    _name;
     vespalib::string                    _baseDir;
-    const uint64_t                      _domainPartSize;
-    const DomainPart::Crc               _defaultCrcType;
+    const DomainConfig                  _domainConfig;
     vespalib::ThreadStackExecutor       _commitExecutor;
     vespalib::ThreadStackExecutor       _sessionExecutor;
     FastOS_ThreadPool                   _threadPool;
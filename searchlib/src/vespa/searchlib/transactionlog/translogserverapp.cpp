@@ -36,14 +36,36 @@ getCrc(searchlib::TranslogserverConfig::Crcmethod crcType)
     abort();
 }
 
+DomainPart::CompressionConfig
+getCompression(const searchlib::TranslogserverConfig::Compression & compression)
+{
+    using CompressionConfig = DomainPart::CompressionConfig;
+    switch (compression.type) {
+        case searchlib::TranslogserverConfig::Compression::NONE:
+            return CompressionConfig();
+        case searchlib::TranslogserverConfig::Compression::LZ4:
+            return CompressionConfig(CompressionConfig::LZ4, compression.level, 90);
+        case searchlib::TranslogserverConfig::Compression::ZSTD:
+            return CompressionConfig(CompressionConfig::ZSTD, compression.level, 90);
+    }
+    abort();
+}
+
 }
 
 void
 TransLogServerApp::start()
 {
     std::shared_ptr<searchlib::TranslogserverConfig> c = _tlsConfig.get();
+    DomainConfig domainConfig;
+    domainConfig.setPartSizeLimit(c->filesizemax)
+                .setCrc(getCrc(c->crcmethod))
+                .setCompression(getCompression(c->compression))
+                .setFSyncOnCommit(c->usefsync)
+                .setCommitLatencyTarget(std::chrono::microseconds(int64_t(c->commit.latencytarget * 1000000)))
+                .setBatchSizeLimit(c->commit.maxbatchsize);
     auto tls = std::make_shared<TransLogServer>(c->servername, c->listenport, c->basedir, _fileHeaderContext,
-                                            c->filesizemax, c->maxthreads, getCrc(c->crcmethod));
+                                                domainConfig, c->maxthreads);
     std::lock_guard<std::mutex> guard(_lock);
     _tls = std::move(tls);
 }
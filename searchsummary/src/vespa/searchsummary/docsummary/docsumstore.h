@@ -3,6 +3,7 @@
 #pragma once
 
 #include "docsumstorevalue.h"
+#include <vector>
 
 namespace search::docsummary {
 
@@ -38,6 +39,15 @@ public:
      **/
     virtual DocsumStoreValue getMappedDocsum(uint32_t docid) = 0;
 
+    /**
+     * Tell the store that docsums for the given local document ids
+     * will be requested next, so it can fetch them in one batch.
+     * Default is to do nothing.
+     *
+     * @param docids local document ids in the order they will be requested
+     **/
+    virtual void prefetch(const std::vector<uint32_t> & docids) { (void) docids; }
+
     /**
      * Will return default input class used.
      **/
@@ -46,6 +46,7 @@ JuniperProperties::reset()
     _properties["juniper.matcher.winsize"]                      = "200";
     _properties["juniper.matcher.winsize_fallback_multiplier"]  = "10.0";
     _properties["juniper.matcher.max_match_candidates"]         = "1000";
+    _properties["juniper.matcher.early_termination"]            = "off";
     //_properties["juniper.proximity.factor"]                   = "0.25";
     //_properties["juniper.stem.max_extend"]                    = "3";
     //_properties["juniper.stem.min_length"]                    = "5";
@@ -63,6 +64,7 @@ JuniperProperties::configure(const JuniperrcConfig &cfg)
     _properties["juniper.matcher.winsize"]  = make_string("%d", cfg.winsize);
     _properties["juniper.matcher.winsize_fallback_multiplier"]  = make_string("%f", cfg.winsizeFallbackMultiplier);
     _properties["juniper.matcher.max_match_candidates"]  = make_string("%d", cfg.maxMatchCandidates);
+    _properties["juniper.matcher.early_termination"]  = cfg.earlyTermination ? "on" : "off";
     _properties["juniper.stem.min_length"]  = make_string("%d", cfg.stemMinLength);
     _properties["juniper.stem.max_extend"]  = make_string("%d", cfg.stemMaxExtend);
 
@@ -81,6 +83,7 @@ JuniperProperties::configure(const JuniperrcConfig &cfg)
         _properties[keyMatcher + "winsize"]                     = make_string("%d", override.winsize);
         _properties[keyMatcher + "winsize_fallback_multiplier"] = make_string("%f", override.winsizeFallbackMultiplier);
         _properties[keyMatcher + "max_match_candidates"] = make_string("%d", override.maxMatchCandidates);
+        _properties[keyMatcher + "early_termination"] = override.earlyTermination ? "on" : "off";
 
         _properties[keyStem + "min_length"] = make_string("%d", override.stemMinLength);
         _properties[keyStem + "max_extend"] = make_string("%d", override.stemMaxExtend);
@@ -3,6 +3,7 @@
 #include <vespa/vespalib/testkit/testapp.h>
 #include <vespa/vespalib/stllike/string.h>
 #include <vespa/vespalib/stllike/cache.hpp>
+#include <vespa/vespalib/stllike/striped_cache.hpp>
 #include <map>
 
 using namespace vespalib;
@@ -41,6 +42,9 @@ private:
     void testCacheEntriesHonoured();
     void testCacheMaxSizeHonoured();
     void testThatMultipleRemoveOnOverflowIsFine();
+    void testAdmissionProtectsFrequentlyUsed();
+    void testStripedCache();
+    void testPopulateOnlyInsertsCurrentValues();
 };
 
 int
@@ -53,6 +57,9 @@ Test::Main()
     testCacheEntriesHonoured();
     testCacheMaxSizeHonoured();
     testThatMultipleRemoveOnOverflowIsFine();
+    testAdmissionProtectsFrequentlyUsed();
+    testStripedCache();
+    testPopulateOnlyInsertsCurrentValues();
     TEST_DONE();
 }
 
@@ -159,5 +166,92 @@ void Test::testThatMultipleRemoveOnOverflowIsFine()
     EXPECT_EQUAL(2924u, cache.sizeBytes());
 }
 
+void Test::testAdmissionProtectsFrequentlyUsed()
+{
+    B m;
+    for (uint32_t i(0); i < 200; i++) {
+        m[i] = "a";
+    }
+    cache< CacheParam<P, B> > lru(m, -1);
+    cache< CacheParam<P, B> > admitting(m, -1);
+    lru.maxElements(10);
+    admitting.maxElements(10).setAdmission(100);
+    EXPECT_FALSE(lru.hasAdmission());
+    EXPECT_TRUE(admitting.hasAdmission());
+    for (size_t round(0); round < 3; round++) {
+        for (uint32_t i(0); i < 10; i++) {
+            lru.read(i);
+            admitting.read(i);
+        }
+    }
+    for (uint32_t i(100); i < 200; i++) {
+        lru.read(i);
+        admitting.read(i);
+    }
+    EXPECT_EQUAL(10u, lru.size());
+    EXPECT_EQUAL(10u, admitting.size());
+    EXPECT_EQUAL(0u, lru.getRejected());
+    EXPECT_EQUAL(100u, admitting.getRejected());
+    for (uint32_t i(0); i < 10; i++) {
+        EXPECT_FALSE(lru.hasKey(i));
+        EXPECT_TRUE(admitting.hasKey(i));
+    }
+    // Rejected objects are still returned.
+    EXPECT_EQUAL("a", admitting.read(150));
+    admitting.setAdmission(0);
+    EXPECT_FALSE(admitting.hasAdmission());
+}
+
+void Test::testStripedCache()
+{
+    B m;
+    striped_cache< CacheParam<P, B, zero<uint32_t>, size<string> > > cache(m, 40000, 3);
+    EXPECT_EQUAL(4u, cache.numStripes());
+    EXPECT_EQUAL(40000u, cache.capacityBytes());
+    EXPECT_TRUE(cache.empty());
+    for (uint32_t i(0); i < 20; i++) {
+        cache.write(i, "15 bytes string");
+    }
+    EXPECT_EQUAL(20u, cache.size());
+    EXPECT_EQUAL(20*95u, cache.sizeBytes());
+    EXPECT_EQUAL(20u, cache.getWrite());
+    m[100] = "String inserted beneath";
+    EXPECT_FALSE(cache.hasKey(100));
+    EXPECT_EQUAL("String inserted beneath", cache.read(100));
+    EXPECT_TRUE(cache.hasKey(100));
+    EXPECT_EQUAL(1u, cache.getMiss());
+    EXPECT_EQUAL("15 bytes string", cache.read(7));
+    EXPECT_EQUAL(1u, cache.getHit());
+    cache.invalidate(7);
+    EXPECT_FALSE(cache.hasKey(7));
+    EXPECT_TRUE(m.find(7) != m.end());
+    cache.erase(8);
+    EXPECT_FALSE(cache.hasKey(8));
+    EXPECT_TRUE(m.find(8) == m.end());
+    EXPECT_EQUAL(19u, cache.size());
+
+    cache.setCapacityBytes(400);
+    for (uint32_t i(200); i < 300; i++) {
+        cache.write(i, "15 bytes string");
+    }
+    EXPECT_LESS_EQUAL(cache.sizeBytes(), 400u + 4*95u);
+}
+
+void Test::testPopulateOnlyInsertsCurrentValues()
+{
+    B m;
+    cache< CacheParam<P, B> > cache(m, -1);
+    cache.populate(1, "fetched in batch", []() { return true; });
+    EXPECT_TRUE(cache.hasKey(1));
+    EXPECT_EQUAL("fetched in batch", cache.read(1));
+    cache.populate(2, "stale", []() { return false; });
+    EXPECT_FALSE(cache.hasKey(2));
+    cache.populate(1, "already there", []() { return true; });
+    EXPECT_EQUAL("fetched in batch", cache.read(1));
+    EXPECT_EQUAL(3u, cache.getMiss());
+    EXPECT_EQUAL(1u, cache.getRace());
+    EXPECT_EQUAL(1u, cache.getInsert());
+    EXPECT_TRUE(m.empty());
+}
 
 TEST_APPHOOK(Test)
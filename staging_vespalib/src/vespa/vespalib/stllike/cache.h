@@ -2,8 +2,10 @@
 #pragma once
 
 #include <vespa/vespalib/stllike/lrucache_map.h>
+#include <vespa/vespalib/stllike/frequency_sketch.h>
 #include <vespa/vespalib/util/sync.h>
 #include <atomic>
+#include <memory>
 
 namespace vespalib {
 
@@ -73,6 +75,16 @@ public:
 
     cache & setCapacityBytes(size_t sz);
 
+    /**
+     * Enables TinyLFU admission. When the cache is full, an object fetched from the backing store
+     * is only inserted if it has been requested more often recently than the object it would evict.
+     * This protects the working set from being flushed by scans.
+     * @param expectedElements is the expected number of distinct keys, used for sizing the frequency sketch.
+     *                         0 disables admission.
+     */
+    cache & setAdmission(size_t expectedElements);
+    bool hasAdmission()                const { return bool(_sketch); }
+
     size_t capacity()                  const { return Lru::capacity(); }
     size_t capacityBytes()             const { return _maxBytes; }
     size_t size()                      const { return Lru::size(); }
@@ -103,6 +115,15 @@ public:
      */
     void write(const K & key, const V & value);
 
+    /**
+     * Insert an object the caller fetched from the backing store itself, e.g. as part of a batched read.
+     * It is accounted as a miss and is subject to admission just like read().
+     * The object is only inserted if isCurrent() still returns true while the store lock of the key is held,
+     * so a value read before a concurrent write can not be inserted after that write invalidated the key.
+     */
+    template <typename IsCurrent>
+    void populate(const K & key, const V & value, IsCurrent isCurrent);
+
     /**
      * Tell if an object with given key exists in the cache.
      * Does not alter the LRU list.
@@ -118,6 +139,7 @@ public:
     size_t        getErase() const { return _erase; }
     size_t   getInvalidate() const { return _invalidate; }
     size_t       getlookup() const { return _lookup; }
+    size_t     getRejected() const { return _rejected; }
 
 protected:
     vespalib::LockGuard getGuard();
@@ -133,6 +155,7 @@ private:
      */
     bool removeOldest(const value_type & v) override;
     size_t calcSize(const K & k, const V & v) const { return sizeof(value_type) + _sizeK(k) + _sizeV(v); }
+    bool admit(const vespalib::LockGuard & guard, const K & key, const V & value) const;
     vespalib::Lock & getLock(const K & k) {
         size_t h(_hasher(k));
         return _addLocks[h%(sizeof(_addLocks)/sizeof(_addLocks[0]))];
@@ -151,6 +174,8 @@ private:
     mutable size_t      _erase;
     mutable size_t      _invalidate;
     mutable size_t      _lookup;
+    size_t              _rejected;
+    std::unique_ptr<FrequencySketch> _sketch;
     BackingStore      & _store;
     vespalib::Lock      _hashLock;
     /// Striped locks that can be used for having a locked access to the backing store.
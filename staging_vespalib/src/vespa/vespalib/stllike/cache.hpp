@@ -27,6 +27,18 @@ cache<P>::setCapacityBytes(size_t sz) {
     return *this;
 }
 
+template< typename P >
+cache<P> &
+cache<P>::setAdmission(size_t expectedElements) {
+    vespalib::LockGuard guard(_hashLock);
+    if (expectedElements == 0) {
+        _sketch.reset();
+    } else if ( ! _sketch || (_sketch->width() < expectedElements)) {
+        _sketch = std::make_unique<FrequencySketch>(expectedElements);
+    }
+    return *this;
+}
+
 template< typename P >
 void
 cache<P>::invalidate(const K & key) {
@@ -64,6 +76,8 @@ cache<P>::cache(BackingStore & b, size_t maxBytes) :
     _erase(0),
     _invalidate(0),
     _lookup(0),
+    _rejected(0),
+    _sketch(),
     _store(b)
 { }
 
@@ -77,6 +91,19 @@ cache<P>::removeOldest(const value_type & v) {
     return remove;
 }
 
+template< typename P >
+bool
+cache<P>::admit(const vespalib::LockGuard & guard, const K & key, const V & value) const {
+    (void) guard;
+    if ( ! _sketch ||
+         (((sizeBytes() + calcSize(key, value)) <= capacityBytes()) && (Lru::size() < Lru::capacity())))
+    {
+        return true;
+    }
+    const K * victim = Lru::oldestKey();
+    return (victim == nullptr) || (_sketch->estimate(_hasher(key)) > _sketch->estimate(_hasher(*victim)));
+}
+
 template< typename P >
 vespalib::LockGuard
 cache<P>::getGuard() {
@@ -89,6 +116,9 @@ cache<P>::read(const K & key)
 {
     {
         vespalib::LockGuard guard(_hashLock);
+        if (_sketch) {
+            _sketch->record(_hasher(key));
+        }
         if (Lru::hasKey(key)) {
             _hit++;
             return (*this)[key];
@@ -109,9 +139,13 @@ cache<P>::read(const K & key)
     V value;
     if (_store.read(key, value)) {
         vespalib::LockGuard guard(_hashLock);
-        Lru::insert(key, value);
-        _sizeBytes += calcSize(key, value);
-        _insert++;
+        if (admit(guard, key, value)) {
+            Lru::insert(key, value);
+            _sizeBytes += calcSize(key, value);
+            _insert++;
+        } else {
+            _rejected++;
+        }
     } else {
         _noneExisting.fetch_add(1);
     }
@@ -132,6 +166,31 @@ cache<P>::write(const K & key, const V & value)
     _store.write(key, value);
 }
 
+template< typename P >
+template< typename IsCurrent >
+void
+cache<P>::populate(const K & key, const V & value, IsCurrent isCurrent)
+{
+    vespalib::LockGuard storeGuard(getLock(key));
+    vespalib::LockGuard guard(_hashLock);
+    if (_sketch) {
+        _sketch->record(_hasher(key));
+    }
+    _miss++;
+    if (Lru::hasKey(key)) {
+        // Somebody else just fetched it ahead of me.
+        _race++;
+    } else if ( ! isCurrent()) {
+        // Written after the caller read it, leave it to the next read.
+    } else if (admit(guard, key, value)) {
+        Lru::insert(key, value);
+        _sizeBytes += calcSize(key, value);
+        _insert++;
+    } else {
+        _rejected++;
+    }
+}
+
 template< typename P >
 void
 cache<P>::erase(const K & key)
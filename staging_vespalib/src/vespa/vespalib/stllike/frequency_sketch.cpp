@@ -0,0 +1,74 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "frequency_sketch.h"
+#include <algorithm>
+
+namespace vespalib {
+
+namespace {
+
+const uint64_t SEEDS[] = { 0xc3a5c85c97cb3127ul, 0xb492b66fbe98f273ul, 0x9ae16a3b2f90404ful, 0xcbf29ce484222325ul };
+
+size_t
+roundUp2inN(size_t n) {
+    size_t v(1);
+    while (v < n) {
+        v <<= 1;
+    }
+    return v;
+}
+
+}
+
+FrequencySketch::FrequencySketch(size_t expectedElements)
+    : _counters(),
+      _mask(roundUp2inN(std::max(expectedElements, 16ul)) - 1),
+      _sampleSize(10 * width()),
+      _numRecorded(0)
+{
+    _counters.resize(NUM_ROWS * width(), 0);
+}
+
+FrequencySketch::~FrequencySketch() { }
+
+size_t
+FrequencySketch::index(uint64_t hash, size_t row) const
+{
+    uint64_t h = (hash + SEEDS[row]) * SEEDS[row];
+    return (row * width()) + ((h >> 32) & _mask);
+}
+
+void
+FrequencySketch::record(uint64_t hash)
+{
+    for (size_t row(0); row < NUM_ROWS; row++) {
+        uint8_t & counter = _counters[index(hash, row)];
+        if (counter < MAX_COUNT) {
+            counter++;
+        }
+    }
+    if (++_numRecorded >= _sampleSize) {
+        age();
+    }
+}
+
+uint32_t
+FrequencySketch::estimate(uint64_t hash) const
+{
+    uint32_t minCount(MAX_COUNT);
+    for (size_t row(0); row < NUM_ROWS; row++) {
+        minCount = std::min(minCount, uint32_t(_counters[index(hash, row)]));
+    }
+    return minCount;
+}
+
+void
+FrequencySketch::age()
+{
+    for (uint8_t & counter : _counters) {
+        counter >>= 1;
+    }
+    _numRecorded /= 2;
+}
+
+}
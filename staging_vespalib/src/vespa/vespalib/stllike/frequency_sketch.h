@@ -0,0 +1,41 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace vespalib {
+
+/**
+ * Approximate access frequency of keys, identified by their hash, in a recent window.
+ * This is a count-min sketch with 4 rows of small saturating counters. All counters are
+ * halved when the number of recorded accesses reaches 10 times the width, so that old
+ * popularity fades away. Used by @ref cache as TinyLFU admission filter.
+ * Not thread safe.
+ */
+class FrequencySketch
+{
+public:
+    /**
+     * @param expectedElements is the number of distinct keys expected to be tracked.
+     */
+    FrequencySketch(size_t expectedElements);
+    ~FrequencySketch();
+    void record(uint64_t hash);
+    uint32_t estimate(uint64_t hash) const;
+    size_t width() const { return _mask + 1; }
+    size_t memoryUsage() const { return _counters.size(); }
+private:
+    static constexpr size_t NUM_ROWS = 4;
+    static constexpr uint8_t MAX_COUNT = 15;
+    size_t index(uint64_t hash, size_t row) const;
+    void age();
+
+    std::vector<uint8_t> _counters;
+    size_t               _mask;
+    size_t               _sampleSize;
+    size_t               _numRecorded;
+};
+
+}
@@ -153,6 +153,14 @@ public:
      */
     bool hasKey(const K & key) const { return HashTable::find(key) != HashTable::end(); }
 
+    /**
+     * The key of the least recently used object, which is the next to be removed.
+     * Returns nullptr if empty.
+     */
+    const K * oldestKey() const {
+        return (_tail != LinkedValueBase::npos) ? & HashTable::getByInternalIndex(_tail).first : nullptr;
+    }
+
     /**
      * Called when an object is inserted, to see if the LRU should be removed.
      * Default is to obey the maxsize given in constructor.
@@ -0,0 +1,82 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include "cache.h"
+#include <vector>
+
+namespace vespalib {
+
+/**
+ * A cache split into a number of independent @ref cache stripes, each with its own lock and an
+ * equal share of the byte and element limits. A key always maps to the same stripe, so lookups
+ * of different keys rarely contend. Eviction and admission are decided per stripe.
+ * It has the same interface and parameters as @ref cache, but does not support extension by inheritance.
+ */
+template< typename P >
+class striped_cache
+{
+    typedef cache<P> Stripe;
+protected:
+    typedef typename P::BackingStore   BackingStore;
+    typedef typename P::Hash  Hash;
+    typedef typename P::Key   K;
+    typedef typename P::Value V;
+public:
+    /**
+     * @param backingStore is the store for populating the cache on a cache miss.
+     * @param maxBytes is the maximum limit of bytes the cache can hold in total.
+     * @param numStripes is the number of stripes the cache is split into. Rounded up to a power of 2.
+     */
+    striped_cache(BackingStore & b, size_t maxBytes, size_t numStripes);
+    ~striped_cache();
+
+    striped_cache & maxElements(size_t elems);
+    striped_cache & reserveElements(size_t elems);
+    striped_cache & setCapacityBytes(size_t sz);
+    /**
+     * Enables TinyLFU admission in all stripes, see @ref cache::setAdmission.
+     */
+    striped_cache & setAdmission(size_t expectedElements);
+
+    size_t capacity()      const { return _maxElements; }
+    size_t capacityBytes() const { return _maxBytes; }
+    size_t numStripes()    const { return _stripes.size(); }
+    size_t size()          const { return sum(&Stripe::size); }
+    size_t sizeBytes()     const { return sum(&Stripe::sizeBytes); }
+    bool empty()           const { return size() == 0; }
+
+    void erase(const K & key) { getStripe(key).erase(key); }
+    void invalidate(const K & key) { getStripe(key).invalidate(key); }
+    V read(const K & key) { return getStripe(key).read(key); }
+    void write(const K & key, const V & value) { getStripe(key).write(key, value); }
+    template <typename IsCurrent>
+    void populate(const K & key, const V & value, IsCurrent isCurrent) { getStripe(key).populate(key, value, isCurrent); }
+    bool hasKey(const K & key) const { return getStripe(key).hasKey(key); }
+
+    size_t          getHit() const { return sum(&Stripe::getHit); }
+    size_t         getMiss() const { return sum(&Stripe::getMiss); }
+    size_t getNoneExisting() const { return sum(&Stripe::getNoneExisting); }
+    size_t         getRace() const { return sum(&Stripe::getRace); }
+    size_t       getInsert() const { return sum(&Stripe::getInsert); }
+    size_t        getWrite() const { return sum(&Stripe::getWrite); }
+    size_t        getErase() const { return sum(&Stripe::getErase); }
+    size_t   getInvalidate() const { return sum(&Stripe::getInvalidate); }
+    size_t       getlookup() const { return sum(&Stripe::getlookup); }
+    size_t     getRejected() const { return sum(&Stripe::getRejected); }
+private:
+    Stripe & getStripe(const K & key) const {
+        // Use the high bits of a remixed hash so the stripe is independent of the bucket within the stripe.
+        uint64_t h = uint64_t(_hasher(key)) * 0x9e3779b97f4a7c15ul;
+        return *_stripes[(h >> 32) & (_stripes.size() - 1)];
+    }
+    size_t sum(size_t (Stripe::*getter)() const) const;
+    static size_t perStripe(size_t total, size_t numStripes);
+    size_t perStripe(size_t total) const { return perStripe(total, _stripes.size()); }
+
+    Hash                                 _hasher;
+    size_t                               _maxBytes;
+    size_t                               _maxElements;
+    std::vector<std::unique_ptr<Stripe>> _stripes;
+};
+
+}
@@ -0,0 +1,83 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include "striped_cache.h"
+#include "cache.hpp"
+
+namespace vespalib {
+
+template< typename P >
+striped_cache<P>::striped_cache(BackingStore & b, size_t maxBytes, size_t numStripes) :
+    _hasher(),
+    _maxBytes(maxBytes),
+    _maxElements(std::numeric_limits<size_t>::max()),
+    _stripes()
+{
+    size_t n(1);
+    while (n < numStripes) {
+        n <<= 1;
+    }
+    _stripes.reserve(n);
+    for (size_t i(0); i < n; i++) {
+        _stripes.push_back(std::make_unique<Stripe>(b, perStripe(maxBytes, n)));
+    }
+}
+
+template< typename P >
+striped_cache<P>::~striped_cache() { }
+
+template< typename P >
+size_t
+striped_cache<P>::perStripe(size_t total, size_t numStripes) {
+    return (total == std::numeric_limits<size_t>::max()) ? total : (total + numStripes - 1) / numStripes;
+}
+
+template< typename P >
+size_t
+striped_cache<P>::sum(size_t (Stripe::*getter)() const) const {
+    size_t total(0);
+    for (const auto & stripe : _stripes) {
+        total += ((*stripe).*getter)();
+    }
+    return total;
+}
+
+template< typename P >
+striped_cache<P> &
+striped_cache<P>::maxElements(size_t elems) {
+    _maxElements = elems;
+    for (auto & stripe : _stripes) {
+        stripe->maxElements(perStripe(elems));
+    }
+    return *this;
+}
+
+template< typename P >
+striped_cache<P> &
+striped_cache<P>::reserveElements(size_t elems) {
+    for (auto & stripe : _stripes) {
+        stripe->reserveElements(perStripe(elems));
+    }
+    return *this;
+}
+
+template< typename P >
+striped_cache<P> &
+striped_cache<P>::setCapacityBytes(size_t sz) {
+    _maxBytes = sz;
+    for (auto & stripe : _stripes) {
+        stripe->setCapacityBytes(perStripe(sz));
+    }
+    return *this;
+}
+
+template< typename P >
+striped_cache<P> &
+striped_cache<P>::setAdmission(size_t expectedElements) {
+    for (auto & stripe : _stripes) {
+        stripe->setAdmission((expectedElements != 0) ? perStripe(expectedElements) : 0);
+    }
+    return *this;
+}
+
+}
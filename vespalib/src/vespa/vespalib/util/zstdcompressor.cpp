@@ -4,6 +4,7 @@
 #include <vespa/vespalib/util/alloc.h>
 #include <vespa/vespalib/util/sync.h>
 #include <zstd.h>
+#include <zdict.h>
 #include <vector>
 #include <cassert>
 
@@ -62,4 +63,102 @@ ZStdCompressor::unprocess(const void * inputV, size_t inputLen, void * outputV,
     return ! ZSTD_isError(sz);
 }
 
+ZStdDictionary::ZStdDictionary(const void * data, size_t sz)
+    : ZStdDictionary(data, sz, ZSTD_createDDict(data, sz))
+{
+    assert(_ddict != nullptr);
+}
+
+ZStdDictionary::ZStdDictionary(const void * data, size_t sz, ZSTD_DDict_s * ddict)
+    : _data(static_cast<const char *>(data), static_cast<const char *>(data) + sz),
+      _id(ZDICT_getDictID(data, sz)),
+      _ddict(ddict),
+      _lock(),
+      _cdicts()
+{
+}
+
+ZStdDictionary::~ZStdDictionary()
+{
+    for (auto & entry : _cdicts) {
+        ZSTD_freeCDict(entry.second);
+    }
+    ZSTD_freeDDict(_ddict);
+}
+
+std::unique_ptr<ZStdDictionary>
+ZStdDictionary::train(const std::vector<ConstBufferRef> & samples, size_t maxSize)
+{
+    std::vector<char> sampleBuffer;
+    std::vector<size_t> sampleSizes;
+    sampleSizes.reserve(samples.size());
+    for (const ConstBufferRef & sample : samples) {
+        sampleBuffer.insert(sampleBuffer.end(), sample.c_str(), sample.c_str() + sample.size());
+        sampleSizes.push_back(sample.size());
+    }
+    if (sampleBuffer.empty() || (maxSize == 0)) {
+        return std::unique_ptr<ZStdDictionary>();
+    }
+    std::vector<char> dict(maxSize);
+    size_t sz = ZDICT_trainFromBuffer(&dict[0], dict.size(), &sampleBuffer[0], &sampleSizes[0], sampleSizes.size());
+    if (ZDICT_isError(sz)) {
+        return std::unique_ptr<ZStdDictionary>();
+    }
+    return std::make_unique<ZStdDictionary>(&dict[0], sz);
+}
+
+std::unique_ptr<ZStdDictionary>
+ZStdDictionary::create(const void * data, size_t sz)
+{
+    // Trained dictionaries always carry an id, raw content does not.
+    if ((sz == 0) || (ZDICT_getDictID(data, sz) == 0)) {
+        return std::unique_ptr<ZStdDictionary>();
+    }
+    ZSTD_DDict * ddict = ZSTD_createDDict(data, sz);
+    if (ddict == nullptr) {
+        return std::unique_ptr<ZStdDictionary>();
+    }
+    return std::unique_ptr<ZStdDictionary>(new ZStdDictionary(data, sz, ddict));
+}
+
+ZSTD_CDict *
+ZStdDictionary::getCompressDict(int level) const
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    ZSTD_CDict * & cdict = _cdicts[level];
+    if (cdict == nullptr) {
+        cdict = ZSTD_createCDict(&_data[0], _data.size(), level);
+        assert(cdict != nullptr);
+    }
+    return cdict;
+}
+
+bool
+ZStdDictionary::compress(int level, const void * input, size_t inputLen, void * output, size_t & outputLen) const
+{
+    if ( ! _tlCompressState) {
+        _tlCompressState = std::make_unique<CompressContext>();
+    }
+    size_t sz = ZSTD_compress_usingCDict(_tlCompressState->get(), output, outputLen, input, inputLen, getCompressDict(level));
+    if (ZSTD_isError(sz)) {
+        return false;
+    }
+    outputLen = sz;
+    return true;
+}
+
+bool
+ZStdDictionary::decompress(const void * input, size_t inputLen, void * output, size_t & outputLen) const
+{
+    if ( ! _tlDecompressState) {
+        _tlDecompressState = std::make_unique<DecompressContext>();
+    }
+    size_t sz = ZSTD_decompress_usingDDict(_tlDecompressState->get(), output, outputLen, input, inputLen, _ddict);
+    if (ZSTD_isError(sz)) {
+        return false;
+    }
+    outputLen = sz;
+    return true;
+}
+
 }
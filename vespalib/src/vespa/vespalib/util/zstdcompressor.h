@@ -2,6 +2,13 @@
 #pragma once
 
 #include "compressor.h"
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+struct ZSTD_CDict_s;
+struct ZSTD_DDict_s;
 
 namespace vespalib::compression {
 
@@ -13,5 +20,46 @@ public:
     size_t adjustProcessLen(uint16_t options, size_t len)   const override;
 };
 
+/**
+ * A zstd dictionary trained from sample data. Compressing many small buffers
+ * with similar content using a shared dictionary gives a far better ratio
+ * than compressing each of them on its own.
+ */
+class ZStdDictionary
+{
+public:
+    using SP = std::shared_ptr<const ZStdDictionary>;
+    ZStdDictionary(const void * data, size_t sz);
+    ZStdDictionary(const ZStdDictionary &) = delete;
+    ZStdDictionary & operator = (const ZStdDictionary &) = delete;
+    ~ZStdDictionary();
+
+    /**
+     * Train a dictionary of at most maxSize bytes from the given samples.
+     * Returns an empty pointer if training fails, typically due to too little sample data.
+     */
+    static std::unique_ptr<ZStdDictionary> train(const std::vector<ConstBufferRef> & samples, size_t maxSize);
+
+    /**
+     * Create a dictionary from data previously produced by train, e.g. read back from disk.
+     * Returns an empty pointer if the data is not a valid dictionary.
+     */
+    static std::unique_ptr<ZStdDictionary> create(const void * data, size_t sz);
+
+    uint32_t getId() const { return _id; }
+    ConstBufferRef getData() const { return ConstBufferRef(&_data[0], _data.size()); }
+    bool compress(int level, const void * input, size_t inputLen, void * output, size_t & outputLen) const;
+    bool decompress(const void * input, size_t inputLen, void * output, size_t & outputLen) const;
+private:
+    ZStdDictionary(const void * data, size_t sz, ZSTD_DDict_s * ddict);
+    ZSTD_CDict_s * getCompressDict(int level) const;
+
+    std::vector<char>                      _data;
+    uint32_t                               _id;
+    ZSTD_DDict_s                         * _ddict;
+    mutable std::mutex                     _lock;
+    mutable std::map<int, ZSTD_CDict_s *>  _cdicts;
+};
+
 }
 